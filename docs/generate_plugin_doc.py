@@ -12,6 +12,7 @@ SHAPE_ORDERING = [
     'obj',
     'ply',
     'serialized',
+    'mmesh',
     'cube',
     'sphere',
     'rectangle',
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <mitsuba/core/fwd.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Process-wide registry of immutable data derived from files
+ *
+ * Plugins such as \c bitmap, \c envmap and \c gridvolume convert the contents
+ * of a file into the representation used for rendering. Material libraries
+ * frequently reference the same file from many plugins, in which case this
+ * conversion would be repeated and its result stored once per plugin.
+ *
+ * This registry maps a key (the resolved path of the file, combined with all
+ * parameters that affect the conversion) to the converted data. Entries are
+ * only referenced weakly: they are shared as long as some plugin holds on to
+ * the returned pointer, and released as soon as the last one goes away.
+ * Callers must treat the shared data as immutable.
+ */
+class MI_EXPORT_LIB AssetRegistry {
+public:
+    /**
+     * \brief Look up an entry, or create it if it doesn't exist yet
+     *
+     * The function \c create is invoked (at most once per key, even when
+     * several threads request the same entry concurrently) to produce the
+     * data. It must return the data along with its size in bytes, which is
+     * used to report how much memory was saved by sharing it.
+     */
+    template <typename T, typename Func>
+    static std::shared_ptr<const T> get(const std::string &key, Func &&create) {
+        return std::static_pointer_cast<const T>(get_impl(key,
+            [&](size_t &size) -> std::shared_ptr<const void> {
+                auto [value, value_size] = create();
+                size = value_size;
+                return std::shared_ptr<const T>(std::move(value));
+            }));
+    }
+
+    /**
+     * \brief Identify the current contents of a file within a key
+     *
+     * Combines the path with the modification time and size of the file, so
+     * that entries created before the file was overwritten aren't reused.
+     */
+    static std::string file_key(const fs::path &path);
+
+    /// Return the number of entries that are currently alive
+    static size_t entry_count();
+
+    /// Return how often an existing entry was handed out again
+    static size_t hit_count();
+
+    /// Return the total size of the data that was shared instead of recreated
+    static size_t deduplicated_bytes();
+
+    /// Enable or disable the registry (enabled by default)
+    static void set_enabled(bool value);
+
+    /// Return whether the registry is enabled
+    static bool enabled();
+
+private:
+    using Factory = std::function<std::shared_ptr<const void>(size_t &)>;
+    static std::shared_ptr<const void> get_impl(const std::string &key,
+                                                const Factory &create);
+};
+
+NAMESPACE_END(mitsuba)
@@ -5,6 +5,9 @@
 #include <mitsuba/core/math.h>
 #include <drjit/dynamic.h>
 #include <drjit/traversable_base.h>
+#include <nanothread/nanothread.h>
+#include <memory>
+#include <vector>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -17,12 +20,19 @@ NAMESPACE_BEGIN(mitsuba)
  * probability mass functions (PMFs) will automatically be normalized during
  * initialization. The associated scale factor can be retrieved using the
  * function \ref normalization().
+ *
+ * By default, samples are generated via a binary search over the CDF, whose
+ * cost grows logarithmically with the number of entries. Alternatively, \ref
+ * set_alias_sampling() builds a Walker/Vose alias table that enables sampling
+ * in constant time. Note that the mapping from samples to indices is then no
+ * longer monotonic, which breaks the stratification of the input samples.
  */
 template <typename Value> struct DiscreteDistribution: drjit::TraversableBase {
     using Float = std::conditional_t<dr::is_static_array_v<Value>,
                                      dr::value_t<Value>, Value>;
     using FloatStorage   = DynamicBuffer<Float>;
     using UInt32         = dr::uint32_array_t<Float>;
+    using UInt32Storage  = DynamicBuffer<UInt32>;
     using Index          = dr::uint32_array_t<Value>;
     using Mask           = dr::mask_t<Value>;
     using Vector2u       = dr::Array<UInt32, 2>;
@@ -58,8 +68,38 @@ public:
             compute_cdf();
         else
             compute_cdf_scalar(m_pmf.data(), m_pmf.size());
+
+        if (m_alias_sampling)
+            compute_alias_table();
     }
 
+    /**
+     * \brief Enable or disable sampling via an alias table
+     *
+     * When enabled, an alias table is built alongside the CDF (here, and
+     * whenever \ref update() is called), and all sampling routines run in
+     * constant time instead of performing a binary search. PMF and CDF
+     * evaluation are unaffected.
+     */
+    void set_alias_sampling(bool value) {
+        m_alias_sampling = value;
+        if (value && !m_pmf.empty()) {
+            compute_alias_table();
+        } else {
+            m_alias_prob = FloatStorage();
+            m_alias_index = UInt32Storage();
+        }
+    }
+
+    /// Is sampling via an alias table enabled?
+    bool alias_sampling() const { return m_alias_sampling; }
+
+    /// Return the probabilities of the alias table (empty if disabled)
+    const FloatStorage &alias_prob() const { return m_alias_prob; }
+
+    /// Return the alias indices of the alias table (empty if disabled)
+    const UInt32Storage &alias_index() const { return m_alias_index; }
+
     /// Return the unnormalized probability mass function
     FloatStorage &pmf() { return m_pmf; }
 
@@ -117,6 +157,9 @@ public:
     Index sample(Value sample, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
+        if (m_alias_sampling)
+            return sample_alias(sample, active).first;
+
         sample *= m_sum;
 
         return dr::binary_search<Index>(
@@ -174,6 +217,9 @@ public:
     sample_reuse(Value value, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
+        if (m_alias_sampling)
+            return sample_alias(value, active);
+
         Index index = sample(value, active);
 
         Value pmf = eval_pmf_normalized(index, active),
@@ -203,6 +249,11 @@ public:
     sample_reuse_pmf(Value value, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
+        if (m_alias_sampling) {
+            auto [index, reused] = sample_alias(value, active);
+            return { index, reused, eval_pmf_normalized(index, active) };
+        }
+
         auto [index, pdf] = sample_pmf(value, active);
 
         Value pmf = eval_pmf_normalized(index, active),
@@ -237,22 +288,83 @@ private:
         if (size == 0)
             Throw("DiscreteDistribution: empty distribution!");
 
+        /* Large distributions are processed in parallel using a blocked
+           prefix sum. The blocks have a fixed size so that the result doesn't
+           depend on the number of threads. */
+        constexpr size_t BlockSize = 1 << 16;
+        size_t block_count = (size + BlockSize - 1) / BlockSize;
+
         std::vector<ScalarFloat> cdf(size);
-        ScalarVector2u valid = (uint32_t) -1;
+        std::unique_ptr<double[]> block_sum(new double[block_count]);
+        std::unique_ptr<ScalarVector2u[]> block_valid(new ScalarVector2u[block_count]);
+        std::unique_ptr<bool[]> block_negative(new bool[block_count]);
+
+        /* Accumulate the block starting at 'sum'. If 'write' is set, store
+           the CDF, otherwise only determine the sum and the valid range. */
+        auto process_block = [&](size_t block, double sum, bool write) {
+            ScalarVector2u valid = (uint32_t) -1;
+            bool negative = false;
+
+            uint32_t start = (uint32_t) (block * BlockSize),
+                     end   = (uint32_t) std::min(size, (block + 1) * BlockSize);
+
+            for (uint32_t i = start; i < end; ++i) {
+                double value = (double) pmf[i];
+                sum += value;
+                if (write)
+                    cdf[i] = (ScalarFloat) sum;
+
+                if (value < 0.0) {
+                    negative = true;
+                } else if (value > 0.0) {
+                    // Determine the first and last bin with nonzero density
+                    if (valid.x() == (uint32_t) -1)
+                        valid.x() = i;
+                    valid.y() = i;
+                }
+            }
 
-        double sum = 0.0;
-        for (uint32_t i = 0; i < size; ++i) {
-            double value = (double) *pmf++;
-            sum += value;
-            cdf[i] = (ScalarFloat) sum;
+            block_sum[block] = sum;
+            block_valid[block] = valid;
+            block_negative[block] = negative;
+        };
 
-            if (value < 0.0) {
+        if (block_count == 1) {
+            process_block(0, 0.0, true);
+        } else {
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, block_count, 1),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i)
+                        process_block(i, 0.0, false);
+                }
+            );
+
+            // Exclusive prefix sum over the blocks
+            std::unique_ptr<double[]> block_offset(new double[block_count]);
+            double offset = 0.0;
+            for (size_t i = 0; i < block_count; ++i) {
+                block_offset[i] = offset;
+                offset += block_sum[i];
+            }
+
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, block_count, 1),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i)
+                        process_block(i, block_offset[i], true);
+                }
+            );
+        }
+
+        ScalarVector2u valid = (uint32_t) -1;
+        for (size_t i = 0; i < block_count; ++i) {
+            if (block_negative[i])
                 Throw("DiscreteDistribution: entries must be non-negative!");
-            } else if (value > 0.0) {
-                // Determine the first and last bin with nonzero density
+            if (block_valid[i].x() != (uint32_t) -1) {
                 if (valid.x() == (uint32_t) -1)
-                    valid.x() = i;
-                valid.y() = i;
+                    valid.x() = block_valid[i].x();
+                valid.y() = block_valid[i].y();
             }
         }
 
@@ -266,15 +378,113 @@ private:
         dr::make_opaque(m_valid, m_sum, m_normalization);
     }
 
+    /**
+     * Build the alias table using Vose's method. This is done on the host
+     * and in double precision, since the construction is inherently
+     * sequential and sensitive to roundoff.
+     */
+    void compute_alias_table() {
+        size_t size = m_pmf.size();
+        if (size == 0)
+            Throw("DiscreteDistribution: empty distribution!");
+        if (size > (size_t) 0xFFFFFFFFu)
+            Throw("DiscreteDistribution: too many entries for an alias table!");
+
+        std::unique_ptr<ScalarFloat[]> pmf(new ScalarFloat[size]);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::store(pmf.get(), m_pmf);
+        else
+            memcpy(pmf.get(), m_pmf.data(), size * sizeof(ScalarFloat));
+
+        double sum = 0.0;
+        uint32_t fallback = (uint32_t) -1;
+        for (uint32_t i = 0; i < size; ++i) {
+            if (pmf[i] < 0.f)
+                Throw("DiscreteDistribution: entries must be non-negative!");
+            else if (pmf[i] > 0.f)
+                fallback = i;
+            sum += (double) pmf[i];
+        }
+
+        if (fallback == (uint32_t) -1)
+            Throw("DiscreteDistribution: no probability mass found!");
+
+        std::unique_ptr<double[]> scaled(new double[size]);
+        std::unique_ptr<ScalarFloat[]> prob(new ScalarFloat[size]);
+        std::unique_ptr<uint32_t[]> alias(new uint32_t[size]);
+        std::vector<uint32_t> small, large;
+
+        double scale = (double) size / sum;
+        for (uint32_t i = 0; i < size; ++i) {
+            scaled[i] = (double) pmf[i] * scale;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+
+            prob[s] = (ScalarFloat) scaled[s];
+            alias[s] = l;
+
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        for (uint32_t l : large) {
+            prob[l] = 1.f;
+            alias[l] = l;
+        }
+
+        /* Entries that remain due to roundoff are close to 1. Zero-valued
+           entries must never be sampled, hence redirect them elsewhere. */
+        for (uint32_t s : small) {
+            bool nonzero = pmf[s] > 0.f;
+            prob[s] = nonzero ? 1.f : 0.f;
+            alias[s] = nonzero ? s : fallback;
+        }
+
+        m_alias_prob = dr::load<FloatStorage>(prob.get(), size);
+        m_alias_index = dr::load<UInt32Storage>(alias.get(), size);
+    }
+
+    /// Sample an index and a reusable sample value using the alias table
+    std::pair<Index, Value> sample_alias(Value value, Mask active) const {
+        uint32_t size = (uint32_t) m_alias_prob.size();
+
+        Value scaled = value * (ScalarFloat) size;
+        Index index = dr::minimum(Index(dr::maximum(scaled, 0.f)), size - 1u);
+        Value frac = dr::clip(scaled - Value(index), 0.f, 1.f);
+
+        Value prob = dr::gather<Value>(m_alias_prob, index, active);
+        Mask use_alias = frac >= prob;
+
+        Index alias = dr::gather<Index>(m_alias_index, index, active && use_alias);
+        index = dr::select(use_alias, alias, index);
+
+        // The sample is uniformly distributed within either part of the bin
+        Value num = dr::select(use_alias, frac - prob, frac),
+              den = dr::select(use_alias, 1.f - prob, prob),
+              reused = dr::select(den > 0.f, num / den, 0.f);
+
+        return { index, dr::minimum(reused, dr::OneMinusEpsilon<Value>) };
+    }
+
 private:
     FloatStorage m_pmf;
     FloatStorage m_cdf;
     Float m_sum = 0.f;
     Float m_normalization = 0.f;
     Vector2u m_valid;
+    FloatStorage m_alias_prob;
+    UInt32Storage m_alias_index;
+    bool m_alias_sampling = false;
 
     MI_TRAVERSE_CB(drjit::TraversableBase, m_pmf, m_cdf, m_sum, m_normalization,
-                   m_valid)
+                   m_valid, m_alias_prob, m_alias_index)
 };
 
 /**
@@ -31,6 +31,7 @@ class Bitmap;
 class DefaultFormatter;
 class DummyStream;
 class FileResolver;
+class FilePrefetcher;
 class FileStream;
 class Formatter;
 class Logger;
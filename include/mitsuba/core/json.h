@@ -0,0 +1,54 @@
+#pragma once
+
+#include <mitsuba/core/fwd.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Minimal JSON value representation
+ *
+ * Used to exchange job descriptions, results, statistics and traces with
+ * other processes and tools. Object members are kept in their original
+ * order.
+ */
+struct MI_EXPORT_LIB JSONValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JSONValue> array;
+    std::vector<std::pair<std::string, JSONValue>> object;
+
+    bool is_null() const { return type == Type::Null; }
+    bool is_bool() const { return type == Type::Bool; }
+    bool is_number() const { return type == Type::Number; }
+    bool is_string() const { return type == Type::String; }
+    bool is_array() const { return type == Type::Array; }
+    bool is_object() const { return type == Type::Object; }
+
+    /// Look up an object member, returns \c nullptr if not present
+    const JSONValue *find(std::string_view key) const;
+
+    /// Return a string member, or \c def if it is not present
+    std::string get_string(std::string_view key, std::string_view def = "") const;
+
+    /// Return a numeric member, or \c def if it is not present
+    double get_number(std::string_view key, double def = 0.0) const;
+
+    /// Convert the value back into a compact JSON string
+    std::string to_string() const;
+};
+
+/// Parse a JSON document, throws an exception on syntax errors
+extern MI_EXPORT_LIB JSONValue parse_json(std::string_view text);
+
+/// Return \c value as a quoted JSON string literal
+extern MI_EXPORT_LIB std::string json_string(std::string_view value);
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <string>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Subsystems whose memory usage is tracked by \ref MemoryUsage
+enum class MemoryCategory : uint32_t {
+    /// Vertex and index buffers of meshes
+    Geometry,
+
+    /// Bitmap textures
+    Textures,
+
+    /// Volume grids
+    Volumes,
+
+    /// Sampling tables of emitters
+    Emitters,
+
+    /// Acceleration data structures
+    Acceleration,
+
+    /// Film storage
+    Film,
+
+    CategoryCount
+};
+
+/**
+ * \brief Reports the resident memory of an object to \ref MemoryUsage
+ *
+ * Objects that own large buffers hold a tracker as a member and call \ref
+ * set() whenever they (re)allocate them. The contribution is removed when the
+ * tracker is destroyed. Copies of a tracker start out empty, since the copied
+ * object has not allocated anything yet.
+ */
+class MI_EXPORT_LIB MemoryTracker {
+public:
+    MemoryTracker(MemoryCategory category);
+    MemoryTracker(const MemoryTracker &other) : MemoryTracker(other.m_category) { }
+    MemoryTracker &operator=(const MemoryTracker &) { return *this; }
+    ~MemoryTracker();
+
+    /**
+     * \brief Report the number of bytes currently used by the owning object
+     *
+     * \param name
+     *     Identifies the object in \ref MemoryUsage::report()
+     */
+    void set(size_t bytes, const std::string &name = "");
+
+    /// Return the number of bytes reported last
+    size_t bytes() const { return m_bytes; }
+
+    /// Return the subsystem of the owning object
+    MemoryCategory category() const { return m_category; }
+
+    /// Return the name of the owning object
+    const std::string &name() const { return m_name; }
+
+private:
+    MemoryCategory m_category;
+    size_t m_bytes = 0;
+    std::string m_name;
+};
+
+/// Aggregated memory usage of all \ref MemoryTracker instances
+class MI_EXPORT_LIB MemoryUsage {
+public:
+    /// Return the number of bytes used by the given subsystem
+    static size_t bytes(MemoryCategory category);
+
+    /// Return the number of bytes used by all subsystems
+    static size_t total();
+
+    /**
+     * \brief Set the memory budget in bytes (0 disables it)
+     *
+     * A warning including \ref report() is logged whenever the total memory
+     * usage grows past the budget.
+     */
+    static void set_budget(size_t bytes);
+
+    /// Return the memory budget in bytes (0 if disabled)
+    static size_t budget();
+
+    /// Return a summary of the memory usage per subsystem and the largest objects
+    static std::string report();
+};
+
+extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, MemoryCategory value);
+
+NAMESPACE_END(mitsuba)
@@ -86,6 +86,18 @@ struct ParserConfig {
     /// Merge compatible meshes (same material) into single larger mesh
     bool merge_meshes = true;
 
+    /// Replace meshes that are identical up to a rigid transformation by
+    /// instances of a shared shape group (requires merge_meshes)
+    bool instance_duplicates = false;
+
+    /// Read files referenced by "filename" properties ahead of time on
+    /// background threads (only used with parallel instantiation)
+    bool prefetch = true;
+
+    /// Directory storing binary caches of parsed and transformed scenes
+    /// (see \ref parse_file_cached()). Caching is disabled when empty.
+    fs::path cache_directory;
+
     /// Constructor that takes variant name
     ParserConfig(std::string_view variant) : variant(variant) {}
 };
@@ -296,7 +308,11 @@ extern MI_EXPORT_LIB void transform_merge_equivalent(const ParserConfig &config,
  * - Merges them into single mesh instances to reduce memory usage
  * - Preserves non-mesh shapes and meshes with unique attributes
  *
- * \param config Parser configuration (currently unused)
+ * If \c config.instance_duplicates is set, meshes that only differ by a rigid
+ * transformation are furthermore replaced by instances of a shared shape
+ * group before merging.
+ *
+ * \param config Parser configuration
  * \param state Parser state to modify in-place
  */
 extern MI_EXPORT_LIB void transform_merge_meshes(const ParserConfig &config,
@@ -372,6 +388,57 @@ extern MI_EXPORT_LIB void transform_relocate(const ParserConfig &config,
 extern MI_EXPORT_LIB void transform_all(const ParserConfig &config,
                                         ParserState &state);
 
+/**
+ * \brief Parse an XML file and apply \ref transform_all(), reusing a binary
+ * cache of the result when possible
+ *
+ * Parsing large XML files and running the transformation pipeline can take
+ * several seconds. When \c config.cache_directory is set, this function
+ * stores the transformed parser state in that directory (see \ref
+ * write_binary()) and loads it directly on subsequent calls.
+ *
+ * A cache file is specific to the scene file, the parameter substitutions,
+ * and the configuration options affecting the transformations. It is
+ * discarded and rewritten when the size or modification time of the scene
+ * file or of any included XML file changes. Other files that are read while
+ * parsing (e.g., spectra) are not tracked.
+ *
+ * Without a cache directory, this is equivalent to calling \ref parse_file()
+ * followed by \ref transform_all().
+ *
+ * \param config Parser configuration options
+ * \param filename Path to the XML file to load
+ * \param params List of parameter substitutions to apply
+ * \return Transformed parser state
+ */
+extern MI_EXPORT_LIB ParserState parse_file_cached(
+    const ParserConfig &config,
+    const fs::path &filename,
+    const ParameterList &params = {}
+);
+
+/**
+ * \brief Serialize a parser state into a compact binary representation
+ *
+ * All nodes, their properties (including resolved references), and the
+ * file metadata used for error reporting are stored. Properties holding
+ * instantiated objects or arbitrary data (\ref Properties::Type::Object and
+ * \ref Properties::Type::Any) cannot be serialized and raise an exception.
+ *
+ * \param state Parser state to serialize
+ * \param stream Target stream
+ */
+extern MI_EXPORT_LIB void write_binary(const ParserState &state,
+                                       Stream *stream);
+
+/**
+ * \brief Deserialize a parser state written by \ref write_binary()
+ *
+ * \param stream Source stream
+ * \return The reconstructed parser state
+ */
+extern MI_EXPORT_LIB ParserState read_binary(Stream *stream);
+
 /**
  * \brief Generate a human-readable file location string for error reporting
  *
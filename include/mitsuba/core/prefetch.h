@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/object.h>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Reads files referenced by a scene ahead of time
+ *
+ * Before instantiating a scene, the parser registers every file referenced by
+ * a \c filename property with an instance of this class. The files are then
+ * read into memory on worker threads, and images are additionally decoded
+ * into \ref Bitmap instances. At most \c concurrency of these jobs run at any
+ * time, and files are skipped once the (estimated) memory footprint of the
+ * prefetched data would exceed \c memory_budget.
+ *
+ * Plugin constructors obtain the data through the static \ref open() and
+ * \ref load_bitmap() functions. These wait for a pending prefetch of the
+ * requested file and otherwise fall back to reading it from disk, hence
+ * file I/O of later plugins overlaps with the construction of earlier ones.
+ *
+ * The contents of a file are read once and shared by all of its uses. The
+ * prefetcher drops its reference when the last registered use of a file has
+ * been consumed, or at the latest when it is destroyed.
+ */
+class MI_EXPORT_LIB FilePrefetcher : public Object {
+public:
+    /// Create a prefetcher with the given concurrency and memory budget (in bytes)
+    FilePrefetcher(size_t concurrency = 4, size_t memory_budget = 1024 * 1024 * 1024);
+
+    /// Wait for pending reads and release all prefetched data
+    ~FilePrefetcher();
+
+    /**
+     * \brief Schedule a file to be read into memory
+     *
+     * Each call registers one use of the file. Files that don't exist, or that
+     * don't fit into the remaining memory budget, are ignored.
+     */
+    void prefetch(const fs::path &path);
+
+    /// Return the number of files that are being (or have been) prefetched
+    size_t file_count() const;
+
+    /// Return the estimated memory footprint of the prefetched data
+    size_t memory_usage() const;
+
+    /**
+     * \brief Return the prefetched contents of a file
+     *
+     * Waits until the read of the file completes. Returns \c nullptr if the
+     * file wasn't prefetched or if reading it failed. Otherwise, the returned
+     * stream is a read-only view of a buffer that is shared by all uses of
+     * the file.
+     */
+    static ref<MemoryStream> fetch(const fs::path &path);
+
+    /// Return a stream over the prefetched contents of a file, or open it
+    static ref<Stream> open(const fs::path &path);
+
+    /// Return the prefetched and decoded contents of an image, or load it
+    static ref<Bitmap> load_bitmap(const fs::path &path);
+
+    /// Return a human-readable string representation
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS(FilePrefetcher)
+private:
+    struct FilePrefetcherPrivate;
+    std::unique_ptr<FilePrefetcherPrivate> d;
+};
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Kinds of statistics counters, see \ref StatsCounter and \ref StatsHistogram
+enum class StatsType : uint32_t {
+    /// Number of occurrences of an event (e.g. traced rays)
+    Counter,
+
+    /// Fraction of events with a certain property (e.g. occluded shadow rays)
+    Ratio,
+
+    /// Distribution of a small integer quantity (e.g. primitive tests per ray)
+    Histogram
+};
+
+#if defined(MI_ENABLE_STATISTICS)
+
+NAMESPACE_BEGIN(detail)
+
+/// Maximum number of counter slots (one per counter, two per ratio, one per histogram bin)
+static constexpr uint32_t StatsSlotCount = 1024;
+
+using StatsSlot = std::atomic<uint64_t>;
+
+/// Reserve \c slots consecutive counter slots and return the index of the first one
+extern MI_EXPORT_LIB uint32_t stats_register(const char *category,
+                                             const char *name, StatsType type,
+                                             uint32_t slots);
+
+/// Allocate the counter slots of the calling thread
+extern MI_EXPORT_LIB StatsSlot *stats_register_thread();
+
+/// Return the counter slots of the calling thread
+inline StatsSlot *stats_slots() {
+    static thread_local StatsSlot *slots = nullptr;
+    if (unlikely(!slots))
+        slots = stats_register_thread();
+    return slots;
+}
+
+inline void stats_add(uint32_t index, uint64_t value) {
+    /* Slots are only ever written by the thread that owns them, hence no
+       atomic read-modify-write operation is needed */
+    StatsSlot &slot = stats_slots()[index];
+    slot.store(slot.load(std::memory_order_relaxed) + value,
+               std::memory_order_relaxed);
+}
+
+NAMESPACE_END(detail)
+
+/**
+ * \brief Thread-local statistics counter
+ *
+ * Counters are meant to be declared as static variables of the code that
+ * increments them, e.g.
+ *
+ * \code
+ * static StatsCounter stats_rays("Ray tracing", "Rays traced");
+ * ...
+ * ++stats_rays;
+ * \endcode
+ *
+ * Each thread increments its own copy, and \ref Statistics sums them up on
+ * request. Counters that are declared several times with the same category
+ * and name (e.g. in different plugins) are reported as one. Unless Mitsuba
+ * is compiled with <tt>MI_ENABLE_STATISTICS</tt>, all operations on counters
+ * compile to nothing.
+ */
+class StatsCounter {
+public:
+    StatsCounter(const char *category, const char *name,
+                 StatsType type = StatsType::Counter)
+        : m_index(detail::stats_register(category, name, type,
+                                         type == StatsType::Ratio ? 2 : 1)) { }
+
+    StatsCounter &operator++() {
+        detail::stats_add(m_index, 1);
+        return *this;
+    }
+
+    StatsCounter &operator+=(uint64_t value) {
+        detail::stats_add(m_index, value);
+        return *this;
+    }
+
+    /// Increase the denominator of a counter of type \ref StatsType::Ratio
+    void inc_base(uint64_t value = 1) {
+        detail::stats_add(m_index + 1, value);
+    }
+
+private:
+    uint32_t m_index;
+};
+
+/**
+ * \brief Thread-local histogram of a small integer quantity
+ *
+ * Values larger than or equal to <tt>bins - 1</tt> are recorded in the last
+ * bin.
+ */
+class StatsHistogram {
+public:
+    StatsHistogram(const char *category, const char *name, uint32_t bins)
+        : m_index(detail::stats_register(category, name, StatsType::Histogram, bins)),
+          m_bins(bins) { }
+
+    void put(uint64_t value) {
+        detail::stats_add(m_index + (uint32_t) std::min<uint64_t>(value, m_bins - 1), 1);
+    }
+
+private:
+    uint32_t m_index;
+    uint32_t m_bins;
+};
+
+#else
+
+class StatsCounter {
+public:
+    constexpr StatsCounter(const char *, const char *,
+                           StatsType = StatsType::Counter) { }
+    StatsCounter &operator++() { return *this; }
+    StatsCounter &operator+=(uint64_t) { return *this; }
+    void inc_base(uint64_t = 1) { }
+};
+
+class StatsHistogram {
+public:
+    constexpr StatsHistogram(const char *, const char *, uint32_t) { }
+    void put(uint64_t) { }
+};
+
+#endif
+
+/// Aggregation and reporting of the statistics counters of all threads
+class MI_EXPORT_LIB Statistics {
+public:
+    /// Was Mitsuba compiled with support for statistics counters?
+    static constexpr bool enabled() {
+#if defined(MI_ENABLE_STATISTICS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// Reset the counters of all threads to zero
+    static void reset();
+
+    /// Sum the counters of all threads and return a human-readable summary
+    static std::string report();
+
+    /**
+     * \brief Sum the counters of all threads and return them as a JSON object
+     *
+     * The result maps categories to objects that map counter names to values.
+     * Ratios are written as <tt>{"value": .., "base": ..}</tt>, histograms as
+     * arrays of bin counts.
+     */
+    static std::string to_json();
+};
+
+/**
+ * \brief Work done by the calling thread in scalar variants
+ *
+ * In contrast to \ref StatsCounter, these tallies don't depend on the build
+ * configuration: the render cost AOVs of the \c aov integrator read them
+ * before and after each sample to attribute the work to individual pixels.
+ * They are only updated while such an integrator exists (see
+ * \ref work_counters_enabled()).
+ */
+struct WorkCounters {
+    /// Number of traced rays (including shadow rays)
+    uint64_t rays = 0;
+
+    /// Number of rays that found a surface interaction (i.e. path vertices)
+    uint64_t vertices = 0;
+
+    /// Number of kd-tree nodes visited during ray traversal
+    uint64_t kd_nodes = 0;
+};
+
+/// Return the work counters of the calling thread
+extern MI_EXPORT_LIB WorkCounters &work_counters();
+
+/// Number of existing integrators that report render cost AOVs
+extern MI_EXPORT_LIB std::atomic<uint32_t> work_counters_users;
+
+/**
+ * \brief Return whether the work counters need to be updated
+ *
+ * Checked before every update, so that renders without cost AOVs only pay
+ * for a relaxed load instead of a call to \ref work_counters().
+ */
+inline bool work_counters_enabled() {
+    return work_counters_users.load(std::memory_order_relaxed) != 0;
+}
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/filesystem.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Records a timeline of events (e.g. during scene loading)
+ *
+ * When enabled, \ref ScopedTraceEvent instances record when they begin and
+ * end along with the thread that executed them. Each thread appends to its
+ * own buffer, so recording adds little overhead even when many plugins are
+ * instantiated in parallel. The timeline can be exported in the Chrome trace
+ * event format, which is understood by <tt>chrome://tracing</tt> and
+ * <a href="https://ui.perfetto.dev">Perfetto</a>.
+ */
+class MI_EXPORT_LIB Trace {
+public:
+    /**
+     * \brief Start or stop recording events
+     *
+     * Starting a recording discards the events of the previous one.
+     */
+    static void set_enabled(bool value);
+
+    /// Are events currently being recorded?
+    static bool enabled();
+
+    /// Discard all recorded events
+    static void clear();
+
+    /// Return the number of recorded events
+    static size_t event_count();
+
+    /// Return the recorded events in the Chrome trace event format (JSON)
+    static std::string to_json();
+
+    /// Write the recorded events in the Chrome trace event format (JSON)
+    static void write(const fs::path &filename);
+
+    /// Return the time in nanoseconds since the recording was started
+    static uint64_t now();
+
+    /**
+     * \brief Record an event of the calling thread
+     *
+     * \param category
+     *     Groups related events, e.g. "Parser" or "File I/O"
+     *
+     * \param detail
+     *     Optional additional information that is shown when selecting the
+     *     event (e.g. the ID of an instantiated plugin)
+     *
+     * \param start, end
+     *     Timestamps obtained via \ref now()
+     */
+    static void record(const char *category, std::string_view name,
+                       std::string_view detail, uint64_t start, uint64_t end);
+};
+
+/**
+ * \brief Records the lifetime of the object as an event of \ref Trace
+ *
+ * Unless tracing is enabled, the constructor only queries \ref
+ * Trace::enabled() and does not copy its arguments. However, any temporary
+ * that the caller builds to pass as an argument is still constructed. Hot call
+ * sites should therefore pass strings that already exist, or a path, which is
+ * only converted when the event is actually recorded.
+ *
+ * \code
+ * ScopedTraceEvent event("File I/O", "Read file", filename);
+ * \endcode
+ */
+class ScopedTraceEvent {
+public:
+    ScopedTraceEvent(const char *category, std::string_view name,
+                     std::string_view detail = { })
+        : m_active(Trace::enabled()) {
+        if (m_active) {
+            m_detail = detail;
+            start(category, name);
+        }
+    }
+
+    /// Variant that only converts the path to a string when tracing is enabled
+    template <typename T,
+              std::enable_if_t<std::is_same_v<T, fs::path>, int> = 0>
+    ScopedTraceEvent(const char *category, std::string_view name,
+                     const T &detail)
+        : m_active(Trace::enabled()) {
+        if (m_active) {
+            m_detail = detail.string();
+            start(category, name);
+        }
+    }
+
+    ~ScopedTraceEvent() {
+        if (m_active)
+            Trace::record(m_category, m_name, m_detail, m_start, Trace::now());
+    }
+
+    ScopedTraceEvent(const ScopedTraceEvent &) = delete;
+    ScopedTraceEvent &operator=(const ScopedTraceEvent &) = delete;
+
+private:
+    void start(const char *category, std::string_view name) {
+        m_category = category;
+        m_name = name;
+        m_start = Trace::now();
+    }
+
+private:
+    bool m_active;
+    const char *m_category = nullptr;
+    std::string m_name, m_detail;
+    uint64_t m_start = 0;
+};
+
+NAMESPACE_END(mitsuba)
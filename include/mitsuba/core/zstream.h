@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mitsuba/core/stream.h>
+#include <vector>
 
 extern "C" {
     struct z_stream_s;
@@ -134,4 +135,179 @@ private:
     bool m_did_write;
 };
 
+/**
+ * \brief Block-parallel compression/decompression stream based on \c zlib.
+ *
+ * In contrast to \ref ZStream, which processes data using a single \c zlib
+ * state, this class splits the data into blocks of \c block_size bytes that
+ * are compressed independently. Several blocks are compressed or
+ * decompressed at once on the thread pool.
+ *
+ * The blocks are concatenated into a single (zlib or gzip) stream, hence the
+ * output remains readable by \ref ZStream and other sequential decoders.
+ * When the stream is closed, an index of the blocks is appended after the
+ * compressed data. In gzip streams, it is stored in the header of additional
+ * empty members, hence the output remains a valid (multi-member) gzip file.
+ * zlib streams can't be extended in this way: the index directly follows
+ * them, which \ref ZStream ignores but stricter decoders may report as
+ * trailing data. Reading through this class requires the index, which
+ * enables seeking within the uncompressed data: only the blocks that are
+ * actually accessed are decompressed. The index is located using a footer
+ * at the end of the child stream, hence the compressed payload must extend
+ * to the end of the child stream when reading it.
+ *
+ * A given instance can be used either for reading or for writing.
+ */
+class MI_EXPORT_LIB BlockZStream : public Stream {
+public:
+    using Stream::read;
+    using Stream::write;
+
+    /** \brief Creates a new block compression stream with the given
+     * underlying stream, which must outlive it.
+     *
+     * \param child_stream
+     *    Stream that receives (or provides) the compressed data. The payload
+     *    starts at the current position of the child stream.
+     *
+     * \param stream_type
+     *    Container format of the compressed data
+     *
+     * \param level
+     *    Compression level (-1: default, 0-9: fastest to smallest)
+     *
+     * \param block_size
+     *    Size (in bytes) of the uncompressed blocks (writing only)
+     */
+    BlockZStream(Stream *child_stream,
+                 ZStream::EStreamType stream_type = ZStream::EDeflateStream,
+                 int level = -1, size_t block_size = 1024 * 1024);
+
+    /// Destructor
+    ~BlockZStream();
+
+    /// Returns a string representation
+    std::string to_string() const override;
+
+    /** \brief Closes the stream, but not the underlying child stream.
+     * When writing, this compresses any remaining data and writes the
+     * index. No further read or write operations are permitted.
+     *
+     * This function is idempotent.
+     * It is called automatically by the destructor.
+     */
+    void close() override;
+
+    /// Whether the stream is closed (no read or write are then permitted).
+    bool is_closed() const override { return !m_child_stream || m_child_stream->is_closed(); };
+
+    // =========================================================================
+    //! @{ \name Compression stream-specific features
+    // =========================================================================
+
+    /// Returns the child stream of this compression stream
+    const Stream *child_stream() const { return m_child_stream.get(); }
+
+    /// Returns the child stream of this compression stream
+    Stream *child_stream() { return m_child_stream; }
+
+    /// Return the number of compressed blocks (read from the index when reading)
+    size_t block_count() const;
+
+    /// Return the uncompressed size of the blocks
+    size_t block_size() const { return m_block_size; }
+
+    //! @}
+    // =========================================================================
+
+    // =========================================================================
+    //! @{ \name Implementation of the Stream interface
+    // =========================================================================
+
+    /**
+     * \brief Reads a specified amount of data from the stream, decompressing
+     * the blocks containing it (and the following ones) in parallel.
+     * Throws an exception when the stream ended prematurely.
+     */
+    void read(void *p, size_t size) override;
+
+    /**
+     * \brief Writes a specified amount of data into the stream. The data is
+     * compressed once enough blocks are available to keep all threads busy.
+     */
+    void write(const void *p, size_t size) override;
+
+    /// Compresses and writes any buffered data (this may create a partial block)
+    void flush() override;
+
+    /// Seeks to a position within the uncompressed data (reading only)
+    void seek(size_t pos) override;
+
+    //// Unsupported. Always throws.
+    void truncate(size_t) override {
+        Throw("truncate(): unsupported in a block ZLIB stream!");
+    }
+
+    /// Returns the current position within the uncompressed data
+    size_t tell() const override { return m_pos; }
+
+    /// Returns the size of the uncompressed data
+    size_t size() const override;
+
+    /// Can we write to the stream?
+    bool can_write() const override {
+        return m_mode != Mode::Read && m_child_stream && m_child_stream->can_write();
+    }
+
+    /// Can we read from the stream?
+    bool can_read() const override {
+        return m_mode != Mode::Write && m_child_stream && m_child_stream->can_read();
+    }
+
+    //! @}
+    // =========================================================================
+
+    MI_DECLARE_CLASS(BlockZStream)
+
+private:
+    enum class Mode { Undecided, Read, Write };
+
+    /// Switch to the given mode, which can't be changed afterwards
+    void set_mode(Mode mode) const;
+
+    /// Read the block index from the end of the child stream
+    void read_index() const;
+
+    /// Compress and write the buffered data
+    void compress_buffer();
+
+    /// Return the decompressed contents of a block
+    const std::vector<uint8_t> &fetch_block(size_t index);
+
+private:
+    ref<Stream> m_child_stream;
+    ZStream::EStreamType m_stream_type;
+    int m_level;
+    size_t m_block_size;
+    /// Number of blocks processed at once
+    size_t m_batch_size;
+    /// Position of the compressed payload in the child stream
+    size_t m_start;
+    /// Position within the uncompressed data
+    size_t m_pos = 0;
+    mutable Mode m_mode = Mode::Undecided;
+
+    /// Offsets of the blocks in the compressed and uncompressed data
+    mutable std::vector<uint64_t> m_compressed_offsets, m_uncompressed_offsets;
+
+    /// Writing: data waiting to be compressed, size of the compressed data and checksum
+    std::vector<uint8_t> m_buffer;
+    uint64_t m_compressed_size = 0;
+    uint32_t m_checksum = 0;
+
+    /// Reading: decompressed contents of the blocks starting at \c m_cache_start
+    std::vector<std::vector<uint8_t>> m_cache;
+    size_t m_cache_start = 0;
+};
+
 NAMESPACE_END(mitsuba)
@@ -765,6 +765,47 @@ static const char *__doc_mitsuba_ArgParser_parse = R"doc(Parse the given set of
 
 static const char *__doc_mitsuba_ArgParser_parse_2 = R"doc(Parse the given set of command line arguments)doc";
 
+static const char *__doc_mitsuba_AssetRegistry =
+R"doc(Process-wide registry of immutable data derived from files
+
+Plugins such as ``bitmap``, ``envmap`` and ``gridvolume`` convert the
+contents of a file into the representation used for rendering.
+Material libraries frequently reference the same file from many
+plugins, in which case this conversion would be repeated and its
+result stored once per plugin.
+
+This registry maps a key (the resolved path of the file, combined with
+all parameters that affect the conversion) to the converted data.
+Entries are only referenced weakly: they are shared as long as some
+plugin holds on to the returned pointer, and released as soon as the
+last one goes away. Callers must treat the shared data as immutable.)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_deduplicated_bytes = R"doc(Return the total size of the data that was shared instead of recreated)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_enabled = R"doc(Return whether the registry is enabled)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_entry_count = R"doc(Return the number of entries that are currently alive)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_file_key =
+R"doc(Identify the current contents of a file within a key
+
+Combines the path with the modification time and size of the file, so
+that entries created before the file was overwritten aren't reused.)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_get =
+R"doc(Look up an entry, or create it if it doesn't exist yet
+
+The function ``create`` is invoked (at most once per key, even when
+several threads request the same entry concurrently) to produce the
+data. It must return the data along with its size in bytes, which is
+used to report how much memory was saved by sharing it.)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_get_impl = R"doc()doc";
+
+static const char *__doc_mitsuba_AssetRegistry_hit_count = R"doc(Return how often an existing entry was handed out again)doc";
+
+static const char *__doc_mitsuba_AssetRegistry_set_enabled = R"doc(Enable or disable the registry (enabled by default))doc";
+
 static const char *__doc_mitsuba_BSDF =
 R"doc(Bidirectional Scattering Distribution Function (BSDF) interface
 
@@ -2097,6 +2138,54 @@ static const char *__doc_mitsuba_Bitmap_write_ppm = R"doc(Save a file using the
 
 static const char *__doc_mitsuba_Bitmap_write_rgbe = R"doc(Save a file using the RGBE file format)doc";
 
+static const char *__doc_mitsuba_BlockZStream =
+R"doc(Block-parallel compression/decompression stream based on ``zlib``.
+
+In contrast to ZStream, which processes data using a single ``zlib``
+state, this class splits the data into blocks of ``block_size`` bytes
+that are compressed independently. Several blocks are compressed or
+decompressed at once on the thread pool.
+
+The blocks are concatenated into a single (zlib or gzip) stream, hence
+the output remains readable by ZStream and other sequential decoders.
+When the stream is closed, an index of the blocks is appended after the
+compressed data. In gzip streams, it is stored in the header of
+additional empty members, hence the output remains a valid (multi-
+member) gzip file. zlib streams can't be extended in this way: the
+index directly follows them, which ZStream ignores but stricter
+decoders may report as trailing data. Reading through this class
+requires the index, which enables seeking within the uncompressed data: only the blocks that are
+actually accessed are decompressed. The index is located using a
+footer at the end of the child stream, hence the compressed payload
+must extend to the end of the child stream when reading it.
+
+A given instance can be used either for reading or for writing.)doc";
+
+static const char *__doc_mitsuba_BlockZStream_BlockZStream =
+R"doc(Creates a new block compression stream with the given underlying
+stream, which must outlive it.
+
+Parameter ``child_stream``:
+    Stream that receives (or provides) the compressed data. The
+    payload starts at the current position of the child stream.
+
+Parameter ``stream_type``:
+    Container format of the compressed data
+
+Parameter ``level``:
+    Compression level (-1: default, 0-9: fastest to smallest)
+
+Parameter ``block_size``:
+    Size (in bytes) of the uncompressed blocks (writing only))doc";
+
+static const char *__doc_mitsuba_BlockZStream_block_count = R"doc(Return the number of compressed blocks (read from the index when reading))doc";
+
+static const char *__doc_mitsuba_BlockZStream_block_size = R"doc(Return the uncompressed size of the blocks)doc";
+
+static const char *__doc_mitsuba_BlockZStream_child_stream = R"doc(Returns the child stream of this compression stream)doc";
+
+static const char *__doc_mitsuba_BlockZStream_child_stream_2 = R"doc(Returns the child stream of this compression stream)doc";
+
 static const char *__doc_mitsuba_BoundingBox =
 R"doc(Generic n-dimensional bounding box data structure
 
@@ -3073,6 +3162,12 @@ static const char *__doc_mitsuba_DiscreteDistribution_DiscreteDistribution_3 = R
 
 static const char *__doc_mitsuba_DiscreteDistribution_DiscreteDistribution_4 = R"doc(Initialize from a given floating point array)doc";
 
+static const char *__doc_mitsuba_DiscreteDistribution_alias_index = R"doc(Return the alias indices of the alias table (empty if disabled))doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_alias_prob = R"doc(Return the probabilities of the alias table (empty if disabled))doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_alias_sampling = R"doc(Is sampling via an alias table enabled?)doc";
+
 static const char *__doc_mitsuba_DiscreteDistribution_cdf = R"doc(Return the unnormalized cumulative distribution function)doc";
 
 static const char *__doc_mitsuba_DiscreteDistribution_cdf_2 =
@@ -3168,6 +3263,14 @@ Returns:
 1. the discrete index associated with the sample 2. the re-scaled
 sample value 3. the normalized probability value of the sample)doc";
 
+static const char *__doc_mitsuba_DiscreteDistribution_set_alias_sampling =
+R"doc(Enable or disable sampling via an alias table
+
+When enabled, an alias table is built alongside the CDF (here, and
+whenever update() is called), and all sampling routines run in
+constant time instead of performing a binary search. PMF and CDF
+evaluation are unaffected.)doc";
+
 static const char *__doc_mitsuba_DiscreteDistribution_size = R"doc(Return the number of entries)doc";
 
 static const char *__doc_mitsuba_DiscreteDistribution_sum = R"doc(Return the original sum of PMF entries before normalization)doc";
@@ -3941,6 +4044,14 @@ static const char *__doc_mitsuba_Film_variant_name = R"doc()doc";
 
 static const char *__doc_mitsuba_Film_write = R"doc(Write the developed contents of the film to a file on disk)doc";
 
+static const char *__doc_mitsuba_Film_write_async =
+R"doc(Equivalent to write(), but the image is encoded and written to disk
+asynchronously on a different thread
+
+The film is developed before this function returns, hence it can be
+cleared or rendered to again right away. The default implementation
+simply calls write().)doc";
+
 static const char *__doc_mitsuba_FilterBoundaryCondition =
 R"doc(When resampling data to a different resolution using
 Resampler::resample(), this enumeration specifies how lookups
@@ -5373,6 +5484,22 @@ static const char *__doc_mitsuba_Medium_use_emitter_sampling = R"doc(Returns whe
 
 static const char *__doc_mitsuba_Medium_variant_name = R"doc()doc";
 
+static const char *__doc_mitsuba_MemoryCategory = R"doc(Subsystems whose memory usage is tracked by MemoryUsage)doc";
+
+static const char *__doc_mitsuba_MemoryCategory_Acceleration = R"doc(Acceleration data structures)doc";
+
+static const char *__doc_mitsuba_MemoryCategory_CategoryCount = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryCategory_Emitters = R"doc(Sampling tables of emitters)doc";
+
+static const char *__doc_mitsuba_MemoryCategory_Film = R"doc(Film storage)doc";
+
+static const char *__doc_mitsuba_MemoryCategory_Geometry = R"doc(Vertex and index buffers of meshes)doc";
+
+static const char *__doc_mitsuba_MemoryCategory_Textures = R"doc(Bitmap textures)doc";
+
+static const char *__doc_mitsuba_MemoryCategory_Volumes = R"doc(Volume grids)doc";
+
 static const char *__doc_mitsuba_MemoryMappedFile =
 R"doc(Basic cross-platform abstraction for memory mapped files
 
@@ -5512,6 +5639,54 @@ static const char *__doc_mitsuba_MemoryStream_write =
 R"doc(Writes a specified amount of data into the memory buffer. The capacity
 of the memory buffer is extended if necessary.)doc";
 
+static const char *__doc_mitsuba_MemoryTracker =
+R"doc(Reports the resident memory of an object to MemoryUsage
+
+Objects that own large buffers hold a tracker as a member and call
+set() whenever they (re)allocate them. The contribution is removed when
+the tracker is destroyed. Copies of a tracker start out empty, since
+the copied object has not allocated anything yet.)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_MemoryTracker = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_MemoryTracker_2 = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_bytes = R"doc(Return the number of bytes reported last)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_category = R"doc(Return the subsystem of the owning object)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_m_bytes = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_m_category = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_m_name = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_name = R"doc(Return the name of the owning object)doc";
+
+static const char *__doc_mitsuba_MemoryTracker_operator_assign = R"doc()doc";
+
+static const char *__doc_mitsuba_MemoryTracker_set =
+R"doc(Report the number of bytes currently used by the owning object
+
+Parameter ``name``:
+    Identifies the object in MemoryUsage::report())doc";
+
+static const char *__doc_mitsuba_MemoryUsage = R"doc(Aggregated memory usage of all MemoryTracker instances)doc";
+
+static const char *__doc_mitsuba_MemoryUsage_budget = R"doc(Return the memory budget in bytes (0 if disabled))doc";
+
+static const char *__doc_mitsuba_MemoryUsage_bytes = R"doc(Return the number of bytes used by the given subsystem)doc";
+
+static const char *__doc_mitsuba_MemoryUsage_report = R"doc(Return a summary of the memory usage per subsystem and the largest objects)doc";
+
+static const char *__doc_mitsuba_MemoryUsage_set_budget =
+R"doc(Set the memory budget in bytes (0 disables it)
+
+A warning including report() is logged whenever the total memory
+usage grows past the budget.)doc";
+
+static const char *__doc_mitsuba_MemoryUsage_total = R"doc(Return the number of bytes used by all subsystems)doc";
+
 static const char *__doc_mitsuba_Mesh = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_2 = R"doc()doc";
@@ -5611,6 +5786,26 @@ since it uses a mutex.)doc";
 
 static const char *__doc_mitsuba_Mesh_class_name = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_compact =
+R"doc(Does this mesh store its data in compact form?
+
+When the ``compact`` property is set, initialize() encodes vertex
+normals using 2 x 16 bits (octahedral mapping) and texture coordinates
+using half precision. When the mesh is intersected through the
+accessors of this class (i.e. by the kd-tree of scalar variants built
+without Embree), vertex positions are furthermore quantized to
+``compact_position_bits`` (16 or 21) bits per component relative to
+the bounding box, and the faces of meshes with less than 65536
+vertices use 16-bit indices.
+
+Decoding happens in the accessors (vertex_position(),
+vertex_normal(), etc.). Compact storage is only available in scalar
+variants and the compact data cannot be modified through traverse().)doc";
+
+static const char *__doc_mitsuba_Mesh_compact_buffers =
+R"doc(Encode the buffers of the mesh in compact form and release the single
+precision versions (see compact()))doc";
+
 static const char *__doc_mitsuba_Mesh_compute_surface_interaction = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_differential_motion = R"doc()doc";
@@ -5631,6 +5826,8 @@ static const char *__doc_mitsuba_Mesh_eval_attribute_3 = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_eval_parameterization = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_expanded = R"doc(Return an equivalent mesh that stores its data in single precision)doc";
+
 static const char *__doc_mitsuba_Mesh_face_count = R"doc(Return the total number of faces)doc";
 
 static const char *__doc_mitsuba_Mesh_face_data_bytes = R"doc()doc";
@@ -5643,6 +5840,10 @@ static const char *__doc_mitsuba_Mesh_faces_buffer = R"doc(Return face indices b
 
 static const char *__doc_mitsuba_Mesh_faces_buffer_2 = R"doc(Const variant of faces_buffer.)doc";
 
+static const char *__doc_mitsuba_Mesh_gather_u16 = R"doc(Return the ``i``-th entry of a buffer of 16-bit values packed in pairs)doc";
+
+static const char *__doc_mitsuba_Mesh_half_to_float = R"doc(Convert the bit pattern of a half precision value to single precision)doc";
+
 static const char *__doc_mitsuba_Mesh_has_attribute = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_has_face_normals = R"doc(Does this mesh use face normals?)doc";
@@ -5674,6 +5875,18 @@ static const char *__doc_mitsuba_Mesh_m_area_pmf = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_bbox = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_m_compact = R"doc(Compact storage requested through the ``compact`` property)doc";
+
+static const char *__doc_mitsuba_Mesh_m_compact_faces = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_m_compact_normals = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_m_compact_position_bits = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_m_compact_positions = R"doc(Packed buffers used in place of the above when the mesh is compact)doc";
+
+static const char *__doc_mitsuba_Mesh_m_compact_texcoords = R"doc()doc";
+
 static const char *__doc_mitsuba_Mesh_m_face_count = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_face_normals =
@@ -5692,8 +5905,16 @@ static const char *__doc_mitsuba_Mesh_m_name = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_parameterization = R"doc(Optional: used in eval_parameterization())doc";
 
+static const char *__doc_mitsuba_Mesh_m_position_bits = R"doc(Quantization of the vertex positions (0: single precision, 16 or 21 bits))doc";
+
+static const char *__doc_mitsuba_Mesh_m_position_offset = R"doc()doc";
+
+static const char *__doc_mitsuba_Mesh_m_position_scale = R"doc(Decoded position = quantized position * scale + offset)doc";
+
 static const char *__doc_mitsuba_Mesh_m_scene = R"doc(Pointer to the scene that owns this mesh)doc";
 
+static const char *__doc_mitsuba_Mesh_m_short_indices = R"doc(Is ``m_compact_faces`` used instead of ``m_faces``?)doc";
+
 static const char *__doc_mitsuba_Mesh_m_sil_dedge_pmf =
 R"doc(Sampling density of silhouette
 (build_indirect_silhouette_distribution))doc";
@@ -5735,6 +5956,8 @@ Returns:
     and ``v`` contains the first two components of the intersection in
     barycentric coordinates)doc";
 
+static const char *__doc_mitsuba_Mesh_octahedral_to_normal = R"doc(Decode a unit vector stored using the octahedral mapping (2 x 16 bits))doc";
+
 static const char *__doc_mitsuba_Mesh_opposite_dedge =
 R"doc(Returns the opposite edge index associated with directed edge
 ``index``
@@ -5759,6 +5982,8 @@ static const char *__doc_mitsuba_Mesh_primitive_count = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_primitive_silhouette_projection = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_radiance_sampling = R"doc(Are faces sampled proportionally to their emitted power?)doc";
+
 static const char *__doc_mitsuba_Mesh_ray_intersect_triangle = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_ray_intersect_triangle_impl =
@@ -5807,6 +6032,16 @@ static const char *__doc_mitsuba_Mesh_sample_silhouette = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_set_bsdf = R"doc(Set the shape's BSDF)doc";
 
+static const char *__doc_mitsuba_Mesh_set_radiance_sampling =
+R"doc(Sample faces proportionally to their emitted power
+
+When enabled, and the mesh has an emitter, position sampling selects
+each face with a probability proportional to its area times its
+average emitted radiance, which is estimated once when the sampling
+tables are built. Positions within the chosen face remain uniform.
+pdf_position() then requires the ``prim_index`` field of the position
+sample.)doc";
+
 static const char *__doc_mitsuba_Mesh_set_scene = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_surface_area = R"doc()doc";
@@ -5845,6 +6080,30 @@ static const char *__doc_mitsuba_Mesh_vertex_texcoords_buffer = R"doc(Return ver
 
 static const char *__doc_mitsuba_Mesh_vertex_texcoords_buffer_2 = R"doc(Const variant of vertex_texcoords_buffer.)doc";
 
+static const char *__doc_mitsuba_Mesh_write_mmesh =
+R"doc(Write the mesh to a native binary mesh file (<tt>.mmesh</tt>)
+
+In addition to the geometry, the file stores the bounding box and the
+area of each face. The ``mmesh`` shape plugin memory-maps such files,
+so that uncompressed buffers are used without any parsing or copying.
+
+Parameter ``filename``:
+    Target file path on disk
+
+Parameter ``compress``:
+    Compress the buffers in independent chunks. This reduces the size
+    of the file, but the buffers must then be decompressed when loading
+    it.)doc";
+
+static const char *__doc_mitsuba_Mesh_write_mmesh_2 =
+R"doc(Write the mesh encoded in the native binary mesh format to a stream
+
+Parameter ``stream``:
+    Target stream that will receive the encoded output
+
+Parameter ``compress``:
+    Compress the buffers in independent chunks)doc";
+
 static const char *__doc_mitsuba_Mesh_write_ply =
 R"doc(Write the mesh to a binary PLY file
 
@@ -6743,6 +7002,12 @@ static const char *__doc_mitsuba_PositionSample_p = R"doc(Sampled position)doc";
 
 static const char *__doc_mitsuba_PositionSample_pdf = R"doc(Probability density at the sample)doc";
 
+static const char *__doc_mitsuba_PositionSample_prim_index =
+R"doc(Optional: index of the primitive (e.g. triangle) containing the
+sampled position
+
+This is used by shapes whose sampling density varies per primitive.)doc";
+
 static const char *__doc_mitsuba_PositionSample_time = R"doc(Associated time value)doc";
 
 static const char *__doc_mitsuba_PositionSample_uv =
@@ -9984,6 +10249,21 @@ static const char *__doc_mitsuba_Spiral_reset =
 R"doc(Reset the spiral to its initial state. Does not affect the number of
 passes.)doc";
 
+static const char *__doc_mitsuba_Statistics = R"doc(Aggregation and reporting of the statistics counters of all threads)doc";
+
+static const char *__doc_mitsuba_Statistics_enabled = R"doc(Was Mitsuba compiled with support for statistics counters?)doc";
+
+static const char *__doc_mitsuba_Statistics_report = R"doc(Sum the counters of all threads and return a human-readable summary)doc";
+
+static const char *__doc_mitsuba_Statistics_reset = R"doc(Reset the counters of all threads to zero)doc";
+
+static const char *__doc_mitsuba_Statistics_to_json =
+R"doc(Sum the counters of all threads and return them as a JSON object
+
+The result maps categories to objects that map counter names to
+values. Ratios are written as ``{"value": .., "base": ..}``,
+histograms as arrays of bin counts.)doc";
+
 static const char *__doc_mitsuba_Stream =
 R"doc(Abstract seekable stream class
 
@@ -11329,6 +11609,46 @@ static const char *__doc_mitsuba_Timer_start = R"doc()doc";
 
 static const char *__doc_mitsuba_Timer_value = R"doc()doc";
 
+static const char *__doc_mitsuba_Trace =
+R"doc(Records a timeline of events (e.g. during scene loading)
+
+When enabled, ScopedTraceEvent instances record when they begin and
+end along with the thread that executed them. Each thread appends to
+its own buffer, so recording adds little overhead even when many
+plugins are instantiated in parallel. The timeline can be exported in
+the Chrome trace event format, which is understood by
+<tt>chrome://tracing</tt> and Perfetto.)doc";
+
+static const char *__doc_mitsuba_Trace_clear = R"doc(Discard all recorded events)doc";
+
+static const char *__doc_mitsuba_Trace_enabled = R"doc(Are events currently being recorded?)doc";
+
+static const char *__doc_mitsuba_Trace_event_count = R"doc(Return the number of recorded events)doc";
+
+static const char *__doc_mitsuba_Trace_now = R"doc(Return the time in nanoseconds since the recording was started)doc";
+
+static const char *__doc_mitsuba_Trace_record =
+R"doc(Record an event of the calling thread
+
+Parameter ``category``:
+    Groups related events, e.g. "Parser" or "File I/O"
+
+Parameter ``detail``:
+    Optional additional information that is shown when selecting the
+    event (e.g. the ID of an instantiated plugin)
+
+Parameter ``start``:
+    Timestamps obtained via now())doc";
+
+static const char *__doc_mitsuba_Trace_set_enabled =
+R"doc(Start or stop recording events
+
+Starting a recording discards the events of the previous one.)doc";
+
+static const char *__doc_mitsuba_Trace_to_json = R"doc(Return the recorded events in the Chrome trace event format (JSON))doc";
+
+static const char *__doc_mitsuba_Trace_write = R"doc(Write the recorded events in the Chrome trace event format (JSON))doc";
+
 static const char *__doc_mitsuba_Transform =
 R"doc(Unified homogeneous coordinate transformation
 
@@ -12175,6 +12495,10 @@ static const char *__doc_mitsuba_filesystem_is_regular_file =
 R"doc(Checks if ``p`` points to a regular file, as opposed to a directory or
 symlink.)doc";
 
+static const char *__doc_mitsuba_filesystem_last_write_time =
+R"doc(Returns the time of the last modification of the file at ``p`` (in
+nanoseconds since the epoch, where supported by the platform).)doc";
+
 static const char *__doc_mitsuba_filesystem_path =
 R"doc(Represents a path to a filesystem resource. On construction, the path
 is parsed and stored in a system-agnostic representation. The path can
@@ -13078,6 +13402,10 @@ such as how to handle unused parameters and other validation settings.)doc";
 
 static const char *__doc_mitsuba_parser_ParserConfig_ParserConfig = R"doc(Constructor that takes variant name)doc";
 
+static const char *__doc_mitsuba_parser_ParserConfig_instance_duplicates =
+R"doc(Replace meshes that are identical up to a rigid transformation by
+instances of a shared shape group (requires merge_meshes))doc";
+
 static const char *__doc_mitsuba_parser_ParserConfig_max_include_depth = R"doc(Maximum include depth to prevent infinite recursion)doc";
 
 static const char *__doc_mitsuba_parser_ParserConfig_merge_equivalent = R"doc(Enable merging of identical plugin instances (e.g., materials))doc";
@@ -13307,8 +13635,12 @@ of mesh objects (i.e., with identical BSDF, media, emitter, etc.) -
 Merges them into single mesh instances to reduce memory usage -
 Preserves non-mesh shapes and meshes with unique attributes
 
+If ``config.instance_duplicates`` is set, meshes that only differ by a
+rigid transformation are furthermore replaced by instances of a shared
+shape group before merging.
+
 Parameter ``config``:
-    Parser configuration (currently unused)
+    Parser configuration
 
 Parameter ``state``:
     Parser state to modify in-place)doc";
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <drjit/packet.h>
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/memory.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/vector.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/mesh.h>
+
+/// Branching factor of the wide BVH
+#define MI_BVH_WIDTH 8u
+
+/**
+ * Depth beyond which the builder stops evaluating the SAH and splits at the
+ * object median. Together with the 32-bit primitive count, this bounds the
+ * depth of the tree and the size of the traversal stack.
+ */
+#define MI_BVH_MAXDEPTH 64u
+
+/// Compile-time traversal stack size (entries)
+#define MI_BVH_STACK_SIZE ((MI_BVH_WIDTH - 1u) * (MI_BVH_MAXDEPTH + 32u) + 1u)
+
+/// Grain size for parallelization
+#define MI_BVH_GRAIN_SIZE 10240u
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Wide bounding volume hierarchy over the shapes of a scene
+ *
+ * This class is an alternative to \ref ShapeKDTree for builds without Embree.
+ * The hierarchy is first constructed as a binary tree using the binned surface
+ * area heuristic (SAH) and then collapsed into nodes with up to \c
+ * MI_BVH_WIDTH children. Each node stores the bounding boxes of its children
+ * quantized to 8 bits relative to the node's own bounds, and traversal tests a
+ * ray against all children of a node at once using Dr.Jit packets.
+ *
+ * In contrast to the kd-tree, every primitive is referenced exactly once.
+ * This bounds the memory footprint and makes it possible to refit the
+ * hierarchy when geometry moves.
+ *
+ * The BVH is selected by setting the scene's \c accel property to \c "bvh".
+ * The following scene properties control its construction:
+ *
+ * - \c bvh_max_leaf_size: maximum number of primitives per leaf (default: 4)
+ * - \c bvh_bins: number of SAH bins per axis (default: 16)
+ * - \c bvh_traversal_cost: relative cost of a node traversal (default: 1)
+ * - \c bvh_intersection_cost: relative cost of a primitive test (default: 1)
+ * - \c bvh_refit_threshold: largest tolerated growth of the SAH cost when
+ *   refitting the hierarchy, relative to the cost after the last full build.
+ *   A value of 0 disables refitting. (default: 1.5)
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB ShapeBVH : public Object {
+public:
+    MI_IMPORT_TYPES(Shape, Mesh)
+
+    using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
+    using Size        = uint32_t;
+    using Index       = uint32_t;
+
+    static constexpr size_t Width = MI_BVH_WIDTH;
+    using FloatP = dr::Packet<ScalarFloat, Width>;
+    using MaskP  = dr::mask_t<FloatP>;
+
+    /// Reference to a single primitive of one of the registered shapes
+    struct PrimRef {
+        Index shape_index;
+        Index prim_index;
+    };
+
+    /// Special values of \ref BVHNode::count
+    static constexpr uint8_t EmptySlot = 0x00, InnerSlot = 0xFF;
+
+    /**
+     * \brief Node of the wide BVH
+     *
+     * Along axis \c a, the bounds of child \c i are given by
+     * <tt>origin[a] + lo[a][i] * scale[a]</tt> and
+     * <tt>origin[a] + hi[a][i] * scale[a]</tt>.
+     */
+    struct BVHNode {
+        /// Origin of the quantization grid (lower corner of the node)
+        ScalarPoint3f origin;
+        /// Size of one quantization step along each axis
+        ScalarVector3f scale;
+        /// Quantized lower bounds of the children
+        uint8_t lo[3][Width];
+        /// Quantized upper bounds of the children
+        uint8_t hi[3][Width];
+        /// Index of an inner child node, or offset of a leaf's primitives
+        Index child[Width];
+        /// Primitive count of a leaf child, \ref EmptySlot or \ref InnerSlot
+        uint8_t count[Width];
+    };
+
+    /// Create an empty BVH and take build-related parameters from \c props.
+    ShapeBVH(const Properties &props);
+
+    /// Clear the BVH (build-related parameters remain)
+    void clear();
+
+    /// Register a new shape with the BVH (to be called before \ref build())
+    void add_shape(Shape *shape);
+
+    /// Build the BVH
+    void build();
+
+    /**
+     * \brief Update the bounds of the BVH after the geometry of some of the
+     * registered shapes moved, while keeping its topology
+     *
+     * Only the subtrees referencing primitives of shapes flagged as dirty
+     * (see \ref Shape::dirty()) and their ancestors are updated.
+     *
+     * \return \c false when the BVH cannot be refit, in which case it must be
+     * cleared and rebuilt by the caller. This happens when it hasn't been
+     * built yet, when refitting is disabled, when the primitive count of a
+     * shape changed, or when the SAH cost of the refit hierarchy exceeds the
+     * cost after the last build by more than the \c bvh_refit_threshold
+     * factor.
+     */
+    bool refit();
+
+    /// Has the BVH been built?
+    bool ready() const { return (bool) m_nodes; }
+
+    /// Return the number of registered shapes
+    Size shape_count() const { return Size(m_shapes.size()); }
+
+    /// Return the number of registered primitives
+    Size primitive_count() const { return m_primitive_map.back(); }
+
+    /// Return the number of nodes of the wide BVH
+    Size node_count() const { return m_node_count; }
+
+    /// Return the i-th shape (const version)
+    const Shape *shape(size_t i) const { Assert(i < m_shapes.size()); return m_shapes[i]; }
+
+    /// Return the i-th shape
+    Shape *shape(size_t i) { Assert(i < m_shapes.size()); return m_shapes[i]; }
+
+    /// Return the bounding box of the entire BVH
+    const ScalarBoundingBox3f &bbox() const { return m_bbox; }
+
+    /// Return the SAH cost of the hierarchy, normalized by the area of its bounds
+    ScalarFloat sah_cost() const { return m_cost; }
+
+    /// Return the amount of memory used by the nodes and primitive references
+    size_t memory_usage() const {
+        return m_node_count * (sizeof(BVHNode) + sizeof(ScalarBoundingBox3f)) +
+               m_prim_count * sizeof(PrimRef);
+    }
+
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection3f ray_intersect_preliminary(const Ray3f &ray,
+                                                                   Mask active) const {
+        DRJIT_MARK_USED(active);
+        if constexpr (!dr::is_array_v<Float>)
+            return ray_intersect_scalar<ShadowRay>(ray);
+        else
+            Throw("BVH should only be used in scalar mode");
+    }
+
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    ray_intersect_scalar(ScalarRay3f ray) const {
+        /// Ray traversal stack entry
+        struct StackEntry {
+            // Inner node index or offset of the leaf primitives
+            Index index;
+            // Leaf primitive count or InnerSlot
+            uint32_t count;
+            // Ray distance to the entry point of the node
+            ScalarFloat t;
+        };
+
+        // Resulting intersection struct
+        PreliminaryIntersection<ScalarFloat, Shape> pi;
+
+        if (unlikely(m_node_count == 0))
+            return pi;
+
+        // Allocate the node stack
+        StackEntry stack[MI_BVH_STACK_SIZE];
+        uint32_t stack_index = 0;
+        stack[stack_index++] = { 0, InnerSlot, ScalarFloat(0) };
+
+        ScalarVector3f d_rcp = dr::rcp(ray.d);
+
+        while (likely(stack_index > 0)) {
+            const StackEntry entry = stack[--stack_index];
+
+            // Skip nodes lying beyond the closest intersection found so far
+            if (entry.t > ray.maxt)
+                continue;
+
+            if (entry.count == InnerSlot) { // Inner node
+                const BVHNode &node = m_nodes[entry.index];
+
+                alignas(alignof(FloatP)) ScalarFloat t_near[Width];
+                dr::store_aligned(t_near, intersect_children(node, ray, d_rcp));
+
+                /* Push the children that were hit sorted by decreasing
+                   distance, so that the closest one is visited next */
+                uint32_t start = stack_index;
+                for (uint32_t i = 0; i < Width; ++i) {
+                    ScalarFloat t = t_near[i];
+                    if (t == dr::Infinity<ScalarFloat>)
+                        continue;
+
+                    uint32_t j = stack_index++;
+                    while (j > start && stack[j - 1].t < t) {
+                        stack[j] = stack[j - 1];
+                        --j;
+                    }
+                    stack[j] = { node.child[i], node.count[i], t };
+                }
+            } else { // Leaf node
+                for (Index i = entry.index; i < entry.index + entry.count; ++i) {
+                    PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
+                        intersect_prim<ShadowRay>(m_prims[i], ray);
+
+                    if (unlikely(prim_pi.is_valid())) {
+                        if constexpr (ShadowRay)
+                            return prim_pi;
+
+                        Assert(prim_pi.t >= 0.f && prim_pi.t <= ray.maxt);
+                        pi = prim_pi;
+                        ray.maxt = pi.t;
+                    }
+                }
+            }
+        }
+
+        return pi;
+    }
+
+    /// Brute force intersection routine for debugging purposes
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection3f
+    ray_intersect_naive(Ray3f ray, Mask active) const {
+        if constexpr (!dr::is_array_v<Float>) {
+            PreliminaryIntersection3f pi = dr::zeros<PreliminaryIntersection3f>();
+
+            for (Size i = 0; i < m_prim_count; ++i) {
+                PreliminaryIntersection3f prim_pi = intersect_prim<ShadowRay>(m_prims[i], ray);
+
+                if (prim_pi.is_valid()) {
+                    pi = prim_pi;
+                    ray.maxt = prim_pi.t;
+                }
+
+                if (ShadowRay && dr::all(pi.is_valid() || !active))
+                    break;
+            }
+
+            return pi;
+        } else {
+            Throw("BVH should only be used in scalar mode");
+        }
+    }
+
+    /// Return a human-readable string representation of the scene contents.
+    virtual std::string to_string() const override;
+
+    MI_DECLARE_CLASS(ShapeBVH)
+protected:
+    /**
+     * \brief Intersect a ray against the (dequantized) bounds of all children
+     * of \c node
+     *
+     * Returns the distance to the entry point of each child, or infinity if
+     * the child is empty or missed.
+     */
+    MI_INLINE FloatP intersect_children(const BVHNode &node,
+                                        const ScalarRay3f &ray,
+                                        const ScalarVector3f &d_rcp) const {
+        FloatP t_near = ScalarFloat(0),
+               t_far  = ray.maxt;
+        FloatP count;
+
+        for (uint32_t i = 0; i < Width; ++i)
+            count.entry(i) = (ScalarFloat) node.count[i];
+
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            FloatP lo, hi;
+            for (uint32_t i = 0; i < Width; ++i) {
+                lo.entry(i) = (ScalarFloat) node.lo[axis][i];
+                hi.entry(i) = (ScalarFloat) node.hi[axis][i];
+            }
+
+            lo = dr::fmadd(lo, node.scale[axis], node.origin[axis]);
+            hi = dr::fmadd(hi, node.scale[axis], node.origin[axis]);
+
+            FloatP t0 = (lo - ray.o[axis]) * d_rcp[axis],
+                   t1 = (hi - ray.o[axis]) * d_rcp[axis];
+
+            t_near = dr::maximum(t_near, dr::minimum(t0, t1));
+            t_far  = dr::minimum(t_far,  dr::maximum(t0, t1));
+        }
+
+        /* Conservatively enlarge the far distance to account for rounding
+           errors in the slab test (Ize, "Robust BVH Ray Traversal", 2013) */
+        t_far *= ScalarFloat(1) + 4 * dr::Epsilon<ScalarFloat>;
+
+        return dr::select(count != ScalarFloat(EmptySlot) && t_near <= t_far, t_near,
+                          dr::Infinity<ScalarFloat>);
+    }
+
+    /**
+     * \brief Check whether a primitive is intersected by the given ray.
+     */
+    template <bool ShadowRay = false>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    intersect_prim(const PrimRef &ref, const ScalarRay3f &ray) const {
+        Index shape_index  = ref.shape_index,
+              prim_index   = ref.prim_index;
+        const Shape *shape = m_shapes[shape_index];
+        const Mesh *mesh = (const Mesh *) shape;
+
+        PreliminaryIntersection<ScalarFloat, Shape> pi;
+
+        if constexpr (ShadowRay) {
+            bool hit;
+            if (shape->is_mesh())
+                hit = mesh->ray_intersect_triangle_scalar(prim_index, ray).first != dr::Infinity<ScalarFloat>;
+            else
+                hit = shape->ray_test_scalar(ray);
+            pi.t = dr::select(hit, 0.f , pi.t);
+        } else {
+            uint32_t inst_index = (uint32_t) -1;
+            if (shape->is_mesh())
+                std::tie(pi.t, pi.prim_uv) = mesh->ray_intersect_triangle_scalar(prim_index, ray);
+            else
+                std::tie(pi.t, pi.prim_uv, inst_index, prim_index) =
+                    shape->ray_intersect_preliminary_scalar(ray);
+            pi.prim_index = prim_index;
+
+            bool hit_inst  = (inst_index != (uint32_t) -1);
+            pi.shape       = hit_inst ? (const Shape *) (size_t) shape_index : shape; // shape_index for LLVM + BVH
+            pi.instance    = hit_inst ? shape : nullptr;
+            pi.shape_index = hit_inst ? inst_index : shape_index;
+        }
+
+        return pi;
+    }
+
+    /// Quantize the bounds of the \c slot-th child relative to the node bounds
+    static void quantize(BVHNode &node, uint32_t slot,
+                         const ScalarBoundingBox3f &bounds,
+                         const ScalarBoundingBox3f &node_bounds);
+
+    /// Initialize the quantization grid of a node covering \c node_bounds
+    static void init_quantization(BVHNode &node,
+                                  const ScalarBoundingBox3f &node_bounds);
+
+    /// Return the (dequantized) bounds of the \c slot-th child of a node
+    static ScalarBoundingBox3f child_bbox(const BVHNode &node, uint32_t slot);
+
+    /// Contribution of a node and of its leaf children to the SAH cost
+    ScalarFloat node_cost(Index node_index) const;
+
+    /// Compute the normalized SAH cost of the entire hierarchy
+    ScalarFloat compute_cost() const;
+
+protected:
+    std::vector<ref<Shape>> m_shapes;
+    std::vector<Size> m_primitive_map;
+    MemoryTracker m_memory { MemoryCategory::Acceleration };
+
+    std::unique_ptr<BVHNode[]> m_nodes;
+    std::unique_ptr<PrimRef[]> m_prims;
+    /// Full-precision bounds of every node (needed for refitting)
+    std::unique_ptr<ScalarBoundingBox3f[]> m_node_bounds;
+    Size m_node_count = 0;
+    Size m_prim_count = 0;
+
+    ScalarBoundingBox3f m_bbox;
+
+    Size m_max_leaf_size = 4;
+    Size m_bin_count = 16;
+    ScalarFloat m_traversal_cost = 1.f;
+    ScalarFloat m_intersection_cost = 1.f;
+    ScalarFloat m_refit_threshold = 1.5f;
+    ScalarFloat m_build_cost = 0.f;
+    ScalarFloat m_cost = 0.f;
+    LogLevel m_log_level = Debug;
+};
+
+MI_EXTERN_CLASS(ShapeBVH)
+NAMESPACE_END(mitsuba)
@@ -77,6 +77,16 @@ public:
     /// Write the developed contents of the film to a file on disk
     virtual void write(const fs::path &path) const = 0;
 
+    /**
+     * \brief Equivalent to \ref write(), but the image is encoded and written
+     * to disk asynchronously on a different thread
+     *
+     * The film is developed before this function returns, hence it can be
+     * cleared or rendered to again right away. The default implementation
+     * simply calls \ref write().
+     */
+    virtual void write_async(const fs::path &path) const;
+
     /// dr::schedule() variables that represent the internal film storage
     virtual void schedule_storage() = 0;
 
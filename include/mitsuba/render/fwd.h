@@ -30,6 +30,7 @@ template <typename Float, typename Spectrum> class ProjectiveCamera;
 template <typename Float, typename Spectrum> class Shape;
 template <typename Float, typename Spectrum> class ShapeGroup;
 template <typename Float, typename Spectrum> class ShapeKDTree;
+template <typename Float, typename Spectrum> class ShapeBVH;
 template <typename Float, typename Spectrum> class Texture;
 template <typename Float, typename Spectrum> class Volume;
 template <typename Float, typename Spectrum> class VolumeGrid;
@@ -74,6 +75,7 @@ template <typename Float_, typename Spectrum_> struct RenderAliases {
     using Shape                  = mitsuba::Shape<Float, Spectrum>;
     using ShapeGroup             = mitsuba::ShapeGroup<Float, Spectrum>;
     using ShapeKDTree            = mitsuba::ShapeKDTree<Float, Spectrum>;
+    using ShapeBVH               = mitsuba::ShapeBVH<Float, Spectrum>;
     using Mesh                   = mitsuba::Mesh<Float, Spectrum>;
     using Integrator             = mitsuba::Integrator<Float, Spectrum>;
     using SamplingIntegrator     = mitsuba::SamplingIntegrator<Float, Spectrum>;
@@ -161,6 +163,7 @@ template <typename Float_, typename Spectrum_> struct RenderAliases {
     using MicrofacetDistribution = typename RenderAliases::MicrofacetDistribution;                 \
     using Shape                  = typename RenderAliases::Shape;                                  \
     using ShapeKDTree            = typename RenderAliases::ShapeKDTree;                            \
+    using ShapeBVH               = typename RenderAliases::ShapeBVH;                               \
     using Mesh                   = typename RenderAliases::Mesh;                                   \
     using Integrator             = typename RenderAliases::Integrator;                             \
     using SamplingIntegrator     = typename RenderAliases::SamplingIntegrator;                     \
@@ -450,6 +450,36 @@ public:
     //! @}
     // =========================================================================
 
+    /**
+     * \brief Render a single image block (scalar variants only)
+     *
+     * This function renders one of the blocks that \ref render() splits the
+     * image into, which allows the blocks of an image to be distributed over
+     * several processes. The caller must prepare the film and set the offset
+     * and size of \c block, which should have been created with
+     * <tt>film->create_block(block_size, false, true)</tt>.
+     *
+     * \param block_id
+     *    Unique index of the block, used to decorrelate the random numbers
+     *    of different blocks
+     *
+     * \param block_size
+     *    Maximum size of the blocks the image is split into
+     *
+     * \param spp
+     *    Number of samples per pixel
+     *
+     * \param seed
+     *    Seed value of the render job
+     */
+    void render_tile(const Scene *scene,
+                     Sensor *sensor,
+                     ImageBlock *block,
+                     uint32_t block_id,
+                     uint32_t block_size,
+                     uint32_t spp,
+                     uint32_t seed = 0) const;
+
     MI_DECLARE_CLASS(SamplingIntegrator)
 protected:
     SamplingIntegrator(const Properties &props);
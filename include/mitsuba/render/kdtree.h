@@ -8,8 +8,10 @@
 #include <mitsuba/core/fwd.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/ray.h>
+#include <mitsuba/core/statistics.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
@@ -2128,6 +2130,12 @@ private:
     Float m_empty_space_bonus;
 };
 
+/// Statistics counters of ShapeKDTree::ray_intersect_scalar()
+inline StatsCounter stats_kd_nodes_visited("KD-tree traversal", "Nodes visited");
+inline StatsCounter stats_kd_primitive_tests("KD-tree traversal", "Primitive tests");
+inline StatsHistogram stats_kd_primitive_tests_per_ray("KD-tree traversal",
+                                                       "Primitive tests per ray", 32);
+
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB ShapeKDTree : public TShapeKDTree<BoundingBox<Point<dr::scalar_t<Float>, 3>>, uint32_t,
                                                           SurfaceAreaHeuristic3<dr::scalar_t<Float>>,
@@ -2229,8 +2237,21 @@ public:
 
         ScalarVector3f d_rcp = dr::rcp(ray.d);
 
+        /* Tallied locally and recorded once per ray. Apart from the node count
+           (see \ref WorkCounters), these are optimized away unless statistics
+           are enabled */
+        uint32_t nodes_visited = 0, primitive_tests = 0;
+        auto record_stats = [&]() {
+            stats_kd_nodes_visited += nodes_visited;
+            stats_kd_primitive_tests += primitive_tests;
+            stats_kd_primitive_tests_per_ray.put(primitive_tests);
+            if (work_counters_enabled())
+                work_counters().kd_nodes += nodes_visited;
+        };
+
         const KDNode *node = m_nodes.get();
         while (mint <= maxt) {
+            nodes_visited++;
             if (likely(!node->leaf())) { // Inner node
                 const ScalarFloat split = node->split();
                 const uint32_t axis     = node->axis();
@@ -2272,13 +2293,16 @@ public:
                 Index prim_end = prim_start + node->primitive_count();
                 for (Index i = prim_start; i < prim_end; i++) {
                     Index prim_index = m_indices[i];
+                    primitive_tests++;
 
                     PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
                         intersect_prim<ShadowRay>(prim_index, ray);
 
                     if (unlikely(prim_pi.is_valid())) {
-                        if constexpr (ShadowRay)
+                        if constexpr (ShadowRay) {
+                            record_stats();
                             return prim_pi;
+                        }
 
                         Assert(prim_pi.t >= 0.f && prim_pi.t <= ray.maxt);
                         pi = prim_pi;
@@ -2298,6 +2322,7 @@ public:
             }
         }
 
+        record_stats();
         return pi;
     }
 
@@ -2531,6 +2556,7 @@ protected:
 protected:
     std::vector<ref<Shape>> m_shapes;
     std::vector<Size> m_primitive_map;
+    MemoryTracker m_memory { MemoryCategory::Acceleration };
 };
 
 MI_EXTERN_CLASS(ShapeKDTree)
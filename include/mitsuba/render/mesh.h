@@ -6,6 +6,7 @@
 #include <mitsuba/core/struct.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/distr_1d.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/properties.h>
 #include <unordered_map>
 #include <mutex>
@@ -74,6 +75,9 @@ public:
     /// Return the total number of faces
     ScalarSize face_count() const { return m_face_count; }
 
+    /* The following buffers are empty when the corresponding data is stored
+       in compact form (see \ref compact()). */
+
     /// Return vertex positions buffer
     FloatStorage& vertex_positions_buffer() { return m_vertex_positions; }
     /// Const variant of \ref vertex_positions_buffer.
@@ -115,6 +119,14 @@ public:
     MI_INLINE auto face_indices(Index index,
                                 dr::mask_t<Index> active = true) const {
         using Result = Vector<dr::uint32_array_t<Index>, 3>;
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (unlikely(m_short_indices)) {
+                dr::uint32_array_t<Index> i = index * 3u;
+                return Result(gather_u16(m_compact_faces, i, active),
+                              gather_u16(m_compact_faces, i + 1u, active),
+                              gather_u16(m_compact_faces, i + 2u, active));
+            }
+        }
         return dr::gather<Result>(m_faces, index, active);
     }
 
@@ -126,10 +138,15 @@ public:
     MI_INLINE auto edge_indices(Index tri_index, Index edge_index,
                                 dr::mask_t<Index> active = true) const {
         using UInt32 = dr::uint32_array_t<Index>;
-        return Vector<UInt32, 2>(
-            dr::gather<UInt32>(m_faces, 3 * tri_index + edge_index, active),
-            dr::gather<UInt32>(m_faces, 3 * tri_index + (edge_index + 1) % 3, active)
-        );
+        UInt32 i0 = 3 * tri_index + edge_index,
+               i1 = 3 * tri_index + (edge_index + 1) % 3;
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (unlikely(m_short_indices))
+                return Vector<UInt32, 2>(gather_u16(m_compact_faces, i0, active),
+                                         gather_u16(m_compact_faces, i1, active));
+        }
+        return Vector<UInt32, 2>(dr::gather<UInt32>(m_faces, i0, active),
+                                 dr::gather<UInt32>(m_faces, i1, active));
     }
 
     /// Returns the world-space position of the vertex with index \c index
@@ -137,6 +154,27 @@ public:
     MI_INLINE auto vertex_position(Index index,
                                    dr::mask_t<Index> active = true) const {
         using Result = Point<dr::replace_scalar_t<Index, InputFloat>, 3>;
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (unlikely(m_position_bits != 0)) {
+                using UInt32 = dr::uint32_array_t<Index>;
+                Point<UInt32, 3> q;
+                if (m_position_bits == 16) {
+                    UInt32 i = index * 3u;
+                    q = Point<UInt32, 3>(gather_u16(m_compact_positions, i, active),
+                                         gather_u16(m_compact_positions, i + 1u, active),
+                                         gather_u16(m_compact_positions, i + 2u, active));
+                } else {
+                    // 3 x 21 bits packed into two words
+                    auto w = dr::gather<dr::Array<UInt32, 2>>(m_compact_positions,
+                                                              index, active);
+                    q = Point<UInt32, 3>(w[0] & 0x1FFFFFu,
+                                         (w[0] >> 21) | ((w[1] & 0x3FFu) << 11),
+                                         (w[1] >> 10) & 0x1FFFFFu);
+                }
+                return dr::fmadd(Result(q), Result(m_position_scale),
+                                 Result(m_position_offset));
+            }
+        }
         return dr::gather<Result>(m_vertex_positions, index, active);
     }
 
@@ -145,6 +183,13 @@ public:
     MI_INLINE auto vertex_normal(Index index,
                                  dr::mask_t<Index> active = true) const {
         using Result = Normal<dr::replace_scalar_t<Index, InputFloat>, 3>;
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (unlikely(dr::width(m_compact_normals) != 0)) {
+                auto w = dr::gather<dr::uint32_array_t<Index>>(m_compact_normals,
+                                                               index, active);
+                return Result(octahedral_to_normal(w));
+            }
+        }
         return dr::gather<Result>(m_vertex_normals, index, active);
     }
 
@@ -153,6 +198,14 @@ public:
     MI_INLINE auto vertex_texcoord(Index index,
                                    dr::mask_t<Index> active = true) const {
         using Result = Point<dr::replace_scalar_t<Index, InputFloat>, 2>;
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (unlikely(dr::width(m_compact_texcoords) != 0)) {
+                // Two half precision values
+                auto w = dr::gather<dr::uint32_array_t<Index>>(m_compact_texcoords,
+                                                               index, active);
+                return Result(half_to_float(w & 0xFFFFu), half_to_float(w >> 16));
+            }
+        }
         return dr::gather<Result>(m_vertex_texcoords, index, active);
     }
 
@@ -187,10 +240,14 @@ public:
     }
 
     /// Does this mesh have per-vertex normals?
-    bool has_vertex_normals() const { return dr::width(m_vertex_normals) != 0; }
+    bool has_vertex_normals() const {
+        return dr::width(m_vertex_normals) != 0 || dr::width(m_compact_normals) != 0;
+    }
 
     /// Does this mesh have per-vertex texture coordinates?
-    bool has_vertex_texcoords() const { return dr::width(m_vertex_texcoords) != 0; }
+    bool has_vertex_texcoords() const {
+        return dr::width(m_vertex_texcoords) != 0 || dr::width(m_compact_texcoords) != 0;
+    }
 
     /// Does this mesh have additional mesh attributes?
     bool has_mesh_attributes() const { return m_mesh_attributes.size() > 0; }
@@ -201,6 +258,25 @@ public:
     /// Does this shape have flipped normals?
     bool has_flipped_normals() const override { return m_flip_normals; }
 
+    /**
+     * \brief Does this mesh store its data in compact form?
+     *
+     * When the \c compact property is set, \ref initialize() encodes vertex
+     * normals using 2 x 16 bits (octahedral mapping) and texture coordinates
+     * using half precision. When the mesh is intersected through the
+     * accessors of this class (i.e. by the kd-tree of scalar variants built
+     * without Embree), vertex positions are furthermore quantized to
+     * \c compact_position_bits (16 or 21) bits per component relative to the
+     * bounding box, and the faces of meshes with less than 65536 vertices use
+     * 16-bit indices.
+     *
+     * Decoding happens in the accessors (\ref vertex_position(), \ref
+     * vertex_normal(), etc.). Compact storage is only available in scalar
+     * variants and the compact data cannot be modified through \ref
+     * traverse().
+     */
+    bool compact() const { return m_compact; }
+
     /// @}
     // =========================================================================
 
@@ -220,6 +296,33 @@ public:
      */
     void write_ply(Stream *stream) const;
 
+    /**
+     * Write the mesh to a native binary mesh file (<tt>.mmesh</tt>)
+     *
+     * In addition to the geometry, the file stores the bounding box and the
+     * area of each face. The \c mmesh shape plugin memory-maps such files, so
+     * that uncompressed buffers are used without any parsing or copying.
+     *
+     * \param filename
+     *    Target file path on disk
+     *
+     * \param compress
+     *    Compress the buffers in independent chunks. This reduces the size of
+     *    the file, but the buffers must then be decompressed when loading it.
+     */
+    void write_mmesh(const std::string &filename, bool compress = false) const;
+
+    /**
+     * Write the mesh encoded in the native binary mesh format to a stream
+     *
+     * \param stream
+     *    Target stream that will receive the encoded output
+     *
+     * \param compress
+     *    Compress the buffers in independent chunks
+     */
+    void write_mmesh(Stream *stream, bool compress = false) const;
+
     /// Merge two meshes into one
     ref<Mesh> merge(const Mesh *other) const;
 
@@ -238,6 +341,21 @@ public:
      */
     void build_directed_edges();
 
+    /**
+     * \brief Sample faces proportionally to their emitted power
+     *
+     * When enabled, and the mesh has an emitter, position sampling selects
+     * each face with a probability proportional to its area times its average
+     * emitted radiance, which is estimated once when the sampling tables are
+     * built. Positions within the chosen face remain uniform. \ref
+     * pdf_position() then requires the \c prim_index field of the position
+     * sample.
+     */
+    void set_radiance_sampling(bool value);
+
+    /// Are faces sampled proportionally to their emitted power?
+    bool radiance_sampling() const { return m_radiance_sampling; }
+
     // =============================================================
     //! @{ \name Shape interface implementation
     // =============================================================
@@ -259,6 +377,23 @@ public:
 
     Float pdf_position(const PositionSample3f &ps, Mask active = true) const override;
 
+    /**
+     * \brief Sample a direction towards the mesh
+     *
+     * When the \c solid_angle_sampling property is set, this first selects a
+     * face as in \ref sample_position(). If the face subtends a solid angle
+     * larger than \c solid_angle_threshold, a direction is then sampled
+     * uniformly within its spherical triangle (Arvo 1995). Otherwise, and by
+     * default, a position is sampled uniformly on the face and the density
+     * is converted to solid angle.
+     */
+    DirectionSample3f sample_direction(const Interaction3f &it,
+                                       const Point2f &sample,
+                                       Mask active = true) const override;
+
+    Float pdf_direction(const Interaction3f &it, const DirectionSample3f &ds,
+                        Mask active = true) const override;
+
     Point3f barycentric_coordinates(const SurfaceInteraction3f &si,
                                     Mask active = true) const;
 
@@ -431,6 +566,68 @@ protected:
      */
     void build_pmf();
 
+    /**
+     * \brief Build the table for sampling faces proportionally to their
+     * emitted power (see \ref set_radiance_sampling())
+     *
+     * Requires \c m_area_pmf and must be called with \c m_mutex held.
+     */
+    void build_radiance_pmf();
+
+    /**
+     * \brief Encode the buffers of the mesh in compact form and release the
+     * single precision versions (see \ref compact())
+     */
+    void compact_buffers();
+
+    /// Return an equivalent mesh that stores its data in single precision
+    ref<Mesh> expanded() const;
+
+    /// Return the \c i-th entry of a buffer of 16-bit values packed in pairs
+    template <typename UInt32_>
+    MI_INLINE static UInt32_ gather_u16(const DynamicBuffer<UInt32> &buf,
+                                        const UInt32_ &i,
+                                        dr::mask_t<UInt32_> active) {
+        UInt32_ w = dr::gather<UInt32_>(buf, i >> 1, active);
+        return (w >> ((i & 1u) << 4)) & 0xFFFFu;
+    }
+
+    /// Decode a unit vector stored using the octahedral mapping (2 x 16 bits)
+    template <typename UInt32_>
+    MI_INLINE static auto octahedral_to_normal(const UInt32_ &w) {
+        using Value = dr::float32_array_t<UInt32_>;
+        Value x = dr::fmadd(Value(w & 0xFFFFu), 1.f / 32767.f, -1.f),
+              y = dr::fmadd(Value(w >> 16), 1.f / 32767.f, -1.f),
+              z = 1.f - dr::abs(x) - dr::abs(y),
+              t = dr::maximum(-z, 0.f);
+        x -= dr::copysign(t, x);
+        y -= dr::copysign(t, y);
+        return dr::normalize(Normal<Value, 3>(x, y, z));
+    }
+
+    /// Convert the bit pattern of a half precision value to single precision
+    template <typename UInt32_>
+    MI_INLINE static auto half_to_float(const UInt32_ &h) {
+        using Value = dr::float32_array_t<UInt32_>;
+        UInt32_ exponent = (h >> 10) & 0x1Fu, mantissa = h & 0x3FFu;
+        Value value = dr::select(
+            exponent == 0u, Value(mantissa) * 5.9604645e-8f, // 2^-24
+            dr::reinterpret_array<Value>(((exponent + 112u) << 23) |
+                                         (mantissa << 13)));
+        return dr::select((h & 0x8000u) != 0u, -value, value);
+    }
+
+    /// Return a position sample at barycentric coordinates \c b of a face
+    PositionSample3f position_on_face(const UInt32 &face, const Point2f &b,
+                                      Mask active = true) const;
+
+    /// Density of position samples on a face when \c m_radiance_pmf is used
+    Float radiance_pdf(const UInt32 &face, Mask active = true) const;
+
+    /// Solid angle subtended by a face as seen from \c p
+    Float face_solid_angle(const UInt32 &face, const Point3f &p,
+                           Mask active = true) const;
+
     /**
      * \brief Precompute the set of edges that could contribute to the indirect
      * discontinuous integral.
@@ -580,6 +777,22 @@ protected:
 
     mutable DynamicBuffer<UInt32> m_faces;
 
+    /// Compact storage requested through the \c compact property
+    bool m_compact = false;
+    uint32_t m_compact_position_bits = 21;
+    /// Quantization of the vertex positions (0: single precision, 16 or 21 bits)
+    uint32_t m_position_bits = 0;
+    /// Is \c m_compact_faces used instead of \c m_faces?
+    bool m_short_indices = false;
+    /// Decoded position = quantized position * scale + offset
+    ScalarVector3f m_position_scale;
+    ScalarPoint3f m_position_offset;
+    /// Packed buffers used in place of the above when the mesh is compact
+    DynamicBuffer<UInt32> m_compact_positions;
+    DynamicBuffer<UInt32> m_compact_normals;
+    DynamicBuffer<UInt32> m_compact_texcoords;
+    DynamicBuffer<UInt32> m_compact_faces;
+
     /// Directed edges data structures to support neighbor queries
     mutable DynamicBuffer<UInt32> m_E2E;
     bool m_E2E_outdated = true;
@@ -604,10 +817,18 @@ protected:
     /// Flag that can be set by the user to disable loading/computation of vertex normals
     bool m_face_normals = false;
     bool m_flip_normals = false;
+    /// Sample faces using an alias table instead of a CDF
+    bool m_alias_sampling = false;
+    /// Sample directions uniformly within faces that subtend a large solid angle
+    bool m_solid_angle_sampling = false;
+    ScalarFloat m_solid_angle_threshold = 1e-3f;
 
     /* Surface area distribution -- generated on demand when \ref
        prepare_area_pmf() is first called. */
     DiscreteDistribution<Float> m_area_pmf;
+    /// Distribution of faces wrt. their emitted power (optional)
+    DiscreteDistribution<Float> m_radiance_pmf;
+    bool m_radiance_sampling = false;
     std::mutex m_mutex;
 
     /// Optional: used in eval_parameterization()
@@ -616,9 +837,13 @@ protected:
     /// Pointer to the scene that owns this mesh
     Scene<Float, Spectrum>* m_scene = nullptr;
 
+    /// Reports the size of the vertex and face buffers
+    MemoryTracker m_memory { MemoryCategory::Geometry };
+
     MI_DECLARE_TRAVERSE_CB(m_vertex_positions, m_vertex_normals,
                            m_vertex_texcoords, m_faces, m_E2E, m_sil_dedge_pmf,
-                           m_mesh_attributes, m_area_pmf, m_parameterization)
+                           m_mesh_attributes, m_area_pmf, m_radiance_pmf,
+                           m_parameterization)
 };
 
 MI_EXTERN_CLASS(Mesh)
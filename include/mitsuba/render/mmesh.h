@@ -0,0 +1,115 @@
+#pragma once
+
+#include <mitsuba/core/fwd.h>
+#include <cstdint>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Layout of the native binary mesh container (<tt>.mmesh</tt>)
+ *
+ * A file starts with a \ref MeshFileHeader, which is directly followed by
+ * one \ref MeshFileSection per stored buffer (vertex positions, normals,
+ * texture coordinates, faces, face areas and mesh attributes). All values
+ * are stored in little endian byte order.
+ *
+ * Every section starts at a multiple of \ref MeshFileAlignment bytes and is
+ * followed by at least 16 bytes of padding, so that uncompressed sections can
+ * be used in place once the file is mapped into memory. Compressed sections
+ * are split into chunks of \c chunk_size bytes that are compressed
+ * independently (as zlib streams, see \ref ZStream) and can hence be decoded
+ * in parallel. Their payload starts
+ * with a table of <tt>chunk_count + 1</tt> \c uint64_t offsets (relative to
+ * the start of the section) that delimit the compressed chunks.
+ *
+ * Files are written by \ref Mesh::write_mmesh() and read by the \c mmesh
+ * shape plugin.
+ */
+
+/// Identifier at the start of every file
+constexpr char MeshFileMagic[8] = { 'M', 'I', '_', 'M', 'E', 'S', 'H', '\0' };
+
+/// Current version of the container format
+constexpr uint32_t MeshFileVersion = 1;
+
+/// Alignment (in bytes) of the sections within the file
+constexpr uint64_t MeshFileAlignment = 64;
+
+/// Uncompressed size (in bytes) of the chunks of a compressed section
+constexpr uint32_t MeshFileChunkSize = 4 * 1024 * 1024;
+
+enum class MeshFileFlags : uint32_t {
+    None               = 0x0,
+    /// The file contains per-vertex normals
+    HasVertexNormals   = 0x1,
+    /// The file contains per-vertex texture coordinates
+    HasVertexTexcoords = 0x2,
+    /// The mesh was rendered using face normals when it was written
+    FaceNormals        = 0x4,
+    /** Color attributes contain spectral upsampling model coefficients
+        (i.e. the file was written from a spectral variant) */
+    SpectralColors     = 0x8
+};
+
+MI_DECLARE_ENUM_OPERATORS(MeshFileFlags)
+
+enum class MeshFileSectionType : uint32_t {
+    VertexPositions = 0,
+    VertexNormals   = 1,
+    VertexTexcoords = 2,
+    Faces           = 3,
+    /// Surface area of each face
+    FaceAreas       = 4,
+    VertexAttribute = 5,
+    FaceAttribute   = 6
+};
+
+enum class MeshFileCompression : uint32_t {
+    None    = 0,
+    /// Chunks compressed as zlib streams (DEFLATE with zlib header and checksum)
+    Deflate = 1
+};
+
+struct MeshFileHeader {
+    /// Must be equal to \ref MeshFileMagic
+    char magic[8];
+    /// Must be equal to \ref MeshFileVersion
+    uint32_t version;
+    /// Combination of \ref MeshFileFlags
+    uint32_t flags;
+    uint64_t vertex_count;
+    uint64_t face_count;
+    /// Bounding box of the vertex positions
+    float bbox_min[3];
+    float bbox_max[3];
+    /// Number of \ref MeshFileSection entries following the header
+    uint32_t section_count;
+    uint32_t reserved;
+    /// Null-terminated name of the shape
+    char name[64];
+};
+
+struct MeshFileSection {
+    /// Null-terminated name of the buffer (e.g. "vertex_color" for attributes)
+    char name[48];
+    /// Type of the stored buffer
+    MeshFileSectionType type;
+    /// Number of values per vertex or face
+    uint32_t components;
+    /// Compression of the section
+    MeshFileCompression compression;
+    /// Size of the uncompressed chunks (compressed sections only)
+    uint32_t chunk_size;
+    /// Offset of the section from the start of the file
+    uint64_t offset;
+    /// Number of bytes occupied by the section in the file
+    uint64_t stored_size;
+    /// Number of bytes of the uncompressed buffer
+    uint64_t size;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(MeshFileHeader) == 128 && sizeof(MeshFileSection) == 96,
+              "Unexpected size of the mesh file structures!");
+
+NAMESPACE_END(mitsuba)
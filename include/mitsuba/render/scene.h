@@ -795,6 +795,7 @@ protected:
     MI_INLINE Mask ray_test_gpu(const Ray3f &ray, Mask active) const;
 
     using ShapeKDTree = mitsuba::ShapeKDTree<Float, Spectrum>;
+    using ShapeBVH    = mitsuba::ShapeBVH<Float, Spectrum>;
 
     /// Updates the discrete distribution used to select an emitter
     void update_emitter_sampling_distribution();
@@ -833,6 +834,8 @@ protected:
 
     bool m_shapes_grad_enabled;
     bool m_thread_reordering;
+    /// Sample emitters using an alias table instead of a CDF
+    bool m_alias_sampling = false;
 
     /**
      * When the scene is defined on the CPU, traversal of the acceleration
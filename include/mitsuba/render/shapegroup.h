@@ -51,6 +51,19 @@ public:
     /// Returns a union of ShapeType flags denoting what is present in the ShapeGroup
     uint32_t shape_types() const { return m_shape_types; }
 
+    /// Return the shapes contained in this group
+    const std::vector<ref<Base>> &shapes() const { return m_shapes; }
+
+#if !defined(MI_ENABLE_EMBREE)
+    /**
+     * \brief Return the kd-tree built over the shapes of this group
+     *
+     * Instances use this to traverse the group's acceleration data structure
+     * directly, bypassing a virtual call per bottom-level query.
+     */
+    const ShapeKDTree *kdtree() const { return m_kdtree.get(); }
+#endif
+
     void traverse(TraversalCallback *callback) override;
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
     bool parameters_grad_enabled() const override;
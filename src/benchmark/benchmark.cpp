@@ -0,0 +1,329 @@
+#include <mitsuba/core/argparser.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/jit.h>
+#include <mitsuba/core/json.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/struct.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/scene.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "benchmark.h"
+
+using namespace mitsuba;
+
+static void help() {
+    std::cout << util::info_copyright() << std::endl;
+    std::cout << R"(
+Usage: mitsuba-bench [options]
+
+Times the sampling, warping, BSDF, image block, struct conversion and ray
+intersection kernels of Mitsuba. All inputs are generated from a fixed seed,
+so that the results of different runs (e.g. before and after a change) can be
+compared.
+
+Options:
+
+    -h, --help
+        Display this help text.
+
+    -m <variants>, --mode <variants>
+        Comma-separated list of the variants to benchmark.
+
+        Default: )" MI_DEFAULT_VARIANT R"(
+
+        Available:
+              )" << string::indent(MI_VARIANTS, 14) << R"(
+    -l, --list
+        List the available benchmarks and exit.
+
+    -f <text>, --filter <text>
+        Only run the benchmarks whose name contains "text"
+        (e.g. "bsdf/" or "warp/square_to_beckmann").
+
+    -t <count>, --threads <count>
+        Number of threads used by the LLVM backend.
+
+    -r <count>, --repetitions <count>
+        Number of timed repetitions of each benchmark (default: 5). The
+        median is reported.
+
+    --min-time <seconds>
+        Minimum duration of each repetition (default: 0.1).
+
+    --seed <value>
+        Seed of the random inputs (default: 0).
+
+    -o <filename>, --output <filename>
+        Write the results to a JSON file.
+
+    --baseline <filename>
+        Compare the results against a JSON file written by an earlier run
+        with -o, and exit with status 1 if a benchmark became slower by
+        more than the tolerance.
+
+    --tolerance <fraction>
+        Relative slowdown that is still accepted by --baseline
+        (default: 0.1, i.e. 10%).
+
+Benchmarks of JIT (CUDA/LLVM) variants process 2^20 items per kernel launch.
+Their timings include the time needed to trace and launch each kernel.
+)";
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_initialization() {
+    Scene<Float, Spectrum>::static_accel_initialization();
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_shutdown() {
+    Scene<Float, Spectrum>::static_accel_shutdown();
+}
+
+/// Measurements of one benchmark
+struct BenchmarkResult {
+    std::string variant, name;
+    /// Time per item of each repetition, in nanoseconds
+    std::vector<double> ns_per_item;
+
+    double median() const {
+        std::vector<double> values = ns_per_item;
+        std::sort(values.begin(), values.end());
+        size_t n = values.size();
+        return n % 2 == 1 ? values[n / 2]
+                          : .5 * (values[n / 2 - 1] + values[n / 2]);
+    }
+};
+
+/// Time \c count calls of \c benchmark.run, in seconds
+static double time_benchmark(const Benchmark &benchmark, size_t count) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        benchmark.run();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static BenchmarkResult run_benchmark(const std::string &variant,
+                                     const Benchmark &benchmark,
+                                     double min_time, size_t repetitions) {
+    // Warm up (this also compiles the kernels of JIT variants)
+    benchmark.run();
+
+    // Number of calls needed to reach the minimum time per repetition
+    double time = std::max(time_benchmark(benchmark, 1), 1e-9);
+    size_t count = (size_t) std::max(1.0, std::ceil(min_time / time));
+
+    BenchmarkResult result{ variant, benchmark.name, { } };
+    for (size_t i = 0; i < repetitions; ++i) {
+        time = time_benchmark(benchmark, count);
+        result.ns_per_item.push_back(time * 1e9 / double(count * benchmark.items));
+    }
+    return result;
+}
+
+static std::string results_to_json(const std::vector<BenchmarkResult> &results,
+                                   uint32_t seed) {
+    std::ostringstream oss;
+    oss << "{\"seed\": " << seed << ", \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult &r = results[i];
+        double median = r.median();
+        oss << (i > 0 ? "," : "") << std::endl
+            << "  {\"variant\": " << json_string(r.variant)
+            << ", \"name\": " << json_string(r.name)
+            << tfm::format(", \"ns_per_item\": %.4f", median)
+            << tfm::format(", \"items_per_second\": %.6g", 1e9 / median)
+            << ", \"repetitions\": [";
+        for (size_t j = 0; j < r.ns_per_item.size(); ++j)
+            oss << (j > 0 ? ", " : "") << tfm::format("%.4f", r.ns_per_item[j]);
+        oss << "]}";
+    }
+    oss << std::endl << "]}";
+    return oss.str();
+}
+
+/// Returns the number of benchmarks that are slower than in the baseline
+static size_t compare_baseline(const std::vector<BenchmarkResult> &results,
+                               const fs::path &filename, double tolerance) {
+    ref<FileStream> stream = new FileStream(filename);
+    std::string text(stream->size(), '\0');
+    stream->read(text.data(), text.size());
+
+    JSONValue baseline = parse_json(text);
+    const JSONValue *entries = baseline.find("results");
+    if (!entries || !entries->is_array())
+        Throw("\"%s\" does not contain benchmark results!", filename.string());
+
+    std::map<std::pair<std::string, std::string>, double> reference;
+    for (const JSONValue &entry : entries->array)
+        reference[{ entry.get_string("variant"), entry.get_string("name") }] =
+            entry.get_number("ns_per_item");
+
+    size_t regressions = 0;
+    std::cout << std::endl << "Comparison with \"" << filename.string() << "\":" << std::endl;
+    for (const BenchmarkResult &r : results) {
+        auto it = reference.find({ r.variant, r.name });
+        if (it == reference.end() || it->second <= 0.0)
+            continue;
+        double ratio = r.median() / it->second;
+        bool regression = ratio > 1.0 + tolerance;
+        regressions += regression;
+        std::cout << tfm::format("  %-16s %-48s %+7.1f%%%s", r.variant, r.name,
+                                 (ratio - 1.0) * 100.0,
+                                 regression ? "  <-- REGRESSION" : "")
+                  << std::endl;
+    }
+    return regressions;
+}
+
+int main(int argc, char *argv[]) {
+    Jit::static_initialization();
+    Thread::static_initialization();
+    Logger::static_initialization();
+    Bitmap::static_initialization();
+
+    // Ensure that the mitsuba-render shared library is loaded
+    librender_nop();
+
+    ArgParser parser;
+    using StringVec     = std::vector<std::string>;
+    auto arg_help       = parser.add(StringVec{ "-h", "--help" });
+    auto arg_mode       = parser.add(StringVec{ "-m", "--mode" }, true);
+    auto arg_list       = parser.add(StringVec{ "-l", "--list" });
+    auto arg_filter     = parser.add(StringVec{ "-f", "--filter" }, true);
+    auto arg_threads    = parser.add(StringVec{ "-t", "--threads" }, true);
+    auto arg_reps       = parser.add(StringVec{ "-r", "--repetitions" }, true);
+    auto arg_min_time   = parser.add(StringVec{ "--min-time" }, true);
+    auto arg_seed       = parser.add(StringVec{ "--seed" }, true);
+    auto arg_output     = parser.add(StringVec{ "-o", "--output" }, true);
+    auto arg_baseline   = parser.add(StringVec{ "--baseline" }, true);
+    auto arg_tolerance  = parser.add(StringVec{ "--tolerance" }, true);
+
+    std::string error_msg;
+    std::vector<std::string> modes, initialized_modes;
+    bool cuda = false, llvm = false, regression = false;
+
+    try {
+        parser.parse(argc, argv);
+
+        if (*arg_help) {
+            help();
+            modes.clear();
+        } else {
+            modes = string::tokenize(*arg_mode ? arg_mode->as_string() : MI_DEFAULT_VARIANT, ",");
+        }
+
+        // Keep the output focused on the measurements
+        Thread::thread()->logger()->set_log_level(Warn);
+
+        uint32_t thread_count = pool_size() + 1;
+        if (*arg_threads)
+            thread_count = std::max(arg_threads->as_int(), 1);
+        pool_set_size(nullptr, thread_count - 1);
+
+        for (const std::string &mode : modes) {
+            cuda |= string::starts_with(mode, "cuda_");
+            llvm |= string::starts_with(mode, "llvm_");
+        }
+
+#if defined(MI_ENABLE_CUDA)
+        if (cuda)
+            jit_init((uint32_t) JitBackend::CUDA);
+#endif
+
+#if defined(MI_ENABLE_LLVM)
+        if (llvm)
+            jit_init((uint32_t) JitBackend::LLVM);
+#endif
+
+        color_management_static_initialization(cuda, llvm);
+
+        // Needed by the ray intersection benchmarks
+        for (const std::string &mode : modes) {
+            MI_INVOKE_VARIANT(mode, scene_static_accel_initialization);
+            initialized_modes.push_back(mode);
+        }
+
+        std::string filter = *arg_filter ? arg_filter->as_string() : "";
+        size_t repetitions = *arg_reps ? (size_t) std::max(arg_reps->as_int(), 1) : 5;
+        double min_time = *arg_min_time ? arg_min_time->as_float() : 0.1;
+        uint32_t seed = *arg_seed ? (uint32_t) arg_seed->as_int() : 0;
+
+        std::vector<BenchmarkResult> results;
+        for (const std::string &mode : modes) {
+            std::vector<Benchmark> benchmarks = create_benchmarks(mode, seed);
+            for (const Benchmark &benchmark : benchmarks) {
+                if (benchmark.name.find(filter) == std::string::npos)
+                    continue;
+
+                if (*arg_list) {
+                    std::cout << mode << " " << benchmark.name << std::endl;
+                    continue;
+                }
+
+                BenchmarkResult r = run_benchmark(mode, benchmark, min_time, repetitions);
+                double median = r.median();
+                std::cout << tfm::format("%-16s %-48s %10.2f ns/item %12.4g items/s",
+                                         mode, benchmark.name, median, 1e9 / median)
+                          << std::endl;
+                results.push_back(std::move(r));
+            }
+        }
+
+        if (*arg_output) {
+            fs::path filename = arg_output->as_string();
+            ref<FileStream> stream = new FileStream(filename, FileStream::ETruncReadWrite);
+            stream->write_line(results_to_json(results, seed));
+        }
+
+        if (*arg_baseline) {
+            double tolerance = *arg_tolerance ? arg_tolerance->as_float() : 0.1;
+            size_t regressions =
+                compare_baseline(results, arg_baseline->as_string(), tolerance);
+            if (regressions > 0) {
+                std::cout << regressions << " benchmark(s) are more than "
+                          << tolerance * 100.0 << "% slower than the baseline."
+                          << std::endl;
+                regression = true;
+            }
+        }
+    } catch (const std::exception &e) {
+        error_msg = std::string("Caught a critical exception: ") + e.what();
+    } catch (...) {
+        error_msg = std::string("Caught a critical exception of unknown type!");
+    }
+
+    if (!error_msg.empty())
+        std::cerr << std::endl << error_msg << std::endl;
+
+    for (const std::string &mode : initialized_modes)
+        MI_INVOKE_VARIANT(mode, scene_static_accel_shutdown);
+    color_management_static_shutdown();
+    Bitmap::static_shutdown();
+    StructConverter::static_shutdown();
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+    Jit::static_shutdown();
+
+#if defined(MI_ENABLE_CUDA) || defined(MI_ENABLE_LLVM)
+    if (cuda || llvm)
+        jit_shutdown();
+#endif
+
+    if (!error_msg.empty())
+        return -1;
+    return regression ? 1 : 0;
+}
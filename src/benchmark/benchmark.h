@@ -0,0 +1,32 @@
+#pragma once
+
+#include <mitsuba/core/fwd.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// A kernel that is timed by the \c mitsuba-bench executable
+struct Benchmark {
+    /// Hierarchical name of the kernel, e.g. "warp/square_to_cosine_hemisphere"
+    std::string name;
+
+    /// Number of items (samples, BSDF queries, pixels, ..) processed per call of \c run
+    size_t items;
+
+    /// Process \c items items. Waits for the kernel to finish in JIT variants.
+    std::function<void()> run;
+};
+
+/**
+ * \brief Create the benchmarks of the given variant
+ *
+ * The inputs of each kernel are generated by a random number generator
+ * initialized with \c seed, so that repeated runs (and runs on different
+ * machines) process exactly the same data.
+ */
+extern std::vector<Benchmark> create_benchmarks(const std::string &variant,
+                                                uint32_t seed);
+
+NAMESPACE_END(mitsuba)
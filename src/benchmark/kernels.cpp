@@ -0,0 +1,344 @@
+#include <mitsuba/core/config.h>
+#include <mitsuba/core/distr_1d.h>
+#include <mitsuba/core/distr_2d.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/struct.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/render/microfacet.h>
+#include <mitsuba/render/rfilter.h>
+#include <mitsuba/render/scene.h>
+#include <memory>
+
+#include "benchmark.h"
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Number of items processed per call in scalar variants
+static constexpr size_t BenchmarkScalarItems = 4096;
+
+/// Number of lanes of the kernels launched in JIT variants
+static constexpr size_t BenchmarkJitItems = 1 << 20;
+
+/// Resolution of the tabulated distributions and of the image block
+static constexpr uint32_t BenchmarkResolution = 256;
+
+NAMESPACE_BEGIN()
+
+/// Prevent the compiler from discarding the computation of \c value
+template <typename T> MI_INLINE void do_not_optimize(const T &value) {
+#if defined(_MSC_VER)
+    static volatile const void *sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+template <typename Float, typename RNG> Float next_float(RNG &rng) {
+    return Float(rng.next_float32());
+}
+
+template <typename Float, typename RNG> Point<Float, 2> next_point2(RNG &rng) {
+    Float x = next_float<Float>(rng),
+          y = next_float<Float>(rng);
+    return Point<Float, 2>(x, y);
+}
+
+/**
+ * \brief Wrap a kernel that processes one item (scalar variants) or one
+ * wavefront of items (JIT variants) per call
+ *
+ * \c func receives the random number generator that provides its inputs.
+ * Its result (if any) is consumed so that the computation cannot be
+ * optimized away. In JIT variants, the time to trace and launch the kernel
+ * is part of the measurement, amortized over the width of the wavefront.
+ */
+template <typename Float, typename Func>
+Benchmark make_benchmark(const std::string &name, uint32_t seed, Func func) {
+    using RNG = PCG32<dr::uint32_array_t<Float>>;
+    constexpr bool Jit = dr::is_jit_v<Float>;
+    constexpr size_t items = Jit ? BenchmarkJitItems : BenchmarkScalarItems;
+    using Result = decltype(func(std::declval<RNG &>()));
+
+    auto rng = std::make_shared<RNG>(Jit ? items : 1, seed);
+
+    return Benchmark{ name, items, [rng, func]() {
+        if constexpr (Jit) {
+            if constexpr (std::is_void_v<Result>)
+                func(*rng);
+            else
+                dr::schedule(func(*rng));
+            dr::schedule(rng->state);
+            dr::eval();
+            dr::sync_thread();
+        } else {
+            for (size_t i = 0; i < items; ++i) {
+                if constexpr (std::is_void_v<Result>)
+                    func(*rng);
+                else
+                    do_not_optimize(func(*rng));
+            }
+        }
+    } };
+}
+
+/// Strictly positive random values used to build the tabulated distributions
+template <typename ScalarFloat>
+std::vector<ScalarFloat> random_table(size_t size, uint32_t seed) {
+    PCG32<uint32_t> rng(1, seed);
+    std::vector<ScalarFloat> values(size);
+    for (size_t i = 0; i < size; ++i)
+        values[i] = ScalarFloat(.01f + rng.next_float32());
+    return values;
+}
+
+/// Scene containing a tessellated unit sphere with vertex normals (262K triangles)
+template <typename Float, typename Spectrum>
+ref<Scene<Float, Spectrum>> create_sphere_scene(bool compact) {
+    MI_IMPORT_TYPES(Scene, Mesh)
+    const uint32_t n_theta = 256, n_phi = 512;
+
+    Properties props;
+    props.set("compact", compact);
+    ref<Mesh> mesh = new Mesh("sphere", (n_theta + 1) * n_phi, 2 * n_theta * n_phi,
+                              props, true /* normals */, false /* texcoords */);
+
+    auto *positions = mesh->vertex_positions_buffer().data(),
+         *normals   = mesh->vertex_normals_buffer().data();
+    for (uint32_t i = 0; i <= n_theta; ++i) {
+        ScalarFloat theta = dr::Pi<ScalarFloat> * i / n_theta;
+        for (uint32_t j = 0; j < n_phi; ++j) {
+            ScalarFloat phi = dr::TwoPi<ScalarFloat> * j / n_phi;
+            auto [sin_theta, cos_theta] = dr::sincos(theta);
+            auto [sin_phi, cos_phi] = dr::sincos(phi);
+            size_t k = 3 * ((size_t) i * n_phi + j);
+            positions[k]     = normals[k]     = (float) (sin_theta * cos_phi);
+            positions[k + 1] = normals[k + 1] = (float) (sin_theta * sin_phi);
+            positions[k + 2] = normals[k + 2] = (float) cos_theta;
+        }
+    }
+
+    uint32_t *faces = mesh->faces_buffer().data();
+    for (uint32_t i = 0; i < n_theta; ++i) {
+        for (uint32_t j = 0; j < n_phi; ++j) {
+            uint32_t a = i * n_phi + j, b = i * n_phi + (j + 1) % n_phi,
+                     c = a + n_phi, d = b + n_phi;
+            uint32_t quad[6] = { a, c, b, b, c, d };
+            std::copy(quad, quad + 6, faces);
+            faces += 6;
+        }
+    }
+    mesh->initialize();
+
+    Properties scene_props("scene");
+    scene_props.set("mesh", (Object *) mesh.get());
+    return PluginManager::instance()->create_object<Scene>(scene_props);
+}
+
+template <typename Float, typename Spectrum>
+std::vector<Benchmark> create_benchmarks_impl(uint32_t seed) {
+    MI_IMPORT_TYPES(BSDF, ImageBlock, ReconstructionFilter)
+    using RNG = PCG32<UInt32>;
+
+    std::vector<Benchmark> result;
+    auto add = [&](const std::string &name, auto func) {
+        result.push_back(make_benchmark<Float>(name, seed, func));
+    };
+
+    // ----------------------------------------------------------
+    //  Warping functions
+    // ----------------------------------------------------------
+
+    add("warp/square_to_uniform_disk_concentric", [](RNG &rng) {
+        return warp::square_to_uniform_disk_concentric(next_point2<Float>(rng));
+    });
+
+    add("warp/square_to_cosine_hemisphere", [](RNG &rng) {
+        Vector3f v = warp::square_to_cosine_hemisphere(next_point2<Float>(rng));
+        return std::make_pair(v, warp::square_to_cosine_hemisphere_pdf(v));
+    });
+
+    add("warp/square_to_uniform_sphere", [](RNG &rng) {
+        Vector3f v = warp::square_to_uniform_sphere(next_point2<Float>(rng));
+        return std::make_pair(v, warp::square_to_uniform_sphere_pdf(v));
+    });
+
+    add("warp/square_to_beckmann", [](RNG &rng) {
+        Float alpha = .3f;
+        Vector3f v = warp::square_to_beckmann(next_point2<Float>(rng), alpha);
+        return std::make_pair(v, warp::square_to_beckmann_pdf(v, alpha));
+    });
+
+    add("warp/square_to_von_mises_fisher", [](RNG &rng) {
+        Float kappa = 10.f;
+        Vector3f v = warp::square_to_von_mises_fisher(next_point2<Float>(rng), kappa);
+        return std::make_pair(v, warp::square_to_von_mises_fisher_pdf(v, kappa));
+    });
+
+    // ----------------------------------------------------------
+    //  Tabulated distributions
+    // ----------------------------------------------------------
+
+    const uint32_t res = BenchmarkResolution;
+    std::vector<ScalarFloat> table = random_table<ScalarFloat>(res * res, seed);
+
+    auto discrete = std::make_shared<DiscreteDistribution<Float>>(table.data(), res);
+    add("distr/discrete_1d", [discrete](RNG &rng) {
+        return discrete->sample(next_float<Float>(rng));
+    });
+
+    auto hierarchical = std::make_shared<Hierarchical2D<Float, 0>>(
+        table.data(), ScalarVector2u(res));
+    add("distr/hierarchical_2d", [hierarchical](RNG &rng) {
+        return hierarchical->sample(next_point2<Float>(rng));
+    });
+
+    auto marginal = std::make_shared<Marginal2D<Float, 0, true>>(
+        table.data(), ScalarVector2u(res));
+    add("distr/marginal_2d", [marginal](RNG &rng) {
+        return marginal->sample(next_point2<Float>(rng));
+    });
+
+    // ----------------------------------------------------------
+    //  Microfacet distributions (visible normal sampling)
+    // ----------------------------------------------------------
+
+    for (MicrofacetType type : { MicrofacetType::Beckmann, MicrofacetType::GGX }) {
+        MicrofacetDistribution<Float, Spectrum> distr(type, .3f, true);
+        std::string name = type == MicrofacetType::GGX ? "ggx" : "beckmann";
+        add("microfacet/" + name + "/sample", [distr](RNG &rng) {
+            Vector3f wi = warp::square_to_cosine_hemisphere(next_point2<Float>(rng));
+            return distr.sample(wi, next_point2<Float>(rng));
+        });
+    }
+
+    // ----------------------------------------------------------
+    //  BSDF sampling and evaluation
+    // ----------------------------------------------------------
+
+    auto make_si = [](RNG &rng) {
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        si.n = Normal3f(0.f, 0.f, 1.f);
+        si.sh_frame = Frame3f(si.n);
+        si.uv = next_point2<Float>(rng);
+        si.wi = warp::square_to_cosine_hemisphere(next_point2<Float>(rng));
+        si.wavelengths = sample_wavelength<Float, Spectrum>(next_float<Float>(rng)).first;
+        return si;
+    };
+
+    for (const char *name : { "diffuse", "roughconductor", "roughdielectric", "principled" }) {
+        std::string plugin = name;
+        Properties props(plugin);
+        if (plugin == "roughconductor" || plugin == "roughdielectric")
+            props.set("alpha", .3f);
+        else if (plugin == "principled")
+            props.set("roughness", .3f);
+        ref<BSDF> bsdf = PluginManager::instance()->create_object<BSDF>(props);
+
+        add("bsdf/" + plugin + "/sample", [bsdf, make_si](RNG &rng) {
+            SurfaceInteraction3f si = make_si(rng);
+            Float sample1 = next_float<Float>(rng);
+            return bsdf->sample(BSDFContext(), si, sample1, next_point2<Float>(rng));
+        });
+
+        add("bsdf/" + plugin + "/eval", [bsdf, make_si](RNG &rng) {
+            SurfaceInteraction3f si = make_si(rng);
+            Vector3f wo = warp::square_to_cosine_hemisphere(next_point2<Float>(rng));
+            return bsdf->eval(BSDFContext(), si, wo);
+        });
+    }
+
+    // ----------------------------------------------------------
+    //  Splatting into image blocks
+    // ----------------------------------------------------------
+
+    for (const char *name : { "box", "tent", "gaussian", "mitchell", "catmullrom", "lanczos" }) {
+        ref<ReconstructionFilter> rfilter =
+            PluginManager::instance()->create_object<ReconstructionFilter>(Properties(name));
+        ref<ImageBlock> block = new ImageBlock(ScalarVector2u(res), ScalarPoint2i(0),
+                                               5, rfilter.get());
+
+        add(std::string("imageblock/put/") + name, [block](RNG &rng) {
+            Point2f pos = next_point2<Float>(rng) * (ScalarFloat) BenchmarkResolution;
+            Float value = next_float<Float>(rng);
+            Float values[5] = { value, value, value, 1.f, 1.f };
+            block->put(pos, values);
+        });
+    }
+
+    // ----------------------------------------------------------
+    //  Ray intersection with default and compact meshes (compact
+    //  storage is only supported by scalar variants)
+    // ----------------------------------------------------------
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        for (bool compact : { false, true }) {
+            ref<Scene<Float, Spectrum>> scene = create_sphere_scene<Float, Spectrum>(compact);
+            std::string name = compact ? "compact" : "default";
+            add("scene/ray_intersect/" + name, [scene](RNG &rng) {
+                Point3f o(warp::square_to_uniform_sphere(next_point2<Float>(rng)) * 3.f),
+                        t(warp::square_to_uniform_sphere(next_point2<Float>(rng)) * .5f);
+                return scene->ray_intersect(Ray3f(o, dr::normalize(t - o)));
+            });
+        }
+    }
+
+    // ----------------------------------------------------------
+    //  Struct conversion (host code, only timed in scalar variants)
+    // ----------------------------------------------------------
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        uint32_t in_flags = +Struct::Flags::Normalized | +Struct::Flags::Gamma;
+        ref<Struct> source = new Struct();
+        source->append("R", Struct::Type::UInt8, in_flags)
+               .append("G", Struct::Type::UInt8, in_flags)
+               .append("B", Struct::Type::UInt8, in_flags)
+               .append("A", Struct::Type::UInt8,
+                       +Struct::Flags::Normalized | +Struct::Flags::Alpha);
+
+        ref<Struct> target = new Struct();
+        target->append("R", Struct::Type::Float32)
+               .append("G", Struct::Type::Float32)
+               .append("B", Struct::Type::Float32)
+               .append("A", Struct::Type::Float32, +Struct::Flags::Alpha);
+
+        ref<StructConverter> conv = new StructConverter(source, target);
+
+        auto src = std::make_shared<std::vector<uint8_t>>(BenchmarkScalarItems * 4);
+        auto dst = std::make_shared<std::vector<float>>(BenchmarkScalarItems * 4);
+        PCG32<uint32_t> rng(1, seed);
+        for (uint8_t &value : *src)
+            value = (uint8_t) rng.next_uint32();
+
+        // Converts all pixels at once rather than calling a per-item kernel
+        result.push_back(Benchmark{
+            "struct/convert_rgba8_srgb_to_float32", BenchmarkScalarItems,
+            [conv, src, dst]() {
+                if (!conv->convert(BenchmarkScalarItems, src->data(), dst->data()))
+                    Throw("StructConverter::convert() failed!");
+                do_not_optimize(dst->data()[0]);
+            } });
+    }
+
+    return result;
+}
+
+NAMESPACE_END()
+
+std::vector<Benchmark> create_benchmarks(const std::string &variant, uint32_t seed) {
+    return MI_INVOKE_VARIANT(variant, create_benchmarks_impl, seed);
+}
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,96 @@
+#include <mitsuba/core/asset.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/util.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+struct AssetEntry {
+    /// Held while the entry is being created
+    std::mutex mutex;
+    std::weak_ptr<const void> value;
+    /// Size of the data in bytes
+    size_t size = 0;
+};
+
+/// Global registry of shared assets, indexed by their key
+static std::mutex asset_mutex;
+static std::unordered_map<std::string, std::shared_ptr<AssetEntry>> asset_entries;
+static size_t asset_prune_threshold = 64;
+static std::atomic<size_t> asset_hits { 0 };
+static std::atomic<size_t> asset_deduplicated_bytes { 0 };
+static std::atomic<bool> asset_enabled { true };
+
+std::shared_ptr<const void> AssetRegistry::get_impl(const std::string &key,
+                                                    const Factory &create) {
+    size_t size = 0;
+    if (!asset_enabled)
+        return create(size);
+
+    std::shared_ptr<AssetEntry> entry;
+    {
+        std::lock_guard<std::mutex> guard(asset_mutex);
+        std::shared_ptr<AssetEntry> &slot = asset_entries[key];
+        if (!slot) {
+            /* Periodically drop entries that expired and that nobody is
+               about to fill */
+            if (asset_entries.size() > asset_prune_threshold) {
+                for (auto it = asset_entries.begin(); it != asset_entries.end(); ) {
+                    if (it->second && it->second.use_count() == 1 &&
+                        it->second->value.expired())
+                        it = asset_entries.erase(it);
+                    else
+                        ++it;
+                }
+                asset_prune_threshold = std::max((size_t) 64, 2 * asset_entries.size());
+            }
+            slot = std::make_shared<AssetEntry>();
+        }
+        entry = slot;
+    }
+
+    // Concurrent requests for the same key wait until the first one is done
+    std::lock_guard<std::mutex> guard(entry->mutex);
+    std::shared_ptr<const void> value = entry->value.lock();
+    if (value) {
+        asset_hits++;
+        asset_deduplicated_bytes += entry->size;
+        Log(Debug, "Sharing \"%s\" (%s)", key, util::mem_string(entry->size));
+        return value;
+    }
+
+    value = create(size);
+    entry->value = value;
+    entry->size = size;
+    return value;
+}
+
+std::string AssetRegistry::file_key(const fs::path &path) {
+    // Missing files are reported by the plugin that tries to load them
+    if (!fs::is_regular_file(path))
+        return path.string();
+    return tfm::format("%s:mtime=%lld:size=%zu", path.string(),
+                       (long long) fs::last_write_time(path), fs::file_size(path));
+}
+
+size_t AssetRegistry::entry_count() {
+    std::lock_guard<std::mutex> guard(asset_mutex);
+    size_t count = 0;
+    for (const auto &kv : asset_entries)
+        count += (kv.second && !kv.second->value.expired()) ? 1 : 0;
+    return count;
+}
+
+size_t AssetRegistry::hit_count() { return asset_hits; }
+
+size_t AssetRegistry::deduplicated_bytes() { return asset_deduplicated_bytes; }
+
+void AssetRegistry::set_enabled(bool value) { asset_enabled = value; }
+
+bool AssetRegistry::enabled() { return asset_enabled; }
+
+NAMESPACE_END(mitsuba)
@@ -7,6 +7,7 @@
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/trace.h>
 #include <unordered_map>
 #include <algorithm>
 #include <atomic>
@@ -118,6 +119,7 @@ Bitmap::Bitmap(Stream *stream, FileFormat format) {
 }
 
 Bitmap::Bitmap(const fs::path &filename, FileFormat format) {
+    ScopedTraceEvent trace_event("File I/O", "Load image", filename);
     ref<FileStream> fs = new FileStream(filename);
     read(fs, format);
 }
@@ -0,0 +1,228 @@
+#include <mitsuba/core/json.h>
+
+#include <mitsuba/core/logger.h>
+#include <cstdlib>
+#include <cstring>
+
+NAMESPACE_BEGIN(mitsuba)
+
+NAMESPACE_BEGIN()
+
+struct JSONParser {
+    std::string_view text;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const char *msg) const {
+        Throw("JSON parse error at offset %zu: %s", pos, msg);
+    }
+
+    void skip_whitespace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' ||
+                                     text[pos] == '\n' || text[pos] == '\r'))
+            pos++;
+    }
+
+    bool consume(char c) {
+        skip_whitespace();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c))
+            fail(tfm::format("expected '%c'", c).c_str());
+    }
+
+    bool consume_literal(std::string_view literal) {
+        if (text.substr(pos, literal.size()) == literal) {
+            pos += literal.size();
+            return true;
+        }
+        return false;
+    }
+
+    std::string parse_string() {
+        expect('"');
+        std::string result;
+        while (true) {
+            if (pos >= text.size())
+                fail("unterminated string");
+            char c = text[pos++];
+            if (c == '"')
+                break;
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (pos >= text.size())
+                fail("unterminated escape sequence");
+            c = text[pos++];
+            switch (c) {
+                case '"': result += '"'; break;
+                case '\\': result += '\\'; break;
+                case '/': result += '/'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'n': result += '\n'; break;
+                case 'r': result += '\r'; break;
+                case 't': result += '\t'; break;
+                case 'u': {
+                        if (pos + 4 > text.size())
+                            fail("invalid unicode escape");
+                        uint32_t cp = (uint32_t) std::strtoul(
+                            std::string(text.substr(pos, 4)).c_str(), nullptr, 16);
+                        pos += 4;
+                        // Encode as UTF-8 (surrogate pairs are not combined)
+                        if (cp < 0x80) {
+                            result += (char) cp;
+                        } else if (cp < 0x800) {
+                            result += (char) (0xC0 | (cp >> 6));
+                            result += (char) (0x80 | (cp & 0x3F));
+                        } else {
+                            result += (char) (0xE0 | (cp >> 12));
+                            result += (char) (0x80 | ((cp >> 6) & 0x3F));
+                            result += (char) (0x80 | (cp & 0x3F));
+                        }
+                    }
+                    break;
+                default:
+                    fail("invalid escape sequence");
+            }
+        }
+        return result;
+    }
+
+    JSONValue parse_value() {
+        skip_whitespace();
+        if (pos >= text.size())
+            fail("unexpected end of input");
+
+        JSONValue value;
+        char c = text[pos];
+        if (c == '{') {
+            pos++;
+            value.type = JSONValue::Type::Object;
+            if (consume('}'))
+                return value;
+            do {
+                skip_whitespace();
+                std::string key = parse_string();
+                expect(':');
+                value.object.emplace_back(std::move(key), parse_value());
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            pos++;
+            value.type = JSONValue::Type::Array;
+            if (consume(']'))
+                return value;
+            do {
+                value.array.push_back(parse_value());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            value.type = JSONValue::Type::String;
+            value.string = parse_string();
+        } else if (consume_literal("true")) {
+            value.type = JSONValue::Type::Bool;
+            value.boolean = true;
+        } else if (consume_literal("false")) {
+            value.type = JSONValue::Type::Bool;
+        } else if (consume_literal("null")) {
+            value.type = JSONValue::Type::Null;
+        } else {
+            std::string number(text.substr(pos, 64));
+            char *end = nullptr;
+            value.type = JSONValue::Type::Number;
+            value.number = std::strtod(number.c_str(), &end);
+            if (end == number.c_str())
+                fail("invalid value");
+            pos += (size_t) (end - number.c_str());
+        }
+        return value;
+    }
+};
+
+NAMESPACE_END()
+
+const JSONValue *JSONValue::find(std::string_view key) const {
+    for (const auto &[k, v] : object) {
+        if (k == key)
+            return &v;
+    }
+    return nullptr;
+}
+
+std::string JSONValue::get_string(std::string_view key, std::string_view def) const {
+    const JSONValue *v = find(key);
+    if (!v)
+        return std::string(def);
+    if (!v->is_string())
+        Throw("JSON member \"%s\" must be a string", key);
+    return v->string;
+}
+
+double JSONValue::get_number(std::string_view key, double def) const {
+    const JSONValue *v = find(key);
+    if (!v)
+        return def;
+    if (!v->is_number())
+        Throw("JSON member \"%s\" must be a number", key);
+    return v->number;
+}
+
+std::string JSONValue::to_string() const {
+    switch (type) {
+        case Type::Null: return "null";
+        case Type::Bool: return boolean ? "true" : "false";
+        case Type::Number: return tfm::format("%.17g", number);
+        case Type::String: return json_string(string);
+        case Type::Array: {
+                std::string result = "[";
+                for (size_t i = 0; i < array.size(); ++i)
+                    result += (i > 0 ? "," : "") + array[i].to_string();
+                return result + "]";
+            }
+        case Type::Object: {
+                std::string result = "{";
+                for (size_t i = 0; i < object.size(); ++i)
+                    result += (i > 0 ? "," : "") + json_string(object[i].first) +
+                              ":" + object[i].second.to_string();
+                return result + "}";
+            }
+    }
+    return "null";
+}
+
+JSONValue parse_json(std::string_view text) {
+    JSONParser parser{ text };
+    JSONValue value = parser.parse_value();
+    parser.skip_whitespace();
+    if (parser.pos != text.size())
+        parser.fail("trailing characters");
+    return value;
+}
+
+std::string json_string(std::string_view value) {
+    std::string result = "\"";
+    for (char c : value) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\r': result += "\\r"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20)
+                    result += tfm::format("\\u%04x", (int) c);
+                else
+                    result += c;
+        }
+    }
+    return result + "\"";
+}
+
+NAMESPACE_END(mitsuba)
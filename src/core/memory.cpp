@@ -0,0 +1,149 @@
+#include <mitsuba/core/memory.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/util.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Number of objects listed by MemoryUsage::report()
+static constexpr size_t MemoryReportLargestObjects = 5;
+
+NAMESPACE_BEGIN()
+
+struct MemoryRegistry {
+    std::mutex mutex;
+    std::unordered_set<const MemoryTracker *> trackers;
+    size_t bytes[(uint32_t) MemoryCategory::CategoryCount] { };
+    size_t total = 0;
+    std::atomic<size_t> budget { 0 };
+};
+
+/// Constructed on first use, since trackers can be created during static initialization
+MemoryRegistry &registry() {
+    static MemoryRegistry *registry = new MemoryRegistry();
+    return *registry;
+}
+
+NAMESPACE_END()
+
+MemoryTracker::MemoryTracker(MemoryCategory category) : m_category(category) {
+    MemoryRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    r.trackers.insert(this);
+}
+
+MemoryTracker::~MemoryTracker() {
+    set(0);
+    MemoryRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    r.trackers.erase(this);
+}
+
+void MemoryTracker::set(size_t bytes, const std::string &name) {
+    MemoryRegistry &r = registry();
+    size_t budget = r.budget.load(std::memory_order_relaxed),
+           total_before, total_after;
+
+    /* locked */ {
+        std::lock_guard<std::mutex> guard(r.mutex);
+        total_before = r.total;
+        r.bytes[(uint32_t) m_category] += bytes - m_bytes;
+        r.total += bytes - m_bytes;
+        total_after = r.total;
+        m_bytes = bytes;
+        if (!name.empty())
+            m_name = name;
+    }
+
+    if (budget > 0 && total_before <= budget && total_after > budget)
+        Log(Warn, "Memory usage exceeds the budget of %s!\n%s",
+            util::mem_string(budget), MemoryUsage::report());
+}
+
+size_t MemoryUsage::bytes(MemoryCategory category) {
+    MemoryRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    return r.bytes[(uint32_t) category];
+}
+
+size_t MemoryUsage::total() {
+    MemoryRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    return r.total;
+}
+
+void MemoryUsage::set_budget(size_t bytes) {
+    registry().budget.store(bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryUsage::budget() {
+    return registry().budget.load(std::memory_order_relaxed);
+}
+
+std::string MemoryUsage::report() {
+    MemoryRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+
+    std::ostringstream oss;
+    oss << "Memory usage: " << util::mem_string(r.total);
+    size_t budget = r.budget.load(std::memory_order_relaxed);
+    if (budget > 0)
+        oss << " (budget: " << util::mem_string(budget) << ")";
+    oss << std::endl;
+
+    size_t counts[(uint32_t) MemoryCategory::CategoryCount] { };
+    std::vector<const MemoryTracker *> largest;
+    for (const MemoryTracker *t : r.trackers) {
+        if (t->bytes() == 0)
+            continue;
+        counts[(uint32_t) t->category()]++;
+        largest.push_back(t);
+    }
+
+    for (uint32_t i = 0; i < (uint32_t) MemoryCategory::CategoryCount; ++i) {
+        if (r.bytes[i] == 0)
+            continue;
+        std::ostringstream name;
+        name << (MemoryCategory) i;
+        oss << tfm::format("  %-14s %10s (%zu object%s)", name.str() + ":",
+                           util::mem_string(r.bytes[i]), counts[i],
+                           counts[i] == 1 ? "" : "s") << std::endl;
+    }
+
+    size_t count = std::min(largest.size(), MemoryReportLargestObjects);
+    std::partial_sort(largest.begin(), largest.begin() + count, largest.end(),
+                      [](const MemoryTracker *a, const MemoryTracker *b) {
+                          return a->bytes() > b->bytes();
+                      });
+
+    if (count > 0)
+        oss << "  Largest objects:" << std::endl;
+    for (size_t i = 0; i < count; ++i) {
+        const MemoryTracker *t = largest[i];
+        oss << "    " << util::mem_string(t->bytes()) << " -- "
+            << (t->name().empty() ? "<unnamed>" : "\"" + t->name() + "\"")
+            << " (" << t->category() << ")" << std::endl;
+    }
+
+    return oss.str();
+}
+
+std::ostream &operator<<(std::ostream &os, MemoryCategory value) {
+    switch (value) {
+        case MemoryCategory::Geometry:     os << "Geometry"; break;
+        case MemoryCategory::Textures:     os << "Textures"; break;
+        case MemoryCategory::Volumes:      os << "Volumes"; break;
+        case MemoryCategory::Emitters:     os << "Emitters"; break;
+        case MemoryCategory::Acceleration: os << "Acceleration"; break;
+        case MemoryCategory::Film:         os << "Film"; break;
+        default:                           os << "Invalid"; break;
+    }
+    return os;
+}
+
+NAMESPACE_END(mitsuba)
@@ -1,13 +1,18 @@
 #include <mitsuba/core/parser.h>
+#include <mitsuba/core/asset.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fstream.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/core/string.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/formatter.h>
 #include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
 #include <mitsuba/core/frame.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/mitsuba.h>
@@ -16,6 +21,7 @@
 #include <string_view>
 #include <charconv>
 #include <mutex>
+#include <thread>
 #include <tuple>
 #include <nanothread/nanothread.h>
 
@@ -1077,6 +1083,7 @@ static ParserState parse_file_impl(const ParserConfig &config,
         Throw("File not found: %s", filename.string());
 
     Log(Info, "Loading XML file \"%s\" ..", filename);
+    ScopedTraceEvent trace_event("Parser", "Parse XML file", filename);
 
     // Parse XML using pugixml
     pugi::xml_document doc;
@@ -1118,6 +1125,7 @@ static ParserState parse_file_impl(const ParserConfig &config,
 
 ParserState parse_string(const ParserConfig &config, std::string_view string, const ParameterList &param_list) {
     SortedParameters params = make_sorted_parameters(param_list);
+    ScopedTraceEvent trace_event("Parser", "Parse XML string");
 
     // Parse XML using pugixml
     pugi::xml_document doc;
@@ -1460,7 +1468,7 @@ void transform_reorder(const ParserConfig &/*config*/, ParserState &state) {
     }
 }
 
-void transform_merge_meshes(const ParserConfig &/*config*/, ParserState &state) {
+void transform_merge_meshes(const ParserConfig &config, ParserState &state) {
     if (state.empty() || state.root().type != ObjectType::Scene)
         return;
 
@@ -1478,6 +1486,8 @@ void transform_merge_meshes(const ParserConfig &/*config*/, ParserState &state)
     SceneNode merge_node;
     merge_node.type = ObjectType::Shape;
     merge_node.props.set_plugin_name("merge");
+    if (config.instance_duplicates)
+        merge_node.props.set("instance_duplicates", true);
 
     for (const auto &[name, ref_idx] : children) {
         merge_node.props.set(name, Properties::ResolvedReference(ref_idx), false);
@@ -1585,12 +1595,22 @@ void transform_relocate(const ParserConfig &/*config*/, ParserState &state,
 }
 
 void transform_all(const ParserConfig &config, ParserState &state) {
-    transform_upgrade(config, state);
-    transform_resolve(config, state);
-    if (config.merge_equivalent)
+    /* scoped */ {
+        ScopedTraceEvent trace_event("Parser", "Transform: upgrade");
+        transform_upgrade(config, state);
+    }
+    /* scoped */ {
+        ScopedTraceEvent trace_event("Parser", "Transform: resolve");
+        transform_resolve(config, state);
+    }
+    if (config.merge_equivalent) {
+        ScopedTraceEvent trace_event("Parser", "Transform: merge equivalent");
         transform_merge_equivalent(config, state);
-    if (config.merge_meshes)
+    }
+    if (config.merge_meshes) {
+        ScopedTraceEvent trace_event("Parser", "Transform: merge meshes");
         transform_merge_meshes(config, state);
+    }
 }
 
 // ===========================================================================
@@ -1681,6 +1701,8 @@ static Task* instantiate_node(const ParserConfig &config,
         SceneNode &node = state[index];
         Properties &props = node.props;
 
+        ScopedTraceEvent trace_event("Instantiate", props.plugin_name(), props.id());
+
         // Replace ResolvedReference properties with actual objects
         for (auto &key : props.filter(Properties::Type::ResolvedReference)) {
             size_t child_idx = key.get<Properties::ResolvedReference>().index();
@@ -1798,17 +1820,504 @@ static Task* instantiate_node(const ParserConfig &config,
     }
 }
 
+/// Start reading all files referenced by "filename" properties in the background
+static ref<FilePrefetcher> prefetch_files(ParserState &state) {
+    ref<FilePrefetcher> prefetcher = new FilePrefetcher();
+    const FileResolver *fr = file_resolver();
+
+    for (size_t i = 0; i < state.size(); ++i) {
+        const Properties &props = state[i].props;
+        if (!props.has_property("filename") ||
+            props.type("filename") != Properties::Type::String)
+            continue;
+
+        // These files are memory-mapped rather than read
+        if (props.plugin_name() == "mmesh")
+            continue;
+
+        // Don't interfere with the detection of unused properties
+        std::string_view filename = props.get<std::string_view>("filename");
+        props.mark_queried("filename", false);
+
+        prefetcher->prefetch(fr->resolve(filename));
+    }
+
+    if (prefetcher->file_count() > 0)
+        Log(Debug, "Prefetching %zu files (%s) ..", prefetcher->file_count(),
+            util::mem_string(prefetcher->memory_usage()));
+
+    return prefetcher;
+}
+
 std::vector<ref<Object>> instantiate(const ParserConfig &config, ParserState &state) {
     if (state.empty())
         Throw("No nodes to instantiate");
 
+    /* Overlap disk I/O and image decoding with the construction of objects.
+       Plugins pick up the prefetched data via FilePrefetcher::open() and
+       FilePrefetcher::load_bitmap(), and the prefetcher releases anything
+       left unused when going out of scope. */
+    ref<FilePrefetcher> prefetcher;
+    if (config.parallel && config.prefetch)
+        prefetcher = prefetch_files(state);
+
+    size_t asset_hits = AssetRegistry::hit_count(),
+           asset_bytes = AssetRegistry::deduplicated_bytes();
+
     std::vector<Scratch> scratch(state.size());
-    instantiate_node(config, state, scratch, 0);
+    /* scoped */ {
+        ScopedTraceEvent trace_event("Instantiate", "Instantiate scene");
+        instantiate_node(config, state, scratch, 0);
+    }
+
+    asset_hits = AssetRegistry::hit_count() - asset_hits;
+    asset_bytes = AssetRegistry::deduplicated_bytes() - asset_bytes;
+    if (asset_hits > 0)
+        Log(Info, "Shared the data of %zu texture and volume instances (%s).",
+            asset_hits, util::mem_string(asset_bytes));
 
     // Return the expanded root objects
     return scratch[0].objects;
 }
 
+// ===========================================================================
+//   Binary scene cache
+// ===========================================================================
+
+/// Identifies binary parser state files ("MSC" followed by a format version)
+static constexpr char CacheMagic[3] = { 'M', 'S', 'C' };
+static constexpr uint8_t CacheVersion = 1;
+
+static void write_matrix(Stream *stream, const ScalarMatrix4d &m) {
+    for (size_t i = 0; i < 4; ++i)
+        stream->write_array(m[i].data(), 4);
+}
+
+static void read_matrix(Stream *stream, ScalarMatrix4d &m) {
+    for (size_t i = 0; i < 4; ++i)
+        stream->read_array(m[i].data(), 4);
+}
+
+static void write_properties(Stream *stream, const Properties &props) {
+    stream->write(std::string(props.plugin_name()));
+    stream->write(std::string(props.id()));
+
+    uint32_t count = 0;
+    for (const auto &prop : props) {
+        (void) prop;
+        count++;
+    }
+    stream->write(count);
+
+    for (const auto &prop : props) {
+        Properties::Type type = prop.type();
+        stream->write(std::string(prop.name()));
+        stream->write((uint8_t) type);
+
+        switch (type) {
+            case Properties::Type::Bool:
+                stream->write((uint8_t) prop.get<bool>());
+                break;
+
+            case Properties::Type::Integer:
+                stream->write(prop.get<int64_t>());
+                break;
+
+            case Properties::Type::Float:
+                stream->write(prop.get<double>());
+                break;
+
+            case Properties::Type::String:
+                stream->write(std::string(prop.get<std::string_view>()));
+                break;
+
+            case Properties::Type::Vector: {
+                    ScalarVector3d v = prop.get<ScalarVector3d>();
+                    stream->write_array(v.data(), 3);
+                }
+                break;
+
+            case Properties::Type::Color: {
+                    ScalarColor3d c = prop.get<ScalarColor3d>();
+                    stream->write_array(c.data(), 3);
+                }
+                break;
+
+            case Properties::Type::Spectrum: {
+                    const Properties::Spectrum &s = prop.get<Properties::Spectrum>();
+                    stream->write(s.wavelengths);
+                    stream->write(s.values);
+                    stream->write((uint8_t) s.m_regular);
+                }
+                break;
+
+            case Properties::Type::Transform: {
+                    ScalarAffineTransform4d t = prop.get<ScalarAffineTransform4d>();
+                    write_matrix(stream, t.matrix);
+                    write_matrix(stream, t.inverse_transpose);
+                }
+                break;
+
+            case Properties::Type::Reference:
+                stream->write(std::string(prop.get<Properties::Reference>().id()));
+                break;
+
+            case Properties::Type::ResolvedReference:
+                stream->write((uint64_t) prop.get<Properties::ResolvedReference>().index());
+                break;
+
+            default:
+                Throw("Property \"%s\" of type \"%s\" cannot be serialized",
+                      prop.name(), property_type_name(type));
+        }
+    }
+}
+
+static void read_properties(Stream *stream, Properties &props) {
+    std::string plugin_name, id;
+    stream->read(plugin_name);
+    stream->read(id);
+    props.set_plugin_name(plugin_name);
+    if (!id.empty())
+        props.set_id(id);
+
+    uint32_t count = 0;
+    stream->read(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        uint8_t type_id = 0;
+        stream->read(name);
+        stream->read(type_id);
+
+        switch ((Properties::Type) type_id) {
+            case Properties::Type::Bool: {
+                    uint8_t value = 0;
+                    stream->read(value);
+                    props.set(name, value != 0);
+                }
+                break;
+
+            case Properties::Type::Integer: {
+                    int64_t value = 0;
+                    stream->read(value);
+                    props.set(name, value);
+                }
+                break;
+
+            case Properties::Type::Float: {
+                    double value = 0;
+                    stream->read(value);
+                    props.set(name, value);
+                }
+                break;
+
+            case Properties::Type::String: {
+                    std::string value;
+                    stream->read(value);
+                    props.set(name, std::move(value));
+                }
+                break;
+
+            case Properties::Type::Vector: {
+                    ScalarVector3d value;
+                    stream->read_array(value.data(), 3);
+                    props.set(name, value);
+                }
+                break;
+
+            case Properties::Type::Color: {
+                    ScalarColor3d value;
+                    stream->read_array(value.data(), 3);
+                    props.set(name, value);
+                }
+                break;
+
+            case Properties::Type::Spectrum: {
+                    Properties::Spectrum value;
+                    uint8_t regular = 0;
+                    stream->read(value.wavelengths);
+                    stream->read(value.values);
+                    stream->read(regular);
+                    value.m_regular = regular != 0;
+                    props.set(name, std::move(value));
+                }
+                break;
+
+            case Properties::Type::Transform: {
+                    ScalarMatrix4d matrix, inverse_transpose;
+                    read_matrix(stream, matrix);
+                    read_matrix(stream, inverse_transpose);
+                    props.set(name, ScalarAffineTransform4d(matrix, inverse_transpose));
+                }
+                break;
+
+            case Properties::Type::Reference: {
+                    std::string value;
+                    stream->read(value);
+                    props.set(name, Properties::Reference(value));
+                }
+                break;
+
+            case Properties::Type::ResolvedReference: {
+                    uint64_t value = 0;
+                    stream->read(value);
+                    props.set(name, Properties::ResolvedReference((size_t) value));
+                }
+                break;
+
+            default:
+                Throw("Invalid property type %u in binary scene description",
+                      (uint32_t) type_id);
+        }
+    }
+}
+
+void write_binary(const ParserState &state, Stream *stream) {
+    stream->write_array(CacheMagic, sizeof(CacheMagic));
+    stream->write(CacheVersion);
+
+    stream->write((uint64_t) state.nodes.size());
+    for (const SceneNode &node : state.nodes) {
+        stream->write((uint32_t) node.type);
+        stream->write(node.file_index);
+        stream->write((uint64_t) node.offset);
+        write_properties(stream, node.props);
+    }
+
+    stream->write(state.node_paths);
+
+    std::vector<std::string> files;
+    files.reserve(state.files.size());
+    for (const fs::path &file : state.files)
+        files.push_back(file.string());
+    stream->write(files);
+
+    stream->write((uint64_t) state.versions.size());
+    for (const util::Version &version : state.versions) {
+        stream->write((uint32_t) version.major_version);
+        stream->write((uint32_t) version.minor_version);
+        stream->write((uint32_t) version.patch_version);
+    }
+
+    stream->write((uint64_t) state.id_to_index.size());
+    for (const auto &[id, index] : state.id_to_index) {
+        stream->write(id);
+        stream->write((uint64_t) index);
+    }
+
+    stream->write((int32_t) state.depth);
+}
+
+ParserState read_binary(Stream *stream) {
+    char magic[sizeof(CacheMagic)];
+    uint8_t version = 0;
+    stream->read_array(magic, sizeof(CacheMagic));
+    stream->read(version);
+
+    if (!std::equal(magic, magic + sizeof(CacheMagic), CacheMagic))
+        Throw("Invalid binary scene description (unrecognized header)");
+    if (version != CacheVersion)
+        Throw("Unsupported binary scene description version %u (expected %u)",
+              (uint32_t) version, (uint32_t) CacheVersion);
+
+    ParserState state;
+
+    uint64_t node_count = 0;
+    stream->read(node_count);
+    state.nodes.resize(node_count);
+    for (SceneNode &node : state.nodes) {
+        uint32_t type = 0;
+        uint64_t offset = 0;
+        stream->read(type);
+        stream->read(node.file_index);
+        stream->read(offset);
+        node.type = (ObjectType) type;
+        node.offset = (size_t) offset;
+        read_properties(stream, node.props);
+    }
+
+    stream->read(state.node_paths);
+
+    std::vector<std::string> files;
+    stream->read(files);
+    for (const std::string &file : files)
+        state.files.emplace_back(file);
+
+    uint64_t version_count = 0;
+    stream->read(version_count);
+    for (uint64_t i = 0; i < version_count; ++i) {
+        uint32_t major = 0, minor = 0, patch = 0;
+        stream->read(major);
+        stream->read(minor);
+        stream->read(patch);
+        state.versions.emplace_back((int) major, (int) minor, (int) patch);
+    }
+
+    uint64_t id_count = 0;
+    stream->read(id_count);
+    for (uint64_t i = 0; i < id_count; ++i) {
+        std::string id;
+        uint64_t index = 0;
+        stream->read(id);
+        stream->read(index);
+        state.id_to_index.emplace(std::move(id), (size_t) index);
+    }
+
+    int32_t depth = 0;
+    stream->read(depth);
+    state.depth = depth;
+
+    return state;
+}
+
+/// Files that a cached parser state was derived from
+struct CacheDependency {
+    std::string path;
+    int64_t mtime;
+    uint64_t size;
+};
+
+/// Build the list of dependencies of a parsed file (the file and its includes)
+static std::vector<CacheDependency> cache_dependencies(const ParserState &state) {
+    std::vector<CacheDependency> result;
+    for (const fs::path &file : state.files) {
+        if (std::any_of(result.begin(), result.end(),
+                        [&](const CacheDependency &d) { return d.path == file.string(); }))
+            continue;
+        result.push_back({ file.string(), fs::last_write_time(file),
+                           (uint64_t) fs::file_size(file) });
+    }
+    return result;
+}
+
+/// Identifies everything that influences the result of parse_file_cached()
+static std::string cache_key(const ParserConfig &config,
+                             const fs::path &filename,
+                             const ParameterList &params) {
+    std::string key = tfm::format(
+        "file=%s;variant=%s;merge_equivalent=%i;merge_meshes=%i;"
+        "instance_duplicates=%i;unused_parameters=%i;max_include_depth=%i;"
+        "version=%i.%i.%i",
+        filename.string(), config.variant, (int) config.merge_equivalent,
+        (int) config.merge_meshes, (int) config.instance_duplicates,
+        (int) config.unused_parameters, config.max_include_depth,
+        MI_VERSION_MAJOR, MI_VERSION_MINOR, MI_VERSION_PATCH);
+    for (const auto &[name, value] : params)
+        key += tfm::format(";%s=%s", name, value);
+
+    // Relative paths (e.g. of included files) depend on the search paths
+    const FileResolver *fr = file_resolver();
+    for (size_t i = 0; i < fr->size(); ++i)
+        key += tfm::format(";path=%s", (*fr)[i].string());
+    return key;
+}
+
+/// Try to load a cached parser state, returns false if it is missing or stale
+static bool read_cache(const fs::path &cache_file, const std::string &key,
+                       ParserState &state) {
+    if (!fs::exists(cache_file))
+        return false;
+
+    ref<FileStream> stream = new FileStream(cache_file, FileStream::ERead);
+
+    std::string stored_key;
+    stream->read(stored_key);
+    if (stored_key != key)
+        return false;
+
+    uint32_t dep_count = 0;
+    stream->read(dep_count);
+    for (uint32_t i = 0; i < dep_count; ++i) {
+        CacheDependency dep;
+        stream->read(dep.path);
+        stream->read(dep.mtime);
+        stream->read(dep.size);
+
+        fs::path path(dep.path);
+        if (!fs::exists(path) || fs::last_write_time(path) != dep.mtime ||
+            (uint64_t) fs::file_size(path) != dep.size) {
+            Log(Debug, "Scene cache \"%s\" is out of date (\"%s\" changed)",
+                cache_file, dep.path);
+            return false;
+        }
+    }
+
+    state = read_binary(stream);
+    return true;
+}
+
+static void write_cache(const fs::path &cache_file, const std::string &key,
+                        const ParserState &state) {
+    std::vector<CacheDependency> deps = cache_dependencies(state);
+
+    // Write to a temporary file first so that concurrent readers never see
+    // a partially written cache
+    fs::path tmp_file = cache_file;
+    tmp_file.replace_extension(tfm::format(
+        ".%zx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id())));
+    {
+        ref<FileStream> stream = new FileStream(tmp_file, FileStream::ETruncReadWrite);
+        stream->write(key);
+        stream->write((uint32_t) deps.size());
+        for (const CacheDependency &dep : deps) {
+            stream->write(dep.path);
+            stream->write(dep.mtime);
+            stream->write(dep.size);
+        }
+        write_binary(state, stream);
+    }
+
+    if (!fs::rename(tmp_file, cache_file)) {
+        fs::remove(tmp_file);
+        Throw("Could not move \"%s\" to \"%s\"", tmp_file, cache_file);
+    }
+}
+
+ParserState parse_file_cached(const ParserConfig &config,
+                              const fs::path &filename,
+                              const ParameterList &params) {
+    if (config.cache_directory.empty()) {
+        ParserState state = parse_file(config, filename, params);
+        transform_all(config, state);
+        return state;
+    }
+
+    fs::path abs_filename = fs::absolute(filename);
+    std::string key = cache_key(config, abs_filename, params);
+
+    std::string stem = abs_filename.filename().string();
+    stem = stem.substr(0, stem.size() - abs_filename.extension().string().size());
+    fs::path cache_file = config.cache_directory /
+        tfm::format("%s-%016llx.mscene", stem,
+                    (unsigned long long) std::hash<std::string>()(key));
+
+    ParserState state;
+    try {
+        if (read_cache(cache_file, key, state)) {
+            Log(Info, "Loaded cached scene description \"%s\"", cache_file);
+            return state;
+        }
+    } catch (const std::exception &e) {
+        Log(Warn, "Could not read scene cache \"%s\", reparsing: %s",
+            cache_file, e.what());
+    }
+
+    state = parse_file(config, filename, params);
+    transform_all(config, state);
+
+    try {
+        if (!fs::exists(config.cache_directory))
+            fs::create_directory(config.cache_directory);
+        write_cache(cache_file, key, state);
+        Log(Debug, "Wrote scene cache \"%s\"", cache_file);
+    } catch (const std::exception &e) {
+        Log(Warn, "Could not write scene cache \"%s\": %s", cache_file, e.what());
+    }
+
+    return state;
+}
+
 // ===========================================================================
 //   XML writing support
 // ===========================================================================
@@ -0,0 +1,280 @@
+#include <mitsuba/core/prefetch.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/mstream.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/trace.h>
+#include <mitsuba/core/util.h>
+#include <nanothread/nanothread.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// File extensions that are decoded into a Bitmap after being read
+static bool is_image_file(const fs::path &path) {
+    std::string ext = string::to_lower(path.extension().string());
+    return ext == ".exr" || ext == ".png" || ext == ".jpg" || ext == ".jpeg" ||
+           ext == ".hdr" || ext == ".rgbe" || ext == ".pfm" || ext == ".ppm" ||
+           ext == ".bmp" || ext == ".tga";
+}
+
+/**
+ * Read-only view of the contents of a prefetched file. All uses of a file
+ * share the same buffer, which is released along with the last view.
+ */
+class PrefetchedStream final : public MemoryStream {
+public:
+    using Stream::write;
+
+    PrefetchedStream(MemoryStream *buffer)
+        : MemoryStream(const_cast<uint8_t *>(buffer->raw_buffer()), buffer->size()),
+          m_buffer(buffer) { }
+
+    void write(const void *, size_t) override {
+        Throw("Attempted to write to the read-only contents of a prefetched file!");
+    }
+
+    void truncate(size_t) override {
+        Throw("Attempted to truncate the read-only contents of a prefetched file!");
+    }
+
+    bool can_write() const override { return false; }
+
+private:
+    ref<MemoryStream> m_buffer;
+};
+
+struct PrefetchEntry {
+    /// Task reading (and decoding) the file
+    Task *task = nullptr;
+    /// File contents (non-image files)
+    ref<MemoryStream> stream;
+    /// Decoded image (image files)
+    ref<Bitmap> bitmap;
+    /// Number of registered uses that haven't been consumed yet
+    size_t uses = 0;
+    /// Estimated memory footprint in bytes
+    size_t size = 0;
+    /// Set when the file couldn't be read
+    bool failed = false;
+    /// Prefetcher that registered this entry
+    std::atomic<size_t> *memory_usage = nullptr;
+};
+
+/// Global registry of files that are being prefetched, indexed by their path
+static std::mutex prefetch_mutex;
+static std::unordered_map<std::string, std::shared_ptr<PrefetchEntry>> prefetch_entries;
+
+struct FilePrefetcher::FilePrefetcherPrivate {
+    size_t memory_budget;
+    std::atomic<size_t> memory_usage { 0 };
+
+    /// Last task scheduled in each lane (reads within a lane are sequential)
+    std::vector<Task *> lanes;
+    size_t next_lane = 0;
+
+    /// Entries registered by this prefetcher
+    std::vector<std::string> keys;
+};
+
+/// Release the memory accounted to an entry (prefetch_mutex must be held)
+static void release_entry(PrefetchEntry &entry) {
+    if (entry.memory_usage)
+        entry.memory_usage->fetch_sub(entry.size);
+    entry.size = 0;
+    entry.stream = nullptr;
+    entry.bitmap = nullptr;
+}
+
+FilePrefetcher::FilePrefetcher(size_t concurrency, size_t memory_budget)
+    : d(new FilePrefetcherPrivate()) {
+    if (concurrency == 0)
+        Throw("FilePrefetcher: the concurrency must be at least 1!");
+    d->memory_budget = memory_budget;
+    d->lanes.resize(concurrency, nullptr);
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    std::vector<std::shared_ptr<PrefetchEntry>> entries;
+    {
+        std::lock_guard<std::mutex> guard(prefetch_mutex);
+        for (const std::string &key : d->keys) {
+            auto it = prefetch_entries.find(key);
+            if (it == prefetch_entries.end() ||
+                it->second->memory_usage != &d->memory_usage)
+                continue;
+            entries.push_back(it->second);
+            prefetch_entries.erase(it);
+        }
+    }
+
+    for (auto &entry : entries) {
+        task_wait_and_release(entry->task);
+        std::lock_guard<std::mutex> guard(prefetch_mutex);
+        release_entry(*entry);
+        entry->memory_usage = nullptr;
+    }
+}
+
+void FilePrefetcher::prefetch(const fs::path &path) {
+    if (!fs::is_regular_file(path))
+        return;
+
+    std::string key = path.string();
+    std::lock_guard<std::mutex> guard(prefetch_mutex);
+
+    auto it = prefetch_entries.find(key);
+    if (it != prefetch_entries.end()) {
+        it->second->uses++;
+        return;
+    }
+
+    /* Decoded images typically take up several times the space of the
+       (compressed) file on disk */
+    bool is_image = is_image_file(path);
+    size_t size = fs::file_size(path) * (is_image ? 4 : 1);
+    if (d->memory_usage + size > d->memory_budget) {
+        Log(Debug, "Not prefetching \"%s\": the memory budget of %s is exhausted.",
+            path.filename().string(), util::mem_string(d->memory_budget));
+        return;
+    }
+    d->memory_usage += size;
+
+    auto entry = std::make_shared<PrefetchEntry>();
+    entry->uses = 1;
+    entry->size = size;
+    entry->memory_usage = &d->memory_usage;
+
+    Task *&lane = d->lanes[d->next_lane++ % d->lanes.size()];
+    entry->task = dr::do_async(
+        [entry, path, is_image]() {
+            try {
+                ScopedTraceEvent trace_event("File I/O", "Prefetch file", path);
+                ref<FileStream> fs = new FileStream(path);
+                size_t file_size = fs->size();
+                ref<MemoryStream> ms = new MemoryStream(file_size);
+
+                std::unique_ptr<uint8_t[]> buf(new uint8_t[1024 * 1024]);
+                for (size_t pos = 0; pos < file_size; ) {
+                    size_t chunk = std::min(file_size - pos, (size_t) 1024 * 1024);
+                    fs->read(buf.get(), chunk);
+                    ms->write(buf.get(), chunk);
+                    pos += chunk;
+                }
+                ms->seek(0);
+
+                ref<Bitmap> bitmap = is_image ? new Bitmap(ms) : nullptr;
+
+                std::lock_guard<std::mutex> guard(prefetch_mutex);
+                if (is_image) {
+                    // Account for the actual size of the decoded image
+                    entry->memory_usage->fetch_sub(entry->size);
+                    entry->size = bitmap->buffer_size();
+                    entry->memory_usage->fetch_add(entry->size);
+                    entry->bitmap = bitmap;
+                } else {
+                    entry->stream = ms;
+                }
+            } catch (const std::exception &e) {
+                /* Plugins will load the file themselves and report a
+                   potential error with more context */
+                Log(Debug, "Could not prefetch \"%s\": %s",
+                    path.filename().string(), e.what());
+                std::lock_guard<std::mutex> guard(prefetch_mutex);
+                entry->failed = true;
+                release_entry(*entry);
+            }
+        },
+        &lane, lane ? 1 : 0);
+    lane = entry->task;
+
+    prefetch_entries[key] = entry;
+    d->keys.push_back(key);
+}
+
+size_t FilePrefetcher::file_count() const {
+    return d->keys.size();
+}
+
+size_t FilePrefetcher::memory_usage() const {
+    return d->memory_usage;
+}
+
+/// Look up a file and wait until its prefetch completes
+static std::shared_ptr<PrefetchEntry> wait_for_entry(const fs::path &path) {
+    std::shared_ptr<PrefetchEntry> entry;
+    {
+        std::lock_guard<std::mutex> guard(prefetch_mutex);
+        auto it = prefetch_entries.find(path.string());
+        if (it == prefetch_entries.end())
+            return nullptr;
+        entry = it->second;
+    }
+
+    task_wait(entry->task);
+    return entry;
+}
+
+ref<MemoryStream> FilePrefetcher::fetch(const fs::path &path) {
+    std::shared_ptr<PrefetchEntry> entry = wait_for_entry(path);
+    if (!entry)
+        return nullptr;
+
+    std::lock_guard<std::mutex> guard(prefetch_mutex);
+    if (entry->failed || !entry->stream)
+        return nullptr;
+
+    /* Every use receives its own view of the shared buffer, hence files
+       referenced many times (e.g. by the shapes of a .serialized file)
+       are never copied */
+    ref<MemoryStream> result = new PrefetchedStream(entry->stream.get());
+    if (entry->uses > 1) {
+        entry->uses--;
+    } else {
+        entry->uses = 0;
+        release_entry(*entry);
+    }
+
+    return result;
+}
+
+ref<Stream> FilePrefetcher::open(const fs::path &path) {
+    ref<MemoryStream> stream = fetch(path);
+    if (stream)
+        return stream;
+    return new FileStream(path);
+}
+
+ref<Bitmap> FilePrefetcher::load_bitmap(const fs::path &path) {
+    std::shared_ptr<PrefetchEntry> entry = wait_for_entry(path);
+
+    if (entry) {
+        std::lock_guard<std::mutex> guard(prefetch_mutex);
+        if (!entry->failed && entry->bitmap) {
+            ref<Bitmap> result;
+            if (entry->uses > 1) {
+                entry->uses--;
+                result = new Bitmap(*entry->bitmap);
+            } else {
+                result = entry->bitmap;
+                entry->uses = 0;
+                release_entry(*entry);
+            }
+            return result;
+        }
+    }
+
+    return new Bitmap(path);
+}
+
+std::string FilePrefetcher::to_string() const {
+    return tfm::format("FilePrefetcher[files=%zu, memory_usage=%s, "
+                       "memory_budget=%s, concurrency=%zu]",
+                       d->keys.size(), util::mem_string(d->memory_usage),
+                       util::mem_string(d->memory_budget), d->lanes.size());
+}
+
+NAMESPACE_END(mitsuba)
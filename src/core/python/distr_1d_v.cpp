@@ -39,6 +39,14 @@ MI_PY_EXPORT(DiscreteDistribution) {
             .def("eval_cdf_normalized", &DiscreteDistribution::eval_cdf_normalized,
                  "index"_a, "active"_a = true, D(DiscreteDistribution, eval_cdf_normalized))
             .def_method(DiscreteDistribution, update)
+            .def_method(DiscreteDistribution, set_alias_sampling, "value"_a)
+            .def_method(DiscreteDistribution, alias_sampling)
+            .def_prop_ro("alias_prob",
+              [](DiscreteDistribution &t) { return t.alias_prob(); },
+              D(DiscreteDistribution, alias_prob))
+            .def_prop_ro("alias_index",
+              [](DiscreteDistribution &t) { return t.alias_index(); },
+              D(DiscreteDistribution, alias_index))
             .def_method(DiscreteDistribution, normalization)
             .def_method(DiscreteDistribution, sum)
             .def("sample",
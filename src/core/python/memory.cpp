@@ -0,0 +1,20 @@
+#include <mitsuba/core/memory.h>
+#include <mitsuba/python/python.h>
+#include <nanobind/stl/string.h>
+
+MI_PY_EXPORT(MemoryUsage) {
+    nb::enum_<MemoryCategory>(m, "MemoryCategory", D(MemoryCategory))
+        .value("Geometry",     MemoryCategory::Geometry,     D(MemoryCategory, Geometry))
+        .value("Textures",     MemoryCategory::Textures,     D(MemoryCategory, Textures))
+        .value("Volumes",      MemoryCategory::Volumes,      D(MemoryCategory, Volumes))
+        .value("Emitters",     MemoryCategory::Emitters,     D(MemoryCategory, Emitters))
+        .value("Acceleration", MemoryCategory::Acceleration, D(MemoryCategory, Acceleration))
+        .value("Film",         MemoryCategory::Film,         D(MemoryCategory, Film));
+
+    nb::class_<MemoryUsage>(m, "MemoryUsage", D(MemoryUsage))
+        .def_static_method(MemoryUsage, bytes, "category"_a)
+        .def_static_method(MemoryUsage, total)
+        .def_static_method(MemoryUsage, set_budget, "bytes"_a)
+        .def_static_method(MemoryUsage, budget)
+        .def_static_method(MemoryUsage, report);
+}
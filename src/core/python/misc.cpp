@@ -1,3 +1,5 @@
+#include <mitsuba/core/asset.h>
+#include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/python/python.h>
 #include <nanobind/stl/string.h>
@@ -10,6 +12,17 @@ MI_PY_EXPORT(misc) {
         .def("mem_string", &util::mem_string, D(util, mem_string), "size"_a, "precise"_a = false)
         .def("trap_debugger", &util::trap_debugger, D(util, trap_debugger));
 
+    nb::class_<AssetRegistry>(m, "AssetRegistry", D(AssetRegistry))
+        .def_static("file_key", &AssetRegistry::file_key, "path"_a,
+                    D(AssetRegistry, file_key))
+        .def_static("entry_count", &AssetRegistry::entry_count, D(AssetRegistry, entry_count))
+        .def_static("hit_count", &AssetRegistry::hit_count, D(AssetRegistry, hit_count))
+        .def_static("deduplicated_bytes", &AssetRegistry::deduplicated_bytes,
+                    D(AssetRegistry, deduplicated_bytes))
+        .def_static("set_enabled", &AssetRegistry::set_enabled, "value"_a,
+                    D(AssetRegistry, set_enabled))
+        .def_static("enabled", &AssetRegistry::enabled, D(AssetRegistry, enabled));
+
     // Bind util::Version struct
     nb::class_<util::Version>(m, "Version")
         .def(nb::init<>())
@@ -338,7 +338,16 @@ MI_PY_EXPORT(parser) {
         .def_rw("merge_equivalent", &ParserConfig::merge_equivalent,
                 "Enable merging of equivalent nodes (deduplication) (default: true)")
         .def_rw("merge_meshes", &ParserConfig::merge_meshes,
-                "Enable merging of meshes into a single merge shape (default: true)");
+                "Enable merging of meshes into a single merge shape (default: true)")
+        .def_rw("instance_duplicates", &ParserConfig::instance_duplicates,
+                "Replace meshes that are identical up to a rigid transformation "
+                "by instances of a shared shape group (default: false)")
+        .def_rw("prefetch", &ParserConfig::prefetch,
+                "Read files referenced by the scene ahead of time on background "
+                "threads during parallel instantiation (default: true)")
+        .def_rw("cache_directory", &ParserConfig::cache_directory,
+                "Directory storing binary caches of parsed and transformed "
+                "scenes, used by parse_file_cached() (default: disabled)");
 
     // Export SceneNode
     nb::class_<SceneNode>(parser, "SceneNode")
@@ -396,6 +405,15 @@ MI_PY_EXPORT(parser) {
           "config"_a, "filename"_a, "kwargs"_a,
           "Parse a scene from an XML file");
 
+    parser.def("parse_file_cached",
+          [](const ParserConfig &config, std::string_view filename, nb::kwargs kwargs) {
+              nb::gil_scoped_release release;
+              return parse_file_cached(config, fs::path(filename), convert_param_list(kwargs));
+          },
+          "config"_a, "filename"_a, "kwargs"_a,
+          "Parse a scene from an XML file and apply all transformations, "
+          "reusing the binary cache in ``config.cache_directory`` when possible");
+
     parser.def("parse_string",
           [](const ParserConfig &config, std::string_view string, nb::kwargs kwargs) {
               return parse_string(config, string, convert_param_list(kwargs));
@@ -467,7 +485,8 @@ MI_PY_EXPORT(parser) {
 
     m.def(
         "load_file",
-        [](const std::string &name, bool parallel, bool optimize, nb::kwargs kwargs) {
+        [](const std::string &name, bool parallel, bool optimize,
+           const std::string &cache_directory, nb::kwargs kwargs) {
             parser::ParameterList params = convert_param_list(kwargs);
             nb::str variant_str = get_variant_str();
             parser::ParserConfig config(variant_str.c_str());
@@ -475,6 +494,7 @@ MI_PY_EXPORT(parser) {
             config.parallel = parallel;
             config.merge_equivalent = optimize;
             config.merge_meshes = optimize;
+            config.cache_directory = cache_directory;
 
             // Set up FileResolver like the old parser does
             fs::path filename(name);
@@ -489,8 +509,8 @@ MI_PY_EXPORT(parser) {
             std::vector<ref<Object>> objects;
             try {
                 nb::gil_scoped_release release;
-                parser::ParserState state = parser::parse_file(config, name, params);
-                parser::transform_all(config, state);
+                parser::ParserState state =
+                    parser::parse_file_cached(config, name, params);
                 objects = parser::instantiate(config, state);
             } catch (...) {
                 set_file_resolver(fs_backup.get());
@@ -501,7 +521,8 @@ MI_PY_EXPORT(parser) {
 
             return single_object_or_list(objects);
         },
-        "path"_a, "parallel"_a = true, "optimize"_a = true, "kwargs"_a,
+        "path"_a, "parallel"_a = true, "optimize"_a = true,
+        "cache_directory"_a = "", "kwargs"_a,
         R"doc(Load a Mitsuba scene or object from an XML file
 
 Parameter ``name``:
@@ -513,6 +534,10 @@ Parameter ``parallel``:
 Parameter ``optimize``:
     Whether to enable optimizations like merging identical objects (default: True)
 
+Parameter ``cache_directory``:
+    When specified, the parsed and transformed scene description is cached
+    in this directory, which speeds up subsequent loads of the same file.
+
 Parameter ``kwargs``:
     A dictionary of key value pairs that will replace any default parameters declared in the XML.
 
@@ -0,0 +1,11 @@
+#include <mitsuba/core/statistics.h>
+#include <mitsuba/python/python.h>
+#include <nanobind/stl/string.h>
+
+MI_PY_EXPORT(Statistics) {
+    nb::class_<Statistics>(m, "Statistics", D(Statistics))
+        .def_static_method(Statistics, enabled)
+        .def_static_method(Statistics, reset)
+        .def_static_method(Statistics, report)
+        .def_static_method(Statistics, to_json);
+}
@@ -118,3 +118,18 @@ MI_PY_EXPORT(ZStream) {
             return nb::cast(stream.child_stream());
         }, D(ZStream, child_stream));
 }
+
+MI_PY_EXPORT(BlockZStream) {
+    MI_PY_CLASS(BlockZStream, Stream)
+        .def(nb::init<Stream*, ZStream::EStreamType, int, size_t>(),
+            D(BlockZStream, BlockZStream),
+            "child_stream"_a,
+            "stream_type"_a = ZStream::EDeflateStream,
+            "level"_a = -1,
+            "block_size"_a = 1024 * 1024)
+        .def("child_stream", [](BlockZStream &stream) {
+            return nb::cast(stream.child_stream());
+        }, D(BlockZStream, child_stream))
+        .def_method(BlockZStream, block_count)
+        .def_method(BlockZStream, block_size);
+}
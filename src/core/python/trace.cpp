@@ -0,0 +1,13 @@
+#include <mitsuba/core/trace.h>
+#include <mitsuba/python/python.h>
+#include <nanobind/stl/string.h>
+
+MI_PY_EXPORT(Trace) {
+    nb::class_<Trace>(m, "Trace", D(Trace))
+        .def_static_method(Trace, set_enabled, "value"_a)
+        .def_static_method(Trace, enabled)
+        .def_static_method(Trace, clear)
+        .def_static_method(Trace, event_count)
+        .def_static_method(Trace, to_json)
+        .def_static_method(Trace, write, "filename"_a);
+}
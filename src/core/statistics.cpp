@@ -0,0 +1,216 @@
+#include <mitsuba/core/statistics.h>
+#include <mitsuba/core/json.h>
+#include <mitsuba/core/logger.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+#if defined(MI_ENABLE_STATISTICS)
+
+NAMESPACE_BEGIN()
+
+struct StatsEntry {
+    std::string category;
+    std::string name;
+    StatsType type;
+    uint32_t index;
+    uint32_t slots;
+};
+
+struct StatsRegistry {
+    std::mutex mutex;
+    std::vector<StatsEntry> entries;
+    uint32_t slots_used = 0;
+
+    /* Counter slots of all threads that have incremented a counter. They are
+       never released, since counters remain readable after a thread exits */
+    std::vector<std::unique_ptr<detail::StatsSlot[]>> threads;
+};
+
+/// Constructed on first use, since counters are registered during static initialization
+StatsRegistry &registry() {
+    static StatsRegistry *registry = new StatsRegistry();
+    return *registry;
+}
+
+/// Aggregated value of a counter (identified by its category and name)
+struct StatsValue {
+    StatsType type;
+    std::vector<uint64_t> slots;
+};
+
+/// Sum the counters of all threads, sorted by category and name
+std::map<std::pair<std::string, std::string>, StatsValue> aggregate() {
+    StatsRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+
+    std::map<std::pair<std::string, std::string>, StatsValue> result;
+    for (const StatsEntry &entry : r.entries) {
+        StatsValue &value = result[{ entry.category, entry.name }];
+        value.type = entry.type;
+        if (value.slots.size() < entry.slots)
+            value.slots.resize(entry.slots, 0);
+        for (const auto &thread : r.threads) {
+            for (uint32_t i = 0; i < entry.slots; ++i)
+                value.slots[i] += thread[entry.index + i].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+std::string count_string(uint64_t value) {
+    const char *suffixes[] = { "", " K", " M", " G", " T" };
+    double scaled = (double) value;
+    int suffix = 0;
+    while (scaled >= 1000.0 && suffix < 4) {
+        scaled /= 1000.0;
+        suffix++;
+    }
+    if (suffix == 0)
+        return std::to_string(value);
+    return tfm::format("%.2f%s", scaled, suffixes[suffix]);
+}
+
+NAMESPACE_END()
+
+NAMESPACE_BEGIN(detail)
+
+uint32_t stats_register(const char *category, const char *name, StatsType type,
+                        uint32_t slots) {
+    StatsRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    if (r.slots_used + slots > StatsSlotCount)
+        Throw("stats_register(): out of counter slots while registering "
+              "\"%s\" (increase StatsSlotCount)", name);
+    uint32_t index = r.slots_used;
+    r.slots_used += slots;
+    r.entries.push_back(StatsEntry{ category, name, type, index, slots });
+    return index;
+}
+
+StatsSlot *stats_register_thread() {
+    StatsRegistry &r = registry();
+    std::unique_ptr<StatsSlot[]> slots(new StatsSlot[StatsSlotCount]);
+    for (uint32_t i = 0; i < StatsSlotCount; ++i)
+        slots[i].store(0, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(r.mutex);
+    r.threads.push_back(std::move(slots));
+    return r.threads.back().get();
+}
+
+NAMESPACE_END(detail)
+
+void Statistics::reset() {
+    StatsRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    for (const auto &thread : r.threads) {
+        for (uint32_t i = 0; i < detail::StatsSlotCount; ++i)
+            thread[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+std::string Statistics::report() {
+    std::ostringstream oss;
+    oss << "Statistics:";
+    std::string category;
+
+    for (const auto &[key, value] : aggregate()) {
+        if (key.first != category) {
+            category = key.first;
+            oss << std::endl << "  " << category << std::endl;
+        }
+        oss << "    " << key.second << ": ";
+
+        switch (value.type) {
+            case StatsType::Counter:
+                oss << count_string(value.slots[0]);
+                break;
+
+            case StatsType::Ratio:
+                oss << count_string(value.slots[0]) << " / "
+                    << count_string(value.slots[1]);
+                if (value.slots[1] > 0)
+                    oss << tfm::format(" (%.2f %%)",
+                                       100.0 * value.slots[0] / value.slots[1]);
+                break;
+
+            case StatsType::Histogram: {
+                    uint64_t total = 0;
+                    for (uint64_t v : value.slots)
+                        total += v;
+                    for (size_t i = 0; i < value.slots.size(); ++i) {
+                        if (value.slots[i] == 0)
+                            continue;
+                        oss << std::endl << "      "
+                            << (i + 1 == value.slots.size() ? ">= " : "") << i
+                            << ": " << count_string(value.slots[i])
+                            << tfm::format(" (%.2f %%)", 100.0 * value.slots[i] / total);
+                    }
+                }
+                break;
+        }
+        oss << std::endl;
+    }
+
+    return oss.str();
+}
+
+std::string Statistics::to_json() {
+    std::ostringstream oss;
+    std::string category;
+    bool first = true;
+    oss << "{";
+
+    for (const auto &[key, value] : aggregate()) {
+        if (key.first != category) {
+            oss << (category.empty() ? "" : "}, ") << json_string(key.first) << ": {";
+            category = key.first;
+            first = true;
+        }
+        oss << (first ? "" : ", ") << json_string(key.second) << ": ";
+        first = false;
+
+        switch (value.type) {
+            case StatsType::Counter:
+                oss << value.slots[0];
+                break;
+
+            case StatsType::Ratio:
+                oss << "{\"value\": " << value.slots[0]
+                    << ", \"base\": " << value.slots[1] << "}";
+                break;
+
+            case StatsType::Histogram:
+                oss << "[";
+                for (size_t i = 0; i < value.slots.size(); ++i)
+                    oss << (i > 0 ? ", " : "") << value.slots[i];
+                oss << "]";
+                break;
+        }
+    }
+
+    oss << (category.empty() ? "}" : "}}");
+    return oss.str();
+}
+
+#else
+
+void Statistics::reset() { }
+std::string Statistics::report() { return ""; }
+std::string Statistics::to_json() { return "{}"; }
+
+#endif
+
+std::atomic<uint32_t> work_counters_users { 0 };
+
+WorkCounters &work_counters() {
+    static thread_local WorkCounters counters;
+    return counters;
+}
+
+NAMESPACE_END(mitsuba)
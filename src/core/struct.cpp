@@ -4,6 +4,7 @@
 #include <mitsuba/core/stream.h>
 #include <mitsuba/core/hash.h>
 #include <mitsuba/core/jit.h>
+#include <mitsuba/core/trace.h>
 #include <drjit-core/half.h>
 #include <drjit/array.h>
 #include <drjit/color.h>
@@ -1266,6 +1267,8 @@ StructConverter::StructConverter(const Struct *source, const Struct *target, boo
         return;
     }
 
+    ScopedTraceEvent trace_event("JIT", "Compile StructConverter");
+
     CodeHolder code;
     code.init(jit->runtime.environment());
     #if MI_JIT_LOG_ASSEMBLY == 1
@@ -255,3 +255,144 @@ def test18_irrcont_simple_function(variants_vec_backends_once):
                 0.48734, 0.654313, 0.786607, 0.899653, 1.])
          * d.normalization())
     )
+
+
+def test19_discr_alias_table(variants_vec_backends_once):
+    # The alias table must reproduce the PMF exactly
+    import numpy as np
+
+    x = mi.DiscreteDistribution([1, 3, 2, 0, 6])
+    assert not x.alias_sampling()
+    assert len(x.alias_prob) == 0
+
+    x.set_alias_sampling(True)
+    assert x.alias_sampling()
+    assert len(x.alias_prob) == 5 and len(x.alias_index) == 5
+
+    prob  = np.array(x.alias_prob)
+    alias = np.array(x.alias_index)
+    mass = prob.copy()
+    np.add.at(mass, alias, 1 - prob)
+    assert np.allclose(mass / 5, np.array([1, 3, 2, 0, 6]) / 12)
+
+    # Changing the PMF rebuilds the table
+    x.pmf = [1, 1, 1, 1, 1]
+    x.update()
+    assert dr.allclose(x.alias_prob, 1)
+
+    x.set_alias_sampling(False)
+    assert len(x.alias_prob) == 0
+
+
+def test20_discr_alias_sample(variants_vec_backends_once):
+    # Alias sampling must visit bins in proportion to their mass and never
+    # return zero-valued bins
+    x = mi.DiscreteDistribution([0, 0, 1, 0, 3, 0, 0, 0])
+    x.set_alias_sampling(True)
+
+    n = 100000
+    index, reused, pmf = x.sample_reuse_pmf(dr.linspace(mi.Float, 0, 1, n))
+    assert dr.all((index == 2) | (index == 4))
+    assert dr.allclose(pmf, dr.select(index == 2, .25, .75))
+    assert dr.allclose(dr.count(index == 2) / n, .25, atol=1e-3)
+
+    assert dr.all((reused >= 0) & (reused < 1))
+    assert dr.allclose(dr.mean(reused), .5, atol=1e-3)
+
+    # Out-of-range samples are clamped
+    assert dr.all(x.sample([-100, 100]) != 0)
+
+
+def test21_discr_alias_bruteforce(variants_vec_backends_once):
+    # Compare histograms of alias and CDF sampling on random distributions
+    rng = mi.PCG32(initseq=dr.arange(mi.UInt64, 1000))
+    n = 200000
+
+    for size in [1, 7, 100]:
+        density = dr.gather(mi.Float, rng.next_float32() * 10, dr.arange(mi.UInt32, size))
+        x = mi.DiscreteDistribution(density)
+        x.set_alias_sampling(True)
+
+        index = x.sample(dr.linspace(mi.Float, 0, 1, n, endpoint=False))
+        hist = dr.zeros(mi.Float, size)
+        dr.scatter_reduce(dr.ReduceOp.Add, hist, 1.0, index)
+
+        assert dr.allclose(hist / n, x.pmf * x.normalization(), atol=1e-3)
+
+
+def test22_discr_alias_scalar(variant_scalar_rgb):
+    x = mi.DiscreteDistribution([1, 3, 2])
+    x.set_alias_sampling(True)
+
+    counts = [0, 0, 0]
+    n = 600
+    for i in range(n):
+        index, reused, pmf = x.sample_reuse_pmf((i + 0.5) / n)
+        assert 0 <= reused < 1
+        assert dr.allclose(pmf, [1, 3, 2][index] / 6)
+        counts[index] += 1
+
+    assert counts == [100, 300, 200]
+
+
+def benchmark_discr_sampling(sample_count, sizes):
+    import time
+
+    results = {}
+    for size in sizes:
+        rng = mi.PCG32(size=size)
+        x = mi.DiscreteDistribution(rng.next_float32())
+        u = mi.PCG32(size=sample_count).next_float32()
+        dr.eval(u)
+
+        for alias in [False, True]:
+            x.set_alias_sampling(alias)
+            dr.eval(x.sample(u))  # Warm up the kernel cache
+
+            t0 = time.time()
+            dr.eval(x.sample(u))
+            results[(size, alias)] = time.time() - t0
+
+        print(f'{size:>10} entries: CDF {sample_count / results[(size, False)] * 1e-6:8.2f} MSamples/s, '
+              f'alias {sample_count / results[(size, True)] * 1e-6:8.2f} MSamples/s')
+    return results
+
+
+@pytest.mark.slow
+def test23_benchmark_discr_sampling_llvm(variant_llvm_ad_rgb):
+    benchmark_discr_sampling(1 << 24, [16, 1 << 12, 1 << 20, 1 << 24])
+
+
+@pytest.mark.slow
+def test24_benchmark_discr_sampling_scalar(variant_scalar_rgb):
+    import time
+
+    for size in [16, 1 << 12, 1 << 20]:
+        rng = mi.PCG32()
+        x = mi.DiscreteDistribution([rng.next_float32() for _ in range(size)])
+        samples = [rng.next_float32() for _ in range(100000)]
+
+        for alias in [False, True]:
+            x.set_alias_sampling(alias)
+            sample = x.sample
+            t0 = time.time()
+            for u in samples:
+                sample(u)
+            t = time.time() - t0
+            print(f'{size:>10} entries, {"alias" if alias else "CDF":>5}: '
+                  f'{len(samples) / t * 1e-6:.2f} MSamples/s')
+
+
+def test25_discr_parallel_cdf(variant_scalar_rgb):
+    import numpy as np
+
+    # Large distributions use a blocked parallel prefix sum
+    values = np.random.default_rng(1).random(1000003).astype(np.float32)
+    values[:10] = 0
+    values[-5:] = 0
+    d = mi.DiscreteDistribution(values)
+
+    cdf = np.cumsum(values.astype(np.float64)).astype(np.float32)
+    assert np.allclose(np.array(d.cdf), cdf, rtol=1e-6)
+    assert d.sample(0.0) == 10
+    assert d.sample(1.0) == len(values) - 6
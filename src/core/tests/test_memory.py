@@ -0,0 +1,66 @@
+import drjit as dr
+import mitsuba as mi
+
+
+def test01_categories(variant_scalar_rgb):
+    geometry = mi.MemoryUsage.bytes(mi.MemoryCategory.Geometry)
+    textures = mi.MemoryUsage.bytes(mi.MemoryCategory.Textures)
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'shape': {
+            'type': 'cube',
+            'bsdf': {
+                'type': 'diffuse',
+                'reflectance': {
+                    'type': 'bitmap',
+                    'data': dr.ones(mi.TensorXf, shape=[16, 16, 3])
+                }
+            }
+        }
+    })
+
+    # 24 vertices and 12 faces, 16x16 texels
+    assert mi.MemoryUsage.bytes(mi.MemoryCategory.Geometry) > geometry
+    assert mi.MemoryUsage.bytes(mi.MemoryCategory.Textures) >= \
+        textures + 16 * 16 * 3 * 4
+    # Embree does not report the size of its acceleration data structure
+    if not mi.MI_ENABLE_EMBREE:
+        assert mi.MemoryUsage.bytes(mi.MemoryCategory.Acceleration) > 0
+    assert mi.MemoryUsage.total() >= \
+        mi.MemoryUsage.bytes(mi.MemoryCategory.Geometry)
+
+    report = mi.MemoryUsage.report()
+    assert 'Geometry' in report
+    assert 'Textures' in report
+
+    # Contributions are removed when the objects are released
+    textures_scene = mi.MemoryUsage.bytes(mi.MemoryCategory.Textures)
+    del scene
+    assert mi.MemoryUsage.bytes(mi.MemoryCategory.Textures) < textures_scene
+
+
+def test02_budget(variant_scalar_rgb):
+    assert mi.MemoryUsage.budget() == 0
+    mi.MemoryUsage.set_budget(1024)
+    assert mi.MemoryUsage.budget() == 1024
+    assert 'budget' in mi.MemoryUsage.report()
+    mi.MemoryUsage.set_budget(0)
+    assert 'budget' not in mi.MemoryUsage.report()
+
+
+def test02_shared_assets(variant_llvm_ad_rgb, tmp_path):
+    # Textures that share the data of a file through the asset registry
+    # account for it only once
+    filename = str(tmp_path / 'texture.exr')
+    mi.Bitmap(dr.ones(mi.TensorXf, shape=[32, 32, 3])).write(filename)
+
+    textures = mi.MemoryUsage.bytes(mi.MemoryCategory.Textures)
+    t1 = mi.load_dict({'type': 'bitmap', 'filename': filename, 'raw': True})
+    single = mi.MemoryUsage.bytes(mi.MemoryCategory.Textures) - textures
+    t2 = mi.load_dict({'type': 'bitmap', 'filename': filename, 'raw': True})
+    shared = mi.MemoryUsage.bytes(mi.MemoryCategory.Textures) - textures
+
+    assert single >= 32 * 32 * 3 * 4
+    assert shared == single
+    del t1, t2
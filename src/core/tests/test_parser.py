@@ -2505,3 +2505,198 @@ def test67_dict_resource_path_management(variant_scalar_rgb, tmp_path):
                 "type": "resources"
             }
         })
+
+
+@fresolver_append_path
+def test68_prefetch_resources(variant_scalar_rgb):
+    """Files read ahead of time must produce the same objects as direct loads"""
+    def instantiate(scene_dict, prefetch):
+        config = mi.parser.ParserConfig('scalar_rgb')
+        config.prefetch = prefetch
+        config.merge_meshes = False
+        state = mi.parser.parse_dict(config, scene_dict)
+        mi.parser.transform_all(config, state)
+        return mi.traverse(mi.parser.instantiate(config, state))
+
+    # Two shapes referencing the same file
+    scene_dict = {
+        'type': 'scene',
+        'mesh_1': {
+            'type': 'ply',
+            'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+        },
+        'mesh_2': {
+            'type': 'ply',
+            'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+            'to_world': mi.ScalarTransform4f().translate([1, 0, 0])
+        }
+    }
+
+    params_ref = instantiate(scene_dict, False)
+    params = instantiate(scene_dict, True)
+    for key in ['mesh_1.vertex_positions', 'mesh_2.vertex_positions',
+                'mesh_1.faces', 'mesh_2.faces']:
+        assert dr.all(params_ref[key] == params[key]), key
+
+    # Images are decoded ahead of time
+    tex_dict = {
+        'type': 'bitmap',
+        'filename': 'resources/data/common/textures/carrot.png'
+    }
+
+    params_ref = instantiate(tex_dict, False)
+    params = instantiate(tex_dict, True)
+    assert dr.all(params_ref['data'] == params['data'], axis=None)
+
+
+@fresolver_append_path
+def test69_instance_duplicates(variant_scalar_rgb):
+    """Meshes differing by a rigid transformation are replaced by instances"""
+    def load(instance_duplicates):
+        config = mi.parser.ParserConfig('scalar_rgb')
+        config.instance_duplicates = instance_duplicates
+        state = mi.parser.parse_dict(config, scene_dict)
+        mi.parser.transform_all(config, state)
+        return mi.parser.instantiate(config, state)
+
+    T = mi.ScalarTransform4f
+    scene_dict = {'type': 'scene'}
+    for i, to_world in enumerate([
+            T(),
+            T().translate([1, 0, 0]),
+            T().translate([0, 2, -1]) @ T().rotate([0, 1, 1], 35),
+            T().rotate([1, 0, 0], 90) @ T().translate([0, -1, 0])]):
+        scene_dict[f'bunny_{i}'] = {
+            'type': 'ply',
+            'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+            'to_world': to_world
+        }
+
+    # A scaled copy and a different mesh must be left alone
+    scene_dict['bunny_scaled'] = {
+        'type': 'ply',
+        'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+        'to_world': T().scale(2)
+    }
+    scene_dict['rectangle'] = {'type': 'rectangle'}
+
+    scene_ref = load(False)
+    scene = load(True)
+
+    shapes = scene.shapes()
+    instances = [s for s in shapes if s.is_instance()]
+    assert len(instances) == 4
+    assert sorted(s.id() for s in instances) == [f'bunny_{i}' for i in range(4)]
+    assert len(shapes) == 6
+
+    # Both scenes must be geometrically identical
+    rng = mi.PCG32()
+    for _ in range(256):
+        o = mi.ScalarPoint3f([rng.next_float32() * 8 - 4 for _ in range(3)])
+        d = mi.warp.square_to_uniform_sphere(
+            mi.ScalarPoint2f(rng.next_float32(), rng.next_float32()))
+        ray = mi.Ray3f(o, d)
+        si_ref = scene_ref.ray_intersect(ray)
+        si = scene.ray_intersect(ray)
+        assert si.is_valid() == si_ref.is_valid()
+        if si_ref.is_valid():
+            assert dr.allclose(si.t, si_ref.t, rtol=1e-4, atol=1e-5)
+
+
+def test70_parse_file_cached(variant_scalar_rgb, tmp_path):
+    """Test that the binary scene cache reproduces and tracks the parsed scene"""
+    import os
+
+    cache_dir = tmp_path / "cache"
+    include_file = tmp_path / "material.xml"
+    main_file = tmp_path / "scene.xml"
+
+    include_file.write_text('''<bsdf type="diffuse" id="mat" version="3.5.0">
+        <rgb name="reflectance" value="0.2, 0.4, 0.6"/>
+    </bsdf>''')
+    main_file.write_text(f'''<scene version="3.5.0">
+        <default name="radius" value="1.0"/>
+        <include filename="{xml_escape(include_file)}"/>
+        <shape type="sphere" id="s1">
+            <float name="radius" value="$radius"/>
+            <transform name="to_world">
+                <translate x="1" y="2" z="3"/>
+                <rotate y="1" angle="30"/>
+            </transform>
+            <ref id="mat"/>
+        </shape>
+        <emitter type="constant">
+            <spectrum name="radiance" value="400:1.0, 500:2.0, 600:0.5"/>
+        </emitter>
+        <integer name="dummy" value="3"/>
+    </scene>''')
+
+    cfg = mi.parser.ParserConfig('scalar_rgb')
+    cfg.merge_meshes = False
+    cfg.cache_directory = str(cache_dir)
+
+    ref = mi.parser.parse_file(cfg, str(main_file), radius='2.5')
+    mi.parser.transform_all(cfg, ref)
+
+    # The first call populates the cache, the second one reads it back
+    state_1 = mi.parser.parse_file_cached(cfg, str(main_file), radius='2.5')
+    cache_files = list(cache_dir.glob('scene-*.mscene'))
+    assert len(cache_files) == 1
+    state_2 = mi.parser.parse_file_cached(cfg, str(main_file), radius='2.5')
+
+    assert state_1 == ref
+    assert state_2 == ref
+    assert state_2.files == ref.files
+    assert state_2.id_to_index == ref.id_to_index
+    assert len(state_2.versions) == len(ref.versions)
+
+    # Different parameters are stored separately
+    state_3 = mi.parser.parse_file_cached(cfg, str(main_file), radius='4.0')
+    assert len(list(cache_dir.glob('scene-*.mscene'))) == 2
+    assert state_3 != ref
+
+    # Changing an included file invalidates the cache
+    include_file.write_text('''<bsdf type="diffuse" id="mat" version="3.5.0">
+        <rgb name="reflectance" value="0.9, 0.4, 0.6"/>
+    </bsdf>''')
+    st = os.stat(include_file)
+    os.utime(include_file, ns=(st.st_atime_ns, st.st_mtime_ns + 10**9))
+
+    state_4 = mi.parser.parse_file_cached(cfg, str(main_file), radius='2.5')
+    assert state_4 != ref
+    idx = state_4.id_to_index['mat']
+    assert dr.allclose(state_4.nodes[idx].props['reflectance'], [0.9, 0.4, 0.6])
+
+    # Included files are found through the search paths of the file resolver
+    lib_file = tmp_path / "lib.xml"
+    lib_file.write_text('''<scene version="3.5.0">
+        <include filename="material_lib.xml"/>
+    </scene>''')
+    reflectance = {}
+    for name, value in [('lib_a', '0.1, 0.1, 0.1'), ('lib_b', '0.7, 0.7, 0.7')]:
+        (tmp_path / name).mkdir()
+        (tmp_path / name / 'material_lib.xml').write_text(f'''<bsdf type="diffuse" id="mat" version="3.5.0">
+            <rgb name="reflectance" value="{value}"/>
+        </bsdf>''')
+        reflectance[name] = [float(v) for v in value.split(',')]
+
+    fres_old = mi.file_resolver()
+    try:
+        for name in ['lib_a', 'lib_b', 'lib_a']:
+            fres = mi.FileResolver(fres_old)
+            fres.append(str(tmp_path / name))
+            mi.set_file_resolver(fres)
+            state = mi.parser.parse_file_cached(cfg, str(lib_file))
+            idx = state.id_to_index['mat']
+            assert dr.allclose(state.nodes[idx].props['reflectance'],
+                               reflectance[name])
+    finally:
+        mi.set_file_resolver(fres_old)
+    assert len(list(cache_dir.glob('lib-*.mscene'))) == 2
+
+    # The cached scene can be instantiated
+    scene = mi.parser.instantiate(cfg, mi.parser.parse_file_cached(
+        cfg, str(main_file), radius='2.5'))
+    assert len(scene.shapes()) == 1
+    assert mi.load_file(str(main_file), cache_directory=str(cache_dir),
+                        radius='2.5') is not None
@@ -0,0 +1,44 @@
+import json
+import mitsuba as mi
+
+
+def test01_render_counters(variant_scalar_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'integrator': {'type': 'path', 'max_depth': 3},
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=[0, 0, 4], target=[0, 0, 0], up=[0, 1, 0]),
+            'film': {'type': 'hdrfilm', 'width': 8, 'height': 8},
+            'sampler': {'type': 'independent', 'sample_count': 4}
+        },
+        'shape': {'type': 'sphere'},
+        'emitter': {'type': 'constant'}
+    })
+
+    mi.render(scene)
+    stats = json.loads(mi.Statistics.to_json())
+
+    if not mi.Statistics.enabled():
+        assert stats == {}
+        assert mi.Statistics.report() == ''
+        return
+
+    # The counters are reset at the beginning of each render job
+    rays = stats['Ray tracing']['Rays traced']
+    assert rays >= 8 * 8 * 4
+    assert stats['Path tracer']['BSDF samples'] > 0
+    assert sum(stats['Path tracer']['Path length']) == 8 * 8 * 4
+
+    shadow = stats['Ray tracing']['Occluded shadow rays']
+    assert 0 <= shadow['value'] <= shadow['base']
+
+    mi.render(scene)
+    stats = json.loads(mi.Statistics.to_json())
+    assert stats['Ray tracing']['Rays traced'] == rays
+
+    mi.Statistics.reset()
+    stats = json.loads(mi.Statistics.to_json())
+    assert stats['Ray tracing']['Rays traced'] == 0
+    assert 'Rays traced' in mi.Statistics.report()
@@ -2,7 +2,8 @@ import os
 import pytest
 import drjit as dr
 
-from mitsuba import Stream, DummyStream, FileStream, MemoryStream, ZStream
+from mitsuba import Stream, DummyStream, FileStream, MemoryStream, ZStream, \
+                    BlockZStream
 from mitsuba.test.util import tmpfile, make_tmpfile
 
 parameters = [
@@ -292,3 +293,78 @@ def test08_fstream(rw, tmpfile):
     else:
         with pytest.raises(RuntimeError):
             FileStream(new_name)
+
+
+@pytest.mark.parametrize('stream_type', [ZStream.EDeflateStream, ZStream.EGZipStream])
+# With 2-byte blocks, the index of gzip streams spans several members
+@pytest.mark.parametrize('block_size', [2, 5, 1000])
+def test09_block_zstream(stream_type, block_size):
+    import zlib
+
+    data = bytes(range(256)) * 40 + os.urandom(1000)
+
+    ms = MemoryStream()
+    bs = BlockZStream(ms, stream_type, block_size=block_size)
+    assert bs.can_write() and bs.can_read()
+    write_contents(bs)
+    bs.write(data)
+    bs.close()
+    assert bs.block_count() > 1
+
+    # The output is a regular zlib/gzip stream followed by the block index
+    d = zlib.decompressobj(wbits=31 if stream_type == ZStream.EGZipStream else 15)
+    payload = d.decompress(ms.raw_buffer())
+    assert d.eof and len(d.unused_data) > 0
+    assert payload.endswith(data)
+
+    # gzip output stores the index in empty members, i.e. it is a valid file
+    if stream_type == ZStream.EGZipStream:
+        import gzip
+        assert gzip.decompress(ms.raw_buffer()) == payload
+
+    # .. which can be read sequentially by ZStream
+    ms.seek(0)
+    zs = ZStream(ms, stream_type)
+    check_contents(zs)
+    assert zs.read(len(data)) == data
+    del zs
+
+    # Read it back through the index
+    ms.seek(0)
+    bs = BlockZStream(ms)
+    assert bs.size() == len(payload)
+    # write_contents() calls flush(), which may create a partial block
+    n_contents = len(payload) - len(data)
+    assert bs.block_count() == -(-n_contents // block_size) + -(-len(data) // block_size)
+    check_contents(bs)
+    assert bs.read(len(data)) == data
+
+    # Random access
+    for pos in [len(payload) - 1, 0, 517, len(payload) - len(data) + 3, 1234]:
+        bs.seek(pos)
+        assert bs.read(10 if pos + 10 <= len(payload) else 1) == \
+            payload[pos:pos + 10]
+        assert bs.tell() == min(pos + 10, len(payload))
+
+    with pytest.raises(RuntimeError, match='past the end'):
+        bs.read(len(payload))
+    with pytest.raises(RuntimeError, match='both reading and writing'):
+        bs.write(b'test')
+
+
+def test10_block_zstream_errors():
+    # A regular zlib stream doesn't contain the block index
+    ms = MemoryStream()
+    zs = ZStream(ms)
+    zs.write(b'hello world')
+    zs.close()
+    ms.seek(0)
+    with pytest.raises(RuntimeError, match='block index'):
+        BlockZStream(ms).read(5)
+
+    # Empty streams remain valid
+    ms = MemoryStream()
+    BlockZStream(ms).write(b'')
+    ms.seek(0)
+    bs = BlockZStream(ms)
+    assert bs.size() == 0 and bs.block_count() == 0
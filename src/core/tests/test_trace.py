@@ -0,0 +1,56 @@
+import json
+import mitsuba as mi
+
+
+def test01_scene_load(variant_scalar_rgb, tmp_path):
+    mi.Trace.set_enabled(True)
+    assert mi.Trace.enabled()
+    assert mi.Trace.event_count() == 0
+
+    mi.load_string("""
+        <scene version="3.0.0">
+            <shape type="sphere" id="my_sphere">
+                <bsdf type="diffuse"/>
+            </shape>
+            <shape type="cube"/>
+        </scene>
+    """)
+
+    mi.Trace.set_enabled(False)
+    count = mi.Trace.event_count()
+    assert count > 0
+
+    trace = json.loads(mi.Trace.to_json())
+    events = [e for e in trace['traceEvents'] if e['ph'] == 'X']
+    assert len(events) == count
+
+    names = {e['name'] for e in events}
+    assert 'Parse XML string' in names
+    assert 'Instantiate scene' in names
+    assert 'Build acceleration structure' in names
+    assert {'scene', 'sphere', 'cube', 'diffuse'} <= names
+
+    for e in events:
+        assert e['dur'] >= 0
+        assert e['tid'] >= 1
+
+    sphere = [e for e in events if e['name'] == 'sphere'][0]
+    assert sphere['args']['detail'] == 'my_sphere'
+    assert sphere['cat'] == 'Instantiate'
+
+    # Every thread that recorded events is named
+    threads = {e['tid'] for e in events}
+    names = [e for e in trace['traceEvents'] if e['ph'] == 'M']
+    assert {e['tid'] for e in names} == threads
+
+    # Disabled: nothing is recorded
+    mi.load_dict({'type': 'sphere'})
+    assert mi.Trace.event_count() == count
+
+    filename = str(tmp_path / 'trace.json')
+    mi.Trace.write(filename)
+    with open(filename) as f:
+        assert json.load(f) == trace
+
+    mi.Trace.clear()
+    assert mi.Trace.event_count() == 0
@@ -0,0 +1,165 @@
+#include <mitsuba/core/trace.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/json.h>
+#include <mitsuba/core/logger.h>
+#include <nanothread/nanothread.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+NAMESPACE_BEGIN()
+
+struct TraceEvent {
+    const char *category;
+    std::string name;
+    std::string detail;
+    uint64_t start, end;
+};
+
+/// Events recorded by one thread
+struct TraceBuffer {
+    /// Only contended while the events are exported or cleared
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+    uint32_t tid;
+    /// Index of the thread in the nanothread pool (0: not a pool thread)
+    uint32_t pool_tid;
+};
+
+struct TraceRegistry {
+    std::mutex mutex;
+    std::atomic<bool> enabled { false };
+    /// Start of the recording (in nanoseconds, see \ref steady_time())
+    std::atomic<int64_t> epoch { 0 };
+
+    /* Buffers of all threads that have recorded an event. Shared with the
+       thread, since the events remain exportable after the thread exits */
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+};
+
+/// Constructed on first use, since events can be recorded during static initialization
+TraceRegistry &registry() {
+    static TraceRegistry *registry = new TraceRegistry();
+    return *registry;
+}
+
+TraceBuffer &thread_buffer() {
+    static thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (unlikely(!buffer)) {
+        TraceRegistry &r = registry();
+        buffer = std::make_shared<TraceBuffer>();
+        buffer->pool_tid = pool_thread_id();
+
+        std::lock_guard<std::mutex> guard(r.mutex);
+        buffer->tid = (uint32_t) r.buffers.size() + 1;
+        r.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+int64_t steady_time() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+NAMESPACE_END()
+
+void Trace::set_enabled(bool value) {
+    TraceRegistry &r = registry();
+    if (value && !r.enabled) {
+        clear();
+        r.epoch = steady_time();
+    }
+    r.enabled = value;
+}
+
+bool Trace::enabled() {
+    return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void Trace::clear() {
+    TraceRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    for (auto &buffer : r.buffers) {
+        std::lock_guard<std::mutex> guard2(buffer->mutex);
+        buffer->events.clear();
+    }
+}
+
+size_t Trace::event_count() {
+    TraceRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+    size_t count = 0;
+    for (auto &buffer : r.buffers) {
+        std::lock_guard<std::mutex> guard2(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+uint64_t Trace::now() {
+    return (uint64_t) (steady_time() - registry().epoch.load(std::memory_order_relaxed));
+}
+
+void Trace::record(const char *category, std::string_view name,
+                   std::string_view detail, uint64_t start, uint64_t end) {
+    if (!enabled())
+        return;
+    TraceBuffer &buffer = thread_buffer();
+    std::lock_guard<std::mutex> guard(buffer.mutex);
+    buffer.events.push_back(TraceEvent{ category, std::string(name),
+                                        std::string(detail), start, end });
+}
+
+std::string Trace::to_json() {
+    TraceRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.mutex);
+
+    std::ostringstream oss;
+    oss << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+
+    for (auto &buffer : r.buffers) {
+        std::lock_guard<std::mutex> guard2(buffer->mutex);
+        if (buffer->events.empty())
+            continue;
+
+        // Name the thread in the timeline
+        std::string thread_name = buffer->pool_tid > 0
+            ? tfm::format("Worker %u", buffer->pool_tid)
+            : tfm::format("Thread %u", buffer->tid);
+        oss << (first ? "" : ",") << std::endl
+            << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+            << buffer->tid << ", \"args\": {\"name\": " << json_string(thread_name) << "}}";
+        first = false;
+
+        // Timestamps are given in microseconds
+        for (const TraceEvent &event : buffer->events) {
+            oss << "," << std::endl
+                << "  {\"name\": " << json_string(event.name)
+                << ", \"cat\": " << json_string(event.category)
+                << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+                << tfm::format(", \"ts\": %.3f, \"dur\": %.3f",
+                               event.start * 1e-3, (event.end - event.start) * 1e-3);
+            if (!event.detail.empty())
+                oss << ", \"args\": {\"detail\": " << json_string(event.detail) << "}";
+            oss << "}";
+        }
+    }
+
+    oss << std::endl << "]}";
+    return oss.str();
+}
+
+void Trace::write(const fs::path &filename) {
+    ref<FileStream> stream = new FileStream(filename, FileStream::ETruncReadWrite);
+    stream->write_line(to_json());
+    Log(Info, "Wrote %zu trace events to \"%s\".", event_count(), filename.string());
+}
+
+NAMESPACE_END(mitsuba)
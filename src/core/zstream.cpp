@@ -1,4 +1,7 @@
 #include <mitsuba/core/zstream.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <cstring>
 #include <zlib.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -177,4 +180,471 @@ std::string ZStream::to_string() const {
     return oss.str();
 }
 
+// =======================================================================
+//! @{ \name BlockZStream
+// =======================================================================
+
+/// Identifier at the end of the block index
+static const char BlockZStreamMagic[4] = { 'M', 'I', 'B', 'Z' };
+
+/// Version of the block index
+static constexpr uint32_t BlockZStreamVersion = 1;
+
+/// Footer following the index: block count, payload size, version, identifier
+static constexpr size_t BlockZStreamFooterSize = 2 * sizeof(uint64_t) + sizeof(uint32_t) + 4;
+
+/// Size of an empty gzip member, excluding the data in its extra field
+static constexpr size_t GZipMemberOverhead = 10 + 2 + 4 + 2 + 8;
+
+/// Maximum amount of data stored in the extra field of a gzip member
+static constexpr size_t GZipMemberCapacity = 65520;
+
+/// Append an integer in little endian byte order to a buffer
+static void put_le(std::vector<uint8_t> &buf, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i)
+        buf.push_back((uint8_t) (value >> (8 * i)));
+}
+
+/// Decode an integer stored in little endian byte order
+static uint64_t get_le(const uint8_t *ptr, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i)
+        value |= (uint64_t) ptr[i] << (8 * i);
+    return value;
+}
+
+/**
+ * Append an empty gzip member that carries \c data (at most
+ * \ref GZipMemberCapacity bytes) in a subfield of its header. gzip readers
+ * skip the subfield and decompress the member to nothing.
+ */
+static void put_gzip_member(std::vector<uint8_t> &buf, const uint8_t *data,
+                            size_t size) {
+    // Header with the FEXTRA flag, followed by a single "MI" subfield
+    const uint8_t header[] = { 0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00,
+                               0x00, 0x00, 0x00, 0xff };
+    buf.insert(buf.end(), header, header + sizeof(header));
+    put_le(buf, size + 4, 2);
+    buf.push_back('M');
+    buf.push_back('I');
+    put_le(buf, size, 2);
+    buf.insert(buf.end(), data, data + size);
+
+    // Empty final block, followed by the CRC-32 and size of the empty data
+    buf.push_back(0x03);
+    buf.push_back(0x00);
+    put_le(buf, 0, 8);
+}
+
+/// Return the data of a member written by put_gzip_member()
+static const uint8_t *get_gzip_member(const uint8_t *ptr, size_t size) {
+    const uint8_t *data = ptr + 16;
+    if (ptr[0] != 0x1f || ptr[1] != 0x8b || ptr[2] != 0x08 || ptr[3] != 0x04 ||
+        get_le(ptr + 10, 2) != size + 4 || ptr[12] != 'M' || ptr[13] != 'I' ||
+        get_le(ptr + 14, 2) != size || data[size] != 0x03 ||
+        data[size + 1] != 0x00 || get_le(data + size + 2, 8) != 0)
+        Throw("BlockZStream: the block index is corrupt!");
+    return data;
+}
+
+BlockZStream::BlockZStream(Stream *child_stream, ZStream::EStreamType stream_type,
+                           int level, size_t block_size)
+    : m_child_stream(child_stream), m_stream_type(stream_type),
+      m_level(level), m_block_size(block_size) {
+    if (block_size == 0 || block_size > (1u << 30))
+        Throw("BlockZStream: the block size must be between 1 byte and 1 GiB!");
+    if (level < -1 || level > 9)
+        Throw("BlockZStream: invalid compression level %i!", level);
+
+    m_batch_size = std::max((size_t) pool_size(), (size_t) 1);
+    m_start = child_stream->tell();
+    m_checksum = stream_type == ZStream::EGZipStream ? crc32(0, Z_NULL, 0)
+                                                     : adler32(0, Z_NULL, 0);
+}
+
+BlockZStream::~BlockZStream() {
+    close();
+}
+
+void BlockZStream::set_mode(Mode mode) const {
+    if (m_mode == mode)
+        return;
+    if (m_mode != Mode::Undecided)
+        Throw("BlockZStream: a stream can't be used for both reading and writing!");
+    if (!m_child_stream)
+        Throw("BlockZStream: attempted to access a closed stream!");
+
+    if (mode == Mode::Read)
+        read_index();
+    m_mode = mode;
+}
+
+void BlockZStream::read_index() const {
+    size_t end = m_child_stream->size();
+    if (end < m_start + BlockZStreamFooterSize)
+        Throw("BlockZStream: the stream doesn't contain a block index!");
+
+    uint8_t tail[BlockZStreamFooterSize + GZipMemberOverhead];
+    m_child_stream->seek(end - BlockZStreamFooterSize);
+    m_child_stream->read(tail, BlockZStreamFooterSize);
+
+    /* The index of gzip streams is stored in empty members (see close()),
+       which end with eight zero bytes rather than the identifier */
+    bool members = memcmp(tail + BlockZStreamFooterSize - 4, BlockZStreamMagic, 4) != 0 &&
+                   end >= m_start + sizeof(tail);
+    const uint8_t *footer = tail;
+    if (members) {
+        m_child_stream->seek(end - sizeof(tail));
+        m_child_stream->read(tail, sizeof(tail));
+        footer = tail + GZipMemberOverhead;
+        if (tail[0] == 0x1f && tail[1] == 0x8b && tail[3] == 0x04 &&
+            get_le(tail + 10, 2) == BlockZStreamFooterSize + 4)
+            footer = get_gzip_member(tail, BlockZStreamFooterSize);
+    }
+
+    if (memcmp(footer + BlockZStreamFooterSize - 4, BlockZStreamMagic, 4) != 0)
+        Throw("BlockZStream: the stream doesn't contain a block index! (the "
+              "compressed payload must extend to the end of the child stream)");
+
+    uint64_t block_count  = get_le(footer, 8),
+             payload_size = get_le(footer + 8, 8);
+    uint32_t version      = (uint32_t) get_le(footer + 16, 4);
+
+    if (version != BlockZStreamVersion)
+        Throw("BlockZStream: unsupported index version %u!", version);
+    if (m_start + payload_size != end)
+        Throw("BlockZStream: the compressed payload must start at the current "
+              "position of the child stream and extend to its end!");
+
+    size_t index_size   = (block_count + 1) * 2 * sizeof(uint64_t),
+           member_count = members ? (index_size + GZipMemberCapacity - 1) /
+                                        GZipMemberCapacity : 0,
+           index_region = index_size + member_count * GZipMemberOverhead,
+           footer_region = BlockZStreamFooterSize + (members ? GZipMemberOverhead : 0);
+    if (block_count > payload_size || index_region + footer_region > payload_size)
+        Throw("BlockZStream: the block index is corrupt!");
+
+    std::unique_ptr<uint8_t[]> index(new uint8_t[index_region]);
+    m_child_stream->seek(end - footer_region - index_region);
+    m_child_stream->read(index.get(), index_region);
+
+    // Gather the pieces of the index from the members containing them
+    if (members) {
+        std::unique_ptr<uint8_t[]> packed(new uint8_t[index_size]);
+        const uint8_t *ptr = index.get();
+        for (size_t offset = 0; offset < index_size; offset += GZipMemberCapacity) {
+            size_t size = std::min(index_size - offset, GZipMemberCapacity);
+            memcpy(packed.get() + offset, get_gzip_member(ptr, size), size);
+            ptr += size + GZipMemberOverhead;
+        }
+        index = std::move(packed);
+    }
+
+    m_compressed_offsets.resize(block_count + 1);
+    m_uncompressed_offsets.resize(block_count + 1);
+    for (size_t i = 0; i <= block_count; ++i) {
+        m_compressed_offsets[i]   = get_le(index.get() + 16 * i, 8);
+        m_uncompressed_offsets[i] = get_le(index.get() + 16 * i + 8, 8);
+
+        if (i > 0 && (m_compressed_offsets[i] <= m_compressed_offsets[i - 1] ||
+                      m_uncompressed_offsets[i] <= m_uncompressed_offsets[i - 1]))
+            Throw("BlockZStream: the block index is corrupt!");
+    }
+
+    if (m_compressed_offsets[block_count] > payload_size - index_region - footer_region)
+        Throw("BlockZStream: the block index is corrupt!");
+}
+
+size_t BlockZStream::block_count() const {
+    if (m_mode == Mode::Read)
+        return m_compressed_offsets.size() - 1;
+    return m_compressed_offsets.size();
+}
+
+size_t BlockZStream::size() const {
+    /* Streams that haven't been accessed yet are assumed to be read from
+       when the child stream already contains data */
+    if (m_mode == Mode::Undecided && m_child_stream &&
+        m_child_stream->can_read() && m_child_stream->size() > m_start)
+        set_mode(Mode::Read);
+
+    if (m_mode == Mode::Read)
+        return m_uncompressed_offsets.back();
+    return m_pos;
+}
+
+void BlockZStream::write(const void *p, size_t size) {
+    set_mode(Mode::Write);
+
+    const uint8_t *ptr = (const uint8_t *) p;
+    size_t capacity = m_batch_size * m_block_size;
+
+    while (size > 0) {
+        size_t n = std::min(size, capacity - m_buffer.size());
+        m_buffer.insert(m_buffer.end(), ptr, ptr + n);
+        ptr += n;
+        size -= n;
+        m_pos += n;
+
+        // Wait for enough data to compress one block per thread
+        if (m_buffer.size() == capacity)
+            compress_buffer();
+    }
+}
+
+void BlockZStream::compress_buffer() {
+    bool gzip = m_stream_type == ZStream::EGZipStream;
+
+    // Write the zlib/gzip header before the first block
+    if (m_compressed_size == 0) {
+        std::vector<uint8_t> header;
+        if (gzip)
+            header = { 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+        else
+            header = { 0x78, 0x9c };
+        m_child_stream->write(header.data(), header.size());
+        m_compressed_size = header.size();
+    }
+
+    if (m_buffer.empty())
+        return;
+
+    size_t block_count = (m_buffer.size() + m_block_size - 1) / m_block_size;
+    std::vector<std::vector<uint8_t>> blocks(block_count);
+    std::vector<uint32_t> checksums(block_count);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, block_count, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                const uint8_t *data = m_buffer.data() + i * m_block_size;
+                size_t size = std::min(m_block_size, m_buffer.size() - i * m_block_size);
+
+                /* Compress each block with a separate raw deflate state. A
+                   full flush byte-aligns its end and resets the dictionary,
+                   so that the blocks can be concatenated and decompressed
+                   independently. */
+                z_stream zs { };
+                int retval = deflateInit2(&zs, m_level, Z_DEFLATED, -15, 8,
+                                          Z_DEFAULT_STRATEGY);
+                if (retval != Z_OK)
+                    Throw("Could not initialize ZLIB: error code %i", retval);
+
+                // Leave room for the flush marker
+                std::vector<uint8_t> &out = blocks[i];
+                out.resize(deflateBound(&zs, (uLong) size) + 16);
+
+                zs.next_in   = (Bytef *) data;
+                zs.avail_in  = (uInt) size;
+                zs.next_out  = out.data();
+                zs.avail_out = (uInt) out.size();
+
+                retval = deflate(&zs, Z_FULL_FLUSH);
+                deflateEnd(&zs);
+                if (retval != Z_OK || zs.avail_in != 0 || zs.avail_out == 0)
+                    Throw("deflate(): stream error!");
+                out.resize(out.size() - zs.avail_out);
+
+                checksums[i] = gzip ? crc32(0, data, (uInt) size)
+                                    : adler32(1, data, (uInt) size);
+            }
+        }
+    );
+
+    size_t uncompressed_offset = m_pos - m_buffer.size();
+    for (size_t i = 0; i < block_count; ++i) {
+        size_t size = std::min(m_block_size, m_buffer.size() - i * m_block_size);
+
+        m_compressed_offsets.push_back(m_compressed_size);
+        m_uncompressed_offsets.push_back(uncompressed_offset + i * m_block_size);
+        m_child_stream->write(blocks[i].data(), blocks[i].size());
+        m_compressed_size += blocks[i].size();
+
+        m_checksum = gzip ? crc32_combine(m_checksum, checksums[i], (z_off_t) size)
+                          : adler32_combine(m_checksum, checksums[i], (z_off_t) size);
+    }
+
+    m_buffer.clear();
+}
+
+void BlockZStream::flush() {
+    if (m_mode != Mode::Write || !m_child_stream)
+        return;
+    compress_buffer();
+    m_child_stream->flush();
+}
+
+void BlockZStream::close() {
+    if (!m_child_stream)
+        return;
+
+    if (m_mode == Mode::Write) {
+        compress_buffer();
+
+        std::vector<uint8_t> buf;
+        bool gzip = m_stream_type == ZStream::EGZipStream;
+
+        // Final (empty) block with fixed Huffman codes, which ends the stream
+        uint64_t data_end = m_compressed_size;
+        buf.push_back(0x03);
+        buf.push_back(0x00);
+
+        if (gzip) {
+            put_le(buf, m_checksum, 4);
+            put_le(buf, m_pos & 0xFFFFFFFFu, 4);
+        } else {
+            // The Adler-32 checksum is stored in big endian byte order
+            for (int i = 3; i >= 0; --i)
+                buf.push_back((uint8_t) (m_checksum >> (8 * i)));
+        }
+
+        // Index of the blocks, which is ignored by sequential readers
+        std::vector<uint8_t> index;
+        size_t block_count = m_compressed_offsets.size();
+        for (size_t i = 0; i < block_count; ++i) {
+            put_le(index, m_compressed_offsets[i], 8);
+            put_le(index, m_uncompressed_offsets[i], 8);
+        }
+        put_le(index, data_end, 8);
+        put_le(index, m_pos, 8);
+
+        /* zlib streams can't be extended, hence readers are expected to
+           ignore the data following them. gzip streams instead consist of
+           members: the index is stored in empty members, so that the
+           output remains a valid gzip file. */
+        if (gzip) {
+            for (size_t offset = 0; offset < index.size(); offset += GZipMemberCapacity)
+                put_gzip_member(buf, index.data() + offset,
+                                std::min(index.size() - offset, GZipMemberCapacity));
+        } else {
+            buf.insert(buf.end(), index.begin(), index.end());
+        }
+
+        std::vector<uint8_t> footer;
+        put_le(footer, block_count, 8);
+        put_le(footer, m_compressed_size + buf.size() + BlockZStreamFooterSize +
+                           (gzip ? GZipMemberOverhead : 0), 8);
+        put_le(footer, BlockZStreamVersion, 4);
+        footer.insert(footer.end(), BlockZStreamMagic, BlockZStreamMagic + 4);
+
+        if (gzip)
+            put_gzip_member(buf, footer.data(), footer.size());
+        else
+            buf.insert(buf.end(), footer.begin(), footer.end());
+
+        m_child_stream->write(buf.data(), buf.size());
+        m_child_stream->flush();
+    }
+
+    m_buffer.clear();
+    m_cache.clear();
+    m_child_stream = nullptr;
+}
+
+const std::vector<uint8_t> &BlockZStream::fetch_block(size_t index) {
+    if (index >= m_cache_start && index < m_cache_start + m_cache.size())
+        return m_cache[index - m_cache_start];
+
+    // Decompress this block and the following ones in parallel
+    size_t end = std::min(index + m_batch_size, block_count()),
+           offset = m_compressed_offsets[index],
+           size = m_compressed_offsets[end] - offset;
+
+    std::unique_ptr<uint8_t[]> compressed(new uint8_t[size]);
+    m_child_stream->seek(m_start + offset);
+    m_child_stream->read(compressed.get(), size);
+
+    std::vector<std::vector<uint8_t>> blocks(end - index);
+    dr::parallel_for(
+        dr::blocked_range<size_t>(index, end, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                std::vector<uint8_t> &out = blocks[i - index];
+                out.resize(m_uncompressed_offsets[i + 1] - m_uncompressed_offsets[i]);
+
+                z_stream zs { };
+                int retval = inflateInit2(&zs, -15);
+                if (retval != Z_OK)
+                    Throw("Could not initialize ZLIB: error code %i", retval);
+
+                zs.next_in   = compressed.get() + (m_compressed_offsets[i] - offset);
+                zs.avail_in  = (uInt) (m_compressed_offsets[i + 1] - m_compressed_offsets[i]);
+                zs.next_out  = out.data();
+                zs.avail_out = (uInt) out.size();
+
+                retval = inflate(&zs, Z_SYNC_FLUSH);
+                inflateEnd(&zs);
+                if ((retval != Z_OK && retval != Z_STREAM_END) || zs.avail_out != 0)
+                    Throw("inflate(): data error in block %zu!", i);
+            }
+        }
+    );
+
+    m_cache = std::move(blocks);
+    m_cache_start = index;
+    return m_cache[0];
+}
+
+void BlockZStream::read(void *p, size_t size) {
+    set_mode(Mode::Read);
+
+    size_t total_size = m_uncompressed_offsets.back();
+    if (m_pos + size > total_size)
+        Throw("read(): attempting to read past the end of the stream (%zu "
+              "bytes requested, %zu available)!", size,
+              total_size - std::min(m_pos, total_size));
+
+    uint8_t *ptr = (uint8_t *) p;
+    while (size > 0) {
+        // Find the block containing the current position
+        size_t block = std::upper_bound(m_uncompressed_offsets.begin(),
+                                        m_uncompressed_offsets.end(), m_pos) -
+                       m_uncompressed_offsets.begin() - 1;
+
+        const std::vector<uint8_t> &data = fetch_block(block);
+        size_t offset = m_pos - m_uncompressed_offsets[block],
+               n = std::min(size, data.size() - offset);
+
+        memcpy(ptr, data.data() + offset, n);
+        ptr += n;
+        size -= n;
+        m_pos += n;
+    }
+}
+
+void BlockZStream::seek(size_t pos) {
+    set_mode(Mode::Read);
+
+    if (pos > m_uncompressed_offsets.back())
+        Throw("seek(): position %zu is past the end of the stream (%zu bytes)!",
+              pos, m_uncompressed_offsets.back());
+    m_pos = pos;
+}
+
+std::string BlockZStream::to_string() const {
+    std::ostringstream oss;
+
+    oss << class_name() << "[" << std::endl;
+    if (is_closed()) {
+        oss << "  closed" << std::endl;
+    } else {
+        oss << "  child_stream = \"" << string::indent(m_child_stream) << "\"" << "," << std::endl
+            << "  host_byte_order = " << host_byte_order() << "," << std::endl
+            << "  byte_order = " << byte_order() << "," << std::endl
+            << "  can_read = " << can_read() << "," << std::endl
+            << "  can_write = " << can_write() << "," << std::endl
+            << "  pos = " << tell() << "," << std::endl
+            << "  size = " << (m_mode == Mode::Read ? m_uncompressed_offsets.back() : m_pos) << "," << std::endl
+            << "  block_size = " << m_block_size << "," << std::endl
+            << "  block_count = " << block_count() << std::endl;
+    }
+
+    oss << "]";
+
+    return oss.str();
+}
+
+//! @}
+// =======================================================================
+
 NAMESPACE_END(mitsuba)
@@ -3,6 +3,7 @@
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/medium.h>
+#include <mitsuba/render/mesh.h>
 #include <mitsuba/render/shape.h>
 #include <mitsuba/render/texture.h>
 #include <drjit/traversable_base.h>
@@ -23,6 +24,13 @@ Area light (:monosp:`area`)
    - Specifies the emitted radiance in units of power per unit area per unit steradian.
    - |exposed|, |differentiable|
 
+ * - triangle_sampling
+   - |bool|
+   - Only relevant for meshes with a spatially varying radiance. When set to
+     |true|, triangles are sampled proportionally to their area times their
+     average radiance (estimated when the mesh is loaded), rather than
+     importance sampling the radiance texture in UV space. (Default: |false|)
+
 This plugin implements an area light, i.e. a light source that emits
 diffuse illumination from the exterior of an arbitrary shape.
 Since the emission profile of an area light is completely diffuse, it
@@ -30,6 +38,14 @@ has the same apparent brightness regardless of the observer's viewing
 direction. Furthermore, since it occupies a nonzero amount of space, an
 area light generally causes scene objects to cast soft shadows.
 
+When the radiance is given by a texture, the emitter by default importance
+samples the texture and maps the result onto the shape using its UV
+parameterization. This ignores the geometry and requires a bijective
+parameterization. On textured meshes such as light panels or emissive screens,
+the :monosp:`triangle_sampling` option is often preferable: it instead builds a
+per-triangle table of the emitted power, which also makes direct illumination
+sampling account for the solid angle subtended by each triangle.
+
 To create an area light source, simply instantiate the desired
 emitter shape and specify an :monosp:`area` instance as its child:
 
@@ -60,7 +76,7 @@ template <typename Float, typename Spectrum>
 class AreaLight final : public Emitter<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Emitter, m_flags, m_shape, m_medium)
-    MI_IMPORT_TYPES(Scene, Shape, Texture)
+    MI_IMPORT_TYPES(Scene, Shape, Mesh, Texture)
 
     AreaLight(const Properties &props) : Base(props) {
         if (props.has_property("to_world"))
@@ -70,11 +86,28 @@ public:
 
         m_radiance = props.get_emissive_texture<Texture>("radiance", 1.f);
 
+        m_triangle_sampling = props.get<bool>("triangle_sampling", false);
+
         m_flags = +EmitterFlags::Surface;
         if (m_radiance->is_spatially_varying())
             m_flags |= +EmitterFlags::SpatiallyVarying;
     }
 
+    void set_shape(Shape *shape) override {
+        Base::set_shape(shape);
+
+        if (!m_triangle_sampling || !m_radiance->is_spatially_varying())
+            return;
+
+        if (shape->is_mesh()) {
+            static_cast<Mesh *>(shape)->set_radiance_sampling(true);
+        } else {
+            Log(Warn, "The 'triangle_sampling' option is only supported on "
+                      "meshes, ignoring it.");
+            m_triangle_sampling = false;
+        }
+    }
+
     void traverse(TraversalCallback *cb) override {
         Base::traverse(cb);
         cb->put("radiance", m_radiance, ParamFlags::Differentiable);
@@ -130,8 +163,8 @@ public:
         SurfaceInteraction3f si;
 
         // One of two very different strategies is used depending on 'm_radiance'
-        if (likely(!m_radiance->is_spatially_varying())) {
-            // Texture is uniform, try to importance sample the shape wrt. solid angle at 'it'
+        if (likely(!sample_texture())) {
+            // Use the shape's sampling strategy and convert to solid angle at 'it'
             ds = m_shape->sample_direction(it, sample, active);
             active &= dr::dot(ds.d, ds.n) < 0.f && (ds.pdf != 0.f);
 
@@ -182,7 +215,7 @@ public:
         }
 
         Float value;
-        if (!m_radiance->is_spatially_varying()) {
+        if (!sample_texture()) {
             value = m_shape->pdf_direction(it, ds, active);
         } else {
             // This surface intersection would be nice to avoid..
@@ -223,8 +256,8 @@ public:
 
         // Two strategies to sample the spatial component based on 'm_radiance'
         PositionSample3f ps;
-        if (!m_radiance->is_spatially_varying()) {
-            // Radiance not spatially varying, use area-based sampling of shape
+        if (!sample_texture()) {
+            // Use the shape's (area- or power-based) sampling strategy
             ps = m_shape->sample_position(time, sample, active);
         } else {
             // Importance sample texture
@@ -268,8 +301,15 @@ public:
     }
 
     MI_DECLARE_CLASS(AreaLight)
+private:
+    /// Should positions be sampled by importance sampling the radiance texture?
+    bool sample_texture() const {
+        return m_radiance->is_spatially_varying() && !m_triangle_sampling;
+    }
+
 private:
     ref<Texture> m_radiance;
+    bool m_triangle_sampling;
 
     MI_TRAVERSE_CB(Base, m_radiance)
 };
@@ -1,8 +1,11 @@
+#include <mitsuba/core/asset.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/bsphere.h>
 #include <mitsuba/core/distr_2d.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/texture.h>
@@ -107,12 +110,23 @@ public:
     using PixelData = dr::Array<Float, is_spectral_v<Spectrum> ? 4 : 3>;
     using ScalarPixelData = dr::Array<ScalarFloat, is_spectral_v<Spectrum> ? 4 : 3>;
 
+    /// Converted contents of an image file (see \ref AssetRegistry)
+    struct Asset {
+        TensorXf data;
+        /// Luminance image used for importance sampling
+        std::unique_ptr<ScalarFloat[]> luminance;
+        ScalarVector2u res;
+        /// Accounts for the data once, however many emitters share it
+        MemoryTracker memory { MemoryCategory::Emitters };
+    };
+
     EnvironmentMapEmitter(const Properties &props) : Base(props) {
         /* Until `set_scene` is called, we have no information
            about the scene and default to the unit bounding sphere. */
         m_bsphere = BoundingSphere3f(ScalarPoint3f(0.f), 1.f);
 
-        ref<Bitmap> bitmap;
+        bool mis_compensation = props.get<bool>("mis_compensation", false);
+        std::shared_ptr<const Asset> asset;
 
         if (props.has_property("bitmap")) {
             // Creates a Bitmap texture directly from an existing Bitmap object
@@ -123,115 +137,37 @@ public:
             Bitmap *b = dynamic_cast<Bitmap *>(other.get());
             if (!b)
                 Throw("Property \"bitmap\" must be a Bitmap instance.");
-            bitmap = b;
+            asset = convert(b, mis_compensation);
         } else {
             FileResolver *fs = file_resolver();
             fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
             m_filename = file_path.filename().string();
-            bitmap = new Bitmap(file_path);
-        }
-
-        if (bitmap->width() < 2 || bitmap->height() < 3)
-            Throw("\"%s\": the environment map resolution must be at least "
-                  "2x3 pixels", (m_filename.empty() ? "<Bitmap>" : m_filename));
-
-        /* Convert to linear RGBA float bitmap, will undergo further
-           conversion into coefficients of a spectral upsampling model below */
-        Bitmap::PixelFormat pixel_format = Bitmap::PixelFormat::RGB;
-        if constexpr (is_spectral_v<Spectrum>)
-            pixel_format = Bitmap::PixelFormat::RGBA;
-        bitmap = bitmap->convert(pixel_format, struct_type_v<Float>, false);
-
-        /* Allocate a larger image including an extra column to
-           account for the periodic boundary */
-        ScalarVector2u res(bitmap->width() + 1, bitmap->height());
-        ref<Bitmap> bitmap_2 = new Bitmap(bitmap->pixel_format(),
-                                          bitmap->component_format(), res);
-
-        // Luminance image used for importance sampling
-        std::unique_ptr<ScalarFloat[]> luminance_data(new ScalarFloat[dr::prod(res)]);
-
-        ScalarFloat *in_ptr  = (ScalarFloat *) bitmap->data(),
-                    *out_ptr = (ScalarFloat *) bitmap_2->data(),
-                    *lum_ptr = (ScalarFloat *) luminance_data.get();
-
-        ScalarFloat theta_scale = 1.f / (bitmap->size().y() - 1) * dr::Pi<Float>;
-
-        /* "MIS Compensation: Optimizing Sampling Techniques in Multiple
-           Importance Sampling" Ondrej Karlik, Martin Sik, Petr Vivoda, Tomas
-           Skrivan, and Jaroslav Krivanek. SIGGRAPH Asia 2019 */
-        ScalarFloat luminance_offset = 0.f;
-        if (props.get<bool>("mis_compensation", false)) {
-            ScalarFloat min_lum = 0.f;
-            double lum_accum_d = 0.0;
-
-            for (size_t y = 0; y < bitmap->size().y(); ++y) {
-                for (size_t x = 0; x < bitmap->size().x(); ++x) {
-                    ScalarColor3f rgb = dr::load<ScalarVector3f>(in_ptr);
-                    ScalarFloat lum = luminance(rgb);
-                    min_lum = dr::minimum(min_lum, lum);
-                    lum_accum_d += (double) lum;
-                    in_ptr += 4;
-                }
-            }
-            in_ptr = (ScalarFloat *) bitmap->data();
-
-            luminance_offset = ScalarFloat(lum_accum_d / dr::prod(bitmap->size()));
-
-            /* Be wary of constant environment maps: average and minimum
-               should be sufficiently different */
-            if (luminance_offset - min_lum <= 0.01f * luminance_offset)
-                luminance_offset = 0.f; // disable
-        }
 
-        size_t pixel_width = is_spectral_v<Spectrum> ? 4 : 3;
-        for (size_t y = 0; y < bitmap->size().y(); ++y) {
-            ScalarFloat sin_theta = dr::sin(y * theta_scale);
-
-            for (size_t x = 0; x < bitmap->size().x(); ++x) {
-                ScalarColor3f rgb = dr::load<ScalarVector3f>(in_ptr);
-
-                ScalarFloat lum = luminance(rgb);
-
-                ScalarPixelData coeff;
-                if constexpr (is_monochromatic_v<Spectrum>) {
-                    coeff = ScalarPixelData(lum);
-                } else if constexpr (is_rgb_v<Spectrum>) {
-                    coeff = rgb;
-                } else {
-                    static_assert(is_spectral_v<Spectrum>);
-                    /* Evaluate the spectral upsampling model. This requires a
-                       reflectance value (colors in [0, 1]) which is accomplished here by
-                       scaling. We use a color where the highest component is 50%,
-                       which generally yields a fairly smooth spectrum. */
-                    ScalarFloat scale = dr::max(rgb) * 2.f;
-                    ScalarColor3f rgb_norm = rgb / dr::maximum(1e-8f, scale);
-                    coeff = dr::concat((ScalarColor3f) srgb_model_fetch(rgb_norm),
-                                       dr::Array<ScalarFloat, 1>(scale));
-                }
-
-                lum = dr::maximum(lum - luminance_offset, 0.f);
-
-                *lum_ptr++ = lum * sin_theta;
-                dr::store(out_ptr, coeff);
-                in_ptr += pixel_width;
-                out_ptr += pixel_width;
-            }
-
-            // Last column of pixels mirrors first
-            ScalarFloat temp = *(lum_ptr - bitmap->size().x());
-            *lum_ptr++ = temp;
-            dr::store(out_ptr, dr::load<ScalarPixelData>(
-                                   out_ptr - bitmap->size().x() * pixel_width));
-            out_ptr += pixel_width;
+            // Emitters loading the same file with the same settings share their data
+            std::string key = tfm::format("envmap:%s:%s:mis_compensation=%i",
+                                          Base::Variant, AssetRegistry::file_key(file_path),
+                                          (int) mis_compensation);
+            asset = AssetRegistry::get<Asset>(key, [&]() {
+                std::shared_ptr<Asset> result =
+                    convert(FilePrefetcher::load_bitmap(file_path), mis_compensation);
+                size_t size = result->data.array().size() * sizeof(ScalarFloat) +
+                              dr::prod(result->res) * sizeof(ScalarFloat);
+                // Only JIT variants share the storage (see below)
+                if constexpr (dr::is_jit_v<Float>)
+                    result->memory.set(size, m_filename);
+                return std::make_pair(result, size);
+            });
         }
 
-        size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), pixel_width };
-        m_data = TensorXf(bitmap_2->data(), 3, shape);
+        // In JIT variants, this shares the underlying storage with the asset
+        m_data = asset->data;
+        if constexpr (dr::is_jit_v<Float>)
+            m_asset = asset;
 
         m_scale = props.get<ScalarFloat>("scale", 1.f);
-        m_warp = Warp(luminance_data.get(), res);
+        m_warp = Warp(asset->luminance.get(), asset->res);
         m_d65 = Texture::D65(1.f);
+        m_memory.set(memory_usage(), std::string(props.id()));
         m_flags = EmitterFlags::Infinite | EmitterFlags::SpatiallyVarying;
     }
 
@@ -244,6 +180,8 @@ public:
 
     void parameters_changed(const std::vector<std::string> &keys = {}) override {
         if (keys.empty() || string::contains(keys, "data")) {
+            // The data may have been replaced, stop attributing it to the asset
+            m_asset.reset();
             if (m_data.ndim() != 3)
                     Throw("Environment map data has dimension %lu, expected 3", m_data.ndim());
 
@@ -330,6 +268,7 @@ public:
             }
 
             m_warp = Warp(luminance_data.get(), res);
+            m_memory.set(memory_usage());
         }
         Base::parameters_changed(keys);
     }
@@ -587,12 +526,131 @@ protected:
 
     MI_DECLARE_CLASS(EnvironmentMapEmitter)
 protected:
+    /// Convert an image into the stored representation and luminance map
+    std::shared_ptr<Asset> convert(ref<Bitmap> bitmap, bool mis_compensation) const {
+        auto asset = std::make_shared<Asset>();
+
+        if (bitmap->width() < 2 || bitmap->height() < 3)
+            Throw("\"%s\": the environment map resolution must be at least "
+                  "2x3 pixels", (m_filename.empty() ? "<Bitmap>" : m_filename));
+
+        /* Convert to linear RGBA float bitmap, will undergo further
+           conversion into coefficients of a spectral upsampling model below */
+        Bitmap::PixelFormat pixel_format = Bitmap::PixelFormat::RGB;
+        if constexpr (is_spectral_v<Spectrum>)
+            pixel_format = Bitmap::PixelFormat::RGBA;
+        bitmap = bitmap->convert(pixel_format, struct_type_v<Float>, false);
+
+        /* Allocate a larger image including an extra column to
+           account for the periodic boundary */
+        ScalarVector2u res(bitmap->width() + 1, bitmap->height());
+        ref<Bitmap> bitmap_2 = new Bitmap(bitmap->pixel_format(),
+                                          bitmap->component_format(), res);
+
+        // Luminance image used for importance sampling
+        std::unique_ptr<ScalarFloat[]> luminance_data(new ScalarFloat[dr::prod(res)]);
+
+        ScalarFloat *in_ptr  = (ScalarFloat *) bitmap->data(),
+                    *out_ptr = (ScalarFloat *) bitmap_2->data(),
+                    *lum_ptr = (ScalarFloat *) luminance_data.get();
+
+        ScalarFloat theta_scale = 1.f / (bitmap->size().y() - 1) * dr::Pi<Float>;
+
+        /* "MIS Compensation: Optimizing Sampling Techniques in Multiple
+           Importance Sampling" Ondrej Karlik, Martin Sik, Petr Vivoda, Tomas
+           Skrivan, and Jaroslav Krivanek. SIGGRAPH Asia 2019 */
+        ScalarFloat luminance_offset = 0.f;
+        if (mis_compensation) {
+            ScalarFloat min_lum = 0.f;
+            double lum_accum_d = 0.0;
+
+            for (size_t y = 0; y < bitmap->size().y(); ++y) {
+                for (size_t x = 0; x < bitmap->size().x(); ++x) {
+                    ScalarColor3f rgb = dr::load<ScalarVector3f>(in_ptr);
+                    ScalarFloat lum = luminance(rgb);
+                    min_lum = dr::minimum(min_lum, lum);
+                    lum_accum_d += (double) lum;
+                    in_ptr += 4;
+                }
+            }
+            in_ptr = (ScalarFloat *) bitmap->data();
+
+            luminance_offset = ScalarFloat(lum_accum_d / dr::prod(bitmap->size()));
+
+            /* Be wary of constant environment maps: average and minimum
+               should be sufficiently different */
+            if (luminance_offset - min_lum <= 0.01f * luminance_offset)
+                luminance_offset = 0.f; // disable
+        }
+
+        size_t pixel_width = is_spectral_v<Spectrum> ? 4 : 3;
+        for (size_t y = 0; y < bitmap->size().y(); ++y) {
+            ScalarFloat sin_theta = dr::sin(y * theta_scale);
+
+            for (size_t x = 0; x < bitmap->size().x(); ++x) {
+                ScalarColor3f rgb = dr::load<ScalarVector3f>(in_ptr);
+
+                ScalarFloat lum = luminance(rgb);
+
+                ScalarPixelData coeff;
+                if constexpr (is_monochromatic_v<Spectrum>) {
+                    coeff = ScalarPixelData(lum);
+                } else if constexpr (is_rgb_v<Spectrum>) {
+                    coeff = rgb;
+                } else {
+                    static_assert(is_spectral_v<Spectrum>);
+                    /* Evaluate the spectral upsampling model. This requires a
+                       reflectance value (colors in [0, 1]) which is accomplished here by
+                       scaling. We use a color where the highest component is 50%,
+                       which generally yields a fairly smooth spectrum. */
+                    ScalarFloat scale = dr::max(rgb) * 2.f;
+                    ScalarColor3f rgb_norm = rgb / dr::maximum(1e-8f, scale);
+                    coeff = dr::concat((ScalarColor3f) srgb_model_fetch(rgb_norm),
+                                       dr::Array<ScalarFloat, 1>(scale));
+                }
+
+                lum = dr::maximum(lum - luminance_offset, 0.f);
+
+                *lum_ptr++ = lum * sin_theta;
+                dr::store(out_ptr, coeff);
+                in_ptr += pixel_width;
+                out_ptr += pixel_width;
+            }
+
+            // Last column of pixels mirrors first
+            ScalarFloat temp = *(lum_ptr - bitmap->size().x());
+            *lum_ptr++ = temp;
+            dr::store(out_ptr, dr::load<ScalarPixelData>(
+                                   out_ptr - bitmap->size().x() * pixel_width));
+            out_ptr += pixel_width;
+        }
+
+        size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), pixel_width };
+        asset->data = TensorXf(bitmap_2->data(), 3, shape);
+        asset->luminance = std::move(luminance_data);
+        asset->res = res;
+        return asset;
+    }
+
+protected:
+    /**
+     * Size of the radiance data and of the luminance sampling table in bytes.
+     * Shared radiance data is accounted for by the asset instead.
+     */
+    size_t memory_usage() const {
+        size_t pixels = m_data.shape(0) * m_data.shape(1);
+        return pixels * ((m_asset ? 0 : m_data.shape(2)) + 1) * sizeof(ScalarFloat);
+    }
+
     std::string m_filename;
     BoundingSphere3f m_bsphere;
     TensorXf m_data;
     Warp m_warp;
     ref<Texture> m_d65;
     Float m_scale;
+    /// Data shared with other emitters (see \ref AssetRegistry)
+    std::shared_ptr<const Asset> m_asset;
+    MemoryTracker m_memory { MemoryCategory::Emitters };
 
     MI_TRAVERSE_CB(Base, m_bsphere, m_data, m_warp, m_d65, m_scale)
 };
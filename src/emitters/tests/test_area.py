@@ -138,3 +138,61 @@ def test05_shape_accessors(variants_vec_rgb):
 
     assert type(emitter.get_shape()) == mi.Mesh
     assert type(emitter_ptr.get_shape()) == mi.ShapePtr
+
+
+def create_textured_cube(triangle_sampling):
+    return mi.load_dict({
+        'type': 'cube',
+        'emitter': {
+            'type': 'area',
+            'triangle_sampling': triangle_sampling,
+            'radiance': {
+                'type': 'checkerboard',
+                'color0': 0.0,
+                'color1': 4.0,
+            }
+        }
+    })
+
+
+def test06_triangle_sampling(variants_vec_rgb):
+    # Power-weighted triangle sampling must be consistent with pdf_direction()
+    # and estimate the same quantity as UV-space texture sampling
+    shape = create_textured_cube(True)
+    emitter = shape.emitter()
+    assert shape.radiance_sampling()
+
+    n = 100000
+    it = dr.zeros(mi.SurfaceInteraction3f, n)
+    it.p = [0.3, 0.5, 4.0]
+    it.wavelengths = dr.zeros(mi.Wavelength, n)
+
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+    ds, res = emitter.sample_direction(it, sampler.next_2d())
+
+    valid = ds.pdf > 0
+    assert dr.allclose(dr.select(valid, emitter.pdf_direction(it, ds), 0),
+                       dr.select(valid, ds.pdf, 0), rtol=1e-4)
+
+    # Reconstruct the records by tracing rays, as integrators do for MIS
+    scene = mi.load_dict({'type': 'scene', 'cube': shape})
+    si = scene.ray_intersect(it.spawn_ray(ds.d))
+    ds2 = mi.DirectionSample3f(scene, si, it)
+    assert dr.all((si.prim_index == ds.prim_index) | ~valid | ~si.is_valid())
+    assert dr.allclose(dr.select(valid & si.is_valid(), emitter.pdf_direction(it, ds2), 0),
+                       dr.select(valid & si.is_valid(), ds.pdf, 0), rtol=1e-3)
+
+    # Compare against the default strategy
+    emitter_ref = create_textured_cube(False).emitter()
+    _, res_ref = emitter_ref.sample_direction(it, sampler.next_2d())
+    assert dr.allclose(dr.mean(res, axis=None), dr.mean(res_ref, axis=None), rtol=5e-2)
+
+
+def test07_triangle_sampling_uniform(variants_vec_rgb):
+    # Without a spatially varying radiance, the option has no effect
+    shape = mi.load_dict({
+        'type': 'cube',
+        'emitter': { 'type': 'area', 'triangle_sampling': True }
+    })
+    assert not shape.radiance_sampling()
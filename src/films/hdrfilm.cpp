@@ -1,6 +1,7 @@
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/render/film.h>
@@ -19,7 +20,7 @@ High dynamic range film (:monosp:`hdrfilm`)
 -------------------------------------------
 
 .. pluginparameters::
- :extra-rows: 8
+ :extra-rows: 9
 
  * - width, height
    - |int|
@@ -64,6 +65,15 @@ High dynamic range film (:monosp:`hdrfilm`)
      in JIT variants and can make sample accumulation quite a bit more expensive.
      (Default: |false|, i.e. disabled)
 
+ * - raw
+   - |bool|
+   - If set to |true|, the film writes the accumulated (unnormalized) channel
+     values along with the weight channel :monosp:`W` instead of the developed
+     image. Such partial renders of the same scene (e.g. rendered with different
+     seeds on several machines) can be combined with ``mitsuba --merge``. This
+     implies :monosp:`file_format=openexr` and :monosp:`component_format=float32`.
+     (Default: |false|, i.e. disabled)
+
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -225,6 +235,16 @@ public:
         }
 
         m_compensate = props.get<bool>("compensate", false);
+        m_raw = props.get<bool>("raw", false);
+
+        if (m_raw) {
+            // Raw output must preserve the accumulated values and weights
+            if (m_file_format != Bitmap::FileFormat::OpenEXR) {
+                Log(Warn, "Raw film output requires the OpenEXR format. Overriding..");
+                m_file_format = Bitmap::FileFormat::OpenEXR;
+            }
+            m_component_format = Struct::Type::Float32;
+        }
 
         props.mark_queried("banner"); // no banner in Mitsuba 3
     }
@@ -264,6 +284,8 @@ public:
             m_storage = new ImageBlock(m_crop_size, m_crop_offset,
                                        (uint32_t) channels.size());
             m_channels = channels;
+            m_memory.set(m_storage->tensor().array().size() * sizeof(ScalarFloat),
+                         std::string(id()));
         }
 
         std::sort(channels.begin(), channels.end());
@@ -442,8 +464,9 @@ public:
             source_fmt, struct_type_v<ScalarFloat>, m_storage->size(),
             m_storage->channel_count(), m_channels, (uint8_t *) storage.data());
 
+        // Copy, since 'source' references the (possibly temporary) storage
         if (raw)
-            return source;
+            return new Bitmap(*source);
 
         bool to_rgb    = m_pixel_format == Bitmap::PixelFormat::RGB ||
                          m_pixel_format == Bitmap::PixelFormat::RGBA;
@@ -546,6 +569,15 @@ public:
     }
 
     void write(const fs::path &path) const override {
+        write_impl(path, false);
+    }
+
+    void write_async(const fs::path &path) const override {
+        write_impl(path, true);
+    }
+
+    /// Develop the film and write it to disk, optionally on a different thread
+    void write_impl(const fs::path &path, bool async) const {
         fs::path filename = path;
         std::string proper_extension;
         if (m_file_format == Bitmap::FileFormat::OpenEXR)
@@ -565,7 +597,7 @@ public:
             Log(Info, "Developing \"%s\" ..", filename.string());
         #endif
 
-        ref<Bitmap> source = bitmap();
+        ref<Bitmap> source = bitmap(m_raw);
         if (m_component_format != struct_type_v<ScalarFloat>) {
             // Mismatch between the current format and the one expected by the film
             // Conversion is necessary before saving to disk
@@ -579,11 +611,13 @@ public:
                 source->channel_count(),
                 channel_names);
             source->convert(target);
+            source = target;
+        }
 
-            target->write(filename, m_file_format);
-        } else {
+        if (async)
+            source->write_async(filename, m_file_format);
+        else
             source->write(filename, m_file_format);
-        }
     }
 
     void schedule_storage() override {
@@ -598,6 +632,7 @@ public:
             << "  crop_offset = " << m_crop_offset << "," << std::endl
             << "  sample_border = " << m_sample_border << "," << std::endl
             << "  compensate = " << m_compensate << "," << std::endl
+            << "  raw = " << m_raw << "," << std::endl
             << "  filter = " << m_filter << "," << std::endl
             << "  file_format = " << m_file_format << "," << std::endl
             << "  pixel_format = " << m_pixel_format << "," << std::endl
@@ -612,9 +647,11 @@ protected:
     Bitmap::PixelFormat m_pixel_format;
     Struct::Type m_component_format;
     bool m_compensate;
+    bool m_raw;
     ref<ImageBlock> m_storage;
     mutable std::mutex m_mutex;
     std::vector<std::string> m_channels;
+    MemoryTracker m_memory { MemoryCategory::Film };
 
     MI_TRAVERSE_CB(Base, m_storage)
 };
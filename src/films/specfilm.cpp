@@ -426,6 +426,15 @@ public:
     }
 
     void write(const fs::path &path) const override {
+        write_impl(path, false);
+    }
+
+    void write_async(const fs::path &path) const override {
+        write_impl(path, true);
+    }
+
+    /// Develop the film and write it to disk, optionally on a different thread
+    void write_impl(const fs::path &path, bool async) const {
         fs::path filename = path;
         std::string proper_extension = ".exr";
 
@@ -453,11 +462,13 @@ public:
                 source->channel_count(),
                 channel_names);
             source->convert(target);
+            source = target;
+        }
 
-            target->write(filename, m_file_format);
-        } else {
+        if (async)
+            source->write_async(filename, m_file_format);
+        else
             source->write(filename, m_file_format);
-        }
     }
 
     void schedule_storage() override {
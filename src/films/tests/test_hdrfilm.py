@@ -236,3 +236,59 @@ def test07_luminance_alpha_mono(variants_all):
     image = mi.TensorXf(film.bitmap())
 
     assert image.shape[2] == 2
+
+
+def test08_write_async(variants_all_rgb, tmpdir):
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 16,
+        'height': 8,
+        'component_format': 'float32',
+        'filter': {'type': 'box'}
+    })
+    film.prepare([])
+
+    block = film.create_block()
+    block.put(mi.Point2f(4.5, 2.5), [1.0, 2.0, 3.0, 1.0])
+    film.put_block(block)
+
+    filename = str(tmpdir.join('test_image.exr'))
+    film.write_async(filename)
+
+    # The film was developed before returning and can be reused right away
+    film.clear()
+    mi.Thread.wait_for_tasks()
+
+    img = mi.TensorXf(mi.Bitmap(filename))
+    assert dr.allclose(img[2, 4, :3], [1.0, 2.0, 3.0])
+    assert dr.allclose(dr.sum(img[:, :, :3], axis=None), 6.0)
+
+
+def test09_raw_output(variant_scalar_rgb, tmpdir):
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 16,
+        'height': 8,
+        'raw': True,
+        'filter': {'type': 'box'}
+    })
+    film.prepare([])
+
+    block = film.create_block()
+    block.put(mi.Point2f(4.5, 2.5), [1.0, 2.0, 3.0, 1.0])
+    block.put(mi.Point2f(4.5, 2.5), [3.0, 2.0, 1.0, 1.0])
+    film.put_block(block)
+
+    filename = str(tmpdir.join('test_image.exr'))
+    film.write(filename)
+
+    # Accumulated values are stored along with the weight channel
+    bmp = mi.Bitmap(filename)
+    assert bmp.component_format() == mi.Struct.Type.Float32
+    names = [bmp.struct_()[i].name for i in range(bmp.channel_count())]
+    assert sorted(names) == ['B', 'G', 'R', 'W']
+
+    img = mi.TensorXf(bmp)
+    pixel = {name: img[2, 4, i] for i, name in enumerate(names)}
+    assert dr.allclose([pixel['R'], pixel['G'], pixel['B'], pixel['W']],
+                       [4.0, 4.0, 4.0, 2.0])
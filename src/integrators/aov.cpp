@@ -1,7 +1,9 @@
+#include <mitsuba/core/statistics.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/sensor.h>
+#include <chrono>
 #include <unordered_map>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -74,6 +76,12 @@ Currently, the following AOVs types are available:
     - :monosp:`duv_dx`, :monosp:`duv_dy`: UV partials wrt. changes in screen-space.
     - :monosp:`prim_index`: Primitive index (e.g. triangle index in the mesh).
     - :monosp:`shape_index`: Shape index.
+    - :monosp:`cost_time`: Time spent by the nested integrators (in microseconds).
+    - :monosp:`cost_rays`: Number of rays traced by the nested integrators.
+    - :monosp:`cost_vertices`: Number of surface interactions (path vertices)
+      found by the nested integrators.
+    - :monosp:`cost_kd_nodes`: Number of kd-tree nodes visited by the nested
+      integrators (only when the scene uses Mitsuba's kd-tree instead of Embree).
 
 Note that integer-valued AOVs (e.g. :monosp:`prim_index`, :monosp:`shape_index`)
 are meaningless whenever there is only partial pixel coverage or when using a
@@ -82,6 +90,29 @@ wide pixel reconstruction filter as it will result in fractional values.
 The :monosp:`albedo` AOV will evaluate the diffuse reflectance
 (\ref BSDF::eval_diffuse_reflectance) of the material. Note that depending on
 the material, this value might only be an approximation.
+
+The render cost AOVs (:monosp:`cost_*`) produce heatmaps that reveal where the
+nested integrators spend their time, e.g. in regions with deep glass, hair or
+dense participating media. Each pixel stores the average cost of its samples
+when the film uses a :monosp:`box` reconstruction filter. These AOVs are only
+available in scalar variants, since a JIT variant traces the computation of all
+samples at once.
+
+.. tabs::
+    .. code-tab:: xml
+
+        <integrator type="aov">
+            <string name="aovs" value="time:cost_time,rays:cost_rays"/>
+            <integrator type="path" name="image"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'aov',
+        'aovs': 'time:cost_time,rays:cost_rays',
+        'image': {
+            'type': 'path',
+        }
  */
 
 template <typename Float, typename Spectrum>
@@ -103,6 +134,10 @@ public:
         dUVdy,
         PrimIndex,
         ShapeIndex,
+        CostTime,
+        CostRays,
+        CostVertices,
+        CostKDNodes,
         IntegratorRGBA
     };
 
@@ -191,13 +226,41 @@ public:
             } else if (item[1] == "shape_index") {
                 m_aov_types.push_back(AOVType::ShapeIndex);
                 m_aov_names.push_back(item[0] + ".I");
+            } else if (item[1] == "cost_time") {
+                m_aov_types.push_back(AOVType::CostTime);
+                m_aov_names.push_back(item[0] + ".T");
+            } else if (item[1] == "cost_rays") {
+                m_aov_types.push_back(AOVType::CostRays);
+                m_aov_names.push_back(item[0] + ".N");
+            } else if (item[1] == "cost_vertices") {
+                m_aov_types.push_back(AOVType::CostVertices);
+                m_aov_names.push_back(item[0] + ".N");
+            } else if (item[1] == "cost_kd_nodes") {
+                m_aov_types.push_back(AOVType::CostKDNodes);
+                m_aov_names.push_back(item[0] + ".N");
             } else {
                 Throw("Invalid AOV type \"%s\"!", item[1]);
             }
+
+            if (item[1].rfind("cost_", 0) == 0) {
+                if constexpr (dr::is_jit_v<Float>)
+                    Throw("The render cost AOV \"%s\" is only supported in "
+                          "scalar variants!", item[1]);
+                m_cost_aovs = true;
+            }
         }
 
         if (m_aov_names.empty())
             Log(Warn, "No AOVs were specified!");
+
+        // Rays are only tallied while some integrator reports their cost
+        if (m_cost_aovs)
+            work_counters_users++;
+    }
+
+    ~AOVIntegrator() {
+        if (m_cost_aovs)
+            work_counters_users--;
     }
 
     std::pair<Spectrum, Mask> sample(const Scene *scene,
@@ -243,6 +306,10 @@ public:
         Float* aovs_rgba_integrator = _aovs;
         Float* aovs = _aovs + m_integrator_aovs_count;
 
+        // Work done by the nested integrators, reported by the cost AOVs
+        WorkCounters cost;
+        double cost_time = 0.0;
+
         size_t inner_idx = 0;
         for (size_t i = 0; i < m_aov_types.size(); ++i) {
             switch (m_aov_types[i]) {
@@ -343,11 +410,44 @@ public:
                     }
                     break;
 
+                case AOVType::CostTime:
+                    *aovs++ = Float((ScalarFloat) cost_time);
+                    break;
+
+                case AOVType::CostRays:
+                    *aovs++ = Float((ScalarFloat) cost.rays);
+                    break;
+
+                case AOVType::CostVertices:
+                    *aovs++ = Float((ScalarFloat) cost.vertices);
+                    break;
+
+                case AOVType::CostKDNodes:
+                    *aovs++ = Float((ScalarFloat) cost.kd_nodes);
+                    break;
+
                 case AOVType::IntegratorRGBA: {
+                    WorkCounters work_before;
+                    std::chrono::steady_clock::time_point start;
+                    if (m_cost_aovs) {
+                        work_before = work_counters();
+                        start = std::chrono::steady_clock::now();
+                    }
+
                     auto [inner_spec, inner_mask] 
                         = m_integrators[inner_idx]->sample(scene, sampler, ray, medium, aovs, active);
                     dr::disable_grad(inner_spec);
 
+                    if (m_cost_aovs) {
+                        std::chrono::duration<double, std::micro> elapsed =
+                            std::chrono::steady_clock::now() - start;
+                        const WorkCounters &work = work_counters();
+                        cost_time     += elapsed.count();
+                        cost.rays     += work.rays - work_before.rays;
+                        cost.vertices += work.vertices - work_before.vertices;
+                        cost.kd_nodes += work.kd_nodes - work_before.kd_nodes;
+                    }
+
                     Color3f rgb = spectrum_to_color3f(inner_spec, ray, active);
 
                     aovs += m_integrators[inner_idx]->aov_names().size();
@@ -572,6 +672,8 @@ protected:
 
 private:
     size_t m_integrator_aovs_count;
+    /// Does any AOV report the render cost of the nested integrators?
+    bool m_cost_aovs = false;
     std::vector<AOVType> m_aov_types;
     std::vector<std::string> m_aov_names;
     std::vector<ref<Base>> m_integrators;
@@ -1,5 +1,6 @@
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/statistics.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
@@ -83,6 +84,10 @@ paths of arbitrary length to compute both direct and indirect illumination.
 
  */
 
+// Only updated in scalar variants
+static StatsCounter stats_bsdf_samples("Path tracer", "BSDF samples");
+static StatsHistogram stats_path_length("Path tracer", "Path length", 16);
+
 template <typename Float, typename Spectrum>
 class PathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 public:
@@ -266,6 +271,9 @@ public:
             auto [bsdf_val, bsdf_pdf, bsdf_sample, bsdf_weight]
                 = bsdf->eval_pdf_sample(bsdf_ctx, si, wo, sample_1, sample_2);
 
+            if constexpr (!dr::is_jit_v<Float>)
+                ++stats_bsdf_samples;
+
             // --------------- Emitter sampling contribution ----------------
 
             if (dr::any_or<true>(active_em)) {
@@ -339,6 +347,9 @@ public:
                                                      ls.active);
         });
 
+        if constexpr (!dr::is_jit_v<Float>)
+            stats_path_length.put(ls.depth);
+
         return {
             /* spec  = */ dr::select(ls.valid_ray, ls.result, 0.f),
             /* valid = */ ls.valid_ray
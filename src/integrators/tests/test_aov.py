@@ -328,3 +328,52 @@ def test07_test_aov_normalmap(variants_all_ad_rgb):
     assert(dr.allclose(
         image[:,:,3:6].array,
         dr.tile(n, image.shape[0] * image.shape[1])))
+
+
+def test08_render_cost(variant_scalar_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f().look_at(
+                origin=[0, 0, 4], target=[0, 0, 0], up=[0, 1, 0]),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16, 'height': 16,
+                'rfilter': {'type': 'box'}
+            },
+            'sampler': {'type': 'independent', 'sample_count': 4}
+        },
+        'shape': {'type': 'sphere'},
+    })
+
+    aov_integrator = mi.load_dict({
+        'type': 'aov',
+        'aovs': 'time:cost_time,rays:cost_rays,vertices:cost_vertices',
+        'image': {'type': 'path', 'max_depth': 3}
+    })
+
+    image = aov_integrator.render(scene, seed=0, spp=4)
+    assert image.shape == (16, 16, 6)
+
+    time = image[:, :, 3].array
+    rays = image[:, :, 4].array
+    vertices = image[:, :, 5].array
+    assert dr.all(time >= 0)
+    assert dr.all(rays >= 1)
+    assert dr.all(vertices <= rays)
+
+    # The pixels that see the sphere trace more rays than the background
+    center, corner = 8 * 16 + 8, 0
+    assert vertices[center] >= 1
+    assert vertices[corner] == 0
+    assert rays[center] > rays[corner]
+
+
+def test09_render_cost_jit(variants_vec_rgb):
+    with pytest.raises(RuntimeError, match='only supported in scalar variants'):
+        mi.load_dict({
+            'type': 'aov',
+            'aovs': 'rays:cost_rays',
+            'image': {'type': 'path'}
+        })
@@ -234,3 +234,23 @@ def test07_adjoint_integrator_trampoline(variants_all_ad_rgb):
     mi.load_dict({
         'type': 'myptracer'
     })
+
+
+def test08_render_thread_count(variant_scalar_rgb):
+    """The image must not depend on the number of threads"""
+    scene, integrator = create_test_scene(emitter='area', shape='receiver')
+
+    thread_count = dr.thread_count()
+    try:
+        # No worker threads: the calling thread renders all samples
+        dr.set_thread_count(0)
+        image_ref = integrator.render(scene, seed=5, spp=64)
+
+        dr.set_thread_count(4)
+        image = integrator.render(scene, seed=5, spp=64)
+    finally:
+        dr.set_thread_count(thread_count)
+
+    assert dr.max(image_ref, axis=None) > 0
+    # Only the order of the accumulated samples differs
+    assert dr.allclose(image, image_ref, rtol=1e-4, atol=1e-6)
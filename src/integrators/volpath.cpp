@@ -1,5 +1,6 @@
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/statistics.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
@@ -67,6 +68,11 @@ to it (as compared to, say, a :ref:`dielectric <bsdf-dielectric>` or
         'max_depth': 8
 
 */
+// Only updated in scalar variants
+static StatsCounter stats_bsdf_samples("Volumetric path tracer", "BSDF samples");
+static StatsCounter stats_null_collisions("Volumetric path tracer",
+                                          "Null-collision steps");
+
 template <typename Float, typename Spectrum>
 class VolumetricPathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 
@@ -241,6 +247,11 @@ public:
                 act_null_scatter |= null_scatter && active_medium;
                 act_medium_scatter |= !act_null_scatter && active_medium;
 
+                if constexpr (!dr::is_jit_v<Float>) {
+                    if (act_null_scatter)
+                        ++stats_null_collisions;
+                }
+
                 if (dr::any_or<true>(is_spectral && act_null_scatter))
                     dr::masked(throughput, is_spectral && act_null_scatter) *=
                         mei.sigma_n / null_scatter_prob;
@@ -365,6 +376,8 @@ public:
                 // ----------------------- BSDF sampling ----------------------
                 auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active_surface),
                                                    sampler->next_2d(active_surface), active_surface);
+                if constexpr (!dr::is_jit_v<Float>)
+                    ++stats_bsdf_samples;
                 bsdf_val = si.to_world_mueller(bsdf_val, -bs.wo, si.wi);
 
                 dr::masked(throughput, active_surface) *= bsdf_val;
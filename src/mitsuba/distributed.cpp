@@ -0,0 +1,721 @@
+#include "distributed.h"
+
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/stream.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/render/sensor.h>
+#include <mitsuba/render/spiral.h>
+#include <nanothread/nanothread.h>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#if !defined(_WIN32)
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <poll.h>
+#  include <sys/socket.h>
+#  include <sys/time.h>
+#  include <sys/un.h>
+#  include <unistd.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+#if !defined(_WIN32)
+
+/// Identifies the protocol spoken between coordinator and workers
+static constexpr uint32_t ProtocolMagic   = 0x4D494452; // "MIDR"
+static constexpr uint32_t ProtocolVersion = 1;
+
+/// Time (in seconds) that a connecting worker has to complete the handshake
+static constexpr int HandshakeTimeout = 10;
+
+/// Time (in seconds) that workers have to finish their last batch of blocks
+static constexpr int ShutdownTimeout = 120;
+
+/// Message types exchanged between coordinator and workers
+enum class Message : uint8_t {
+    Hello,   ///< Worker -> coordinator: magic, version
+    Job,     ///< Coordinator -> worker: scene, parameters, and render settings
+    Request, ///< Worker -> coordinator: number of requested blocks
+    Blocks,  ///< Coordinator -> worker: list of blocks to render
+    Result,  ///< Worker -> coordinator: one rendered block
+    Done     ///< Coordinator -> worker: the job is complete
+};
+
+/// Blocking stream on top of a connected socket
+class SocketStream : public Stream {
+public:
+    using Stream::read;
+    using Stream::write;
+
+    SocketStream(int fd, const std::string &peer) : m_fd(fd), m_peer(peer) { }
+
+    ~SocketStream() { close(); }
+
+    void close() override {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    bool is_closed() const override { return m_fd < 0; }
+
+    void read(void *p, size_t size) override {
+        uint8_t *ptr = (uint8_t *) p;
+        while (size > 0) {
+            ssize_t n = ::recv(m_fd, ptr, size, 0);
+            if (n == 0)
+                Throw("Connection to %s was closed", m_peer);
+            else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                Throw("Timed out while reading from %s", m_peer);
+            else if (n < 0 && errno != EINTR)
+                Throw("Could not read from %s: %s", m_peer, strerror(errno));
+            else if (n > 0) {
+                ptr += n;
+                size -= (size_t) n;
+            }
+        }
+    }
+
+    void write(const void *p, size_t size) override {
+        const uint8_t *ptr = (const uint8_t *) p;
+#if defined(MSG_NOSIGNAL)
+        int flags = MSG_NOSIGNAL;
+#else
+        int flags = 0;
+#endif
+        while (size > 0) {
+            ssize_t n = ::send(m_fd, ptr, size, flags);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                Throw("Timed out while writing to %s", m_peer);
+            else if (n < 0 && errno != EINTR)
+                Throw("Could not write to %s: %s", m_peer, strerror(errno));
+            else if (n > 0) {
+                ptr += n;
+                size -= (size_t) n;
+            }
+        }
+    }
+
+    void seek(size_t) override { Throw("SocketStream: seek() is not supported"); }
+    void truncate(size_t) override { Throw("SocketStream: truncate() is not supported"); }
+    size_t tell() const override { return 0; }
+    size_t size() const override { return 0; }
+    void flush() override { }
+    bool can_write() const override { return !is_closed(); }
+    bool can_read() const override { return !is_closed(); }
+
+    int fd() const { return m_fd; }
+    const std::string &peer() const { return m_peer; }
+
+    std::string to_string() const override {
+        return tfm::format("SocketStream[peer=\"%s\"]", m_peer);
+    }
+
+    MI_DECLARE_CLASS(SocketStream)
+private:
+    int m_fd;
+    std::string m_peer;
+};
+
+static void configure_socket(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#if defined(SO_NOSIGPIPE)
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+/// Make blocking reads and writes fail after \c seconds (0: wait indefinitely)
+static void set_socket_timeout(int fd, int seconds) {
+    timeval tv;
+    tv.tv_sec = seconds;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+/**
+ * Create a socket for the given address ("host:port" or "unix:path"). The
+ * socket either listens for connections or is connected to the address.
+ */
+static int open_socket(const std::string &address, bool listen_mode) {
+    if (string::starts_with(address, "unix:")) {
+        std::string path = address.substr(5);
+        sockaddr_un sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(sa.sun_path))
+            Throw("Invalid UNIX socket path \"%s\"", path);
+        memcpy(sa.sun_path, path.c_str(), path.size());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            Throw("Could not create socket: %s", strerror(errno));
+
+        bool success;
+        if (listen_mode) {
+            ::unlink(path.c_str());
+            success = bind(fd, (sockaddr *) &sa, sizeof(sa)) == 0 &&
+                      listen(fd, 64) == 0;
+        } else {
+            success = connect(fd, (sockaddr *) &sa, sizeof(sa)) == 0;
+        }
+
+        if (!success) {
+            int error = errno;
+            ::close(fd);
+            Throw("Could not %s \"%s\": %s", listen_mode ? "listen on" : "connect to",
+                  address, strerror(error));
+        }
+        return fd;
+    }
+
+    size_t sep = address.rfind(':');
+    if (sep == std::string::npos)
+        Throw("Invalid address \"%s\", expected \"host:port\" or \"unix:path\"", address);
+    std::string host = address.substr(0, sep),
+                port = address.substr(sep + 1);
+
+    addrinfo hints, *info = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (listen_mode)
+        hints.ai_flags = AI_PASSIVE;
+
+    int rv = getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(),
+                         &hints, &info);
+    if (rv != 0)
+        Throw("Could not resolve \"%s\": %s", address, gai_strerror(rv));
+
+    int fd = -1, error = 0;
+    for (addrinfo *ai = info; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            error = errno;
+            continue;
+        }
+
+        bool success;
+        if (listen_mode) {
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            success = bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 &&
+                      listen(fd, 64) == 0;
+        } else {
+            success = connect(fd, ai->ai_addr, ai->ai_addrlen) == 0;
+        }
+
+        if (success)
+            break;
+
+        error = errno;
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(info);
+
+    if (fd < 0)
+        Throw("Could not %s \"%s\": %s", listen_mode ? "listen on" : "connect to",
+              address, strerror(error));
+
+    if (!listen_mode)
+        configure_socket(fd);
+
+    return fd;
+}
+
+template <typename Float, typename Spectrum>
+static ref<Scene<Float, Spectrum>> load_scene(const parser::ParserConfig &config,
+                                              const fs::path &filename,
+                                              const parser::ParameterList &params) {
+    ref<FileResolver> fr_backup = file_resolver();
+    ref<FileResolver> fr = new FileResolver(*fr_backup);
+    fs::path scene_dir = filename.parent_path();
+    if (!fr->contains(scene_dir))
+        fr->append(scene_dir);
+    set_file_resolver(fr);
+
+    std::vector<ref<Object>> objects;
+    try {
+        parser::ParserState state =
+            parser::parse_file_cached(config, filename, params);
+        objects = parser::instantiate(config, state);
+    } catch (...) {
+        set_file_resolver(fr_backup);
+        throw;
+    }
+    set_file_resolver(fr_backup);
+
+    auto *scene = objects.size() == 1
+                      ? dynamic_cast<Scene<Float, Spectrum> *>(objects[0].get())
+                      : nullptr;
+    if (!scene)
+        Throw("Root element of \"%s\" must be a <scene> tag!", filename);
+    return scene;
+}
+
+template <typename Float, typename Spectrum>
+void coordinate(const parser::ParserConfig &config, const std::string &address,
+                const fs::path &filename, const parser::ParameterList &params,
+                uint32_t sensor_index, uint32_t seed, const fs::path &output) {
+    MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock, SamplingIntegrator)
+
+    if constexpr (dr::is_jit_v<Float>) {
+        DRJIT_MARK_USED(address);
+        DRJIT_MARK_USED(sensor_index);
+        DRJIT_MARK_USED(seed);
+        DRJIT_MARK_USED(output);
+        Throw("Distributed rendering is only supported in scalar variants!");
+    } else {
+        ref<Scene> scene = load_scene<Float, Spectrum>(config, filename, params);
+        if (sensor_index >= scene->sensors().size())
+            Throw("Specified sensor index is out of bounds!");
+
+        Sensor *sensor = scene->sensors()[sensor_index];
+        Film *film = sensor->film();
+        auto *integrator = dynamic_cast<SamplingIntegrator *>(scene->integrator());
+        if (!integrator)
+            Throw("Distributed rendering requires a sampling-based integrator!");
+
+        uint32_t spp = (uint32_t) sensor->sampler()->sample_count(),
+                 block_size = MI_BLOCK_SIZE;
+        film->prepare(integrator->aov_names());
+
+        ScalarVector2u film_size = film->crop_size();
+        if (film->sample_border())
+            film_size += 2 * film->rfilter()->border_size();
+
+        // Split the image into the same blocks as SamplingIntegrator::render()
+        struct Block {
+            ScalarPoint2i offset;
+            ScalarVector2u size;
+            uint32_t id;
+            uint32_t assigned = 0;
+            bool done = false;
+        };
+
+        std::vector<Block> blocks;
+        std::deque<uint32_t> pending;
+        Spiral spiral(film_size, film->crop_offset(), block_size);
+        for (uint32_t i = 0; i < spiral.block_count(); ++i) {
+            auto [offset, size, block_id] = spiral.next_block();
+            if (film->sample_border())
+                offset -= film->rfilter()->border_size();
+            blocks.push_back(Block{ ScalarPoint2i(offset), ScalarVector2u(size), block_id });
+            pending.push_back(i);
+        }
+
+        struct Worker {
+            ref<SocketStream> stream;
+            std::set<uint32_t> blocks;
+            uint32_t requested = 0;
+            bool waiting = false;
+        };
+
+        std::vector<Worker> workers;
+        size_t blocks_done = 0;
+
+        int listen_fd = open_socket(address, true);
+        Log(Info, "Coordinator listening on \"%s\" (%ux%u, %u sample%s, %zu blocks)",
+            address, film_size.x(), film_size.y(), spp, spp == 1 ? "" : "s",
+            blocks.size());
+
+        ref<ProgressReporter> progress = new ProgressReporter("Rendering");
+        Timer timer;
+
+        // Hand out unassigned blocks, or steal blocks from other workers
+        auto assign = [&](Worker &worker) {
+            std::vector<uint32_t> result;
+            while (result.size() < worker.requested && !pending.empty()) {
+                uint32_t index = pending.front();
+                pending.pop_front();
+                if (!blocks[index].done)
+                    result.push_back(index);
+            }
+
+            if (result.empty()) {
+                std::vector<uint32_t> candidates;
+                for (uint32_t i = 0; i < blocks.size(); ++i) {
+                    if (!blocks[i].done && worker.blocks.count(i) == 0)
+                        candidates.push_back(i);
+                }
+                std::stable_sort(candidates.begin(), candidates.end(),
+                                 [&](uint32_t a, uint32_t b) {
+                                     return blocks[a].assigned < blocks[b].assigned;
+                                 });
+                candidates.resize(std::min(candidates.size(), (size_t) worker.requested));
+                result = candidates;
+            }
+
+            for (uint32_t index : result) {
+                blocks[index].assigned++;
+                worker.blocks.insert(index);
+            }
+
+            return result;
+        };
+
+        auto send_blocks = [&](Worker &worker, const std::vector<uint32_t> &list) {
+            SocketStream *s = worker.stream;
+            s->write(Message::Blocks);
+            s->write((uint32_t) list.size());
+            for (uint32_t index : list) {
+                const Block &b = blocks[index];
+                s->write(index);
+                s->write(b.id);
+                s->write_array(b.offset.data(), 2);
+                s->write_array(b.size.data(), 2);
+            }
+            worker.requested = 0;
+            worker.waiting = false;
+        };
+
+        auto disconnect = [&](size_t i, const char *reason) {
+            Worker &worker = workers[i];
+            Log(Warn, "Lost worker %s (%s), rescheduling %zu block%s.",
+                worker.stream->peer(), reason, worker.blocks.size(),
+                worker.blocks.size() == 1 ? "" : "s");
+            for (uint32_t index : worker.blocks) {
+                Block &b = blocks[index];
+                if (!b.done && --b.assigned == 0)
+                    pending.push_front(index);
+            }
+            workers.erase(workers.begin() + i);
+        };
+
+        auto handle_message = [&](Worker &worker) {
+            SocketStream *s = worker.stream;
+            Message type;
+            s->read(type);
+
+            if (type == Message::Request) {
+                s->read(worker.requested);
+                worker.waiting = true;
+            } else if (type == Message::Result) {
+                uint32_t index;
+                uint64_t count;
+                s->read(index);
+                s->read(count);
+                if (index >= blocks.size())
+                    Throw("Invalid block index %u", index);
+
+                const Block &b = blocks[index];
+                ref<ImageBlock> block = film->create_block(
+                    ScalarVector2u(block_size), false /* normalize */,
+                    true /* border */);
+                block->set_size(b.size);
+                block->set_offset(b.offset);
+                if ((uint64_t) block->tensor().size() != count)
+                    Throw("Block %u has an unexpected size", index);
+                s->read_array(block->tensor().data(), (size_t) count);
+
+                worker.blocks.erase(index);
+                if (!blocks[index].done) {
+                    film->put_block(block);
+                    blocks[index].done = true;
+                    blocks_done++;
+                    progress->update(blocks_done / (float) blocks.size());
+                }
+            } else {
+                Throw("Unexpected message %u", (uint32_t) type);
+            }
+        };
+
+        while (blocks_done < blocks.size()) {
+            std::vector<pollfd> fds(workers.size() + 1);
+            fds[0] = pollfd{ listen_fd, POLLIN, 0 };
+            for (size_t i = 0; i < workers.size(); ++i)
+                fds[i + 1] = pollfd{ workers[i].stream->fd(), POLLIN, 0 };
+
+            if (poll(fds.data(), (nfds_t) fds.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                Throw("poll() failed: %s", strerror(errno));
+            }
+
+            // Process messages of connected workers (in reverse order, since
+            // workers may be removed)
+            for (size_t i = workers.size(); i-- > 0; ) {
+                if (!fds[i + 1].revents)
+                    continue;
+                try {
+                    handle_message(workers[i]);
+                } catch (const std::exception &e) {
+                    disconnect(i, e.what());
+                }
+            }
+
+            // Accept new workers
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd, nullptr, nullptr);
+                if (fd >= 0) {
+                    configure_socket(fd);
+                    ref<SocketStream> stream =
+                        new SocketStream(fd, tfm::format("#%zu", workers.size()));
+
+                    /* The handshake runs on the accept path, so a client that
+                       stalls must not block the coordinator indefinitely */
+                    set_socket_timeout(fd, HandshakeTimeout);
+                    try {
+                        uint32_t magic, version;
+                        Message type;
+                        stream->read(type);
+                        stream->read(magic);
+                        stream->read(version);
+                        if (type != Message::Hello || magic != ProtocolMagic ||
+                            version != ProtocolVersion)
+                            Throw("protocol mismatch");
+
+                        stream->write(Message::Job);
+                        stream->write(fs::absolute(filename).string());
+                        stream->write(params);
+                        stream->write(sensor_index);
+                        stream->write(spp);
+                        stream->write(seed);
+                        stream->write(block_size);
+                        set_socket_timeout(fd, 0);
+                        workers.push_back(Worker{ stream });
+                        Log(Info, "Worker %s connected.", stream->peer());
+                    } catch (const std::exception &e) {
+                        Log(Warn, "Rejected worker: %s", e.what());
+                    }
+                }
+            }
+
+            // Serve workers that are waiting for blocks
+            for (size_t i = workers.size(); i-- > 0; ) {
+                Worker &worker = workers[i];
+                if (!worker.waiting || blocks_done == blocks.size())
+                    continue;
+                std::vector<uint32_t> list = assign(worker);
+                if (list.empty())
+                    continue;
+                try {
+                    send_blocks(worker, list);
+                } catch (const std::exception &e) {
+                    disconnect(i, e.what());
+                }
+            }
+        }
+
+        ::close(listen_fd);
+        if (string::starts_with(address, "unix:"))
+            ::unlink(address.substr(5).c_str());
+
+        Log(Info, "Rendering finished. (took %s)",
+            util::time_string((float) timer.value(), true));
+
+        film->write(output);
+
+        /* Workers may still be rendering (stolen) blocks and will send their
+           results before they read the 'Done' message. Closing the connections
+           right away would make them fail, hence wait until each worker has
+           read the message and closed its end of the connection. */
+        for (size_t i = workers.size(); i-- > 0; ) {
+            try {
+                workers[i].stream->write(Message::Done);
+            } catch (const std::exception &) {
+                workers.erase(workers.begin() + i);
+            }
+        }
+
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::seconds(ShutdownTimeout);
+        while (!workers.empty()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                Log(Warn, "%zu worker%s did not acknowledge the end of the job.",
+                    workers.size(), workers.size() == 1 ? "" : "s");
+                break;
+            }
+
+            std::vector<pollfd> fds(workers.size());
+            for (size_t i = 0; i < workers.size(); ++i)
+                fds[i] = pollfd{ workers[i].stream->fd(), POLLIN, 0 };
+
+            if (poll(fds.data(), (nfds_t) fds.size(), (int) remaining) < 0) {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+
+            // Discard late results and requests until the worker disconnects
+            for (size_t i = workers.size(); i-- > 0; ) {
+                if (!fds[i].revents)
+                    continue;
+                try {
+                    handle_message(workers[i]);
+                } catch (const std::exception &) {
+                    workers.erase(workers.begin() + i);
+                }
+            }
+        }
+    }
+}
+
+template <typename Float, typename Spectrum>
+void work(const parser::ParserConfig &config, const std::string &address) {
+    MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock, SamplingIntegrator)
+
+    if constexpr (dr::is_jit_v<Float>) {
+        DRJIT_MARK_USED(address);
+        Throw("Distributed rendering is only supported in scalar variants!");
+    } else {
+        // The coordinator might still be starting up
+        int fd = -1;
+        for (int attempt = 0; ; ++attempt) {
+            try {
+                fd = open_socket(address, false);
+                break;
+            } catch (const std::exception &) {
+                if (attempt == 50)
+                    throw;
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            }
+        }
+
+        ref<SocketStream> stream = new SocketStream(fd, address);
+        stream->write(Message::Hello);
+        stream->write(ProtocolMagic);
+        stream->write(ProtocolVersion);
+
+        Message type;
+        std::string filename;
+        parser::ParameterList params;
+        uint32_t sensor_index, spp, seed, block_size;
+        stream->read(type);
+        if (type != Message::Job)
+            Throw("Unexpected message %u", (uint32_t) type);
+        stream->read(filename);
+        stream->read(params);
+        stream->read(sensor_index);
+        stream->read(spp);
+        stream->read(seed);
+        stream->read(block_size);
+
+        ref<Scene> scene = load_scene<Float, Spectrum>(config, filename, params);
+        if (sensor_index >= scene->sensors().size())
+            Throw("Specified sensor index is out of bounds!");
+
+        Sensor *sensor = scene->sensors()[sensor_index];
+        Film *film = sensor->film();
+        auto *integrator = dynamic_cast<SamplingIntegrator *>(scene->integrator());
+        if (!integrator)
+            Throw("Distributed rendering requires a sampling-based integrator!");
+
+        film->prepare(integrator->aov_names());
+        sensor->sampler()->set_sample_count(spp);
+
+        uint32_t batch_size = (uint32_t) pool_size() + 1;
+        size_t blocks_rendered = 0;
+        std::mutex mutex;
+        Timer timer;
+
+        Log(Info, "Worker connected to \"%s\", rendering with %u thread%s.",
+            address, batch_size, batch_size == 1 ? "" : "s");
+
+        while (true) {
+            stream->write(Message::Request);
+            stream->write(batch_size);
+
+            stream->read(type);
+            if (type == Message::Done)
+                break;
+            else if (type != Message::Blocks)
+                Throw("Unexpected message %u", (uint32_t) type);
+
+            struct Task {
+                uint32_t index, id;
+                ScalarPoint2i offset;
+                ScalarVector2u size;
+            };
+
+            uint32_t count;
+            stream->read(count);
+            std::vector<Task> tasks(count);
+            for (Task &t : tasks) {
+                stream->read(t.index);
+                stream->read(t.id);
+                stream->read_array(t.offset.data(), 2);
+                stream->read_array(t.size.data(), 2);
+            }
+
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, tasks.size(), 1),
+                [&](const dr::blocked_range<size_t> &range) {
+                    ref<ImageBlock> block = film->create_block(
+                        ScalarVector2u(block_size), false /* normalize */,
+                        true /* border */);
+
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        const Task &t = tasks[i];
+                        block->set_size(t.size);
+                        block->set_offset(t.offset);
+                        integrator->render_tile(scene, sensor, block, t.id,
+                                                block_size, spp, seed);
+
+                        std::lock_guard<std::mutex> guard(mutex);
+                        stream->write(Message::Result);
+                        stream->write(t.index);
+                        stream->write((uint64_t) block->tensor().size());
+                        stream->write_array(block->tensor().data(),
+                                            block->tensor().size());
+                    }
+                }
+            );
+
+            blocks_rendered += tasks.size();
+        }
+
+        Log(Info, "Job complete, rendered %zu blocks in %s.", blocks_rendered,
+            util::time_string((float) timer.value(), true));
+    }
+}
+
+void run_coordinator(const parser::ParserConfig &config,
+                     const std::string &address, const fs::path &filename,
+                     const parser::ParameterList &params,
+                     uint32_t sensor_index, uint32_t seed,
+                     const fs::path &output) {
+    MI_INVOKE_VARIANT(config.variant, coordinate, config, address, filename,
+                      params, sensor_index, seed, output);
+}
+
+void run_worker(const parser::ParserConfig &config, const std::string &address) {
+    MI_INVOKE_VARIANT(config.variant, work, config, address);
+}
+
+#else
+
+void run_coordinator(const parser::ParserConfig &, const std::string &,
+                     const fs::path &, const parser::ParameterList &,
+                     uint32_t, uint32_t, const fs::path &) {
+    Throw("Distributed rendering is not supported on Windows!");
+}
+
+void run_worker(const parser::ParserConfig &, const std::string &) {
+    Throw("Distributed rendering is not supported on Windows!");
+}
+
+#endif
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <mitsuba/core/parser.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Render an image by distributing its blocks over worker processes
+ *
+ * The coordinator loads the scene to determine the image blocks, listens on
+ * \c address, and hands out blocks to workers (see \ref run_worker()) on
+ * request. Workers stream their weighted image blocks back, which are merged
+ * into the film. Once all blocks are done, the image is written to \c output.
+ *
+ * When no unassigned blocks remain, blocks that are still being rendered by
+ * another worker are handed out a second time, so that slow workers do not
+ * delay the job (the first result wins). Blocks of workers that disconnect
+ * are returned to the queue.
+ *
+ * The address is either <tt>host:port</tt> (TCP) or <tt>unix:path</tt>
+ * (UNIX domain socket). Only scalar variants are supported.
+ */
+extern void run_coordinator(const parser::ParserConfig &config,
+                            const std::string &address,
+                            const fs::path &filename,
+                            const parser::ParameterList &params,
+                            uint32_t sensor_index,
+                            uint32_t seed,
+                            const fs::path &output);
+
+/**
+ * \brief Connect to a coordinator and render image blocks until the job is
+ * complete
+ *
+ * The worker receives the scene path and parameters from the coordinator
+ * and loads the scene itself, hence the file must be accessible under the
+ * same path on both sides.
+ */
+extern void run_worker(const parser::ParserConfig &config,
+                       const std::string &address);
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,131 @@
+#include "merge.h"
+
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Number of rows processed by one task when accumulating images
+static constexpr uint32_t MergeGrainSize = 16;
+
+void merge_raw_films(const std::vector<fs::path> &inputs, const fs::path &output) {
+    if (inputs.empty())
+        Throw("merge_raw_films(): at least one input image must be specified!");
+
+    Timer timer;
+    ref<Bitmap> sum;
+    std::vector<std::string> channels;
+
+    // Load the inputs in batches (one per thread) to bound the memory usage
+    size_t batch_size = pool_size() + 1;
+    for (size_t batch_start = 0; batch_start < inputs.size(); batch_start += batch_size) {
+        size_t batch_end = std::min(inputs.size(), batch_start + batch_size);
+        std::vector<ref<Bitmap>> batch(batch_end - batch_start);
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(batch_start, batch_end, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    ref<Bitmap> bitmap = new Bitmap(inputs[i]);
+                    if (bitmap->component_format() != Struct::Type::Float32)
+                        bitmap = bitmap->convert(bitmap->pixel_format(),
+                                                 Struct::Type::Float32, false);
+                    batch[i - batch_start] = bitmap;
+                }
+            }
+        );
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Bitmap *bitmap = batch[i];
+            std::vector<std::string> names;
+            for (size_t j = 0; j < bitmap->channel_count(); ++j)
+                names.push_back(bitmap->struct_()->operator[](j).name);
+
+            if (!sum) {
+                if (std::find(names.begin(), names.end(), "W") == names.end())
+                    Throw("\"%s\" has no weight channel, was it written by a "
+                          "film with raw output?", inputs[batch_start + i]);
+                channels = names;
+                sum = new Bitmap(Bitmap::PixelFormat::MultiChannel,
+                                 Struct::Type::Float32, bitmap->size(),
+                                 channels.size(), channels);
+                sum->clear();
+            } else if (dr::any(bitmap->size() != sum->size()) || names != channels) {
+                Throw("\"%s\" does not match the size or channels of \"%s\"!",
+                      inputs[batch_start + i], inputs[0]);
+            }
+        }
+
+        // Accumulate the batch in parallel over rows
+        uint32_t width = sum->size().x(), height = sum->size().y();
+        size_t row_size = (size_t) width * channels.size();
+        dr::parallel_for(
+            dr::blocked_range<uint32_t>(0, height, MergeGrainSize),
+            [&](const dr::blocked_range<uint32_t> &range) {
+                float *target = (float *) sum->data() + range.begin() * row_size;
+                size_t count = (range.end() - range.begin()) * row_size;
+                for (const ref<Bitmap> &bitmap : batch) {
+                    const float *source =
+                        (const float *) bitmap->data() + range.begin() * row_size;
+                    for (size_t k = 0; k < count; ++k)
+                        target[k] += source[k];
+                }
+            }
+        );
+
+        Log(Info, "Accumulated %zu/%zu images ..", batch_end, inputs.size());
+    }
+
+    // Develop: divide all other channels by the total weight
+    size_t weight_ch = std::find(channels.begin(), channels.end(), "W") - channels.begin();
+    std::vector<std::string> out_channels;
+    for (size_t i = 0; i < channels.size(); ++i) {
+        if (i != weight_ch)
+            out_channels.push_back(channels[i]);
+    }
+
+    Bitmap::PixelFormat pixel_format = Bitmap::PixelFormat::MultiChannel;
+    if (out_channels == std::vector<std::string>{ "R", "G", "B" })
+        pixel_format = Bitmap::PixelFormat::RGB;
+    else if (out_channels == std::vector<std::string>{ "R", "G", "B", "A" })
+        pixel_format = Bitmap::PixelFormat::RGBA;
+
+    ref<Bitmap> result =
+        new Bitmap(pixel_format, Struct::Type::Float32, sum->size(),
+                   out_channels.size(), out_channels);
+
+    size_t in_ch = channels.size(), out_ch = out_channels.size();
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, sum->pixel_count(), MergeGrainSize * 1024),
+        [&](const dr::blocked_range<size_t> &range) {
+            const float *source = (const float *) sum->data();
+            float *target = (float *) result->data();
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                const float *in = source + i * in_ch;
+                float *out = target + i * out_ch;
+                float weight = in[weight_ch],
+                      inv_weight = weight > 0.f ? 1.f / weight : 0.f;
+                for (size_t j = 0, k = 0; j < in_ch; ++j) {
+                    if (j != weight_ch)
+                        out[k++] = in[j] * inv_weight;
+                }
+            }
+        }
+    );
+
+    fs::path filename = output;
+    if (string::to_lower(filename.extension().string()) != ".exr")
+        filename.replace_extension(".exr");
+
+    result->write(filename, Bitmap::FileFormat::OpenEXR);
+    Log(Info, "Merged %zu images into \"%s\" (took %s).", inputs.size(),
+        filename.string(), util::time_string((float) timer.value(), true));
+}
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <mitsuba/core/filesystem.h>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Combine partial renders of the same image into a developed image
+ *
+ * Each input must be an OpenEXR file written by a film with raw output (see
+ * the \c raw parameter of \c hdrfilm), which stores the accumulated channel
+ * values along with the weight channel \c W. Because the weights are
+ * preserved, partial renders with different sample counts are combined
+ * correctly. The accumulated values of all inputs are summed and divided by
+ * the total weight, and the result (all channels except \c W) is written
+ * to \c output in the OpenEXR format.
+ */
+extern void merge_raw_films(const std::vector<fs::path> &inputs,
+                            const fs::path &output);
+
+NAMESPACE_END(mitsuba)
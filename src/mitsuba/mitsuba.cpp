@@ -1,3 +1,4 @@
+#include <mitsuba/core/appender.h>
 #include <mitsuba/core/argparser.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/filesystem.h>
@@ -5,8 +6,12 @@
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/jit.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/statistics.h>
 #include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/parser.h>
@@ -15,6 +20,11 @@
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/scene.h>
 #include <functional>
+#include <iostream>
+
+#include "distributed.h"
+#include "merge.h"
+#include "server.h"
 
 #if !defined(_WIN32)
 #  include <signal.h>
@@ -57,12 +67,72 @@ Options:
         Index of the sensor to render with (following the declaration order
         in the scene file). Default value: 0.
 
+        Several sensors can be rendered in one batch by specifying "all" or
+        a comma-separated list of indices and ranges (e.g. "0,2,4-7"). The
+        scene is then only loaded once, and the image of each sensor is
+        written to "<output>_<index>.<ext>" while the next one renders.
+
     -a <path1>;<path2>;.., --append <path1>;<path2>
         Add one or more entries to the resource search path.
 
     -o <filename>, --output <filename>
         Write the output image to the file "filename".
 
+    --seed <value>
+        Seed value of the random number generators (default: 0). Partial
+        renders of the same image that use different seeds draw independent
+        samples and can be combined with --merge.
+
+    --stats <filename>
+        Write the statistics counters of each render job (rays traced,
+        kd-tree traversal steps, BSDF samples, ..) to a JSON file. They are
+        only collected in scalar variants, and when Mitsuba was compiled
+        with -DMI_ENABLE_STATISTICS=ON.
+
+    --trace <filename>
+        Record a timeline of scene loading (XML parsing, plugin
+        instantiation, file I/O, acceleration structure construction, ..)
+        and write it to a JSON file that can be opened in chrome://tracing
+        or https://ui.perfetto.dev.
+
+    --memory-budget <MiB>
+        Log a warning with a breakdown of the memory used by geometry,
+        textures, volumes, emitters, acceleration data structures and films
+        as soon as their total exceeds the given amount (in MiB).
+
+    --merge
+        Combine partial renders written by films with raw output (e.g.
+        <film type="hdrfilm"><boolean name="raw" value="true"/></film>) into
+        the final image, weighting each pixel by its accumulated sample
+        weight. Example: mitsuba --merge -o final.exr part_*.exr
+
+    -C <directory>, --cache <directory>
+        Store a binary version of each parsed and optimized scene description
+        in "directory", and reuse it to skip XML parsing on subsequent runs.
+        A cache entry is invalidated when the scene file or one of its
+        included XML files changes.
+
+    --server
+        Run as a render server that reads render jobs from standard input
+        (one JSON object per line) and writes one JSON result per job to
+        standard output. Loaded scenes are kept in memory between jobs.
+        Log messages are redirected to standard error. Example job:
+
+          {"id": "f1", "scene": "scene.xml", "output": "f1.exr",
+           "defines": {"key": "value"}, "params": {"sensor.to_world":
+           [1,0,0,0, 0,1,0,0, 0,0,1,5, 0,0,0,1]}, "sensor": 0, "spp": 64}
+
+    --coordinator <address>
+        Render the specified scene by distributing its image blocks over
+        worker processes that connect to "address" ("host:port" or
+        "unix:path"). Blocks of workers that disconnect are rescheduled.
+        Only scalar variants are supported.
+
+    --worker <address>
+        Connect to a coordinator and render image blocks until the job is
+        complete. The scene file must be accessible under the same path as
+        on the coordinator.
+
  === The following options are only relevant for JIT (CUDA/LLVM) modes ===
 
     -O [0-5]
@@ -105,32 +175,107 @@ void scene_static_accel_shutdown() {
     Scene<Float, Spectrum>::static_accel_shutdown();
 }
 
+/// Parse the argument of -s/--sensor: "all" or a list such as "0,2,4-7"
+static std::vector<size_t> parse_sensor_list(const std::string &spec,
+                                             size_t sensor_count) {
+    auto parse_index = [&](const std::string &value) {
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+            Throw("-s/--sensor: could not parse \"%s\"!", spec);
+        size_t index = (size_t) std::stoull(value);
+        if (index >= sensor_count)
+            Throw("Specified sensor index is out of bounds!");
+        return index;
+    };
+
+    std::vector<size_t> result;
+    if (spec == "all") {
+        for (size_t i = 0; i < sensor_count; ++i)
+            result.push_back(i);
+        return result;
+    }
+
+    for (const std::string &item : string::tokenize(spec, ",")) {
+        size_t sep = item.find('-');
+        size_t first = parse_index(item.substr(0, sep)),
+               last  = sep == std::string::npos ? first
+                                                : parse_index(item.substr(sep + 1));
+        if (first > last)
+            Throw("-s/--sensor: invalid range \"%s\"!", item);
+        for (size_t i = first; i <= last; ++i)
+            result.push_back(i);
+    }
+
+    if (result.empty())
+        Throw("-s/--sensor: no sensor specified!");
+
+    return result;
+}
+
 template <typename Float, typename Spectrum>
-void render(Object *scene_, size_t sensor_i, fs::path filename) {
+void render(Object *scene_, const std::string &sensor_spec, uint32_t seed,
+            fs::path filename, const fs::path &stats_filename) {
     auto *scene = dynamic_cast<Scene<Float, Spectrum> *>(scene_);
     if (!scene)
         Throw("Root element of the input file must be a <scene> tag!");
     if (scene->sensors().empty())
         Throw("No sensor specified for scene: %s", scene);
-    if (sensor_i >= scene->sensors().size())
-        Throw("Specified sensor index is out of bounds!");
-    auto film = scene->sensors()[sensor_i]->film();
+
+    std::vector<size_t> sensors =
+        parse_sensor_list(sensor_spec, scene->sensors().size());
 
     auto integrator = scene->integrator();
     if (!integrator)
         Throw("No integrator specified for scene: %s", scene);
 
-    develop_callback_fn = [film]() { film->develop(); };
+    // Zero-pad the sensor index appended to the filename in batch mode
+    bool batch = sensors.size() > 1;
+    size_t digits = std::to_string(scene->sensors().size() - 1).size();
+    fs::path extension = filename.extension();
+    fs::path stem = fs::path(filename).replace_extension();
+
+    Timer timer;
+    for (size_t sensor_i : sensors) {
+        auto film = scene->sensors()[sensor_i]->film();
+
+        develop_callback_fn = [film]() { film->develop(); };
+
+        integrator->render(scene, (uint32_t) sensor_i,
+                           seed,
+                           0 /* spp */,
+                           false /* develop */,
+                           true /* evaluate */);
+
+        develop_callback_fn = nullptr;
+        Log(Info, "%s", MemoryUsage::report());
+
+        std::string index = std::to_string(sensor_i);
+        index.insert(0, digits - index.size(), '0');
+
+        // Export the statistics counters of this render job
+        if (!stats_filename.empty()) {
+            fs::path path = stats_filename;
+            if (batch)
+                path = fs::path(fs::path(stats_filename).replace_extension().string() +
+                                "_" + index + stats_filename.extension().string());
+            ref<FileStream> stream = new FileStream(path, FileStream::ETruncReadWrite);
+            stream->write_line(Statistics::to_json());
+        }
 
-    integrator->render(scene, (uint32_t) sensor_i,
-                       0 /* seed */,
-                       0 /* spp */,
-                       false /* develop */,
-                       true /* evaluate */);
+        if (!batch) {
+            film->write(filename);
+            break;
+        }
 
-    develop_callback_fn = nullptr;
+        /* The film is developed right away, but the image is encoded and
+           written to disk while the next sensor renders */
+        film->write_async(fs::path(stem.string() + "_" + index + extension.string()));
+    }
 
-    film->write(filename);
+    if (batch) {
+        Thread::wait_for_tasks();
+        Log(Info, "Rendered %i sensors in %s.", sensors.size(),
+            util::time_string((float) timer.value()));
+    }
 }
 
 #if !defined(_WIN32)
@@ -160,6 +305,15 @@ int main(int argc, char *argv[]) {
     auto arg_output    = parser.add(StringVec{ "-o", "--output" }, true);
     auto arg_help      = parser.add(StringVec{ "-h", "--help" });
     auto arg_mode      = parser.add(StringVec{ "-m", "--mode" }, true);
+    auto arg_cache     = parser.add(StringVec{ "-C", "--cache" }, true);
+    auto arg_seed      = parser.add(StringVec{ "--seed" }, true);
+    auto arg_merge     = parser.add(StringVec{ "--merge" });
+    auto arg_stats     = parser.add(StringVec{ "--stats" }, true);
+    auto arg_mem_budget = parser.add(StringVec{ "--memory-budget" }, true);
+    auto arg_trace     = parser.add(StringVec{ "--trace" }, true);
+    auto arg_server    = parser.add(StringVec{ "--server" });
+    auto arg_coord     = parser.add(StringVec{ "--coordinator" }, true);
+    auto arg_worker    = parser.add(StringVec{ "--worker" }, true);
     auto arg_paths     = parser.add(StringVec{ "-a" }, true);
     auto arg_extra     = parser.add("", true);
 
@@ -301,7 +455,29 @@ int main(int argc, char *argv[]) {
 
         MI_INVOKE_VARIANT(mode, scene_static_accel_initialization);
 
-        size_t sensor_i  = (*arg_sensor_i ? arg_sensor_i->as_int() : 0);
+        std::string sensors = (*arg_sensor_i ? arg_sensor_i->as_string() : "0");
+        uint32_t seed = *arg_seed ? (uint32_t) arg_seed->as_int() : 0;
+
+        fs::path stats_filename;
+        if (*arg_stats) {
+            stats_filename = fs::path(arg_stats->as_string());
+            if (!Statistics::enabled())
+                Log(Warn, "--stats: Mitsuba was compiled without statistics "
+                          "counters (MI_ENABLE_STATISTICS), the output will be empty.");
+        }
+
+        if (*arg_mem_budget) {
+            double budget = arg_mem_budget->as_float();
+            if (budget < 0)
+                Throw("--memory-budget: expected a non-negative value!");
+            MemoryUsage::set_budget((size_t) (budget * 1024 * 1024));
+        }
+
+        fs::path trace_filename;
+        if (*arg_trace) {
+            trace_filename = fs::path(arg_trace->as_string());
+            Trace::set_enabled(true);
+        }
 
         // Append the mitsuba directory to the FileResolver search path list
         ref<Thread> thread = Thread::thread();
@@ -319,7 +495,13 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        if (!*arg_extra || *arg_help) {
+        if (*arg_server && !*arg_help) {
+            // Keep standard output free for the job results
+            auto logger = Thread::thread()->logger();
+            logger->clear_appenders();
+            logger->add_appender(new StreamAppender(&std::cerr));
+            Log(Info, "%s", util::info_build(pool_size() + 1));
+        } else if ((!*arg_extra && !*arg_worker) || *arg_help) {
             help(pool_size() + 1);
         } else {
             Log(Info, "%s", util::info_build(pool_size() + 1));
@@ -332,6 +514,43 @@ int main(int argc, char *argv[]) {
         }
 
         parser::ParserConfig config(mode);
+        if (*arg_cache)
+            config.cache_directory = fs::path(arg_cache->as_string());
+
+        if (*arg_server && !*arg_help) {
+            if (*arg_extra)
+                Throw("--server: scene files must be specified in the render jobs!");
+            run_render_server(config, std::cin, std::cout);
+        }
+
+        if (*arg_merge && !*arg_help) {
+            if (!*arg_output)
+                Throw("--merge: the output file must be specified using -o!");
+            std::vector<fs::path> inputs;
+            for (; arg_extra && *arg_extra; arg_extra = arg_extra->next())
+                inputs.emplace_back(arg_extra->as_string());
+            merge_raw_films(inputs, fs::path(arg_output->as_string()));
+        }
+
+        if (*arg_worker && !*arg_help) {
+            if (arg_extra && *arg_extra)
+                Throw("--worker: the scene file is provided by the coordinator!");
+            run_worker(config, arg_worker->as_string());
+        }
+
+        if (*arg_coord && arg_extra && *arg_extra) {
+            if (arg_extra->next())
+                Throw("--coordinator: only a single scene file is supported!");
+            fs::path filename(arg_extra->as_string());
+            fs::path output = *arg_output ? fs::path(arg_output->as_string())
+                                          : filename;
+            if (sensors.empty() ||
+                sensors.find_first_not_of("0123456789") != std::string::npos)
+                Throw("--coordinator: a single sensor index must be specified!");
+            run_coordinator(config, arg_coord->as_string(), filename, params,
+                            (uint32_t) std::stoul(sensors), seed, output);
+            arg_extra = nullptr;
+        }
 
         while (arg_extra && *arg_extra) {
             fs::path filename(arg_extra->as_string());
@@ -346,22 +565,31 @@ int main(int argc, char *argv[]) {
             if (*arg_output)
                 filename = fs::path(arg_output->as_string());
 
-            // Parse the XML file
-            parser::ParserState state = parser::parse_file(
-                config, arg_extra->as_string(), params);
+            std::vector<ref<Object>> objects;
+            /* scoped */ {
+                ScopedTraceEvent trace_event("Scene", "Load scene",
+                                             arg_extra->as_string());
 
-            // Resolve references an optimize the scene representation
-            parser::transform_all(config, state);
+                // Parse the XML file, resolve references and optimize the scene
+                // representation (or load the result from the cache)
+                parser::ParserState state = parser::parse_file_cached(
+                    config, arg_extra->as_string(), params);
+
+                // Instantiate scene objects in parallel
+                objects = parser::instantiate(config, state);
+            }
+            Log(Info, "%s", MemoryUsage::report());
 
-            // Instantiate scene objects in parallel
-            std::vector<ref<Object>> objects =
-                parser::instantiate(config, state);
+            // The trace covers the scenes loaded so far
+            if (!trace_filename.empty())
+                Trace::write(trace_filename);
 
             if (objects.size() != 1)
                 Throw("Root element of the input file is expanded into "
                       "multiple objects, only a single object is expected!");
 
-            MI_INVOKE_VARIANT(mode, render, objects[0].get(), sensor_i, filename);
+            MI_INVOKE_VARIANT(mode, render, objects[0].get(), sensors, seed,
+                              filename, stats_filename);
             arg_extra = arg_extra->next();
         }
     } catch (const std::exception &e) {
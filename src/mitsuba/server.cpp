@@ -0,0 +1,390 @@
+#include "server.h"
+
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/json.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/render/sensor.h>
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <typeinfo>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Maximum number of scenes that are kept in memory at the same time
+static constexpr size_t MaxCachedScenes = 8;
+
+template <typename Float, typename Spectrum>
+class RenderServer {
+public:
+    MI_IMPORT_TYPES()
+    MI_IMPORT_OBJECT_TYPES()
+
+    /// Location of a value exposed by Object::traverse()
+    struct Parameter {
+        void *ptr;
+        const std::type_info *type;
+        Object *node;
+        std::string name;
+    };
+
+    /// Position of an object in the traversal hierarchy
+    struct Node {
+        Object *parent;
+        std::string name;
+        size_t depth;
+    };
+
+    struct CachedScene {
+        ref<Scene> scene;
+        std::unordered_map<std::string, Parameter> params;
+        std::unordered_map<Object *, Node> nodes;
+        /// Callbacks that undo the parameter changes of the previous job
+        std::unordered_map<std::string, std::function<void()>> restore;
+        size_t last_used = 0;
+    };
+
+    /// Records the parameters of an object graph, mirroring mi.traverse()
+    struct ParameterCollector : public TraversalCallback {
+        CachedScene &entry;
+        Object *node;
+        std::string prefix;
+        size_t depth;
+
+        ParameterCollector(CachedScene &entry, Object *node,
+                           const std::string &prefix, size_t depth)
+            : entry(entry), node(node), prefix(prefix), depth(depth) { }
+
+        void put_value(std::string_view name, void *ptr, uint32_t,
+                       const std::type_info &type) override {
+            entry.params[prefix + std::string(name)] =
+                Parameter{ ptr, &type, node, std::string(name) };
+        }
+
+        void put_object(std::string_view name, Object *obj, uint32_t) override {
+            if (!obj || entry.nodes.find(obj) != entry.nodes.end())
+                return;
+            entry.nodes[obj] = Node{ node, std::string(name), depth + 1 };
+            ParameterCollector cb(entry, obj, prefix + std::string(name) + ".",
+                                  depth + 1);
+            obj->traverse(&cb);
+        }
+    };
+
+    RenderServer(const parser::ParserConfig &config) : m_config(config) { }
+
+    void run(std::istream &in, std::ostream &out) {
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+
+            std::string id;
+            try {
+                JSONValue job = parse_json(line);
+                if (!job.is_object())
+                    Throw("Expected a JSON object");
+
+                if (const JSONValue *v = job.find("id"))
+                    id = v->is_string() ? v->string : v->to_string();
+
+                std::string command = job.get_string("command");
+                if (command == "quit") {
+                    out << "{\"status\":\"ok\",\"command\":\"quit\"}" << std::endl;
+                    break;
+                } else if (command == "clear") {
+                    m_scenes.clear();
+                    out << "{\"status\":\"ok\",\"command\":\"clear\"}" << std::endl;
+                    continue;
+                } else if (!command.empty()) {
+                    Throw("Unknown command \"%s\"", command);
+                }
+
+                out << render_job(id, job) << std::endl;
+            } catch (const std::exception &e) {
+                Log(Warn, "Render job %s failed: %s", id.empty() ? "<unnamed>" : id, e.what());
+                out << tfm::format("{\"id\":%s,\"status\":\"error\",\"message\":%s}",
+                                   json_string(id), json_string(e.what()))
+                    << std::endl;
+            }
+        }
+    }
+
+private:
+    std::string render_job(const std::string &id, const JSONValue &job) {
+        Timer timer;
+
+        fs::path scene_path = job.get_string("scene");
+        fs::path output = job.get_string("output");
+        if (scene_path.empty() || output.empty())
+            Throw("Render jobs must specify \"scene\" and \"output\"");
+
+        parser::ParameterList defines;
+        if (const JSONValue *v = job.find("defines")) {
+            if (!v->is_object())
+                Throw("\"defines\" must be a JSON object");
+            for (const auto &[key, value] : v->object)
+                defines.emplace_back(key, value.is_string() ? value.string
+                                                            : value.to_string());
+        }
+
+        // Look up the scene, or load it
+        bool cached = true;
+        std::string key = fs::absolute(scene_path).string();
+        for (const auto &[k, v] : defines)
+            key += "|" + k + "=" + v;
+
+        auto it = m_scenes.find(key);
+        if (it == m_scenes.end()) {
+            cached = false;
+            it = m_scenes.emplace(key, load(scene_path, defines)).first;
+        }
+        CachedScene &entry = it->second;
+        entry.last_used = ++m_job_count;
+        float load_time = timer.reset() / 1000.f;
+
+        // Undo the changes of the previous job and apply the new ones
+        update(entry, job.find("params"));
+        float update_time = timer.reset() / 1000.f;
+
+        Scene *scene = entry.scene;
+        size_t sensor = (size_t) job.get_number("sensor", 0);
+        if (sensor >= scene->sensors().size())
+            Throw("Sensor index %zu is out of bounds", sensor);
+
+        Integrator *integrator = scene->integrator();
+        if (!integrator)
+            Throw("No integrator specified for scene: %s", scene_path);
+
+        integrator->render(scene, (uint32_t) sensor,
+                           (uint32_t) job.get_number("seed", 0),
+                           (uint32_t) job.get_number("spp", 0),
+                           false /* develop */,
+                           true /* evaluate */);
+        float render_time = timer.reset() / 1000.f;
+
+        scene->sensors()[sensor]->film()->write(output);
+        float write_time = timer.reset() / 1000.f;
+
+        Log(Info, "Render job %s done (load: %s, update: %s, render: %s, write: %s)",
+            id.empty() ? "<unnamed>" : id,
+            cached ? "cached" : util::time_string(load_time * 1000.f),
+            util::time_string(update_time * 1000.f),
+            util::time_string(render_time * 1000.f),
+            util::time_string(write_time * 1000.f));
+
+        return tfm::format(
+            "{\"id\":%s,\"status\":\"ok\",\"output\":%s,\"cached\":%s,"
+            "\"load_time\":%.6f,\"update_time\":%.6f,\"render_time\":%.6f,"
+            "\"write_time\":%.6f}",
+            json_string(id), json_string(output.string()),
+            cached ? "true" : "false", load_time, update_time, render_time,
+            write_time);
+    }
+
+    CachedScene load(const fs::path &filename,
+                     const parser::ParameterList &defines) {
+        // Evict the least recently used scene if the cache is full
+        if (m_scenes.size() >= MaxCachedScenes) {
+            auto lru = std::min_element(
+                m_scenes.begin(), m_scenes.end(), [](const auto &a, const auto &b) {
+                    return a.second.last_used < b.second.last_used;
+                });
+            m_scenes.erase(lru);
+        }
+
+        ref<FileResolver> fr_backup = file_resolver();
+        ref<FileResolver> fr = new FileResolver(*fr_backup);
+        fs::path scene_dir = filename.parent_path();
+        if (!fr->contains(scene_dir))
+            fr->append(scene_dir);
+        set_file_resolver(fr);
+
+        std::vector<ref<Object>> objects;
+        try {
+            parser::ParserState state =
+                parser::parse_file_cached(m_config, filename, defines);
+            objects = parser::instantiate(m_config, state);
+        } catch (...) {
+            set_file_resolver(fr_backup);
+            throw;
+        }
+        set_file_resolver(fr_backup);
+
+        Scene *scene = objects.size() == 1
+                           ? dynamic_cast<Scene *>(objects[0].get())
+                           : nullptr;
+        if (!scene)
+            Throw("Root element of \"%s\" must be a <scene> tag!", filename);
+
+        CachedScene entry;
+        entry.scene = scene;
+        entry.nodes[scene] = Node{ nullptr, "", 0 };
+        ParameterCollector cb(entry, scene, "", 0);
+        scene->traverse(&cb);
+        return entry;
+    }
+
+    void update(CachedScene &entry, const JSONValue *params) {
+        if (params && !params->is_object())
+            Throw("\"params\" must be a JSON object");
+
+        // Keys that changed for each object, see mi.SceneParameters.set_dirty()
+        std::unordered_map<Object *, std::vector<std::string>> dirty;
+        auto set_dirty = [&](const Parameter &param) {
+            std::string name = param.name;
+            for (Object *node = param.node; node; ) {
+                const Node &info = entry.nodes[node];
+                std::vector<std::string> &keys = dirty[node];
+                if (std::find(keys.begin(), keys.end(), name) == keys.end())
+                    keys.push_back(name);
+                name = info.name;
+                node = info.parent;
+            }
+        };
+
+        for (auto &[key, restore] : entry.restore) {
+            restore();
+            set_dirty(entry.params[key]);
+        }
+        entry.restore.clear();
+
+        if (params) {
+            for (const auto &[key, value] : params->object) {
+                auto it = entry.params.find(key);
+                if (it == entry.params.end())
+                    Throw("Unknown scene parameter \"%s\"", key);
+                entry.restore[key] = set(key, it->second, value);
+                set_dirty(it->second);
+            }
+        }
+
+        if (dirty.empty())
+            return;
+
+        // Notify objects from the bottom to the top of the hierarchy
+        std::vector<std::pair<Object *, std::vector<std::string>>> work(
+            dirty.begin(), dirty.end());
+        std::sort(work.begin(), work.end(), [&](const auto &a, const auto &b) {
+            return entry.nodes[a.first].depth > entry.nodes[b.first].depth;
+        });
+        for (auto &[node, keys] : work)
+            node->parameters_changed(keys);
+
+        if constexpr (dr::is_jit_v<Float>)
+            dr::eval();
+    }
+
+    /// Overwrite a parameter and return a function that restores its value
+    template <typename T>
+    static std::function<void()> assign(void *ptr, const T &value) {
+        T *target = (T *) ptr;
+        std::function<void()> restore = [target, old = *target]() { *target = old; };
+        *target = value;
+        return restore;
+    }
+
+    static std::function<void()> set(const std::string &key,
+                                     const Parameter &param,
+                                     const JSONValue &value) {
+        const std::type_info &type = *param.type;
+
+        // Flatten (possibly nested) arrays of numbers
+        std::vector<ScalarFloat> v;
+        std::function<void(const JSONValue &)> flatten = [&](const JSONValue &x) {
+            if (x.is_number())
+                v.push_back((ScalarFloat) x.number);
+            else if (x.is_bool())
+                v.push_back(x.boolean ? 1.f : 0.f);
+            else if (x.is_array())
+                for (const JSONValue &y : x.array)
+                    flatten(y);
+            else
+                Throw("Scene parameter \"%s\": expected numeric values", key);
+        };
+        flatten(value);
+
+        auto check_size = [&](size_t n) {
+            // Allow a single value to be broadcast to all components
+            if (v.size() == 1 && n > 1)
+                v.resize(n, v[0]);
+            if (v.size() != n)
+                Throw("Scene parameter \"%s\": expected %zu values, got %zu",
+                      key, n, v.size());
+        };
+
+        auto matrix = [&]() {
+            check_size(16);
+            ScalarMatrix4f m;
+            for (size_t i = 0; i < 4; ++i)
+                for (size_t j = 0; j < 4; ++j)
+                    m(i, j) = v[i * 4 + j];
+            return m;
+        };
+
+        if (type == typeid(Float)) {
+            check_size(1);
+            return assign(param.ptr, Float(v[0]));
+        } else if (type == typeid(ScalarFloat)) {
+            check_size(1);
+            return assign(param.ptr, v[0]);
+        } else if (type == typeid(Color3f)) {
+            check_size(3);
+            return assign(param.ptr, Color3f(v[0], v[1], v[2]));
+        } else if (type == typeid(ScalarColor3f)) {
+            check_size(3);
+            return assign(param.ptr, ScalarColor3f(v[0], v[1], v[2]));
+        } else if (type == typeid(Point3f)) {
+            check_size(3);
+            return assign(param.ptr, Point3f(v[0], v[1], v[2]));
+        } else if (type == typeid(Vector3f)) {
+            check_size(3);
+            return assign(param.ptr, Vector3f(v[0], v[1], v[2]));
+        } else if (type == typeid(AffineTransform4f)) {
+            return assign(param.ptr, AffineTransform4f(ScalarAffineTransform4f(matrix())));
+        } else if (type == typeid(ScalarAffineTransform4f)) {
+            return assign(param.ptr, ScalarAffineTransform4f(matrix()));
+        } else if (type == typeid(int32_t) || type == typeid(Int32)) {
+            check_size(1);
+            return type == typeid(Int32) ? assign(param.ptr, Int32((int32_t) v[0]))
+                                         : assign(param.ptr, (int32_t) v[0]);
+        } else if (type == typeid(uint32_t) || type == typeid(UInt32)) {
+            check_size(1);
+            return type == typeid(UInt32) ? assign(param.ptr, UInt32((uint32_t) v[0]))
+                                          : assign(param.ptr, (uint32_t) v[0]);
+        } else if (type == typeid(bool)) {
+            check_size(1);
+            return assign(param.ptr, v[0] != 0);
+        }
+
+        Throw("Scene parameter \"%s\" has a type that cannot be set by the "
+              "render server", key);
+    }
+
+    parser::ParserConfig m_config;
+    std::unordered_map<std::string, CachedScene> m_scenes;
+    size_t m_job_count = 0;
+};
+
+template <typename Float, typename Spectrum>
+void serve(const parser::ParserConfig &config, std::istream &in, std::ostream &out) {
+    RenderServer<Float, Spectrum> server(config);
+    server.run(in, out);
+}
+
+void run_render_server(const parser::ParserConfig &config, std::istream &in,
+                       std::ostream &out) {
+    Log(Info, "Render server ready (variant: %s), waiting for jobs ..",
+        config.variant);
+    MI_INVOKE_VARIANT(config.variant, serve, config, in, out);
+}
+
+NAMESPACE_END(mitsuba)
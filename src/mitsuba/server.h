@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mitsuba/core/parser.h>
+#include <iosfwd>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Process render jobs until the input stream is closed
+ *
+ * Each line of \c in must contain a JSON object describing a render job:
+ *
+ * \code
+ * {"id": "frame-1", "scene": "scene.xml", "output": "frame-1.exr",
+ *  "defines": {"spp": "64"}, "params": {"camera.to_world": [...]},
+ *  "sensor": 0, "spp": 0, "seed": 0}
+ * \endcode
+ *
+ * Loaded scenes are kept in memory and reused by later jobs that reference
+ * the same file with the same \c defines (XML parameter substitutions).
+ * Entries of \c params are applied to scene parameters exposed by
+ * Object::traverse() (using the same naming scheme as mi.traverse() in
+ * Python), followed by calls to Object::parameters_changed(). They only
+ * affect the job that specifies them.
+ *
+ * One JSON line is written to \c out per job, reporting the status and the
+ * time spent loading, updating, rendering, and writing the image. The line
+ * <tt>{"command": "clear"}</tt> releases all cached scenes, and
+ * <tt>{"command": "quit"}</tt> stops the server.
+ */
+extern void run_render_server(const parser::ParserConfig &config,
+                              std::istream &in, std::ostream &out);
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,121 @@
+import os
+import socket
+import subprocess
+import time
+
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from mitsuba.scalar_rgb.test.util import find_mitsuba_executable
+
+pytestmark = pytest.mark.skipif(
+    os.name == 'nt', reason='Distributed rendering is not supported on Windows')
+
+SCENE = """<scene version="3.0.0">
+    <integrator type="path"/>
+    <sensor type="perspective">
+        <transform name="to_world">
+            <lookat origin="0, 0, 4" target="0, 0, 0" up="0, 1, 0"/>
+        </transform>
+        <sampler type="independent">
+            <integer name="sample_count" value="8"/>
+        </sampler>
+        <film type="hdrfilm">
+            <integer name="width" value="80"/>
+            <integer name="height" value="60"/>
+            <rfilter type="box"/>
+        </film>
+    </sensor>
+    <shape type="sphere">
+        <bsdf type="diffuse"/>
+    </shape>
+    <emitter type="constant"/>
+</scene>
+"""
+
+
+def test01_coordinator_two_workers(variant_scalar_rgb, tmp_path):
+    mitsuba = find_mitsuba_executable()
+    if mitsuba is None:
+        pytest.skip('The mitsuba executable was not found')
+
+    scene = tmp_path / 'scene.xml'
+    scene.write_text(SCENE)
+    address = 'unix:' + str(tmp_path / 'coordinator.sock')
+    common = [mitsuba, '-m', 'scalar_rgb', '-t', '2']
+
+    # Reference: single-process render
+    ref_path = str(tmp_path / 'ref.exr')
+    subprocess.run(common + ['-o', ref_path, str(scene)], check=True,
+                   timeout=300, capture_output=True)
+
+    out_path = str(tmp_path / 'distributed.exr')
+    coordinator = subprocess.Popen(
+        common + ['--coordinator', address, '-o', out_path, str(scene)],
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    workers = [subprocess.Popen(common + ['--worker', address],
+                                stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+               for _ in range(2)]
+
+    try:
+        for p in [coordinator] + workers:
+            out, err = p.communicate(timeout=300)
+            # A regular end of the job must not produce errors on either side
+            assert p.returncode == 0, (out + err).decode()
+    finally:
+        for p in [coordinator] + workers:
+            if p.poll() is None:
+                p.kill()
+
+    # Blocks are seeded by their index, hence the images should match
+    ref = mi.TensorXf(mi.Bitmap(ref_path))
+    result = mi.TensorXf(mi.Bitmap(out_path))
+    assert ref.shape == result.shape
+    assert dr.allclose(ref, result, rtol=1e-4, atol=1e-5)
+
+
+def test02_stalled_handshake(variant_scalar_rgb, tmp_path):
+    # A client that connects without sending the handshake must not prevent
+    # other workers from being served
+    mitsuba = find_mitsuba_executable()
+    if mitsuba is None:
+        pytest.skip('The mitsuba executable was not found')
+
+    scene = tmp_path / 'scene.xml'
+    scene.write_text(SCENE)
+    sock_path = str(tmp_path / 'coordinator.sock')
+    common = [mitsuba, '-m', 'scalar_rgb', '-t', '1']
+
+    out_path = str(tmp_path / 'distributed.exr')
+    coordinator = subprocess.Popen(
+        common + ['--coordinator', 'unix:' + sock_path, '-o', out_path, str(scene)],
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+
+    stalled = None
+    worker = None
+    try:
+        # Wait until the coordinator listens, then connect and stay silent
+        for _ in range(300):
+            stalled = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            try:
+                stalled.connect(sock_path)
+                break
+            except OSError:
+                stalled.close()
+                stalled = None
+                time.sleep(0.1)
+        assert stalled is not None
+
+        worker = subprocess.Popen(common + ['--worker', 'unix:' + sock_path],
+                                  stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        for p in [coordinator, worker]:
+            out, err = p.communicate(timeout=300)
+            assert p.returncode == 0, (out + err).decode()
+        assert os.path.exists(out_path)
+    finally:
+        if stalled is not None:
+            stalled.close()
+        for p in [coordinator, worker]:
+            if p is not None and p.poll() is None:
+                p.kill()
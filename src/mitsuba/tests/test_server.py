@@ -0,0 +1,143 @@
+import json
+import subprocess
+
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from mitsuba.scalar_rgb.test.util import find_mitsuba_executable
+
+SCENE = """<scene version="3.0.0">
+    <default name="spp" value="4"/>
+    <integrator type="path"/>
+    <sensor type="perspective">
+        <transform name="to_world">
+            <lookat origin="0, 0, 4" target="0, 0, 0" up="0, 1, 0"/>
+        </transform>
+        <sampler type="independent">
+            <integer name="sample_count" value="$spp"/>
+        </sampler>
+        <film type="hdrfilm">
+            <integer name="width" value="32"/>
+            <integer name="height" value="24"/>
+            <rfilter type="box"/>
+        </film>
+    </sensor>
+    <shape type="sphere">
+        <bsdf type="diffuse"/>
+    </shape>
+    <emitter type="constant" id="light"/>
+</scene>
+"""
+
+
+def run_server(lines):
+    """Send one line per job to a render server and return its replies"""
+    mitsuba = find_mitsuba_executable()
+    if mitsuba is None:
+        pytest.skip('The mitsuba executable was not found')
+
+    result = subprocess.run([mitsuba, '-m', 'scalar_rgb', '-t', '1', '--server'],
+                            input='\n'.join(lines + ['{"command": "quit"}']) + '\n',
+                            capture_output=True, encoding='utf-8', timeout=300)
+    assert result.returncode == 0, result.stderr
+    replies = [json.loads(line) for line in result.stdout.splitlines()]
+
+    # Every job gets exactly one reply, the last one confirms the shutdown
+    assert len(replies) == len(lines) + 1, result.stdout
+    assert replies[-1] == {'status': 'ok', 'command': 'quit'}
+    return replies[:-1]
+
+
+def test01_json_values(variant_scalar_rgb):
+    # The server echoes the "id" of a job in its reply, strings verbatim
+    # and other values re-serialized
+    values = [
+        0, -12, 1.5, -2.5e-3, 6.02e23,
+        True, False, None,
+        'plain', 'quote " backslash \\ slash /', 'tab\tnewline\nreturn\r',
+        '\b\f\x01', 'café €',
+        [], {}, [1, [2, [3, []]], {'a': {'b': [None]}}],
+        {'z': 1, 'a': 2, 'm': [True, 'x']}
+    ]
+    replies = run_server(['{"id": %s, "command": "none"}' % json.dumps(v)
+                          for v in values])
+
+    for value, reply in zip(values, replies):
+        assert reply['status'] == 'error'
+        assert 'Unknown command' in reply['message']
+        if isinstance(value, str):
+            assert reply['id'] == value
+        else:
+            assert json.loads(reply['id']) == value
+
+
+def test02_json_escapes(variant_scalar_rgb):
+    # Escapes that Python's encoder does not produce by default
+    replies = run_server([
+        r'{"id": "\u0041\u00e9\u20ac", "command": "none"}',
+        r'{"id": "\/\"\\", "command": "none"}',
+        '{ "id" :\t"spaces" ,\r "command" : "none" }',
+    ])
+    assert [r['id'] for r in replies] == ['Aé€', '/"\\', 'spaces']
+
+
+def test03_malformed_json(variant_scalar_rgb):
+    lines = [
+        '{', '}', '[1, 2', '{"id": }', '{"id" "x"}', '{"id": "x",}',
+        '{"id": "unterminated}', '{"id": "\\q"}', '{"id": "\\u12"}',
+        '{"id": tru}', '{"id": nul}', '{"id": .}', '{} trailing', '{"a": 1}}',
+        '{id: "x"}', '[1 2]'
+    ]
+    # Errors are reported per line, the server keeps serving jobs
+    for line, reply in zip(lines, run_server(lines)):
+        assert reply['status'] == 'error', line
+        assert 'JSON parse error' in reply['message'], line
+
+
+def test04_render_job(variant_scalar_rgb, tmp_path):
+    scene = tmp_path / 'scene.xml'
+    scene.write_text(SCENE)
+
+    def job(id, **kwargs):
+        return json.dumps({'id': id, 'scene': str(scene),
+                           'output': str(tmp_path / f'{id}.exr'), **kwargs})
+
+    replies = run_server([
+        job('first'),
+        job('second', params={'light.radiance.value': 2}),
+        job('third'),
+        '[1, 2, 3]',
+        json.dumps({'id': 'no_output', 'scene': str(scene)}),
+        job('bad_param', params={'does.not.exist': 1}),
+        job('bad_sensor', sensor=3),
+        job('fourth', defines={'spp': '2'}),
+    ])
+    ids = [r.get('id') for r in replies]
+    assert ids == ['first', 'second', 'third', '', 'no_output', 'bad_param',
+                   'bad_sensor', 'fourth']
+
+    for r in [replies[0], replies[1], replies[2], replies[7]]:
+        assert r['status'] == 'ok', r
+        assert r['output'].endswith(r['id'] + '.exr')
+        for key in ['load_time', 'update_time', 'render_time', 'write_time']:
+            assert r[key] >= 0
+    # The scene is kept in memory, except when the defines change
+    assert [r['cached'] for r in [replies[0], replies[1], replies[2], replies[7]]] == \
+        [False, True, True, False]
+
+    assert replies[3]['status'] == 'error'
+    assert 'Expected a JSON object' in replies[3]['message']
+    assert replies[4]['status'] == 'error'
+    assert 'must specify' in replies[4]['message']
+    assert replies[5]['status'] == 'error'
+    assert 'does.not.exist' in replies[5]['message']
+    assert replies[6]['status'] == 'error'
+    assert 'out of bounds' in replies[6]['message']
+
+    # Parameter changes only apply to the job that requested them
+    first, second, third = [
+        mi.TensorXf(mi.Bitmap(str(tmp_path / f'{id}.exr')))
+        for id in ['first', 'second', 'third']]
+    assert dr.allclose(second, 2 * first, rtol=1e-4, atol=1e-5)
+    assert dr.allclose(third, first)
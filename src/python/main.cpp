@@ -24,10 +24,14 @@ MI_PY_DECLARE(DummyStream);
 MI_PY_DECLARE(FileStream);
 MI_PY_DECLARE(MemoryStream);
 MI_PY_DECLARE(ZStream);
+MI_PY_DECLARE(BlockZStream);
 MI_PY_DECLARE(ProgressReporter);
 MI_PY_DECLARE(rfilter);
 MI_PY_DECLARE(Thread);
 MI_PY_DECLARE(Timer);
+MI_PY_DECLARE(Trace);
+MI_PY_DECLARE(Statistics);
+MI_PY_DECLARE(MemoryUsage);
 MI_PY_DECLARE(Properties);
 MI_PY_DECLARE(parser);
 MI_PY_DECLARE(misc);
@@ -145,9 +149,13 @@ NB_MODULE(mitsuba_ext, m) {
     MI_PY_IMPORT(FileStream);
     MI_PY_IMPORT(MemoryStream);
     MI_PY_IMPORT(ZStream);
+    MI_PY_IMPORT(BlockZStream);
     MI_PY_IMPORT(ProgressReporter);
     MI_PY_IMPORT(Thread);
     MI_PY_IMPORT(Timer);
+    MI_PY_IMPORT(Trace);
+    MI_PY_IMPORT(Statistics);
+    MI_PY_IMPORT(MemoryUsage);
     MI_PY_IMPORT(Properties);
     MI_PY_IMPORT(parser);
     MI_PY_IMPORT(misc);
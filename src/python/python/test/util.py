@@ -20,6 +20,25 @@ def find_resource(fname):
             raise Exception("find_resource(): could not find \"%s\"" % fname)
         path = os.path.dirname(path)
 
+def find_mitsuba_executable():
+    """
+    Return the path of the ``mitsuba`` command line executable that belongs to
+    the imported Python package, or ``None`` if it cannot be found (e.g. when
+    only the Python bindings were built).
+    """
+    import mitsuba as mi
+
+    name = 'mitsuba.exe' if os.name == 'nt' else 'mitsuba'
+    package = os.path.dirname(os.path.realpath(mi.__file__))
+
+    # Wheels ship the executable within the package, while it is located two
+    # levels above the package in the build directory
+    for path in [package, os.path.dirname(os.path.dirname(package))]:
+        candidate = os.path.join(path, name)
+        if os.path.isfile(candidate) and os.access(candidate, os.X_OK):
+            return candidate
+    return None
+
 def fresolver_append_path(func):
     """
     Function decorator that adds the mitsuba project root
@@ -0,0 +1,705 @@
+#include <mitsuba/render/bvh.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+NAMESPACE_BEGIN(detail)
+
+/**
+ * \brief Helper class that constructs the binary SAH hierarchy which is
+ * subsequently collapsed into the wide BVH
+ */
+template <typename Float, typename Spectrum> struct BVHBuilder {
+    MI_IMPORT_CORE_TYPES()
+    using BVH     = ShapeBVH<Float, Spectrum>;
+    using Size    = typename BVH::Size;
+    using Index   = typename BVH::Index;
+    using PrimRef = typename BVH::PrimRef;
+
+    /// Primitive record used during construction
+    struct BuildPrim {
+        ScalarBoundingBox3f bbox;
+        ScalarPoint3f center;
+        PrimRef ref;
+    };
+
+    /// Node of the binary hierarchy (a leaf if \c prim_count > 0)
+    struct BuildNode {
+        ScalarBoundingBox3f bbox;
+        Index left = 0;
+        Index prim_offset = 0;
+        Size prim_count = 0;
+    };
+
+    /// SAH bin
+    struct Bin {
+        ScalarBoundingBox3f bbox;
+        Size count = 0;
+    };
+
+    struct Split {
+        ScalarFloat cost = dr::Infinity<ScalarFloat>;
+        uint32_t axis = 0;
+        uint32_t bin = 0;
+    };
+
+    BVHBuilder(Size prim_count, Size max_leaf_size, Size bin_count,
+               ScalarFloat traversal_cost, ScalarFloat intersection_cost)
+        : prims(new BuildPrim[prim_count]),
+          nodes(new BuildNode[std::max(2 * prim_count, 1u)]),
+          max_leaf_size(max_leaf_size), bin_count(bin_count),
+          traversal_cost(traversal_cost),
+          intersection_cost(intersection_cost) { }
+
+    /// Compute the bounds of the primitives and of their centers
+    void compute_bounds(Index begin, Index end, ScalarBoundingBox3f &bounds,
+                        ScalarBoundingBox3f &center_bounds) const {
+        if (end - begin < MI_BVH_GRAIN_SIZE) {
+            for (Index i = begin; i < end; ++i) {
+                bounds.expand(prims[i].bbox);
+                center_bounds.expand(prims[i].center);
+            }
+            return;
+        }
+
+        std::mutex mutex;
+        dr::parallel_for(
+            dr::blocked_range<Index>(begin, end, MI_BVH_GRAIN_SIZE),
+            [&](const dr::blocked_range<Index> &range) {
+                ScalarBoundingBox3f local_bounds, local_center_bounds;
+                for (Index i = range.begin(); i != range.end(); ++i) {
+                    local_bounds.expand(prims[i].bbox);
+                    local_center_bounds.expand(prims[i].center);
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                bounds.expand(local_bounds);
+                center_bounds.expand(local_center_bounds);
+            }
+        );
+    }
+
+    /// Map a primitive center to a bin along \c axis
+    MI_INLINE uint32_t bin_index(const ScalarPoint3f &center, uint32_t axis,
+                                 const ScalarBoundingBox3f &center_bounds,
+                                 const ScalarVector3f &bin_scale) const {
+        ScalarFloat rel = (center[axis] - center_bounds.min[axis]) * bin_scale[axis];
+        return std::min((uint32_t) std::max(rel, ScalarFloat(0)), bin_count - 1);
+    }
+
+    /// Find the best SAH split using binning along all three axes
+    Split find_split(Index begin, Index end,
+                     const ScalarBoundingBox3f &bounds,
+                     const ScalarBoundingBox3f &center_bounds,
+                     const ScalarVector3f &bin_scale) const {
+        std::unique_ptr<Bin[]> bins(new Bin[3 * bin_count]);
+
+        auto put = [&](Bin *target, Index i0, Index i1) {
+            for (Index i = i0; i < i1; ++i) {
+                const BuildPrim &prim = prims[i];
+                for (uint32_t axis = 0; axis < 3; ++axis) {
+                    Bin &bin = target[axis * bin_count +
+                        bin_index(prim.center, axis, center_bounds, bin_scale)];
+                    bin.bbox.expand(prim.bbox);
+                    bin.count++;
+                }
+            }
+        };
+
+        if (end - begin < MI_BVH_GRAIN_SIZE) {
+            put(bins.get(), begin, end);
+        } else {
+            std::mutex mutex;
+            dr::parallel_for(
+                dr::blocked_range<Index>(begin, end, MI_BVH_GRAIN_SIZE),
+                [&](const dr::blocked_range<Index> &range) {
+                    std::unique_ptr<Bin[]> local(new Bin[3 * bin_count]);
+                    put(local.get(), range.begin(), range.end());
+                    std::lock_guard<std::mutex> lock(mutex);
+                    for (uint32_t i = 0; i < 3 * bin_count; ++i) {
+                        bins[i].bbox.expand(local[i].bbox);
+                        bins[i].count += local[i].count;
+                    }
+                }
+            );
+        }
+
+        Split best;
+        ScalarFloat inv_area = 1.f / bounds.surface_area();
+        std::unique_ptr<ScalarFloat[]> right_cost(new ScalarFloat[bin_count]);
+
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            if (bin_scale[axis] == 0.f)
+                continue;
+
+            const Bin *axis_bins = bins.get() + axis * bin_count;
+
+            // Sweep from the right: cost contribution of bins [i, bin_count)
+            ScalarBoundingBox3f right_bounds;
+            Size right_count = 0;
+            for (uint32_t i = bin_count - 1; i > 0; --i) {
+                right_bounds.expand(axis_bins[i].bbox);
+                right_count += axis_bins[i].count;
+                right_cost[i] = right_count > 0
+                    ? right_bounds.surface_area() * right_count : 0.f;
+            }
+
+            // Sweep from the left and evaluate the split in front of bin i
+            ScalarBoundingBox3f left_bounds;
+            Size left_count = 0;
+            for (uint32_t i = 1; i < bin_count; ++i) {
+                left_bounds.expand(axis_bins[i - 1].bbox);
+                left_count += axis_bins[i - 1].count;
+                if (left_count == 0 || left_count == end - begin)
+                    continue;
+
+                ScalarFloat cost = traversal_cost + intersection_cost * inv_area *
+                    (left_bounds.surface_area() * left_count + right_cost[i]);
+
+                if (cost < best.cost) {
+                    best.cost = cost;
+                    best.axis = axis;
+                    best.bin  = i;
+                }
+            }
+        }
+
+        return best;
+    }
+
+    /// Recursively build the subtree of node \c node_index over the given range
+    void build(Index node_index, Index begin, Index end, Size depth) {
+        BuildNode &node = nodes[node_index];
+        Size count = end - begin;
+
+        ScalarBoundingBox3f center_bounds;
+        compute_bounds(begin, end, node.bbox, center_bounds);
+
+        if (count <= 1) {
+            make_leaf(node, begin, count);
+            return;
+        }
+
+        ScalarVector3f extents = center_bounds.extents(), bin_scale;
+        for (uint32_t axis = 0; axis < 3; ++axis)
+            bin_scale[axis] = extents[axis] > 0.f
+                ? ScalarFloat(bin_count) * (1.f - dr::Epsilon<ScalarFloat>) / extents[axis]
+                : ScalarFloat(0);
+
+        Split split;
+        if (depth < MI_BVH_MAXDEPTH && dr::any(extents > 0.f))
+            split = find_split(begin, end, node.bbox, center_bounds, bin_scale);
+
+        if (count <= max_leaf_size &&
+            !(split.cost < intersection_cost * count)) {
+            make_leaf(node, begin, count);
+            return;
+        }
+
+        Index mid;
+        if (split.cost != dr::Infinity<ScalarFloat>) {
+            mid = (Index) (std::partition(
+                prims.get() + begin, prims.get() + end,
+                [&](const BuildPrim &prim) {
+                    return bin_index(prim.center, split.axis, center_bounds,
+                                     bin_scale) < split.bin;
+                }) - prims.get());
+        } else {
+            /* No useful SAH split (e.g. all centers coincide, or the depth
+               limit was reached): split at the object median */
+            uint32_t axis = (uint32_t) center_bounds.major_axis();
+            mid = begin + count / 2;
+            std::nth_element(prims.get() + begin, prims.get() + mid,
+                             prims.get() + end,
+                             [axis](const BuildPrim &a, const BuildPrim &b) {
+                                 return a.center[axis] < b.center[axis];
+                             });
+        }
+
+        Index children = node_counter.fetch_add(2);
+        node.left = children;
+
+        if (count > MI_BVH_GRAIN_SIZE) {
+            Task *left_task = dr::do_async(
+                [this, children, begin, mid, depth]() {
+                    build(children, begin, mid, depth + 1);
+                });
+            build(children + 1, mid, end, depth + 1);
+            task_wait_and_release(left_task);
+        } else {
+            build(children, begin, mid, depth + 1);
+            build(children + 1, mid, end, depth + 1);
+        }
+    }
+
+    void make_leaf(BuildNode &node, Index begin, Size count) {
+        node.prim_offset = begin;
+        node.prim_count = count;
+        leaf_counter++;
+    }
+
+    std::unique_ptr<BuildPrim[]> prims;
+    std::unique_ptr<BuildNode[]> nodes;
+    std::atomic<Index> node_counter { 1 };
+    std::atomic<Size> leaf_counter { 0 };
+
+    Size max_leaf_size;
+    Size bin_count;
+    ScalarFloat traversal_cost;
+    ScalarFloat intersection_cost;
+};
+
+NAMESPACE_END(detail)
+
+MI_VARIANT ShapeBVH<Float, Spectrum>::ShapeBVH(const Properties &props) {
+    /* BVH construction: maximum number of primitives stored in a leaf */
+    if (props.has_property("bvh_max_leaf_size"))
+        m_max_leaf_size = (Size) props.get<int>("bvh_max_leaf_size");
+
+    /* BVH construction: number of bins used to evaluate the SAH */
+    if (props.has_property("bvh_bins"))
+        m_bin_count = (Size) props.get<int>("bvh_bins");
+
+    /* BVH construction: relative cost of traversing a node */
+    m_traversal_cost = props.get<ScalarFloat>("bvh_traversal_cost", 1.f);
+
+    /* BVH construction: relative cost of a shape intersection operation */
+    m_intersection_cost = props.get<ScalarFloat>("bvh_intersection_cost", 1.f);
+
+    /* BVH refitting: tolerated growth of the SAH cost before a full rebuild
+       is requested (0 disables refitting) */
+    m_refit_threshold = props.get<ScalarFloat>("bvh_refit_threshold", 1.5f);
+
+    if (m_max_leaf_size == 0 || m_max_leaf_size >= InnerSlot)
+        Throw("The maximum leaf size must be in [1, %i]", InnerSlot - 1);
+    if (m_bin_count < 2)
+        Throw("The number of SAH bins must be >= 2");
+    if (m_traversal_cost <= 0 || m_intersection_cost <= 0)
+        Throw("The traversal and intersection costs must be > 0");
+    if (m_refit_threshold < 0)
+        Throw("The refit threshold must be >= 0");
+
+    m_primitive_map.push_back(0);
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::clear() {
+    m_shapes.clear();
+    m_primitive_map.clear();
+    m_primitive_map.push_back(0);
+    m_bbox.reset();
+    m_nodes.reset();
+    m_prims.reset();
+    m_node_bounds.reset();
+    m_node_count = 0;
+    m_prim_count = 0;
+    m_build_cost = m_cost = 0.f;
+    m_memory.set(0);
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::add_shape(Shape *shape) {
+    Assert(!ready());
+    m_primitive_map.push_back(m_primitive_map.back() +
+                              shape->primitive_count());
+    m_shapes.push_back(shape);
+    m_bbox.expand(shape->bbox());
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::init_quantization(
+    BVHNode &node, const ScalarBoundingBox3f &node_bounds) {
+    node.origin = node_bounds.min;
+
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        ScalarFloat lo = node_bounds.min[axis],
+                    hi = node_bounds.max[axis],
+                    margin = 4 * dr::Epsilon<ScalarFloat> *
+                             std::max(std::abs(lo), std::abs(hi));
+
+        /* Ensure that the grid covers the node bounds including a small
+           margin for rounding errors during dequantization */
+        ScalarFloat scale = (hi - lo + 2 * margin) * (1.f / 255.f);
+        while (std::isfinite(scale) &&
+               dr::fmadd(ScalarFloat(255), scale, lo) < hi + margin)
+            scale = std::nextafter(scale, dr::Infinity<ScalarFloat>);
+
+        node.scale[axis] = scale;
+    }
+
+    for (uint32_t i = 0; i < Width; ++i) {
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            node.lo[axis][i] = 255;
+            node.hi[axis][i] = 0;
+        }
+        node.child[i] = 0;
+        node.count[i] = EmptySlot;
+    }
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::quantize(
+    BVHNode &node, uint32_t slot, const ScalarBoundingBox3f &bounds,
+    const ScalarBoundingBox3f &node_bounds) {
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        ScalarFloat origin = node.origin[axis],
+                    scale  = node.scale[axis],
+                    margin = 4 * dr::Epsilon<ScalarFloat> *
+                             std::max(std::abs(node_bounds.min[axis]),
+                                      std::abs(node_bounds.max[axis]));
+
+        int lo = 0, hi = 255;
+        if (scale > 0.f) {
+            lo = (int) std::clamp(std::floor((bounds.min[axis] - origin) / scale),
+                                  ScalarFloat(0), ScalarFloat(255));
+            hi = (int) std::clamp(std::ceil((bounds.max[axis] - origin) / scale),
+                                  ScalarFloat(0), ScalarFloat(255));
+        }
+
+        // Round outwards until the quantized bounds are conservative
+        while (lo > 0 && dr::fmadd(ScalarFloat(lo), scale, origin) > bounds.min[axis] - margin)
+            --lo;
+        while (hi < 255 && dr::fmadd(ScalarFloat(hi), scale, origin) < bounds.max[axis] + margin)
+            ++hi;
+
+        node.lo[axis][slot] = (uint8_t) lo;
+        node.hi[axis][slot] = (uint8_t) hi;
+    }
+}
+
+MI_VARIANT typename ShapeBVH<Float, Spectrum>::ScalarBoundingBox3f
+ShapeBVH<Float, Spectrum>::child_bbox(const BVHNode &node, uint32_t slot) {
+    ScalarBoundingBox3f bbox;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        bbox.min[axis] = dr::fmadd(ScalarFloat(node.lo[axis][slot]),
+                                   node.scale[axis], node.origin[axis]);
+        bbox.max[axis] = dr::fmadd(ScalarFloat(node.hi[axis][slot]),
+                                   node.scale[axis], node.origin[axis]);
+    }
+    return bbox;
+}
+
+MI_VARIANT typename ShapeBVH<Float, Spectrum>::ScalarFloat
+ShapeBVH<Float, Spectrum>::node_cost(Index node_index) const {
+    const BVHNode &node = m_nodes[node_index];
+    ScalarFloat cost = m_traversal_cost * m_node_bounds[node_index].surface_area();
+    for (uint32_t i = 0; i < Width; ++i) {
+        if (node.count[i] == EmptySlot || node.count[i] == InnerSlot)
+            continue;
+        cost += m_intersection_cost * node.count[i] *
+                child_bbox(node, i).surface_area();
+    }
+    return cost;
+}
+
+MI_VARIANT typename ShapeBVH<Float, Spectrum>::ScalarFloat
+ShapeBVH<Float, Spectrum>::compute_cost() const {
+    if (m_node_count == 0)
+        return 0.f;
+
+    ScalarFloat area = m_node_bounds[0].surface_area();
+    if (!(area > 0.f))
+        return 0.f;
+
+    double cost = 0.0;
+    for (Size i = 0; i < m_node_count; ++i)
+        cost += (double) node_cost(i);
+
+    return (ScalarFloat) (cost / area);
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::build() {
+    using Builder   = detail::BVHBuilder<Float, Spectrum>;
+    using BuildNode = typename Builder::BuildNode;
+
+    if (ready())
+        Throw("The BVH has already been built!");
+
+    Timer timer;
+    Size prim_count = primitive_count();
+    Log(Info, "Building a SAH BVH%i (%i primitives) ..", Width, prim_count);
+
+    if (prim_count == 0) {
+        Log(Warn, "BVH contains no geometry!");
+        m_nodes.reset(new BVHNode[1]);
+        m_prims.reset(new PrimRef[1]);
+        m_node_count = m_prim_count = 0;
+        m_bbox.min = 0.f;
+        m_bbox.max = 0.f;
+        return;
+    }
+
+    Builder builder(prim_count, m_max_leaf_size, m_bin_count,
+                    m_traversal_cost, m_intersection_cost);
+
+    /* ==================================================================== */
+    /*                Gather primitive bounding boxes in parallel           */
+    /* ==================================================================== */
+
+    for (Size s = 0; s < shape_count(); ++s) {
+        const Shape *shape = m_shapes[s];
+        Size offset = m_primitive_map[s],
+             count  = m_primitive_map[s + 1] - offset;
+
+        dr::parallel_for(
+            dr::blocked_range<Size>(0u, count, MI_BVH_GRAIN_SIZE),
+            [&](const dr::blocked_range<Size> &range) {
+                for (Size i = range.begin(); i != range.end(); ++i) {
+                    auto &prim = builder.prims[offset + i];
+                    prim.bbox   = shape->bbox(i);
+                    prim.center = prim.bbox.center();
+                    prim.ref    = { s, i };
+                }
+            }
+        );
+    }
+
+    /* ==================================================================== */
+    /*                 Build the binary SAH hierarchy in parallel           */
+    /* ==================================================================== */
+
+    builder.build(0, 0, prim_count, 0);
+
+    /* ==================================================================== */
+    /*             Collapse the binary hierarchy into wide nodes            */
+    /* ==================================================================== */
+
+    std::vector<BVHNode> nodes;
+    std::vector<ScalarBoundingBox3f> node_bounds;
+    nodes.reserve(builder.leaf_counter / (Width / 2) + 1);
+    node_bounds.reserve(nodes.capacity());
+
+    auto collapse = [&](auto &self, Index bnode_index) -> Index {
+        const BuildNode &bnode = builder.nodes[bnode_index];
+
+        /* Greedily open the child with the largest surface area until the
+           node has 'Width' children or only leaves remain */
+        Index children[Width];
+        uint32_t child_count = 0;
+        if (bnode.prim_count > 0) {
+            children[child_count++] = bnode_index;
+        } else {
+            children[child_count++] = bnode.left;
+            children[child_count++] = bnode.left + 1;
+        }
+
+        while (child_count < Width) {
+            uint32_t best = Width;
+            ScalarFloat best_area = -1.f;
+            for (uint32_t i = 0; i < child_count; ++i) {
+                const BuildNode &c = builder.nodes[children[i]];
+                if (c.prim_count > 0)
+                    continue;
+                ScalarFloat area = c.bbox.surface_area();
+                if (area > best_area) {
+                    best = i;
+                    best_area = area;
+                }
+            }
+            if (best == Width)
+                break;
+            Index opened = children[best];
+            children[best] = builder.nodes[opened].left;
+            children[child_count++] = builder.nodes[opened].left + 1;
+        }
+
+        Index node_index = (Index) nodes.size();
+        nodes.emplace_back();
+        node_bounds.push_back(bnode.bbox);
+        init_quantization(nodes[node_index], bnode.bbox);
+
+        for (uint32_t i = 0; i < child_count; ++i) {
+            const BuildNode &c = builder.nodes[children[i]];
+            Index child;
+            uint8_t count;
+            if (c.prim_count > 0) {
+                child = c.prim_offset;
+                count = (uint8_t) c.prim_count;
+            } else {
+                child = self(self, children[i]);
+                count = InnerSlot;
+            }
+
+            // Note: 'nodes' may have been reallocated by the recursion
+            BVHNode &node = nodes[node_index];
+            node.child[i] = child;
+            node.count[i] = count;
+            quantize(node, i, c.bbox, bnode.bbox);
+        }
+
+        return node_index;
+    };
+
+    collapse(collapse, 0);
+
+    /* ==================================================================== */
+    /*     Store the node and reference lists in a compact contiguous format */
+    /* ==================================================================== */
+
+    m_node_count = (Size) nodes.size();
+    m_prim_count = prim_count;
+
+    m_nodes.reset(new BVHNode[m_node_count]);
+    std::copy(nodes.begin(), nodes.end(), m_nodes.get());
+
+    m_node_bounds.reset(new ScalarBoundingBox3f[m_node_count]);
+    std::copy(node_bounds.begin(), node_bounds.end(), m_node_bounds.get());
+
+    m_prims.reset(new PrimRef[m_prim_count]);
+    dr::parallel_for(
+        dr::blocked_range<Size>(0u, m_prim_count, MI_BVH_GRAIN_SIZE),
+        [&](const dr::blocked_range<Size> &range) {
+            for (Size i = range.begin(); i != range.end(); ++i)
+                m_prims[i] = builder.prims[i].ref;
+        }
+    );
+
+    m_bbox = builder.nodes[0].bbox;
+    m_build_cost = m_cost = compute_cost();
+
+    Log(m_log_level, "Structural BVH statistics:");
+    Log(m_log_level, "   Binary nodes : %i", (Size) builder.node_counter);
+    Log(m_log_level, "   Leaves       : %i", (Size) builder.leaf_counter);
+    Log(m_log_level, "   Wide nodes   : %i", m_node_count);
+    Log(m_log_level, "   Node size    : %i bytes", (Size) sizeof(BVHNode));
+    Log(m_log_level, "   SAH cost     : %.2f", m_cost);
+
+    m_memory.set(memory_usage(), "BVH");
+
+    Log(Info, "Finished. (%s of storage, took %s)",
+        util::mem_string(memory_usage()),
+        util::time_string((float) timer.value())
+    );
+}
+
+MI_VARIANT bool ShapeBVH<Float, Spectrum>::refit() {
+    if (!ready() || m_refit_threshold == 0.f)
+        return false;
+
+    // The topology of the BVH is only valid if no primitives were added or removed
+    for (Size s = 0; s < shape_count(); ++s) {
+        if (m_shapes[s]->primitive_count() !=
+            m_primitive_map[s + 1] - m_primitive_map[s])
+            return false;
+    }
+
+    std::unique_ptr<bool[]> shape_dirty(new bool[shape_count()]);
+    bool any_dirty = false;
+    for (Size s = 0; s < shape_count(); ++s) {
+        shape_dirty[s] = m_shapes[s]->dirty();
+        any_dirty |= shape_dirty[s];
+    }
+
+    if (!any_dirty || m_node_count == 0)
+        return true;
+
+    Timer timer;
+
+    /* ==================================================================== */
+    /*          Flag nodes referencing primitives of dirty shapes           */
+    /* ==================================================================== */
+
+    std::unique_ptr<uint8_t[]> node_dirty(new uint8_t[m_node_count]);
+    dr::parallel_for(
+        dr::blocked_range<Size>(0u, m_node_count, MI_BVH_GRAIN_SIZE / Width),
+        [&](const dr::blocked_range<Size> &range) {
+            for (Size n = range.begin(); n != range.end(); ++n) {
+                const BVHNode &node = m_nodes[n];
+                uint8_t dirty = 0;
+                for (uint32_t i = 0; i < Width && !dirty; ++i) {
+                    if (node.count[i] == EmptySlot || node.count[i] == InnerSlot)
+                        continue;
+                    for (Index j = node.child[i]; j < node.child[i] + node.count[i]; ++j) {
+                        if (shape_dirty[m_prims[j].shape_index]) {
+                            dirty = 1;
+                            break;
+                        }
+                    }
+                }
+                node_dirty[n] = dirty;
+            }
+        }
+    );
+
+    /* ==================================================================== */
+    /*         Recompute the bounds of the flagged nodes bottom-up          */
+    /* ==================================================================== */
+
+    /* Wide nodes are created in depth-first order, hence children are always
+       stored after their parent and a single pass in reverse order visits
+       them first. This also propagates the flags towards the root. */
+    Size updated = 0;
+    for (Size n = m_node_count; n-- > 0; ) {
+        BVHNode &node = m_nodes[n];
+
+        bool dirty = node_dirty[n] != 0;
+        for (uint32_t i = 0; i < Width && !dirty; ++i)
+            dirty = node.count[i] == InnerSlot && node_dirty[node.child[i]];
+
+        if (!dirty)
+            continue;
+
+        ScalarBoundingBox3f bounds, child_bounds[Width];
+        for (uint32_t i = 0; i < Width; ++i) {
+            if (node.count[i] == EmptySlot)
+                continue;
+            if (node.count[i] == InnerSlot) {
+                child_bounds[i] = m_node_bounds[node.child[i]];
+            } else {
+                for (Index j = node.child[i]; j < node.child[i] + node.count[i]; ++j)
+                    child_bounds[i].expand(
+                        m_shapes[m_prims[j].shape_index]->bbox(m_prims[j].prim_index));
+            }
+            bounds.expand(child_bounds[i]);
+        }
+
+        // Requantize the children relative to the new node bounds
+        Index child[Width];
+        uint8_t count[Width];
+        std::copy(node.child, node.child + Width, child);
+        std::copy(node.count, node.count + Width, count);
+
+        init_quantization(node, bounds);
+        for (uint32_t i = 0; i < Width; ++i) {
+            if (count[i] == EmptySlot)
+                continue;
+            node.child[i] = child[i];
+            node.count[i] = count[i];
+            quantize(node, i, child_bounds[i], bounds);
+        }
+
+        m_node_bounds[n] = bounds;
+        node_dirty[n] = 1;
+        updated++;
+    }
+
+    m_bbox = m_node_bounds[0];
+    m_cost = compute_cost();
+
+    Log(m_log_level, "Refit BVH (%i/%i nodes updated, SAH cost %.2f -> %.2f, took %s)",
+        updated, m_node_count, m_build_cost, m_cost,
+        util::time_string((float) timer.value()));
+
+    if (m_cost > m_refit_threshold * m_build_cost) {
+        Log(m_log_level, "Quality of the refit BVH degraded too much, a full "
+            "rebuild is required.");
+        return false;
+    }
+
+    return true;
+}
+
+MI_VARIANT std::string ShapeBVH<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "ShapeBVH[" << std::endl
+        << "  shapes = [" << std::endl;
+    for (auto shape : m_shapes)
+        oss << "    " << string::indent(shape, 4)
+            << "," << std::endl;
+    oss << "  ]" << std::endl << "]";
+    return oss.str();
+}
+
+MI_INSTANTIATE_CLASS(ShapeBVH)
+NAMESPACE_END(mitsuba)
@@ -82,6 +82,10 @@ Film<Float, Spectrum>::prepare_sample(const UnpolarizedSpectrum & /* spec */,
     NotImplementedError("prepare_sample");
 }
 
+MI_VARIANT void Film<Float, Spectrum>::write_async(const fs::path &path) const {
+    write(path);
+}
+
 MI_VARIANT const typename Film<Float, Spectrum>::Texture *
 Film<Float, Spectrum>::sensor_response_function() {
     return m_srf.get();
@@ -6,6 +6,8 @@
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/progress.h>
 #include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/memory.h>
+#include <mitsuba/core/statistics.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/fstream.h>
@@ -199,6 +201,9 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         if (m_timeout > 0.f)
             Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
 
+        // Collect statistics counters of this render job only
+        Statistics::reset();
+
         // If no block size was specified, find size that is good for parallelization
         uint32_t block_size = m_block_size;
         if (block_size == 0) {
@@ -392,6 +397,11 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         Log(Info, "Rendering finished. (took %s)",
             util::time_string((float) m_render_timer.value(), true));
 
+    if constexpr (!dr::is_jit_v<Float> && Statistics::enabled())
+        Log(Info, "%s", Statistics::report());
+
+    Log(Debug, "%s", MemoryUsage::report());
+
     return result;
 }
 
@@ -445,6 +455,39 @@ MI_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *s
     }
 }
 
+MI_VARIANT void SamplingIntegrator<Float, Spectrum>::render_tile(const Scene *scene,
+                                                                  Sensor *sensor,
+                                                                  ImageBlock *block,
+                                                                  uint32_t block_id,
+                                                                  uint32_t block_size,
+                                                                  uint32_t spp,
+                                                                  uint32_t seed) const {
+    if constexpr (!dr::is_jit_v<Float>) {
+        const Film *film = sensor->film();
+        ScalarVector2u film_size = film->crop_size();
+        if (film->sample_border())
+            film_size += 2 * film->rfilter()->border_size();
+
+        // Fork a non-overlapping sampler for the current worker
+        ref<Sampler> sampler = sensor->sampler()->fork();
+
+        std::unique_ptr<Float[]> aovs(new Float[block->channel_count()]);
+
+        // Same seeding as in render()
+        render_block(scene, sensor, sampler, block, aovs.get(), spp,
+                     seed * dr::prod(film_size), block_id, block_size);
+    } else {
+        DRJIT_MARK_USED(scene);
+        DRJIT_MARK_USED(sensor);
+        DRJIT_MARK_USED(block);
+        DRJIT_MARK_USED(block_id);
+        DRJIT_MARK_USED(block_size);
+        DRJIT_MARK_USED(spp);
+        DRJIT_MARK_USED(seed);
+        Throw("render_tile(): only supported in scalar variants.");
+    }
+}
+
 MI_VARIANT void
 SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
                                                    const Sensor *sensor,
@@ -554,6 +597,52 @@ MI_VARIANT MonteCarloIntegrator<Float, Spectrum>::~MonteCarloIntegrator() { }
 
 // -----------------------------------------------------------------------------
 
+/**
+ * Sum the per-thread accumulation buffers of the scalar particle tracer into
+ * the first one and commit the result to the film. The image is split into
+ * bands of rows that are processed in parallel, so no locking is needed. The
+ * buffers are cleared along the way for reuse in the next pass.
+ */
+template <typename ImageBlock, typename Film>
+static void merge_blocks(std::vector<ref<ImageBlock>> &blocks, Film *film) {
+    std::vector<ImageBlock *> active;
+    for (ref<ImageBlock> &block : blocks) {
+        if (block)
+            active.push_back(block.get());
+    }
+
+    if (active.empty())
+        return;
+
+    ImageBlock *target = active[0];
+    if (active.size() > 1) {
+        uint32_t height   = target->size().y();
+        size_t row_stride = (size_t) target->size().x() * target->channel_count();
+        uint32_t grain_size =
+            std::max(height / (4 * (uint32_t) (pool_size() + 1)), 1u);
+
+        dr::parallel_for(
+            dr::blocked_range<uint32_t>(0, height, grain_size),
+            [&](const dr::blocked_range<uint32_t> &range) {
+                size_t begin = range.begin() * row_stride,
+                       end   = range.end() * row_stride;
+                auto *dst = target->tensor().data();
+
+                for (size_t k = 1; k < active.size(); ++k) {
+                    auto *src = active[k]->tensor().data();
+                    for (size_t i = begin; i < end; ++i) {
+                        dst[i] += src[i];
+                        src[i] = 0.f;
+                    }
+                }
+            }
+        );
+    }
+
+    film->put_block(target);
+    target->clear();
+}
+
 MI_VARIANT AdjointIntegrator<Float, Spectrum>::AdjointIntegrator(const Properties &props)
     : Base(props) {
 
@@ -637,64 +726,91 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
         if (m_timeout > 0.f)
             Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
 
-        // Split up all samples between threads
-        size_t grain_size =
-            std::max(samples_per_pass / (4 * n_threads), (size_t) 1);
+        // Collect statistics counters of this render job only
+        Statistics::reset();
 
-        std::mutex mutex;
+        /* Split up the samples of each pass into a fixed number of ranges.
+           This number must not depend on the thread count: the ranges
+           determine the sampler seeds, hence the rendered image. */
+        size_t grain_size = std::max(samples_per_pass / 1024, (size_t) 1);
+
+        std::mutex progress_mutex;
         ref<ProgressReporter> progress = new ProgressReporter("Rendering");
 
         size_t total_samples = samples_per_pass * n_passes;
 
-        seed *= (uint32_t) total_samples / (uint32_t) grain_size;
+        /* Each range of each pass forks its own sampler. The ranges of a pass
+           are numbered consecutively, so that ranges of different passes never
+           share a seed (the passes do not start at multiples of the grain size) */
+        size_t ranges_per_pass = (samples_per_pass + grain_size - 1) / grain_size;
+        seed *= (uint32_t) (ranges_per_pass * n_passes);
         std::atomic<size_t> samples_done(0);
 
-        // Start the render timer (used for timeouts & log messages)
-        m_render_timer.reset();
-
-        dr::parallel_for(
-            dr::blocked_range<size_t>(0, total_samples, grain_size),
-            [&](const dr::blocked_range<size_t> &range) {
-
-                // Fork a non-overlapping sampler for the current worker
-                ref<Sampler> sampler = sensor->sampler()->clone();
-
-                ref<ImageBlock> block = film->create_block(
-                    ScalarVector2u(0) /* use crop size */,
-                    true /* normalize */,
-                    false /* border */);
-
-                block->set_offset(film->crop_offset());
+        /* One accumulation buffer per worker thread (indexed by
+           pool_thread_id()), allocated on first use and reused by all ranges
+           and passes that the thread processes. This avoids allocating and
+           merging a crop-sized block per range under the film's lock. */
+        std::vector<ref<ImageBlock>> blocks(n_threads);
 
-                // Clear block (it's being reused)
-                block->clear();
+        auto report_progress = [&](size_t count) {
+            size_t done = samples_done.fetch_add(count) + count;
+            // Skip the update if another thread is currently reporting
+            std::unique_lock<std::mutex> lock(progress_mutex, std::try_to_lock);
+            if (lock.owns_lock())
+                progress->update(done / (ScalarFloat) total_samples);
+        };
 
-                sampler->seed(seed +
-                              (uint32_t) range.begin() / (uint32_t) grain_size);
+        // Start the render timer (used for timeouts & log messages)
+        m_render_timer.reset();
 
-                size_t ctr = 0;
-                for (auto i = range.begin(); i != range.end() && !should_stop(); ++i) {
-                    sample(scene, sensor, sampler, block, sample_scale);
-                    sampler->advance();
+        for (size_t pass = 0; pass < n_passes && !should_stop(); ++pass) {
+            size_t pass_begin = pass * samples_per_pass;
+
+            dr::parallel_for(
+                dr::blocked_range<size_t>(pass_begin,
+                                          pass_begin + samples_per_pass,
+                                          grain_size),
+                [&](const dr::blocked_range<size_t> &range) {
+                    uint32_t thread_id = pool_thread_id();
+                    Assert(thread_id < blocks.size());
+
+                    ref<ImageBlock> &block = blocks[thread_id];
+                    if (!block) {
+                        block = film->create_block(
+                            ScalarVector2u(0) /* use crop size */,
+                            true /* normalize */,
+                            false /* border */);
+                        block->set_offset(film->crop_offset());
+                        block->clear();
+                    }
 
-                    ctr++;
-                    if (ctr > 10000) {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        samples_done += ctr;
-                        ctr = 0;
-                        progress->update(samples_done / (ScalarFloat) total_samples);
+                    // Fork a non-overlapping sampler for the current range
+                    ref<Sampler> sampler = sensor->sampler()->clone();
+                    sampler->seed(seed + (uint32_t) (pass * ranges_per_pass +
+                                                     (range.begin() - pass_begin) /
+                                                         grain_size));
+
+                    size_t ctr = 0;
+                    for (auto i = range.begin();
+                         i != range.end() && !should_stop(); ++i) {
+                        sample(scene, sensor, sampler, block, sample_scale);
+                        sampler->advance();
+
+                        if (++ctr > 10000) {
+                            report_progress(ctr);
+                            ctr = 0;
+                        }
                     }
-                }
-                total_samples += ctr;
 
-                // When all samples are done for this range, commit to the film
-                /* locked */ {
-                    std::lock_guard<std::mutex> lock(mutex);
-                    progress->update(samples_done / (ScalarFloat) total_samples);
-                    film->put_block(block);
+                    report_progress(ctr);
                 }
-            }
-        );
+            );
+
+            // Commit the samples of this pass to the film
+            merge_blocks(blocks, film);
+        }
+
+        progress->update(samples_done / (ScalarFloat) total_samples);
 
         if (develop)
             result = film->develop();
@@ -784,6 +900,11 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
         Log(Info, "Rendering finished. (took %s)",
             util::time_string((float) m_render_timer.value(), true));
 
+    if constexpr (!dr::is_jit_v<Float> && Statistics::enabled())
+        Log(Info, "%s", Statistics::report());
+
+    Log(Debug, "%s", MemoryUsage::report());
+
     return result;
 }
 
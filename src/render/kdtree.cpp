@@ -56,10 +56,11 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::clear() {
     m_primitive_map.clear();
     m_primitive_map.push_back(0);
     m_bbox.reset();
-    m_nodes.release();
-    m_indices.release();
+    m_nodes.reset();
+    m_indices.reset();
     m_node_count = 0;
     m_index_count = 0;
+    m_memory.set(0);
 }
 
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
@@ -69,9 +70,11 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
 
     Base::build();
 
+    size_t storage = m_index_count * sizeof(Index) + m_node_count * sizeof(KDNode);
+    m_memory.set(storage, "kd-tree");
+
     Log(Info, "Finished. (%s of storage, took %s)",
-        util::mem_string(m_index_count * sizeof(Index) +
-                        m_node_count * sizeof(KDNode)),
+        util::mem_string(storage),
         util::time_string((float) timer.value())
     );
 }
@@ -1,14 +1,22 @@
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mstream.h>
+#include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/warp.h>
+#include <mitsuba/core/zstream.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/mesh.h>
+#include <mitsuba/render/mmesh.h>
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/scene.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 
 #if defined(MI_ENABLE_EMBREE)
     #include <embree3/rtcore.h>
@@ -22,6 +30,9 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Number of faces/vertices processed by a single task of parallel loops over the mesh
+constexpr static size_t MeshGrainSize = 16384;
+
 MI_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
     /* When set to ``true``, Mitsuba will use per-face instead of per-vertex
        normals when rendering the object, which will give it a faceted
@@ -29,6 +40,32 @@ MI_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
     m_face_normals = props.get<bool>("face_normals", false);
     m_flip_normals = props.get<bool>("flip_normals", false);
 
+    /* When set to ``true``, triangles are sampled using an alias table
+       rather than a binary search over the area CDF. This is faster for very
+       large emitters, but doesn't preserve the stratification of samples. */
+    m_alias_sampling = props.get<bool>("alias_sampling", false);
+
+    /* When set to ``true``, directions towards faces subtending a solid angle
+       larger than ``solid_angle_threshold`` (in steradians) are sampled
+       uniformly within their spherical triangle instead of by area. */
+    m_solid_angle_sampling = props.get<bool>("solid_angle_sampling", false);
+    m_solid_angle_threshold = props.get<ScalarFloat>("solid_angle_threshold", 1e-3f);
+    if (m_solid_angle_threshold < 0.f)
+        Throw("The 'solid_angle_threshold' parameter must be non-negative!");
+
+    /* When set to ``true``, the mesh is stored in compact form to reduce its
+       memory footprint (see Mesh::compact()). Positions are then quantized
+       to ``compact_position_bits`` (16 or 21) bits per component. */
+    m_compact = props.get<bool>("compact", false);
+    m_compact_position_bits = props.get<uint32_t>("compact_position_bits", 21);
+    if (m_compact_position_bits != 16 && m_compact_position_bits != 21)
+        Throw("The 'compact_position_bits' parameter must be 16 or 21!");
+    if (dr::is_jit_v<Float> && m_compact) {
+        Log(Warn, "Compact mesh storage is only supported in scalar variants, "
+                  "ignoring the 'compact' parameter.");
+        m_compact = false;
+    }
+
     m_discontinuity_types = (uint32_t) DiscontinuityFlags::PerimeterType;
 
     m_shape_type = ShapeType::Mesh;
@@ -53,6 +90,9 @@ Mesh<Float, Spectrum>::Mesh(const std::string &name, ScalarSize vertex_count,
 
 MI_VARIANT
 void Mesh<Float, Spectrum>::initialize() {
+    if (m_compact)
+        compact_buffers();
+
 #if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
     m_vertex_positions_ptr = m_vertex_positions.data();
     m_faces_ptr = m_faces.data();
@@ -61,6 +101,9 @@ void Mesh<Float, Spectrum>::initialize() {
         ensure_pmf_built();
     mark_dirty();
 
+    m_memory.set(m_vertex_count * vertex_data_bytes() +
+                 m_face_count * face_data_bytes(), m_name);
+
     if constexpr (dr::is_jit_v<Float>) {
         if (parameters_grad_enabled()) {
             build_directed_edges();
@@ -73,13 +116,220 @@ void Mesh<Float, Spectrum>::initialize() {
 
 MI_VARIANT Mesh<Float, Spectrum>::~Mesh() {}
 
+MI_VARIANT void Mesh<Float, Spectrum>::compact_buffers() {
+    if constexpr (!dr::is_jit_v<Float>) {
+        size_t size_before = m_vertex_count * vertex_data_bytes() +
+                             m_face_count * face_data_bytes();
+
+#if !defined(MI_ENABLE_EMBREE)
+        /* Embree needs single precision positions and 32-bit indices. Only
+           the kd-tree of scalar variants goes through the accessors. */
+
+        // Store pairs of 16-bit values in 32-bit words (little endian)
+        auto pack_u16 = [](const std::vector<uint16_t> &values) {
+            DynamicBuffer<UInt32> result =
+                dr::zeros<DynamicBuffer<UInt32>>((values.size() + 1) / 2);
+            std::memcpy(result.data(), values.data(),
+                        values.size() * sizeof(uint16_t));
+            return result;
+        };
+
+        if (m_position_bits == 0 && m_vertex_count > 0) {
+            recompute_bbox();
+
+            uint32_t bits = m_compact_position_bits;
+            ScalarFloat max_value = (ScalarFloat) ((1u << bits) - 1);
+            ScalarVector3f extents = m_bbox.extents(), inv_scale;
+            for (size_t k = 0; k < 3; ++k)
+                inv_scale[k] = extents[k] > 0.f ? max_value / extents[k] : 0.f;
+
+            const InputFloat *pos = m_vertex_positions.data();
+            auto quantize = [&](size_t i) {
+                ScalarPoint3f p = dr::load<InputPoint3f>(pos + 3 * i);
+                ScalarVector3f q = dr::clip(dr::round((p - m_bbox.min) * inv_scale),
+                                            0.f, max_value);
+                return ScalarVector3u(q);
+            };
+
+            DynamicBuffer<UInt32> positions;
+            if (bits == 16) {
+                std::vector<uint16_t> values(m_vertex_count * 3);
+                dr::parallel_for(
+                    dr::blocked_range<size_t>(0, m_vertex_count, MeshGrainSize),
+                    [&](const dr::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            ScalarVector3u q = quantize(i);
+                            for (size_t k = 0; k < 3; ++k)
+                                values[3 * i + k] = (uint16_t) q[k];
+                        }
+                    }
+                );
+                positions = pack_u16(values);
+            } else {
+                positions = dr::empty<DynamicBuffer<UInt32>>(m_vertex_count * 2);
+                uint32_t *ptr = positions.data();
+                dr::parallel_for(
+                    dr::blocked_range<size_t>(0, m_vertex_count, MeshGrainSize),
+                    [&](const dr::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            ScalarVector3u q = quantize(i);
+                            ptr[2 * i + 0] = q.x() | (q.y() << 21);
+                            ptr[2 * i + 1] = (q.y() >> 11) | (q.z() << 10);
+                        }
+                    }
+                );
+            }
+
+            m_position_scale  = extents / max_value;
+            m_position_offset = m_bbox.min;
+            m_compact_positions = std::move(positions);
+            m_vertex_positions = FloatStorage();
+            m_position_bits = bits;
+
+            // Account for rounding errors of the decoded positions
+            recompute_bbox();
+        }
+
+        if (!m_short_indices && m_vertex_count < 65536 && m_position_bits != 0) {
+            const ScalarIndex *faces = m_faces.data();
+            std::vector<uint16_t> values(m_face_count * 3);
+            for (size_t i = 0; i < values.size(); ++i)
+                values[i] = (uint16_t) faces[i];
+            m_compact_faces = pack_u16(values);
+            m_faces = DynamicBuffer<UInt32>();
+            m_short_indices = true;
+        }
+#endif
+
+        if (dr::width(m_vertex_normals) != 0) {
+            const InputFloat *nrm = m_vertex_normals.data();
+            DynamicBuffer<UInt32> normals =
+                dr::empty<DynamicBuffer<UInt32>>(m_vertex_count);
+            uint32_t *ptr = normals.data();
+
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, m_vertex_count, MeshGrainSize),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        InputNormal3f n = dr::load<InputNormal3f>(nrm + 3 * i);
+
+                        // Project onto the octahedron and unfold its lower half
+                        InputNormal3f o = n / (dr::abs(n.x()) + dr::abs(n.y()) +
+                                               dr::abs(n.z()));
+                        InputFloat x = o.x(), y = o.y();
+                        if (o.z() < 0.f) {
+                            x = dr::copysign(1.f - dr::abs(o.y()), o.x());
+                            y = dr::copysign(1.f - dr::abs(o.x()), o.y());
+                        }
+
+                        // Pick the closest of the surrounding grid points
+                        uint32_t u = (uint32_t) dr::clip(dr::floor((x + 1.f) * 32767.f), 0.f, 65533.f),
+                                 v = (uint32_t) dr::clip(dr::floor((y + 1.f) * 32767.f), 0.f, 65533.f),
+                                 best = 0;
+                        InputFloat best_cos = -dr::Infinity<InputFloat>;
+                        for (uint32_t k = 0; k < 4; ++k) {
+                            uint32_t w = (u + (k & 1)) | ((v + (k >> 1)) << 16);
+                            InputFloat cos_theta = dr::dot(octahedral_to_normal(w), n);
+                            if (cos_theta > best_cos) {
+                                best_cos = cos_theta;
+                                best = w;
+                            }
+                        }
+                        ptr[i] = best;
+                    }
+                }
+            );
+
+            m_compact_normals = std::move(normals);
+            m_vertex_normals = FloatStorage();
+        }
+
+        if (dr::width(m_vertex_texcoords) != 0) {
+            const InputFloat *uv = m_vertex_texcoords.data();
+            DynamicBuffer<UInt32> texcoords =
+                dr::empty<DynamicBuffer<UInt32>>(m_vertex_count);
+            uint32_t *ptr = texcoords.data();
+
+            // Largest finite half precision value
+            const InputFloat half_max = 65504.f;
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, m_vertex_count, MeshGrainSize),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        uint32_t u = dr::half(dr::clip(uv[2 * i + 0], -half_max, half_max)).value,
+                                 v = dr::half(dr::clip(uv[2 * i + 1], -half_max, half_max)).value;
+                        ptr[i] = u | (v << 16);
+                    }
+                }
+            );
+
+            m_compact_texcoords = std::move(texcoords);
+            m_vertex_texcoords = FloatStorage();
+        }
+
+        size_t size_after = m_vertex_count * vertex_data_bytes() +
+                            m_face_count * face_data_bytes();
+        Log(Debug, "\"%s\": compact storage reduced the mesh size from %s to %s",
+            m_name, util::mem_string(size_before), util::mem_string(size_after));
+    }
+}
+
+MI_VARIANT ref<Mesh<Float, Spectrum>> Mesh<Float, Spectrum>::expanded() const {
+    if (!m_compact)
+        return const_cast<Mesh *>(this);
+
+    ref<Mesh> mesh = new Mesh(m_name, m_vertex_count, m_face_count,
+                              Properties(), has_vertex_normals(),
+                              has_vertex_texcoords());
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        bool has_normals = has_vertex_normals(),
+             has_texcoords = has_vertex_texcoords();
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_vertex_count, MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    ScalarIndex j = (ScalarIndex) i;
+                    dr::store(mesh->m_vertex_positions.data() + 3 * i,
+                              vertex_position(j));
+                    if (has_normals)
+                        dr::store(mesh->m_vertex_normals.data() + 3 * i,
+                                  vertex_normal(j));
+                    if (has_texcoords)
+                        dr::store(mesh->m_vertex_texcoords.data() + 2 * i,
+                                  vertex_texcoord(j));
+                }
+            }
+        );
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_face_count, MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i)
+                    dr::store(mesh->m_faces.data() + 3 * i,
+                              face_indices((ScalarIndex) i));
+            }
+        );
+    }
+
+    mesh->m_bbox = m_bbox;
+    mesh->m_face_normals = m_face_normals;
+    mesh->m_flip_normals = m_flip_normals;
+    mesh->m_mesh_attributes = m_mesh_attributes;
+    return mesh;
+}
+
 MI_VARIANT void Mesh<Float, Spectrum>::traverse(TraversalCallback *cb) {
     Base::traverse(cb);
 
-    cb->put("faces",            m_faces,            ParamFlags::NonDifferentiable);
-    cb->put("vertex_positions", m_vertex_positions, ParamFlags::Differentiable | ParamFlags::Discontinuous);
-    cb->put("vertex_normals",   m_vertex_normals,   ParamFlags::Differentiable | ParamFlags::Discontinuous);
-    cb->put("vertex_texcoords", m_vertex_texcoords, ParamFlags::Differentiable);
+    // The geometry of compact meshes cannot be modified
+    if (!m_compact) {
+        cb->put("faces",            m_faces,            ParamFlags::NonDifferentiable);
+        cb->put("vertex_positions", m_vertex_positions, ParamFlags::Differentiable | ParamFlags::Discontinuous);
+        cb->put("vertex_normals",   m_vertex_normals,   ParamFlags::Differentiable | ParamFlags::Discontinuous);
+        cb->put("vertex_texcoords", m_vertex_texcoords, ParamFlags::Differentiable);
+    }
 
     // We arbitrarily chose to show all attributes as being differentiable here.
     for (auto &[name, attribute]: m_mesh_attributes)
@@ -87,6 +337,11 @@ MI_VARIANT void Mesh<Float, Spectrum>::traverse(TraversalCallback *cb) {
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::parameters_changed(const std::vector<std::string> &keys) {
+    if (m_compact) {
+        Base::parameters_changed(keys);
+        return;
+    }
+
     bool mesh_attributes_changed = false;
 
     if (m_vertex_positions.size() != m_vertex_count * 3) {
@@ -151,6 +406,9 @@ MI_VARIANT void Mesh<Float, Spectrum>::parameters_changed(const std::vector<std:
 #endif
         mark_dirty();
 
+        m_memory.set(m_vertex_count * vertex_data_bytes() +
+                     m_face_count * face_data_bytes(), m_name);
+
         if (!m_initialized)
             Base::initialize();
     }
@@ -213,6 +471,9 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_ply(const std::string &filename) co
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
+    if (m_compact)
+        return expanded()->write_ply(stream);
+
     auto&& vertex_positions = dr::migrate(m_vertex_positions, AllocType::Host);
     auto&& vertex_normals   = dr::migrate(m_vertex_normals, AllocType::Host);
     auto&& vertex_texcoords = dr::migrate(m_vertex_texcoords, AllocType::Host);
@@ -327,23 +588,295 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
     }
 }
 
+MI_VARIANT void Mesh<Float, Spectrum>::write_mmesh(const std::string &filename,
+                                                   bool compress) const {
+    ref<FileStream> stream =
+        new FileStream(fs::path(filename), FileStream::ETruncReadWrite);
+
+    Timer timer;
+    Log(Info, "Writing mesh to \"%s\" ..", filename);
+    write_mmesh(stream, compress);
+    Log(Info, "\"%s\": wrote %i faces, %i vertices (%s in %s)", filename,
+        m_face_count, m_vertex_count, util::mem_string(stream->size()),
+        util::time_string((float) timer.value()));
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::write_mmesh(Stream *stream,
+                                                   bool compress) const {
+    if (Struct::host_byte_order() == Struct::ByteOrder::BigEndian)
+        Throw("write_mmesh(): not supported on big endian platforms!");
+    if (m_compact)
+        return expanded()->write_mmesh(stream, compress);
+
+    auto&& vertex_positions = dr::migrate(m_vertex_positions, AllocType::Host);
+    auto&& vertex_normals   = dr::migrate(m_vertex_normals, AllocType::Host);
+    auto&& vertex_texcoords = dr::migrate(m_vertex_texcoords, AllocType::Host);
+    auto&& faces = dr::migrate(m_faces, AllocType::Host);
+
+    std::vector<std::pair<std::string, MeshAttribute>> attributes;
+    for (const auto&[name, attribute]: m_mesh_attributes)
+        attributes.push_back({ name, attribute.migrate(AllocType::Host) });
+
+    // Evaluate buffers if necessary
+    if constexpr (dr::is_jit_v<Float>)
+        dr::sync_thread();
+
+    // Precompute the face areas, which loaders can use to build the area pmf
+    const InputFloat *pos_p  = vertex_positions.data();
+    const ScalarIndex *idx_p = faces.data();
+    std::vector<InputFloat> areas(m_face_count);
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, m_face_count, MeshGrainSize),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                ScalarPoint3u idx = dr::load<ScalarPoint3u>(idx_p + 3 * i);
+
+                InputPoint3f p0 = dr::load<InputPoint3f>(pos_p + 3 * idx.x()),
+                             p1 = dr::load<InputPoint3f>(pos_p + 3 * idx.y()),
+                             p2 = dr::load<InputPoint3f>(pos_p + 3 * idx.z());
+
+                areas[i] = .5f * dr::norm(dr::cross(p1 - p0, p2 - p0));
+            }
+        }
+    );
+
+    struct Section {
+        MeshFileSection info;
+        const uint8_t *data;
+        std::vector<std::vector<uint8_t>> chunks;
+    };
+
+    std::vector<Section> sections;
+    auto add_section = [&](const std::string &name, MeshFileSectionType type,
+                           size_t components, const void *data, size_t size) {
+        if (name.size() >= sizeof(MeshFileSection::name))
+            Throw("write_mmesh(): buffer name \"%s\" is too long!", name);
+        Section section {};
+        memcpy(section.info.name, name.c_str(), name.size());
+        section.info.type = type;
+        section.info.components = (uint32_t) components;
+        section.info.size = size;
+        section.info.stored_size = size;
+        section.data = (const uint8_t *) data;
+        sections.push_back(std::move(section));
+    };
+
+    add_section("vertex_positions", MeshFileSectionType::VertexPositions, 3,
+                vertex_positions.data(), m_vertex_count * 3 * sizeof(InputFloat));
+    if (has_vertex_normals())
+        add_section("vertex_normals", MeshFileSectionType::VertexNormals, 3,
+                    vertex_normals.data(), m_vertex_count * 3 * sizeof(InputFloat));
+    if (has_vertex_texcoords())
+        add_section("vertex_texcoords", MeshFileSectionType::VertexTexcoords, 2,
+                    vertex_texcoords.data(), m_vertex_count * 2 * sizeof(InputFloat));
+    add_section("faces", MeshFileSectionType::Faces, 3, faces.data(),
+                m_face_count * 3 * sizeof(ScalarIndex));
+    add_section("face_areas", MeshFileSectionType::FaceAreas, 1, areas.data(),
+                m_face_count * sizeof(InputFloat));
+    for (const auto&[name, attribute]: attributes) {
+        bool is_vertex_attr = attribute.type == MeshAttributeType::Vertex;
+        add_section(name,
+                    is_vertex_attr ? MeshFileSectionType::VertexAttribute
+                                   : MeshFileSectionType::FaceAttribute,
+                    attribute.size, attribute.buf.data(),
+                    attribute.size * sizeof(InputFloat) *
+                        (is_vertex_attr ? m_vertex_count : m_face_count));
+    }
+
+    // Deflate the chunks of all sections in parallel
+    if (compress) {
+        for (Section &section : sections) {
+            size_t chunk_count =
+                (section.info.size + MeshFileChunkSize - 1) / MeshFileChunkSize;
+            section.chunks.resize(chunk_count);
+
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, chunk_count, 1),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        size_t start = i * MeshFileChunkSize,
+                               size  = std::min((size_t) MeshFileChunkSize,
+                                                (size_t) section.info.size - start);
+
+                        ref<MemoryStream> ms = new MemoryStream(size / 2 + 64);
+                        ref<ZStream> zs = new ZStream(ms);
+                        zs->write(section.data + start, size);
+                        zs->close();
+
+                        section.chunks[i].assign(ms->raw_buffer(),
+                                                 ms->raw_buffer() + ms->size());
+                    }
+                }
+            );
+
+            section.info.compression = MeshFileCompression::Deflate;
+            section.info.chunk_size = MeshFileChunkSize;
+            section.info.stored_size = (chunk_count + 1) * sizeof(uint64_t);
+            for (const auto &chunk : section.chunks)
+                section.info.stored_size += chunk.size();
+        }
+    }
+
+    /* Lay out the sections. Each one is followed by at least 16 bytes of
+       padding, as Embree may read slightly past the end of vertex buffers */
+    auto align = [](uint64_t value) {
+        return (value + MeshFileAlignment - 1) / MeshFileAlignment * MeshFileAlignment;
+    };
+
+    uint64_t pos = sizeof(MeshFileHeader) + sections.size() * sizeof(MeshFileSection),
+             end = align(pos);
+    for (Section &section : sections) {
+        section.info.offset = end;
+        end = align(end + section.info.stored_size + 16);
+    }
+
+    MeshFileHeader header {};
+    memcpy(header.magic, MeshFileMagic, sizeof(MeshFileMagic));
+    header.version = MeshFileVersion;
+
+    header.flags = +MeshFileFlags::None;
+    if (has_vertex_normals())
+        header.flags |= +MeshFileFlags::HasVertexNormals;
+    if (has_vertex_texcoords())
+        header.flags |= +MeshFileFlags::HasVertexTexcoords;
+    if (m_face_normals)
+        header.flags |= +MeshFileFlags::FaceNormals;
+    if constexpr (is_spectral_v<Spectrum>)
+        header.flags |= +MeshFileFlags::SpectralColors;
+
+    header.vertex_count = m_vertex_count;
+    header.face_count = m_face_count;
+    for (size_t i = 0; i < 3; ++i) {
+        header.bbox_min[i] = (float) m_bbox.min[i];
+        header.bbox_max[i] = (float) m_bbox.max[i];
+    }
+    header.section_count = (uint32_t) sections.size();
+    memcpy(header.name, m_name.c_str(),
+           std::min(m_name.size(), sizeof(header.name) - 1));
+
+    stream->write(&header, sizeof(MeshFileHeader));
+    for (const Section &section : sections)
+        stream->write(&section.info, sizeof(MeshFileSection));
+
+    uint8_t zeros[2 * MeshFileAlignment] = { };
+    auto pad = [&](uint64_t target) {
+        stream->write(zeros, target - pos);
+        pos = target;
+    };
+
+    for (const Section &section : sections) {
+        pad(section.info.offset);
+
+        if (section.info.compression == MeshFileCompression::None) {
+            stream->write(section.data, section.info.size);
+        } else {
+            std::vector<uint64_t> offsets(section.chunks.size() + 1);
+            offsets[0] = offsets.size() * sizeof(uint64_t);
+            for (size_t i = 0; i < section.chunks.size(); ++i)
+                offsets[i + 1] = offsets[i] + section.chunks[i].size();
+
+            stream->write(offsets.data(), offsets.size() * sizeof(uint64_t));
+            for (const auto &chunk : section.chunks)
+                stream->write(chunk.data(), chunk.size());
+        }
+
+        pos += section.info.stored_size;
+    }
+    pad(end);
+}
+
+/**
+ * \brief Group the corners of a triangle mesh by vertex
+ *
+ * Corner <tt>3 * f + i</tt> refers to the <tt>i</tt>-th vertex of face
+ * <tt>f</tt>. Only corners accepted by \c filter are included. Returns an
+ * offset table with <tt>vertex_count + 1</tt> entries and the list of corners,
+ * where the corners of each vertex are sorted in ascending order. This runs
+ * in parallel, but the sort makes the output independent of the scheduling.
+ */
+template <typename Index, typename Filter>
+static std::pair<std::vector<Index>, std::vector<Index>>
+vertex_corner_table(const Index *faces, size_t face_count, size_t vertex_count,
+                    const Filter &filter) {
+    size_t corner_count = face_count * 3;
+    std::unique_ptr<std::atomic<Index>[]> cursor(new std::atomic<Index>[vertex_count]);
+    for (size_t i = 0; i < vertex_count; ++i)
+        cursor[i].store(0, std::memory_order_relaxed);
+
+    // 1. Count the corners of each vertex
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, corner_count, 3 * MeshGrainSize),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t c = range.begin(); c != range.end(); ++c) {
+                if (filter((Index) c))
+                    cursor[faces[c]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    );
+
+    // 2. Turn the counts into offsets
+    std::vector<Index> offsets(vertex_count + 1);
+    Index sum = 0;
+    for (size_t i = 0; i < vertex_count; ++i) {
+        offsets[i] = sum;
+        sum += cursor[i].load(std::memory_order_relaxed);
+        cursor[i].store(offsets[i], std::memory_order_relaxed);
+    }
+    offsets[vertex_count] = sum;
+
+    // 3. Scatter the corners
+    std::vector<Index> corners(sum);
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, corner_count, 3 * MeshGrainSize),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t c = range.begin(); c != range.end(); ++c) {
+                if (filter((Index) c))
+                    corners[cursor[faces[c]].fetch_add(
+                        1, std::memory_order_relaxed)] = (Index) c;
+            }
+        }
+    );
+
+    // 4. Restore the order of the corners
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, vertex_count, MeshGrainSize),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i)
+                std::sort(corners.begin() + offsets[i],
+                          corners.begin() + offsets[i + 1]);
+        }
+    );
+
+    return { std::move(offsets), std::move(corners) };
+}
+
 MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
     if (!has_vertex_normals())
         Throw("Storing new normals in a Mesh that didn't have normals at "
               "construction time is not implemented yet.");
+    if (m_compact)
+        Throw("recompute_vertex_normals(): the geometry of compact meshes "
+              "cannot be modified!");
 
     /* Weighting scheme based on "Computing Vertex Normals from Polygonal Facets"
        by Grit Thuermer and Charles A. Wuethrich, JGT 1998, Vol 3 */
 
     if constexpr (!dr::is_dynamic_v<Float>) {
-        size_t invalid_counter = 0;
-        std::vector<InputNormal3f> normals(m_vertex_count, dr::zeros<InputNormal3f>());
-
-        for (ScalarSize i = 0; i < m_face_count; ++i) {
-            auto fi = face_indices(i);
-            Assert(fi[0] < m_vertex_count &&
-                   fi[1] < m_vertex_count &&
-                   fi[2] < m_vertex_count);
+        const ScalarIndex *face_data = m_faces.data();
+        for (ScalarSize i = 0; i < m_face_count * 3; ++i)
+            Assert(face_data[i] < m_vertex_count);
+
+        /* Instead of scattering face normals into the vertices, each vertex
+           gathers the contributions of its faces. The faces are visited in
+           ascending order, which reproduces the result of a serial loop. */
+        std::vector<ScalarIndex> offsets, corners;
+        std::tie(offsets, corners) = vertex_corner_table(
+            face_data, m_face_count, m_vertex_count,
+            [](ScalarIndex) { return true; });
+
+        // Weighted normal contributed by a face to its 'j'-th vertex
+        auto face_normal = [&](ScalarIndex f, ScalarIndex j, InputNormal3f &result) {
+            auto fi = face_indices(f);
 
             InputPoint3f v[3] = { vertex_position(fi[0]),
                                   vertex_position(fi[1]),
@@ -353,35 +886,55 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
                           side_1 = v[2] - v[0];
             InputNormal3f n = dr::cross(side_0, side_1);
             InputFloat length_sqr = dr::squared_norm(n);
-            if (likely(length_sqr > 0)) {
-                n *= dr::rsqrt(length_sqr);
+            if (unlikely(!(length_sqr > 0)))
+                return false;
 
-                // Use DrJit to compute the face angles at the same time
-                auto side1 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_0, v[2] - v[1], v[0] - v[2] });
-                auto side2 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_1, v[0] - v[1], v[1] - v[2] });
-                InputVector3f face_angles = unit_angle(dr::normalize(side1), dr::normalize(side2));
+            n *= dr::rsqrt(length_sqr);
 
-                for (size_t j = 0; j < 3; ++j)
-                    normals[fi[j]] += n * face_angles[j];
-            }
-        }
+            // Use DrJit to compute the face angles at the same time
+            auto side1 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_0, v[2] - v[1], v[0] - v[2] });
+            auto side2 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_1, v[0] - v[1], v[1] - v[2] });
+            InputVector3f face_angles = unit_angle(dr::normalize(side1), dr::normalize(side2));
 
-        for (ScalarSize i = 0; i < m_vertex_count; i++) {
-            InputNormal3f n = normals[i];
-            InputFloat length = dr::norm(n);
-            if (likely(length != 0.f)) {
-                n /= length;
-            } else {
-                n = InputNormal3f(1, 0, 0); // Choose some bogus value
-                invalid_counter++;
+            result = n * face_angles[j];
+            return true;
+        };
+
+        /* Write into a new buffer, since the current one may be a read-only
+           memory mapping of a file (see the 'mmesh' plugin) */
+        FloatStorage vertex_normals = dr::empty<FloatStorage>(m_vertex_count * 3);
+
+        std::atomic<size_t> invalid_counter(0);
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_vertex_count, MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                size_t invalid = 0;
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    InputNormal3f n = dr::zeros<InputNormal3f>(), value;
+                    for (ScalarIndex k = offsets[i]; k < offsets[i + 1]; ++k) {
+                        if (face_normal(corners[k] / 3, corners[k] % 3, value))
+                            n += value;
+                    }
+
+                    InputFloat length = dr::norm(n);
+                    if (likely(length != 0.f)) {
+                        n /= length;
+                    } else {
+                        n = InputNormal3f(1, 0, 0); // Choose some bogus value
+                        invalid++;
+                    }
+
+                    dr::store(vertex_normals.data() + 3 * i, n);
+                }
+                invalid_counter += invalid;
             }
+        );
 
-            dr::store(m_vertex_normals.data() + 3 * i, n);
-        }
+        m_vertex_normals = std::move(vertex_normals);
 
         if (invalid_counter > 0)
             Log(Warn, "\"%s\": computed vertex normals (%i invalid vertices!)",
-                m_name, invalid_counter);
+                m_name, (size_t) invalid_counter);
     } else {
         // The following is JITed into two separate kernel launches
 
@@ -420,10 +973,11 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
         using JitInputNormal3f = Normal<dr::replace_scalar_t<Float, InputFloat>, 3>;
         JitInputNormal3f input_normals(normals);
 
-        // Disconnect the vertex normal buffer from any pre-existing AD
-        // graph. Otherwise an AD graph might be unnecessarily retained
-        // here, despite the following lines re-initializing the normals.
-        dr::disable_grad(m_vertex_normals);
+        // Scatter into a new buffer. This disconnects the vertex normals from
+        // any pre-existing AD graph, which might otherwise be unnecessarily
+        // retained here. The previous buffer may also be a read-only memory
+        // mapping of a file (see the 'mmesh' plugin).
+        m_vertex_normals = dr::empty<FloatStorage>(m_vertex_count * 3);
 
         UInt32 ni = dr::arange<UInt32>(m_vertex_count) * 3;
         for (uint32_t i = 0; i < 3; ++i)
@@ -434,6 +988,13 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::recompute_bbox() {
+    if (m_position_bits != 0) {
+        m_bbox.reset();
+        for (ScalarSize i = 0; i < m_vertex_count; ++i)
+            m_bbox.expand(ScalarPoint3f(vertex_position(i)));
+        return;
+    }
+
     auto&& vertex_positions = dr::migrate(m_vertex_positions, AllocType::Host);
     if constexpr (dr::is_jit_v<Float>)
         dr::sync_thread();
@@ -453,19 +1014,21 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_pmf() {
         Throw("Cannot create sampling table for an empty mesh: %s", to_string());
 
     if constexpr (!dr::is_jit_v<Float>) {
-        const InputFloat *pos_p  = m_vertex_positions.data();
-        const ScalarIndex *idx_p = m_faces.data();
-
         std::vector<ScalarFloat> table(m_face_count);
-        for (ScalarIndex i = 0; i < m_face_count; i++) {
-            ScalarPoint3u idx = dr::load<ScalarPoint3u>(idx_p + 3 * i);
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_face_count, MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    ScalarVector3u idx = face_indices((ScalarIndex) i);
 
-            ScalarPoint3f p0 = dr::load<InputPoint3f>(pos_p + 3 * idx.x()),
-                          p1 = dr::load<InputPoint3f>(pos_p + 3 * idx.y()),
-                          p2 = dr::load<InputPoint3f>(pos_p + 3 * idx.z());
+                    ScalarPoint3f p0 = vertex_position(idx.x()),
+                                  p1 = vertex_position(idx.y()),
+                                  p2 = vertex_position(idx.z());
 
-            table[i] = .5f * dr::norm(dr::cross(p1 - p0, p2 - p0));
-        }
+                    table[i] = .5f * dr::norm(dr::cross(p1 - p0, p2 - p0));
+                }
+            }
+        );
 
         m_area_pmf = DiscreteDistribution<Float>(table.data(), m_face_count);
     } else {
@@ -480,6 +1043,116 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_pmf() {
 
         m_area_pmf = DiscreteDistribution<Float>(dr::detach(face_surface_area));
     }
+
+    if (m_alias_sampling)
+        m_area_pmf.set_alias_sampling(true);
+
+    if (m_radiance_sampling)
+        build_radiance_pmf();
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::set_radiance_sampling(bool value) {
+    m_radiance_sampling = value;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (value && !m_area_pmf.empty())
+        build_radiance_pmf();
+    else if (!value)
+        m_radiance_pmf = DiscreteDistribution<Float>();
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::build_radiance_pmf() {
+    if (!m_emitter) {
+        m_radiance_pmf = DiscreteDistribution<Float>();
+        return;
+    }
+
+    /* Estimate the average radiance of each face from a stratified set of
+       points. Only the luminance-like mean over the spectral channels is used,
+       since the table just needs to be roughly proportional to the power. */
+    constexpr uint32_t Resolution = 3, PointCount = Resolution * Resolution;
+
+    auto eval_radiance = [&](const UInt32 &face, const Point2f &sample) {
+        PositionSample3f ps =
+            position_on_face(face, warp::square_to_uniform_triangle(sample));
+
+        Wavelength wavelengths = dr::zeros<Wavelength>();
+        if constexpr (is_spectral_v<Spectrum>)
+            wavelengths = sample_rgb_spectrum(
+                math::sample_shifted<Wavelength>(Float(.5f))).first;
+
+        SurfaceInteraction3f si(ps, wavelengths);
+        si.wi = Vector3f(0.f, 0.f, 1.f);
+
+        UnpolarizedSpectrum value = unpolarized_spectrum(m_emitter->eval(si));
+        return dr::mean(value);
+    };
+
+    /* The radiance estimate can miss small emissive features. It is clamped
+       to a fraction of the average radiance so that every face keeps a
+       nonzero probability, which keeps the estimator unbiased. */
+    constexpr ScalarFloat MinRadianceFraction = 1e-2f;
+
+    ScalarFloat inv_res = 1.f / Resolution,
+                total_area = dr::slice(m_area_pmf.sum()),
+                power;
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        const ScalarFloat *area = m_area_pmf.pmf().data();
+        std::vector<ScalarFloat> table(m_face_count, 0.f);
+
+        double power_d = 0.0;
+        for (ScalarIndex i = 0; i < m_face_count; ++i) {
+            for (uint32_t j = 0; j < PointCount; ++j) {
+                Point2f sample((j % Resolution + .5f) * inv_res,
+                               (j / Resolution + .5f) * inv_res);
+                table[i] += eval_radiance(i, sample) / PointCount;
+            }
+            power_d += (double) table[i] * area[i];
+        }
+        power = (ScalarFloat) power_d;
+
+        if (power > 0.f) {
+            ScalarFloat floor = MinRadianceFraction * power / total_area;
+            for (ScalarIndex i = 0; i < m_face_count; ++i)
+                table[i] = dr::maximum(table[i], floor) * area[i];
+            m_radiance_pmf =
+                DiscreteDistribution<Float>(table.data(), m_face_count);
+        }
+    } else {
+        dr::scoped_disable_symbolic<Float> guard;
+
+        UInt32 index = dr::arange<UInt32>(m_face_count * PointCount),
+               face  = index / PointCount,
+               j     = index % PointCount;
+
+        Point2f sample((Float(j % Resolution) + .5f) * inv_res,
+                       (Float(j / Resolution) + .5f) * inv_res);
+
+        Float radiance = dr::zeros<Float>(m_face_count);
+        dr::scatter_reduce(ReduceOp::Add, radiance,
+                           dr::detach(eval_radiance(face, sample)) / PointCount,
+                           face);
+
+        const Float &area = m_area_pmf.pmf();
+        power = dr::slice(dr::sum(radiance * area));
+
+        if (power > 0.f) {
+            ScalarFloat floor = MinRadianceFraction * power / total_area;
+            m_radiance_pmf = DiscreteDistribution<Float>(
+                dr::maximum(radiance, floor) * area);
+        }
+    }
+
+    if (!(power > 0.f)) {
+        Log(Warn, "Mesh \"%s\": the attached emitter doesn't emit any light, "
+            "falling back to sampling faces by area.", m_name);
+        m_radiance_pmf = DiscreteDistribution<Float>();
+        return;
+    }
+
+    if (m_alias_sampling)
+        m_radiance_pmf.set_alias_sampling(true);
 }
 
 constexpr static uint32_t INVALID_DEDGE = (uint32_t) -1;
@@ -489,92 +1162,117 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_directed_edges() {
 
     if (m_face_count == 0)
         Throw("Cannot create directed edges for an empty mesh: %s", to_string());
+    if (m_short_indices)
+        Throw("Directed edges are not supported by compact meshes: %s", to_string());
 
     if constexpr (!dr::is_jit_v<Float>) {
         auto&& faces = dr::migrate(m_faces, AllocType::Host);
         if constexpr (dr::is_array_v<Float>)
             dr::sync_thread();
 
-        /* To make this algorithm parallel in scalar variants, we'd need to
-         * have a scalar compare-and-swap operation in Dr.Jit */
-
-        std::vector<ScalarIndex> V2E(m_vertex_count, INVALID_DEDGE);
-        std::vector<ScalarIndex> E2E(m_face_count * 3, INVALID_DEDGE);
+        const ScalarIndex *face_data = faces.data();
+        ScalarSize edge_count = m_face_count * 3;
 
-        /* For an edge e1 = (v1, v2), tmp is defined as:
-        /     tmp[e1].first  = v2,
-        /     tmp[e1].second = (next edge e_k that also starts from v1) or INVALID_DEDGE
-        */
-        std::vector<std::pair<ScalarIndex, ScalarIndex>> tmp(m_face_count * 3);
+        // Destination vertex of the directed edge 'e' (its origin is face_data[e])
+        auto edge_end = [face_data](ScalarIndex e) {
+            return face_data[e - e % 3 + (e % 3 + 1) % 3];
+        };
 
-        // 1. Fill `tmp` and `V2E`
-        const ScalarIndex *face_data = faces.data();
-        for (ScalarIndex f = 0; f < m_face_count; f++) {
-            ScalarPoint3u triangle_indices =
-                dr::load<ScalarPoint3u>(face_data + 3 * f);
-            for (ScalarIndex i = 0; i < 3; i++) {
-                ScalarIndex idx_cur = triangle_indices[i],
-                            idx_nxt = triangle_indices[(i + 1) % 3],
-                            edge_id = 3 * f + i;
-                if (idx_cur == idx_nxt)
-                    continue;
-
-                tmp[edge_id] = std::make_pair(idx_nxt, INVALID_DEDGE);
-                if (V2E[idx_cur] != INVALID_DEDGE) {
-                    ScalarIndex last_edge_idx = V2E[idx_cur];
-
-                    while (tmp[last_edge_idx].second != INVALID_DEDGE)
-                        last_edge_idx = tmp[last_edge_idx].second;
-
-                    if (tmp[last_edge_idx].second == INVALID_DEDGE)
-                        tmp[last_edge_idx].second = edge_id;
-                } else {
-                    V2E[idx_cur] = edge_id;
-                }
-            }
-        }
+        auto is_edge = [&](ScalarIndex e) { return face_data[e] != edge_end(e); };
+
+        // 1. Group the directed edges by their origin
+        std::vector<ScalarIndex> V2E, edges;
+        std::tie(V2E, edges) = vertex_corner_table(
+            face_data, m_face_count, m_vertex_count, is_edge);
+
+        /* 2. Find the unique opposite of each edge. Edges with multiple
+              candidates are left unpaired and mark their vertices as
+              non-manifold. */
+        std::vector<ScalarIndex> opposite(edge_count, INVALID_DEDGE);
+        std::unique_ptr<std::atomic<bool>[]> non_manifold(
+            new std::atomic<bool>[m_vertex_count]);
+        for (ScalarIndex i = 0; i < m_vertex_count; i++)
+            non_manifold[i].store(false, std::memory_order_relaxed);
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, edge_count, 3 * MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (ScalarIndex e = (ScalarIndex) range.begin(); e != range.end(); ++e) {
+                    if (!is_edge(e))
+                        continue;
+
+                    ScalarIndex idx_cur = face_data[e],
+                                idx_nxt = edge_end(e),
+                                edge_id_opp = INVALID_DEDGE;
+
+                    for (ScalarIndex k = V2E[idx_nxt]; k < V2E[idx_nxt + 1]; ++k) {
+                        if (edge_end(edges[k]) != idx_cur)
+                            continue;
 
-        // 2. Manifold check & assign `E2E`
-        std::vector<bool> non_manifold(m_vertex_count, false);
-        for (ScalarIndex f = 0; f < m_face_count; f++) {
-            ScalarPoint3u tri = dr::load<ScalarPoint3u>(face_data + 3 * f);
-            for (ScalarIndex i = 0; i < 3; i++) {
-                ScalarIndex idx_cur = tri[i],
-                            idx_nxt = tri[(i + 1) % 3],
-                            edge_id = 3 * f + i;
-                if (idx_cur == idx_nxt)
-                    continue;
-
-                ScalarIndex it = V2E[idx_nxt], edge_id_opp = INVALID_DEDGE;
-                while (it != INVALID_DEDGE) {
-                    if (tmp[it].first == idx_cur) {
                         if (edge_id_opp == INVALID_DEDGE) {
-                            edge_id_opp = it;
+                            edge_id_opp = edges[k];
                         } else {
-                            non_manifold[idx_cur] = true;
-                            non_manifold[idx_nxt] = true;
-                            edge_id_opp           = INVALID_DEDGE;
+                            non_manifold[idx_cur].store(true, std::memory_order_relaxed);
+                            non_manifold[idx_nxt].store(true, std::memory_order_relaxed);
+                            edge_id_opp = INVALID_DEDGE;
                             break;
                         }
                     }
-                    it = tmp[it].second;
+
+                    opposite[e] = edge_id_opp;
                 }
+            }
+        );
+
+        /* 3. Assign `E2E`. An edge 'e' with a unique opposite 'o' > 'e' links
+              both edges. When several edges claim the same 'o' (this can
+              happen around non-manifold vertices), the pairing is resolved as
+              in a serial loop over the edges: 'o' keeps its own opposite if
+              it has a larger index, and otherwise the largest claiming edge. */
+        std::unique_ptr<std::atomic<ScalarIndex>[]> claim(
+            new std::atomic<ScalarIndex>[edge_count]);
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, edge_count, 3 * MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t e = range.begin(); e != range.end(); ++e)
+                    claim[e].store(INVALID_DEDGE, std::memory_order_relaxed);
+            }
+        );
 
-                if (edge_id_opp != INVALID_DEDGE && edge_id < edge_id_opp) {
-                    E2E[edge_id] = edge_id_opp;
-                    E2E[edge_id_opp] = edge_id;
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, edge_count, 3 * MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (ScalarIndex e = (ScalarIndex) range.begin(); e != range.end(); ++e) {
+                    ScalarIndex o = opposite[e];
+                    if (o == INVALID_DEDGE || e > o)
+                        continue;
+
+                    ScalarIndex cur = claim[o].load(std::memory_order_relaxed);
+                    while ((cur == INVALID_DEDGE || cur < e) &&
+                           !claim[o].compare_exchange_weak(cur, e, std::memory_order_relaxed))
+                        ;
                 }
             }
-        }
+        );
 
-        // 3. Log
+        std::vector<ScalarIndex> E2E(edge_count);
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, edge_count, 3 * MeshGrainSize),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t e = range.begin(); e != range.end(); ++e) {
+                    ScalarIndex o = opposite[e];
+                    E2E[e] = (o != INVALID_DEDGE && e < o)
+                                 ? o : claim[e].load(std::memory_order_relaxed);
+                }
+            }
+        );
+
+        // 4. Log
         ScalarIndex non_manifold_count = 0;
-        std::vector<bool> boundary(m_vertex_count, false);
         for (ScalarIndex i = 0; i < m_vertex_count; i++) {
-            if (non_manifold[i]) {
+            if (non_manifold[i].load(std::memory_order_relaxed))
                 non_manifold_count++;
-                continue;
-            }
         }
 
         if (non_manifold_count > 0)
@@ -740,7 +1438,8 @@ Mesh<Float, Spectrum>::merge(const Mesh *other) const {
         other->has_vertex_texcoords() != has_vertex_texcoords() ||
         other->has_face_normals() != has_face_normals() ||
         other->has_flipped_normals() != has_flipped_normals() ||
-        other->has_mesh_attributes() || has_mesh_attributes())
+        other->has_mesh_attributes() || has_mesh_attributes() ||
+        other->compact() != m_compact)
         Throw("Mesh::merge(): the two meshes are incompatible (%s and %s)!",
               to_string(), other->to_string());
 
@@ -757,24 +1456,33 @@ Mesh<Float, Spectrum>::merge(const Mesh *other) const {
         props.set("emitter", (Object *) m_emitter.get());
     props.set("face_normals", m_face_normals);
     props.set("flip_normals", m_flip_normals);
+    props.set("alias_sampling", m_alias_sampling);
+    props.set("solid_angle_sampling", m_solid_angle_sampling);
+    props.set("solid_angle_threshold", m_solid_angle_threshold);
+
+    props.set("compact", m_compact);
+    props.set("compact_position_bits", m_compact_position_bits);
 
     ref<Mesh> result = new Mesh(
         m_name + " + " + other->m_name, m_vertex_count + other->vertex_count(),
         m_face_count + other->face_count(), props, has_vertex_normals(),
         has_vertex_texcoords());
 
+    // Single precision versions of compact meshes
+    ref<Mesh> a = expanded(), b = other->expanded();
+
     result->m_vertex_positions =
-        dr::concat(m_vertex_positions, other->m_vertex_positions);
+        dr::concat(a->m_vertex_positions, b->m_vertex_positions);
 
     if (has_vertex_normals())
         result->m_vertex_normals =
-            dr::concat(m_vertex_normals, other->m_vertex_normals);
+            dr::concat(a->m_vertex_normals, b->m_vertex_normals);
 
     if (has_vertex_texcoords())
         result->m_vertex_texcoords =
-            dr::concat(m_vertex_texcoords, other->m_vertex_texcoords);
+            dr::concat(a->m_vertex_texcoords, b->m_vertex_texcoords);
 
-    result->m_faces = dr::concat(m_faces, other->m_faces);
+    result->m_faces = dr::concat(a->m_faces, b->m_faces);
     result->m_bbox = m_bbox;
     result->m_bbox.expand(other->m_bbox);
 
@@ -812,9 +1520,11 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_parameterization() {
     ref<Mesh> mesh =
         new Mesh(m_name + "_param", m_vertex_count, m_face_count,
                  props, false, false);
-    mesh->m_faces = m_faces;
 
-    auto&& vertex_texcoords = dr::migrate(m_vertex_texcoords, AllocType::Host);
+    ref<Mesh> source = expanded();
+    mesh->m_faces = source->m_faces;
+
+    auto&& vertex_texcoords = dr::migrate(source->m_vertex_texcoords, AllocType::Host);
     if constexpr (dr::is_jit_v<Float>)
         dr::sync_thread();
 
@@ -865,23 +1575,35 @@ Mesh<Float, Spectrum>::sample_position(Float time, const Point2f &sample_, Mask
     Index face_idx;
     Point2f sample = sample_;
 
+    bool radiance_pmf = !m_radiance_pmf.empty();
     std::tie(face_idx, sample.y()) =
-        m_area_pmf.sample_reuse(sample.y(), active);
+        (radiance_pmf ? m_radiance_pmf : m_area_pmf)
+            .sample_reuse(sample.y(), active);
 
-    Vector3u fi = face_indices(face_idx, active);
+    PositionSample3f ps = position_on_face(
+        face_idx, warp::square_to_uniform_triangle(sample), active);
+    ps.time  = time;
+    ps.pdf   = radiance_pmf ? radiance_pdf(face_idx, active)
+                            : Float(m_area_pmf.normalization());
+    ps.delta = false;
+
+    return ps;
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::PositionSample3f
+Mesh<Float, Spectrum>::position_on_face(const UInt32 &face, const Point2f &b,
+                                        Mask active) const {
+    Vector3u fi = face_indices(face, active);
 
     Point3f p0 = vertex_position(fi[0], active),
             p1 = vertex_position(fi[1], active),
             p2 = vertex_position(fi[2], active);
 
     Vector3f e0 = p1 - p0, e1 = p2 - p0;
-    Point2f b = warp::square_to_uniform_triangle(sample);
 
-    PositionSample3f ps;
-    ps.p     = dr::fmadd(e0, b.x(), dr::fmadd(e1, b.y(), p0));
-    ps.time  = time;
-    ps.pdf   = m_area_pmf.normalization();
-    ps.delta = false;
+    PositionSample3f ps = dr::zeros<PositionSample3f>();
+    ps.p          = dr::fmadd(e0, b.x(), dr::fmadd(e1, b.y(), p0));
+    ps.prim_index = face;
 
     if (has_vertex_texcoords()) {
         Point2f uv0 = vertex_texcoord(fi[0], active),
@@ -913,6 +1635,16 @@ Mesh<Float, Spectrum>::sample_position(Float time, const Point2f &sample_, Mask
     return ps;
 }
 
+MI_VARIANT Float Mesh<Float, Spectrum>::radiance_pdf(const UInt32 &face,
+                                                      Mask active) const {
+    /* Faces are chosen proportionally to area times radiance, and positions
+       are then uniform on the chosen face */
+    Float area = m_area_pmf.eval_pmf(face, active);
+    return dr::select(area > 0.f,
+                      m_radiance_pmf.eval_pmf_normalized(face, active) / area,
+                      0.f);
+}
+
 MI_VARIANT
 
 typename Mesh<Float, Spectrum>::SurfaceInteraction3f
@@ -939,8 +1671,141 @@ Mesh<Float, Spectrum>::eval_parameterization(const Point2f &uv,
     return si;
 }
 
-MI_VARIANT Float Mesh<Float, Spectrum>::pdf_position(const PositionSample3f &, Mask) const {
+MI_VARIANT Float Mesh<Float, Spectrum>::face_solid_angle(const UInt32 &face,
+                                                          const Point3f &p,
+                                                          Mask active) const {
+    Vector3u fi = face_indices(face, active);
+
+    Vector3f a = dr::normalize(vertex_position(fi[0], active) - p),
+             b = dr::normalize(vertex_position(fi[1], active) - p),
+             c = dr::normalize(vertex_position(fi[2], active) - p);
+
+    // Van Oosterom and Strackee, "The Solid Angle of a Plane Triangle" (1983)
+    Float num = dr::abs(dr::dot(a, dr::cross(b, c))),
+          den = 1.f + dr::dot(a, b) + dr::dot(b, c) + dr::dot(c, a);
+
+    Float result = 2.f * dr::atan2(num, den);
+    return dr::select(dr::isfinite(result), result, 0.f);
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::DirectionSample3f
+Mesh<Float, Spectrum>::sample_direction(const Interaction3f &it,
+                                        const Point2f &sample_,
+                                        Mask active) const {
+    MI_MASK_ARGUMENT(active);
+
+    if (!m_solid_angle_sampling)
+        return Base::sample_direction(it, sample_, active);
+
+    ensure_pmf_built();
+
+    using Index = dr::replace_scalar_t<Float, ScalarIndex>;
+    Index face;
+    Point2f sample = sample_;
+
+    const DiscreteDistribution<Float> &distr =
+        m_radiance_pmf.empty() ? m_area_pmf : m_radiance_pmf;
+    std::tie(face, sample.y()) = distr.sample_reuse(sample.y(), active);
+    Float face_pmf = distr.eval_pmf_normalized(face, active);
+
+    Vector3u fi = face_indices(face, active);
+    Point3f p0 = vertex_position(fi[0], active),
+            p1 = vertex_position(fi[1], active),
+            p2 = vertex_position(fi[2], active);
+
+    Float solid_angle = face_solid_angle(face, it.p, active);
+    Mask spherical = solid_angle > m_solid_angle_threshold;
+
+    Point2f b = warp::square_to_uniform_triangle(sample);
+
+    if (dr::any_or<true>(spherical)) {
+        /* Sample the spherical triangle spanned by the vertices as seen from
+           the reference point using the method by James Arvo, "Stratified
+           Sampling of Spherical Triangles" (SIGGRAPH 1995). */
+        Vector3f a  = dr::normalize(p0 - it.p),
+                 bv = dr::normalize(p1 - it.p),
+                 c  = dr::normalize(p2 - it.p);
+
+        Vector3f n_ab = dr::normalize(dr::cross(a, bv)),
+                 n_ca = dr::normalize(dr::cross(c, a));
+
+        // Interior angle at vertex 'a'
+        Float alpha = dr::safe_acos(-dr::dot(n_ab, n_ca));
+
+        auto [sin_alpha, cos_alpha] = dr::sincos(alpha);
+        auto [s, t] = dr::sincos(sample.x() * solid_angle - alpha);
+
+        Float u = t - cos_alpha,
+              v = s + sin_alpha * dr::dot(a, bv);
+
+        Float q = ((v * t - u * s) * cos_alpha - v) /
+                  ((v * s + u * t) * sin_alpha);
+        q = dr::clip(dr::select(dr::isfinite(q), q, 1.f), -1.f, 1.f);
+
+        Vector3f c_hat = dr::fmadd(a, q, dr::safe_sqrt(dr::fnmadd(q, q, 1.f)) *
+                                             dr::normalize(c - dr::dot(c, a) * a));
+
+        Float z = 1.f - sample.y() * (1.f - dr::dot(c_hat, bv));
+        Vector3f d = dr::fmadd(bv, z, dr::safe_sqrt(dr::fnmadd(z, z, 1.f)) *
+                                          dr::normalize(c_hat - dr::dot(c_hat, bv) * bv));
+
+        // Find the barycentric coordinates of the sampled point
+        Point2f uv = std::get<1>(moeller_trumbore(Ray3f(it.p, d), p0, p1, p2));
+
+        uv = dr::maximum(uv, 0.f);
+        Float uv_sum = uv.x() + uv.y();
+        uv = dr::select(uv_sum > 1.f, uv / uv_sum, uv);
+        b = dr::select(spherical && dr::isfinite(uv_sum), uv, b);
+    }
+
+    DirectionSample3f ds(position_on_face(face, b, active));
+    ds.time  = it.time;
+    ds.delta = false;
+    ds.d     = ds.p - it.p;
+
+    Float dist_squared = dr::squared_norm(ds.d);
+    ds.dist = dr::sqrt(dist_squared);
+    ds.d /= ds.dist;
+
+    Float area = m_area_pmf.eval_pmf(face, active),
+          x    = dist_squared / (dr::abs_dot(ds.d, ds.n) * area);
+
+    ds.pdf = face_pmf * dr::select(spherical, dr::rcp(solid_angle),
+                                   dr::select(dr::isfinite(x), x, 0.f));
+
+    return ds;
+}
+
+MI_VARIANT Float Mesh<Float, Spectrum>::pdf_direction(const Interaction3f &it,
+                                                       const DirectionSample3f &ds,
+                                                       Mask active) const {
+    MI_MASK_ARGUMENT(active);
+
+    if (!m_solid_angle_sampling)
+        return Base::pdf_direction(it, ds, active);
+
     ensure_pmf_built();
+
+    const DiscreteDistribution<Float> &distr =
+        m_radiance_pmf.empty() ? m_area_pmf : m_radiance_pmf;
+
+    Float face_pmf    = distr.eval_pmf_normalized(ds.prim_index, active),
+          solid_angle = face_solid_angle(ds.prim_index, it.p, active),
+          area        = m_area_pmf.eval_pmf(ds.prim_index, active),
+          dp          = dr::abs_dot(ds.d, ds.n);
+
+    Float pdf_area = dr::select(dp * area != 0.f,
+                                dr::square(ds.dist) / (dp * area), 0.f);
+
+    return face_pmf * dr::select(solid_angle > m_solid_angle_threshold,
+                                 dr::rcp(solid_angle), pdf_area);
+}
+
+MI_VARIANT Float Mesh<Float, Spectrum>::pdf_position(const PositionSample3f &ps,
+                                                      Mask active) const {
+    ensure_pmf_built();
+    if (!m_radiance_pmf.empty())
+        return radiance_pdf(ps.prim_index, active);
     return m_area_pmf.normalization();
 }
 
@@ -1295,6 +2160,9 @@ std::tuple<DynamicBuffer<typename CoreAliases<Float>::UInt32>,
 Mesh<Float, Spectrum>::precompute_silhouette(
     const ScalarPoint3f &viewpoint) const {
     if constexpr (!dr::is_jit_v<Float>) {
+        if (m_compact)
+            Throw("precompute_silhouette(): not supported by compact meshes!");
+
         using Vec3f = ScalarVector3f;
         using Pt3f  = ScalarPoint3f;
 
@@ -1906,6 +2774,9 @@ MI_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
 
     oss << "  face_normals = " << m_face_normals;
 
+    if (m_compact)
+        oss << "," << std::endl << "  compact = 1, position_bits = " << m_position_bits;
+
     if (!m_mesh_attributes.empty()) {
         oss << "," << std::endl << "  mesh attributes = [" << std::endl;
         size_t i = 0;
@@ -1925,10 +2796,20 @@ MI_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
 
 MI_VARIANT size_t Mesh<Float, Spectrum>::vertex_data_bytes() const {
     size_t vertex_data_bytes = 3 * sizeof(InputFloat);
-
-    if (has_vertex_normals())
+    if (m_position_bits == 16)
+        vertex_data_bytes = 3 * sizeof(uint16_t);
+    else if (m_position_bits == 21)
+        vertex_data_bytes = sizeof(uint64_t);
+
+    // Compact normals and texture coordinates occupy a 32-bit word
+    if (dr::width(m_compact_normals) != 0)
+        vertex_data_bytes += sizeof(uint32_t);
+    else if (has_vertex_normals())
         vertex_data_bytes += 3 * sizeof(InputFloat);
-    if (has_vertex_texcoords())
+
+    if (dr::width(m_compact_texcoords) != 0)
+        vertex_data_bytes += sizeof(uint32_t);
+    else if (has_vertex_texcoords())
         vertex_data_bytes += 2 * sizeof(InputFloat);
 
     for (const auto&[name, attribute]: m_mesh_attributes)
@@ -1939,7 +2820,8 @@ MI_VARIANT size_t Mesh<Float, Spectrum>::vertex_data_bytes() const {
 }
 
 MI_VARIANT size_t Mesh<Float, Spectrum>::face_data_bytes() const {
-    size_t face_data_bytes = 3 * sizeof(ScalarIndex);
+    size_t face_data_bytes =
+        3 * (m_short_indices ? sizeof(uint16_t) : sizeof(ScalarIndex));
 
     for (const auto&[name, attribute]: m_mesh_attributes)
         if (attribute.type == MeshAttributeType::Face)
@@ -366,6 +366,12 @@ MI_PY_EXPORT(Shape) {
         .def("write_ply",
              nb::overload_cast<Stream *>(&Mesh::write_ply, nb::const_),
              "stream"_a, D(Mesh, write_ply, 2))
+        .def("write_mmesh",
+             nb::overload_cast<const std::string &, bool>(&Mesh::write_mmesh, nb::const_),
+             "filename"_a, "compress"_a = false, D(Mesh, write_mmesh))
+        .def("write_mmesh",
+             nb::overload_cast<Stream *, bool>(&Mesh::write_mmesh, nb::const_),
+             "stream"_a, "compress"_a = false, D(Mesh, write_mmesh, 2))
         .def("merge", &Mesh::merge, "other"_a,
              D(Mesh, merge))
 
@@ -383,7 +389,12 @@ MI_PY_EXPORT(Shape) {
 
         .def("recompute_vertex_normals", &Mesh::recompute_vertex_normals)
         .def("recompute_bbox", &Mesh::recompute_bbox)
-        .def("build_directed_edges", &Mesh::build_directed_edges);
+        .def("build_directed_edges", &Mesh::build_directed_edges)
+        .def("set_radiance_sampling", &Mesh::set_radiance_sampling, "value"_a,
+             D(Mesh, set_radiance_sampling))
+        .def("radiance_sampling", &Mesh::radiance_sampling,
+             D(Mesh, radiance_sampling))
+        .def("compact", &Mesh::compact, D(Mesh, compact));
 
     bind_mesh_generic<Mesh *>(mesh_cls);
 
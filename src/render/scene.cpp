@@ -1,5 +1,8 @@
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/statistics.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/mesh.h>
@@ -10,6 +13,7 @@
 #  include "scene_embree.inl"
 #else
 #  include <mitsuba/render/kdtree.h>
+#  include <mitsuba/render/bvh.h>
 #  include "scene_native.inl"
 #endif
 
@@ -19,9 +23,15 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+// Only updated in scalar variants
+static StatsCounter stats_rays("Ray tracing", "Rays traced");
+static StatsCounter stats_shadow_rays("Ray tracing", "Occluded shadow rays",
+                                      StatsType::Ratio);
+
 MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     : JitObject<Scene>(props.id()) {
     m_thread_reordering = props.get<bool>("allow_thread_reordering", true);
+    m_alias_sampling = props.get<bool>("alias_sampling", false);
 
     for (auto &prop : props.objects()) {
         ref<Object> v = prop.get<ref<Object>>();
@@ -84,11 +94,20 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     props.mark_queried("kd_clip");
     props.mark_queried("kd_retract_bad_splits");
     props.mark_queried("kd_exact_primitive_threshold");
-
-    if constexpr (dr::is_cuda_v<Float>)
-        accel_init_gpu(props);
-    else
-        accel_init_cpu(props);
+    props.mark_queried("accel");
+    props.mark_queried("bvh_max_leaf_size");
+    props.mark_queried("bvh_bins");
+    props.mark_queried("bvh_traversal_cost");
+    props.mark_queried("bvh_intersection_cost");
+    props.mark_queried("bvh_refit_threshold");
+
+    /* scoped */ {
+        ScopedTraceEvent trace_event("Scene", "Build acceleration structure");
+        if constexpr (dr::is_cuda_v<Float>)
+            accel_init_gpu(props);
+        else
+            accel_init_cpu(props);
+    }
 
     if (!m_emitters.empty()) {
         // Inform environment emitters etc. about the scene bounds
@@ -111,6 +130,8 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props)
     update_silhouette_sampling_distribution();
 
     m_shapes_grad_enabled = false;
+
+    Log(Debug, "%s", MemoryUsage::report());
 }
 
 MI_VARIANT
@@ -130,6 +151,8 @@ void Scene<Float, Spectrum>::update_emitter_sampling_distribution() {
             sample_weights[i] = m_emitters[i]->sampling_weight();
         m_emitter_distr = std::make_unique<DiscreteDistribution<Float>>(
             sample_weights.get(), n_emitters);
+        if (m_alias_sampling)
+            m_emitter_distr->set_alias_sampling(true);
     } else {
         // By default use uniform sampling with constant PMF
         m_emitter_pmf = m_emitters.empty() ? 0.f : (1.f / n_emitters);
@@ -203,10 +226,23 @@ Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, uint32_t ray_flags,
     DRJIT_MARK_USED(reorder_hint);
     DRJIT_MARK_USED(reorder_hint_bits);
 
-    if constexpr (dr::is_cuda_v<Float>)
+    if constexpr (dr::is_cuda_v<Float>) {
         return ray_intersect_gpu(ray, ray_flags, reorder, reorder_hint, reorder_hint_bits, active);
-    else
-        return ray_intersect_cpu(ray, ray_flags, coherent, active);
+    } else {
+        SurfaceInteraction3f si = ray_intersect_cpu(ray, ray_flags, coherent, active);
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (active) {
+                ++stats_rays;
+                if (work_counters_enabled()) {
+                    WorkCounters &work = work_counters();
+                    work.rays++;
+                    if (si.is_valid())
+                        work.vertices++;
+                }
+            }
+        }
+        return si;
+    }
 }
 
 MI_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
@@ -220,6 +256,14 @@ Scene<Float, Spectrum>::ray_intersect_preliminary(const Ray3f &ray,
     DRJIT_MARK_USED(reorder_hint);
     DRJIT_MARK_USED(reorder_hint_bits);
 
+    if constexpr (!dr::is_jit_v<Float>) {
+        if (active) {
+            ++stats_rays;
+            if (work_counters_enabled())
+                work_counters().rays++;
+        }
+    }
+
     if constexpr (dr::is_cuda_v<Float>)
         return ray_intersect_preliminary_gpu(ray, reorder, reorder_hint, reorder_hint_bits, active);
     else
@@ -231,10 +275,21 @@ Scene<Float, Spectrum>::ray_test(const Ray3f &ray, Mask coherent, Mask active) c
     MI_MASKED_FUNCTION(ProfilerPhase::RayTest, active);
     DRJIT_MARK_USED(coherent);
 
-    if constexpr (dr::is_cuda_v<Float>)
+    if constexpr (dr::is_cuda_v<Float>) {
         return ray_test_gpu(ray, active);
-    else
-        return ray_test_cpu(ray, coherent, active);
+    } else {
+        Mask hit = ray_test_cpu(ray, coherent, active);
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (active) {
+                stats_shadow_rays.inc_base();
+                if (hit)
+                    ++stats_shadow_rays;
+                if (work_counters_enabled())
+                    work_counters().rays++;
+            }
+        }
+        return hit;
+    }
 }
 
 MI_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
@@ -1,23 +1,60 @@
 NAMESPACE_BEGIN(mitsuba)
 
+/**
+ * \brief State of the native CPU ray tracing backend
+ *
+ * Exactly one of \c accel (kd-tree, the default) and \c bvh is set,
+ * depending on the scene's \c accel property.
+ */
 template <typename Float, typename Spectrum>
 struct NativeState {
     MI_IMPORT_CORE_TYPES()
-    ShapeKDTree<Float, Spectrum> *accel;
+    ShapeKDTree<Float, Spectrum> *accel = nullptr;
+    ShapeBVH<Float, Spectrum> *bvh = nullptr;
     DynamicBuffer<UInt32> shapes_registry_ids;
     void *func_ptr = nullptr;
     UInt64 func_handle;
+
+    /// Trace a scalar ray through whichever acceleration data structure is active
+    template <bool ShadowRay, typename ScalarRay3f>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape<Float, Spectrum>>
+    ray_intersect_scalar(const ScalarRay3f &ray) const {
+        if (bvh)
+            return bvh->template ray_intersect_scalar<ShadowRay>(ray);
+        else
+            return accel->template ray_intersect_scalar<ShadowRay>(ray);
+    }
+
+    /// Release the acceleration data structure
+    void release() {
+        if (accel) {
+            accel->clear();
+            accel->dec_ref();
+        }
+        if (bvh) {
+            bvh->clear();
+            bvh->dec_ref();
+        }
+    }
 };
 
 MI_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
-    ShapeKDTree *kdtree = new ShapeKDTree(props);
-    kdtree->inc_ref();
+    m_accel = new NativeState<Float, Spectrum>();
+    NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
+
+    std::string_view accel = props.get<std::string_view>("accel", "kdtree");
+    if (accel == "kdtree") {
+        s.accel = new ShapeKDTree(props);
+        s.accel->inc_ref();
+    } else if (accel == "bvh") {
+        s.bvh = new ShapeBVH(props);
+        s.bvh->inc_ref();
+    } else {
+        Throw("Unsupported acceleration data structure \"%s\", expected "
+              "\"kdtree\" or \"bvh\"!", accel);
+    }
 
     if constexpr (dr::is_llvm_v<Float>) {
-        m_accel = new NativeState<Float, Spectrum>();
-        NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
-        s.accel = kdtree;
-
         // Get shapes registry ids
         if (!m_shapes.empty()) {
             std::unique_ptr<uint32_t[]> data(new uint32_t[m_shapes.size()]);
@@ -28,8 +65,6 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props)
         } else {
             s.shapes_registry_ids = dr::zeros<DynamicBuffer<UInt32>>();
         }
-    } else {
-        m_accel = kdtree;
     }
 
     accel_parameters_changed_cpu();
@@ -44,17 +79,30 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
     if constexpr (dr::is_llvm_v<Float>)
         dr::sync_thread();
 
-    ShapeKDTree *kdtree;
-    if constexpr (dr::is_llvm_v<Float>)
-        kdtree = ((NativeState<Float, Spectrum> *) m_accel)->accel;
-    else
-        kdtree = (ShapeKDTree *) m_accel;
-
-    kdtree->clear();
-    for (Shape *shape : m_shapes)
-        kdtree->add_shape(shape);
-    ScopedPhase phase(ProfilerPhase::InitAccel);
-    kdtree->build();
+    NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
+
+    if (s.bvh) {
+        /* When only the geometry of some shapes moved, refit the existing
+           BVH instead of rebuilding it. The native shape groups keep their
+           own kd-tree, so any change to them requires a full rebuild. */
+        bool shapegroups_dirty = false;
+        for (auto &sg : m_shapegroups)
+            shapegroups_dirty |= sg->dirty();
+
+        ScopedPhase phase(ProfilerPhase::InitAccel);
+        if (shapegroups_dirty || !s.bvh->refit()) {
+            s.bvh->clear();
+            for (Shape *shape : m_shapes)
+                s.bvh->add_shape(shape);
+            s.bvh->build();
+        }
+    } else {
+        s.accel->clear();
+        for (Shape *shape : m_shapes)
+            s.accel->add_shape(shape);
+        ScopedPhase phase(ProfilerPhase::InitAccel);
+        s.accel->build();
+    }
 
     /* Set up a callback on the handle variable to release the acceleration
        data structure (AS) when this variable is freed. This ensures that the
@@ -73,11 +121,10 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
                     jit_enqueue_host_func(
                         JitBackend::LLVM,
                         [](void *p) {
-                            Log(Debug, "Free KDTree..");
+                            Log(Debug, "Free acceleration data structure..");
                             NativeState<Float, Spectrum> *s =
                                 (NativeState<Float, Spectrum> *) p;
-                            s->accel->clear();
-                            s->accel->dec_ref();
+                            s->release();
                             delete s;
                         },
                         payload
@@ -87,7 +134,6 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
             (void *) m_accel
         );
 
-        NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
         // To support frozen functions the func_ptr has to exist as a variable
         // when the scene is traversed.
         // Since the LLVM vector width should not change over the lifetime of
@@ -102,7 +148,7 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
             default:
                 Throw("ray_intersect_preliminary_cpu(): Dr.Jit is "
                       "configured for vectors of width %u, which is not "
-                      "supported by the kd-tree ray tracing backend!", jit_width);
+                      "supported by the native ray tracing backend!", jit_width);
         }
 
         s.func_ptr    = func_ptr;
@@ -122,7 +168,9 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
            ray tracing calls are pending. */
         m_accel_handle = 0;
     } else {
-        ((ShapeKDTree *) m_accel)->dec_ref();
+        NativeState<Float, Spectrum> *s = (NativeState<Float, Spectrum> *) m_accel;
+        s->release();
+        delete s;
     }
 
     m_accel = nullptr;
@@ -150,10 +198,8 @@ void kdtree_trace_func_wrapper(const int *valid, void *ptr,
                                void* /* context */, uint8_t *args) {
     MI_IMPORT_TYPES()
     using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
-    using ShapeKDTree = ShapeKDTree<Float, Spectrum>;
 
-    NativeState<Float, Spectrum> *s = (NativeState<Float, Spectrum> *) ptr;
-    const ShapeKDTree *kdtree = s->accel;
+    const NativeState<Float, Spectrum> *s = (const NativeState<Float, Spectrum> *) ptr;
     using RayHit = RayHitT<ScalarFloat>;
 
     for (size_t i = 0; i < Width; i++) {
@@ -176,11 +222,11 @@ void kdtree_trace_func_wrapper(const int *valid, void *ptr,
         ScalarRay3f ray = ScalarRay3f(ray_o, ray_d, ray_maxt, ray_time, wavelength_t<Spectrum>());
 
         if constexpr (ShadowRay) {
-            bool hit = kdtree->template ray_intersect_scalar<true>(ray).is_valid();
+            bool hit = s->template ray_intersect_scalar<true>(ray).is_valid();
             if (hit)
                 ray_maxt = 0.f;
         } else {
-            auto pi = kdtree->template ray_intersect_scalar<false>(ray);
+            auto pi = s->template ray_intersect_scalar<false>(ray);
             if (pi.is_valid()) {
                 ScalarFloat& prim_u = ((ScalarFloat*) &args[offsetof(RayHit, u) * Width])[i];
                 ScalarFloat& prim_v = ((ScalarFloat*) &args[offsetof(RayHit, v) * Width])[i];
@@ -207,8 +253,9 @@ Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray,
                                                       Mask active) const {
     if constexpr (!dr::is_array_v<Float>) {
         DRJIT_MARK_USED(coherent);
-        const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
-        return kdtree->template ray_intersect_preliminary<false>(ray, active);
+        DRJIT_MARK_USED(active);
+        const NativeState<Float, Spectrum> &s = *(const NativeState<Float, Spectrum> *) m_accel;
+        return s.template ray_intersect_scalar<false>(ray);
     } else {
         NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
         void *func_ptr = s.func_ptr,
@@ -283,8 +330,9 @@ Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray,
                                      Mask coherent, Mask active) const {
     if constexpr (!dr::is_jit_v<Float>) {
         DRJIT_MARK_USED(coherent);
-        const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
-        return kdtree->template ray_intersect_preliminary<true>(ray, active).is_valid();
+        DRJIT_MARK_USED(active);
+        const NativeState<Float, Spectrum> &s = *(const NativeState<Float, Spectrum> *) m_accel;
+        return s.template ray_intersect_scalar<true>(ray).is_valid();
     } else {
         NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
         void *func_ptr = s.func_ptr,
@@ -315,14 +363,11 @@ Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray,
 
 MI_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect_naive_cpu(const Ray3f &ray, Mask active) const {
-    const ShapeKDTree *kdtree;
-    if constexpr (dr::is_llvm_v<Float>)
-        kdtree = ((NativeState<Float, Spectrum> *) m_accel)->accel;
-    else
-        kdtree = (const ShapeKDTree *) m_accel;
+    const NativeState<Float, Spectrum> &s = *(const NativeState<Float, Spectrum> *) m_accel;
 
     PreliminaryIntersection3f pi =
-        kdtree->template ray_intersect_naive<false>(ray, active);
+        s.bvh ? s.bvh->template ray_intersect_naive<false>(ray, active)
+              : s.accel->template ray_intersect_naive<false>(ray, active);
 
     return pi.compute_surface_interaction(ray, +RayFlags::All, active);
 }
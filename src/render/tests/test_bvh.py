@@ -0,0 +1,206 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from mitsuba.scalar_rgb.test.util import fresolver_append_path
+
+
+def compare_results(res_a, res_b, atol=0.0):
+    assert dr.all(res_a.is_valid() == res_b.is_valid())
+    if dr.any(res_a.is_valid()):
+        assert dr.allclose(res_a.t, res_b.t, atol=atol), "\n%s\n\n%s" % (res_a.t, res_b.t)
+
+
+def load_scene(accel, shapes, **kwargs):
+    scene_dict = { 'type': 'scene', 'accel': accel }
+    scene_dict.update(kwargs)
+    scene_dict.update(shapes)
+    return mi.load_dict(scene_dict)
+
+
+def test01_invalid_accel(variant_scalar_rgb):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    with pytest.raises(RuntimeError, match='Unsupported acceleration data structure'):
+        load_scene('octree', {})
+
+
+def test02_empty_scene(variants_all_backends_once):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    scene = load_scene('bvh', {})
+    ray = mi.Ray3f([0, 0, -1], [0, 0, 1])
+    assert dr.none(scene.ray_test(ray))
+    assert dr.none(scene.ray_intersect(ray).is_valid())
+
+
+@fresolver_append_path
+@pytest.mark.parametrize('leaf_size', [1, 4, 16])
+def test03_depth_scalar_bunny(variant_scalar_rgb, leaf_size):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    shapes = {
+        'bunny': {
+            'type' : 'ply',
+            'filename' : 'resources/data/common/meshes/bunny_lowres.ply',
+        },
+        'sphere': {
+            'type' : 'sphere',
+            'center' : [0, 0.1, 0],
+            'radius' : 0.02
+        }
+    }
+
+    scene = load_scene('bvh', shapes, bvh_max_leaf_size=leaf_size)
+    scene_kd = load_scene('kdtree', shapes)
+    b = scene.bbox()
+
+    n = 64
+    inv_n = 1.0 / (n - 1)
+
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            r = mi.Ray3f(o, [0, 0, 1], 0.5, [])
+
+            res_naive  = scene.ray_intersect_naive(r)
+            res        = scene.ray_intersect(r)
+            res_kd     = scene_kd.ray_intersect(r)
+            res_shadow = scene.ray_test(r)
+
+            assert dr.all(res_shadow == res_naive.is_valid())
+            compare_results(res_naive, res)
+            compare_results(res_kd, res, atol=1e-6)
+            if res.is_valid():
+                assert res.shape == res_naive.shape
+                assert res.prim_index == res_naive.prim_index
+
+
+@fresolver_append_path
+def test04_llvm_random_rays(variant_llvm_ad_rgb):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    shapes = {
+        'bunny': {
+            'type' : 'ply',
+            'filename' : 'resources/data/common/meshes/bunny_lowres.ply',
+        }
+    }
+
+    scene = load_scene('bvh', shapes)
+    scene_kd = load_scene('kdtree', shapes)
+
+    n = 4096
+    sampler = mi.load_dict({ 'type': 'independent' })
+    sampler.seed(0, n)
+    c = scene.bbox().center()
+    o = c + mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    d = dr.normalize(c + 0.1 * mi.warp.square_to_uniform_sphere(sampler.next_2d()) - o)
+    r = mi.Ray3f(o, d)
+
+    pi    = scene.ray_intersect_preliminary(r)
+    pi_kd = scene_kd.ray_intersect_preliminary(r)
+
+    assert dr.all(pi.is_valid() == pi_kd.is_valid())
+    assert dr.allclose(dr.select(pi.is_valid(), pi.t, 0),
+                       dr.select(pi_kd.is_valid(), pi_kd.t, 0), atol=1e-5)
+    assert dr.all(scene.ray_test(r) == pi.is_valid())
+
+
+@fresolver_append_path
+@pytest.mark.parametrize('threshold', [0.0, 1.5, 1e6])
+def test05_refit_vertex_positions(variant_scalar_rgb, threshold):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    shapes = {
+        'bunny': {
+            'type' : 'ply',
+            'filename' : 'resources/data/common/meshes/bunny_lowres.ply',
+        },
+        'rect': {
+            'type' : 'rectangle',
+            'to_world' : mi.ScalarTransform4f().translate([0, 0, -1])
+        }
+    }
+
+    scene = load_scene('bvh', shapes, bvh_refit_threshold=threshold)
+    params = mi.traverse(scene)
+
+    # Deform the bunny: both the refit and the rebuilt BVH must stay exact
+    for it in range(3):
+        v = dr.unravel(mi.Point3f, params['bunny.vertex_positions'])
+        v = mi.Point3f(v.x * 1.25, v.y + 0.1 * dr.sin(10 * v.x), v.z - 0.05)
+        params['bunny.vertex_positions'] = dr.ravel(v)
+        params.update()
+
+        b = scene.bbox()
+        assert dr.allclose(b.min[2], -1.0)
+
+        n = 32
+        inv_n = 1.0 / (n - 1)
+        for x in range(n):
+            for y in range(n):
+                o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                     b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                     b.max[2] + 1]
+                r = mi.Ray3f(o, [0, 0, -1])
+
+                res_naive = scene.ray_intersect_naive(r)
+                res       = scene.ray_intersect(r)
+
+                assert dr.all(scene.ray_test(r) == res_naive.is_valid())
+                compare_results(res_naive, res)
+
+
+@pytest.mark.slow
+@fresolver_append_path
+def test06_benchmark_bvh_kdtree(variant_llvm_ad_rgb):
+    """
+    Side-by-side comparison of build time, memory usage (reported in the log),
+    and ray throughput of the kd-tree and the BVH.
+    """
+    import time
+
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    shapes = {}
+    for i in range(8):
+        shapes[f'bunny_{i}'] = {
+            'type' : 'ply',
+            'filename' : 'resources/data/common/meshes/bunny_lowres.ply',
+            'to_world' : mi.ScalarTransform4f().translate([0.2 * i, 0, 0])
+        }
+
+    n = 1024 * 1024
+    sampler = mi.load_dict({ 'type': 'independent' })
+    sampler.seed(0, n)
+
+    mi.set_log_level(mi.LogLevel.Info)
+    for accel in ['kdtree', 'bvh']:
+        t0 = time.time()
+        scene = load_scene(accel, shapes)
+        t_build = time.time() - t0
+
+        c = scene.bbox().center()
+        o = c + 2 * mi.warp.square_to_uniform_sphere(sampler.next_2d())
+        d = dr.normalize(c + 0.5 * mi.warp.square_to_uniform_sphere(sampler.next_2d()) - o)
+        r = mi.Ray3f(o, d)
+        dr.eval(r)
+
+        # Warm up the kernel cache
+        dr.eval(scene.ray_intersect_preliminary(r).t)
+
+        t0 = time.time()
+        dr.eval(scene.ray_intersect_preliminary(r).t)
+        t_trace = time.time() - t0
+
+        print(f'{accel:>6}: scene load + build {t_build * 1000:.1f} ms, '
+              f'{n / t_trace * 1e-6:.2f} Mrays/s')
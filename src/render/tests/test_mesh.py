@@ -1467,3 +1467,294 @@ def test39_custom_vertex_normals(variants_vec_rgb):
 
     # The custom vertex normals should not have been modified.
     assert dr.allclose(params['vertex_normals'], normals)
+
+
+@pytest.mark.parametrize('threshold', [0.0, 0.5])
+def test40_solid_angle_sampling(variants_vec_rgb, threshold):
+    # Both sampling strategies must estimate the total solid angle subtended by
+    # the faces, and pdf_direction() must agree with sample_direction()
+    n = 100000
+    it = dr.zeros(mi.Interaction3f, n)
+    it.p = [0.2, -0.3, 1.5]
+
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+    sample = sampler.next_2d()
+
+    estimates = []
+    for solid_angle_sampling in [False, True]:
+        mesh = mi.load_dict({
+            'type': 'cube',
+            'solid_angle_sampling': solid_angle_sampling,
+            'solid_angle_threshold': threshold
+        })
+
+        ds = mesh.sample_direction(it, sample)
+        assert dr.all(ds.pdf > 0)
+        assert dr.allclose(mesh.pdf_direction(it, ds), ds.pdf, rtol=1e-3)
+        assert dr.allclose(dr.norm(ds.p - it.p), ds.dist)
+
+        weight = dr.rcp(ds.pdf)
+        estimates.append((dr.mean(weight), dr.mean(dr.square(weight))))
+
+    (mean_area, sqr_area), (mean_sa, sqr_sa) = estimates
+    assert dr.allclose(mean_area, mean_sa, rtol=2e-2)
+
+    # Sampling the nearby faces by solid angle reduces the variance
+    assert (sqr_sa - mean_sa**2)[0] < (sqr_area - mean_area**2)[0]
+
+
+def reference_directed_edges(faces):
+    # Straightforward serial construction of the opposite edge table
+    invalid = 0xFFFFFFFF
+    end = lambda e: faces[e - e % 3 + (e % 3 + 1) % 3]
+
+    outgoing = {}
+    for e in range(len(faces)):
+        if faces[e] != end(e):
+            outgoing.setdefault(faces[e], []).append(e)
+
+    e2e = [invalid] * len(faces)
+    for e in range(len(faces)):
+        if faces[e] == end(e):
+            continue
+        opp = invalid
+        for k in outgoing.get(end(e), []):
+            if end(k) == faces[e]:
+                if opp == invalid:
+                    opp = k
+                else:
+                    opp = invalid
+                    break
+        if opp != invalid and e < opp:
+            e2e[e], e2e[opp] = opp, e
+    return e2e
+
+
+@fresolver_append_path
+def test41_parallel_preprocessing(variant_scalar_rgb):
+    import numpy as np
+
+    # Non-manifold fan around edge (0, 1) and a degenerate face
+    mesh_nm = mi.Mesh('fan', vertex_count=6, face_count=5)
+    params = mi.traverse(mesh_nm)
+    params['vertex_positions'] = np.random.default_rng(0).random(18).tolist()
+    params['faces'] = [0, 1, 2, 1, 0, 3, 0, 1, 4, 1, 0, 5, 2, 2, 3]
+    params.update()
+
+    mesh = mi.load_dict({
+        'type': 'ply',
+        'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+    })
+
+    for m in [mesh_nm, mesh]:
+        faces = np.array(mi.traverse(m)['faces']).tolist()
+        m.build_directed_edges()
+        e2e = [m.opposite_dedge(e) for e in range(len(faces))]
+        assert e2e == reference_directed_edges(faces)
+
+    # Vertex normals must be deterministic and match a reference
+    params = mi.traverse(mesh)
+    mesh.recompute_vertex_normals()
+    n0 = np.array(params['vertex_normals'])
+    mesh.recompute_vertex_normals()
+    assert np.all(n0 == np.array(params['vertex_normals']))
+
+    p = np.array(params['vertex_positions'], dtype=np.float64).reshape(-1, 3)
+    f = np.array(params['faces']).reshape(-1, 3)
+    ref = np.zeros_like(p)
+    for i in range(3):
+        d0 = p[f[:, (i + 1) % 3]] - p[f[:, i]]
+        d1 = p[f[:, (i + 2) % 3]] - p[f[:, i]]
+        d0 /= np.linalg.norm(d0, axis=1)[:, None]
+        d1 /= np.linalg.norm(d1, axis=1)[:, None]
+        angle = np.arccos(np.clip(np.sum(d0 * d1, axis=1), -1, 1))
+        n = np.cross(p[f[:, 1]] - p[f[:, 0]], p[f[:, 2]] - p[f[:, 0]])
+        n /= np.linalg.norm(n, axis=1)[:, None]
+        np.add.at(ref, f[:, i], n * angle[:, None])
+    ref /= np.linalg.norm(ref, axis=1)[:, None]
+    assert np.allclose(n0.reshape(-1, 3), ref, atol=1e-4)
+
+    # Surface area computed by the (parallel) sampling table
+    area = 0.5 * np.linalg.norm(
+        np.cross(p[f[:, 1]] - p[f[:, 0]], p[f[:, 2]] - p[f[:, 0]]), axis=1).sum()
+    assert np.allclose(mesh.surface_area(), area, rtol=1e-5)
+
+
+
+@fresolver_append_path
+@pytest.mark.parametrize('compress', [False, True])
+def test42_write_mmesh(variants_all_rgb, tmp_path, compress):
+    filepath = str(tmp_path / 'test_mesh-test42_write_mmesh.mmesh')
+
+    mesh = mi.load_dict({
+        'type': 'ply',
+        'filename': 'resources/data/tests/ply/rectangle_normals_uv.ply'
+    })
+    mesh.add_attribute('vertex_test', 1, [1, 2, 3, 4])
+    mesh.add_attribute('face_test', 2, [5, 6, 7, 8])
+    params = mi.traverse(mesh)
+
+    mesh.write_mmesh(filepath, compress=compress)
+
+    mesh_saved = mi.load_dict({ 'type': 'mmesh', 'filename': filepath })
+    params_saved = mi.traverse(mesh_saved)
+
+    assert mesh_saved.vertex_count() == mesh.vertex_count()
+    assert mesh_saved.face_count() == mesh.face_count()
+    for key in ['vertex_positions', 'vertex_normals', 'vertex_texcoords',
+                'faces', 'vertex_test', 'face_test']:
+        assert dr.all(params_saved[key] == params[key]), key
+    assert dr.all(mesh_saved.bbox().min == mesh.bbox().min)
+    assert dr.all(mesh_saved.bbox().max == mesh.bbox().max)
+
+    # The stream variant produces the same file
+    ms = mi.MemoryStream()
+    mesh.write_mmesh(ms, compress=compress)
+    assert mi.FileStream(filepath, mi.FileStream.ERead).size() == ms.size()
+
+    # Transformed meshes must match the PLY loader
+    to_world = mi.ScalarTransform4f().translate([1, 2, 3]).rotate([0, 1, 0], 30).scale(2)
+    mesh_ply = mi.load_dict({
+        'type': 'ply',
+        'filename': 'resources/data/tests/ply/rectangle_normals_uv.ply',
+        'to_world': to_world
+    })
+    mesh_saved = mi.load_dict({ 'type': 'mmesh', 'filename': filepath,
+                                'to_world': to_world })
+    params_ply, params_saved = mi.traverse(mesh_ply), mi.traverse(mesh_saved)
+    assert dr.allclose(params_saved['vertex_positions'], params_ply['vertex_positions'])
+    assert dr.allclose(params_saved['vertex_normals'], params_ply['vertex_normals'])
+    assert dr.allclose(mesh_saved.bbox().min, mesh_ply.bbox().min)
+    assert dr.allclose(mesh_saved.bbox().max, mesh_ply.bbox().max)
+
+
+@fresolver_append_path
+def test43_mmesh_emitter(variants_vec_rgb, tmp_path):
+    filepath = str(tmp_path / 'test_mesh-test43_mmesh_emitter.mmesh')
+
+    mesh = mi.load_dict({
+        'type': 'ply',
+        'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+        'face_normals': True
+    })
+    mesh.write_mmesh(filepath)
+
+    # Load both meshes as emitters: the precomputed face areas must yield
+    # the same sampling table as the one computed by the PLY loader
+    shapes = [mi.load_dict({
+        'type': plugin,
+        'filename': filepath if plugin == 'mmesh' else
+            'resources/data/common/meshes/bunny_lowres.ply',
+        'face_normals': True,
+        'emitter': { 'type': 'area' }
+    }) for plugin in ['mmesh', 'ply']]
+
+    assert not shapes[0].has_vertex_normals()
+    assert dr.allclose(shapes[0].surface_area(), shapes[1].surface_area())
+
+    sample = mi.Point2f(dr.linspace(mi.Float, 0.01, 0.99, 64),
+                        dr.linspace(mi.Float, 0.99, 0.01, 64))
+    ps = [shape.sample_position(0, sample) for shape in shapes]
+    assert dr.allclose(ps[0].p, ps[1].p)
+    assert dr.allclose(ps[0].pdf, ps[1].pdf)
+
+    # Mapped buffers can be replaced through the traversal mechanism
+    params = mi.traverse(shapes[0])
+    params['vertex_positions'] = params['vertex_positions'] * 2
+    params.update()
+    assert dr.allclose(shapes[0].surface_area(), 4 * shapes[1].surface_area())
+
+
+def test44_mmesh_invalid(variant_scalar_rgb, tmp_path):
+    filepath = str(tmp_path / 'test_mesh-test44_mmesh_invalid.mmesh')
+    with open(filepath, 'wb') as f:
+        f.write(b'NOT_A_MESH' + bytes(200))
+
+    with pytest.raises(RuntimeError, match='invalid file format'):
+        mi.load_dict({ 'type': 'mmesh', 'filename': filepath })
+
+
+@fresolver_append_path
+@pytest.mark.parametrize('bits', [16, 21])
+def test45_compact_storage(variant_scalar_rgb, tmp_path, bits):
+    def load(filename, compact):
+        return mi.load_dict({
+            'type': 'ply',
+            'filename': filename,
+            'compact': compact,
+            'compact_position_bits': bits
+        })
+
+    filename = 'resources/data/common/meshes/bunny_lowres.ply'
+    mesh, mesh_ref = load(filename, True), load(filename, False)
+    assert mesh.compact() and not mesh_ref.compact()
+    assert mesh.vertex_count() == mesh_ref.vertex_count()
+    assert mesh.face_count() == mesh_ref.face_count()
+    assert mesh.has_vertex_normals()
+    assert 'vertex_positions' not in mi.traverse(mesh)
+
+    # Quantization error of the positions
+    atol = dr.max(mesh_ref.bbox().extents()) * 2.0**(1 - bits)
+    for i in range(0, mesh.vertex_count(), 7):
+        assert dr.allclose(mesh.vertex_position(i), mesh_ref.vertex_position(i),
+                           rtol=0, atol=atol)
+        assert dr.allclose(mesh.vertex_normal(i), mesh_ref.vertex_normal(i),
+                           rtol=0, atol=1e-3)
+    for i in range(0, mesh.face_count(), 7):
+        assert dr.all(mesh.face_indices(i) == mesh_ref.face_indices(i))
+
+    assert dr.allclose(mesh.surface_area(), mesh_ref.surface_area(), rtol=1e-3)
+
+    # Intersect both meshes
+    scene = mi.load_dict({ 'type': 'scene', 'mesh': mesh })
+    scene_ref = mi.load_dict({ 'type': 'scene', 'mesh': mesh_ref })
+    center = mesh_ref.bbox().center()
+    for d in [[0, 0, 1], [0, 1, 0], [1, 0, 0], [-1, 0, 0]]:
+        ray = mi.Ray3f(center - 10 * mi.Vector3f(d), d)
+        si, si_ref = scene.ray_intersect(ray), scene_ref.ray_intersect(ray)
+        assert si.is_valid() and si_ref.is_valid()
+        assert dr.allclose(si.t, si_ref.t, rtol=0, atol=10 * atol)
+        assert dr.allclose(si.sh_frame.n, si_ref.sh_frame.n, atol=1e-2)
+
+    # Texture coordinates use half precision
+    filename = 'resources/data/tests/ply/rectangle_normals_uv.ply'
+    mesh, mesh_ref = load(filename, True), load(filename, False)
+    assert mesh.has_vertex_texcoords()
+    for i in range(mesh.vertex_count()):
+        assert dr.allclose(mesh.vertex_texcoord(i), mesh_ref.vertex_texcoord(i),
+                           rtol=1e-3, atol=1e-4)
+
+    # Compact meshes are decoded when they are written to disk
+    filepath = str(tmp_path / 'test_mesh-test45_compact_storage.ply')
+    mesh.write_ply(filepath)
+    mesh_saved = mi.load_dict({ 'type': 'ply', 'filename': filepath })
+    for i in range(mesh.vertex_count()):
+        assert dr.allclose(mesh_saved.vertex_position(i), mesh.vertex_position(i))
+        assert dr.allclose(mesh_saved.vertex_texcoord(i), mesh.vertex_texcoord(i))
+
+
+@fresolver_append_path
+def test46_compact_storage_memory(variant_scalar_rgb):
+    # Measure the footprint of compact meshes as reported to mi.MemoryUsage
+    def measure(compact):
+        before = mi.MemoryUsage.bytes(mi.MemoryCategory.Geometry)
+        mesh = mi.load_dict({
+            'type': 'ply',
+            'filename': 'resources/data/common/meshes/bunny_lowres.ply',
+            'compact': compact
+        })
+        return mesh, mi.MemoryUsage.bytes(mi.MemoryCategory.Geometry) - before
+
+    mesh_ref, size_ref = measure(False)
+    mesh, size = measure(True)
+    assert mesh.has_vertex_normals()
+    assert size_ref == 32 * mesh_ref.vertex_count() + 12 * mesh_ref.face_count() \
+        or size_ref == 24 * mesh_ref.vertex_count() + 12 * mesh_ref.face_count()
+
+    # At least 20% smaller with Embree, more with the kd-tree
+    assert size < 0.8 * size_ref
+
+    # Compact meshes can only be merged with each other
+    with pytest.raises(RuntimeError, match='incompatible'):
+        mesh.merge(mesh_ref)
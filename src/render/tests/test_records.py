@@ -65,7 +65,8 @@ def test02_position_sample_construction_vec(variants_vec_backends_once):
       [0, 0]],
   time=[0, 0.5, 0.7, 1, 1.5],
   pdf=[0, 0, 0, 0, 0],
-  delta=[0, 0, 0, 0, 0]
+  delta=[0, 0, 0, 0, 0],
+  prim_index=[0, 0, 0, 0, 0]
 ]"""
 
     assert str(records) == expected
@@ -94,6 +95,7 @@ def test04_direction_sample_construction_single(variants_vec_backends_once):
   time=[],
   pdf=[0.002],
   delta=[],
+  prim_index=[0],
   d=[[0, 42, -1]],
   dist=[0.13],
   emitter=[0x0]
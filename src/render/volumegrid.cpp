@@ -2,6 +2,7 @@
 #include <mitsuba/core/stream.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/core/util.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -11,8 +12,8 @@ VolumeGrid<Float, Spectrum>::VolumeGrid(Stream *stream) { read(stream); }
 
 MI_VARIANT
 VolumeGrid<Float, Spectrum>::VolumeGrid(const fs::path &filename) {
-    ref<FileStream> fs = new FileStream(filename);
-    read(fs);
+    ref<Stream> stream = FilePrefetcher::open(filename);
+    read(stream);
 }
 
 MI_VARIANT
@@ -7,6 +7,7 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/mmap.h>
 #include <mitsuba/core/timer.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/shape.h>
@@ -163,6 +164,7 @@ public:
 
         ref<MemoryMappedFile> mmap = new MemoryMappedFile(file_path);
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        ScopedTraceEvent trace_event("File I/O", "Load geometry", file_path);
 
         // Temporary buffers for vertices and radius
         std::vector<InputPoint3f> vertices;
@@ -77,6 +77,30 @@ public:
         m_shape_type = ShapeType::Instance;
 
         dr::make_opaque(m_to_world);
+        update();
+    }
+
+    /**
+     * \brief Refresh host-side quantities derived from \c to_world
+     *
+     * The world-to-object transform and the world-space bounding box are
+     * queried once per ray and many times during acceleration data structure
+     * construction, respectively. Both are therefore precomputed here instead
+     * of being re-derived on every call.
+     */
+    void update() {
+        m_to_object = m_to_world.scalar().inverse();
+
+        /* Transform the bounding boxes of the individual shapes rather than
+           the (looser) bounding box of the entire group */
+        m_bbox.reset();
+        for (const auto &shape : m_shapegroup->shapes()) {
+            const ScalarBoundingBox3f bbox = shape->bbox();
+            if (!bbox.valid())
+                continue;
+            for (int i = 0; i < 8; ++i)
+                m_bbox.expand(m_to_world.scalar() * bbox.corner(i));
+        }
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -88,21 +112,13 @@ public:
             m_to_world = m_to_world.value().update();
             mark_dirty();
         }
+
+        // The shapes of the group may have moved as well
+        update();
         Base::parameters_changed();
     }
 
-    ScalarBoundingBox3f bbox() const override {
-        const ScalarBoundingBox3f &bbox = m_shapegroup->bbox();
-
-        // If the shape group is empty, return the invalid bbox
-        if (!bbox.valid())
-            return bbox;
-
-        ScalarBoundingBox3f result;
-        for (int i = 0; i < 8; ++i)
-            result.expand(m_to_world.scalar() * bbox.corner(i));
-        return result;
-    }
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
 
     ScalarSize primitive_count() const override { return 1; }
 
@@ -125,7 +141,13 @@ public:
                                    dr::mask_t<FloatP> active) const {
         MI_MASK_ARGUMENT(active);
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_intersect_preliminary_scalar(m_to_world.scalar().inverse() * ray);
+#if !defined(MI_ENABLE_EMBREE)
+            // Descend straight into the bottom-level kd-tree of the group
+            auto pi = m_shapegroup->kdtree()->template ray_intersect_scalar<false>(m_to_object * ray);
+            return { pi.t, pi.prim_uv, pi.shape_index, pi.prim_index };
+#else
+            return m_shapegroup->ray_intersect_preliminary_scalar(m_to_object * ray);
+#endif
         } else {
             Throw("Instance::ray_intersect_preliminary() should only be called with scalar types.");
         }
@@ -138,7 +160,11 @@ public:
         MI_MASK_ARGUMENT(active);
 
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_test_scalar(m_to_world.scalar().inverse() * ray);
+#if !defined(MI_ENABLE_EMBREE)
+            return m_shapegroup->kdtree()->template ray_intersect_scalar<true>(m_to_object * ray).is_valid();
+#else
+            return m_shapegroup->ray_test_scalar(m_to_object * ray);
+#endif
         } else {
             Throw("Instance::ray_test_impl() should only be called with scalar types.");
         }
@@ -293,6 +319,12 @@ public:
 private:
    ref<ShapeGroup_> m_shapegroup;
 
+   /// Cached world-to-object transform (host copy, used by the CPU kd-tree)
+   ScalarAffineTransform4f m_to_object;
+
+   /// Cached world-space bounding box
+   ScalarBoundingBox3f m_bbox;
+
    MI_TRAVERSE_CB(Base, m_shapegroup)
 };
 
@@ -1,15 +1,29 @@
 #include <mitsuba/render/mesh.h>
+#include <mitsuba/core/plugin.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
+#include <nanothread/nanothread.h>
+#include <cmath>
+#include <cstring>
+#include <string_view>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/* The 'merge' shape is inserted by parser::transform_merge_meshes() and
+   collapses compatible meshes into a single mesh. When the
+   'instance_duplicates' property is set, meshes that are identical up to a
+   rigid transformation are first replaced by instances of a shared shape
+   group (see parser::ParserConfig::instance_duplicates). */
+
 template <typename Float, typename Spectrum>
 class MergeShape final : public Shape<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Shape)
     MI_IMPORT_TYPES(BSDF, Medium, Emitter, Sensor, Mesh)
 
+    using InputFloat = typename Mesh::InputFloat;
+    using FloatStorage = typename Mesh::FloatStorage;
+
     MergeShape(const Properties &props) {
         // Note: we are *not* calling the `Shape` constructor as we do not
         // want to accept various properties such as `to_world`.
@@ -17,11 +31,20 @@ public:
         size_t visited = 0, ignored = 0;
         Timer timer;
 
-        for (auto &prop : props.objects()) {
-            ref<Object> shape = prop.get<ref<Object>>();
-            Mesh *mesh = prop.try_get<Mesh>();
+        std::vector<ref<Object>> shapes;
+        for (auto &prop : props.objects())
+            shapes.push_back(prop.get<ref<Object>>());
+
+        if (props.get<bool>("instance_duplicates", false))
+            instance_duplicates(shapes);
 
-            if (!mesh || mesh->has_mesh_attributes()) {
+        for (auto &shape : shapes) {
+            Mesh *mesh = dynamic_cast<Mesh *>(shape.get());
+
+            /* Compact meshes are quantized relative to their own bounding
+               box. Merging them would re-quantize the vertex positions
+               against the (much larger) bounding box of the merged mesh. */
+            if (!mesh || mesh->has_mesh_attributes() || mesh->compact()) {
                 m_objects.push_back(shape);
                 ignored++;
                 continue;
@@ -64,6 +87,348 @@ public:
     MI_DECLARE_CLASS(MergeShape)
 
 private:
+    /// Host-side view of the geometry of a mesh
+    struct Geometry {
+        ref<Mesh> mesh;
+        /// Host copies of the buffers (JIT variants only)
+        FloatStorage positions_host, normals_host;
+        DynamicBuffer<UInt32> faces_host;
+        FloatStorage texcoords_host;
+        const InputFloat *positions = nullptr, *normals = nullptr,
+                         *texcoords = nullptr;
+        const uint32_t *faces = nullptr;
+        int flags = 0;
+        ScalarVector3d centroid;
+        /// Distance of the farthest vertex from the centroid
+        double radius = 0.0;
+        /// Hash of the attributes that are invariant under rigid transformations
+        size_t hash = 0;
+        /// Rigid transformation mapping the representative onto this mesh
+        ScalarMatrix4d to_world;
+    };
+
+    /// Width of the bins of the logarithm of the radius used to bucket meshes
+    static constexpr double RadiusBinWidth = 1e-3;
+
+    /// Shapes that are identical up to a rigid transformation
+    struct Cluster {
+        /// Representative, followed by the duplicates
+        std::vector<Geometry *> members;
+        /// Vertices spanning the reference frame of the representative
+        uint32_t anchors[3];
+    };
+
+    /// Position of vertex \c i (as a vector, since it is also rotated)
+    ScalarVector3d position(const Geometry &g, uint32_t i) const {
+        return ScalarVector3d(dr::load<dr::Array<InputFloat, 3>>(g.positions + 3 * i));
+    }
+
+    static ScalarVector3d mul(const ScalarMatrix3d &m, const ScalarVector3d &v) {
+        ScalarVector3d result;
+        for (size_t i = 0; i < 3; ++i)
+            result.entry(i) = m.entry(i, 0) * v.x() + m.entry(i, 1) * v.y() +
+                              m.entry(i, 2) * v.z();
+        return result;
+    }
+
+    /**
+     * \brief Orthonormal frame spanned by three vertices of a mesh (in
+     * the columns of the returned matrix)
+     */
+    ScalarMatrix3d anchor_frame(const Geometry &g, const uint32_t anchors[3]) const {
+        ScalarVector3d p0 = position(g, anchors[0]),
+                      p1 = position(g, anchors[1]),
+                      p2 = position(g, anchors[2]);
+        ScalarVector3d e1 = dr::normalize(p1 - p0),
+                       e2 = p2 - p0;
+        e2 = dr::normalize(e2 - e1 * dr::dot(e1, e2));
+        ScalarVector3d e3 = dr::cross(e1, e2);
+        return ScalarMatrix3d(e1.x(), e2.x(), e3.x(),
+                              e1.y(), e2.y(), e3.y(),
+                              e1.z(), e2.z(), e3.z());
+    }
+
+    /**
+     * \brief Choose three well-separated vertices of the representative of a
+     * cluster. Returns \c false when the mesh is (nearly) degenerate.
+     */
+    bool choose_anchors(const Geometry &g, uint32_t anchors[3]) const {
+        uint32_t n = g.mesh->vertex_count();
+        auto farthest = [&](auto distance) {
+            uint32_t best = 0;
+            double best_value = -1.0;
+            for (uint32_t i = 0; i < n; ++i) {
+                double value = distance(position(g, i));
+                if (value > best_value) {
+                    best = i;
+                    best_value = value;
+                }
+            }
+            return std::make_pair(best, best_value);
+        };
+
+        anchors[0] = farthest([&](const ScalarVector3d &p) {
+            return dr::squared_norm(p - g.centroid); }).first;
+        ScalarVector3d p0 = position(g, anchors[0]);
+        anchors[1] = farthest([&](const ScalarVector3d &p) {
+            return dr::squared_norm(p - p0); }).first;
+        ScalarVector3d d = dr::normalize(position(g, anchors[1]) - p0);
+        auto [i2, dist2] = farthest([&](const ScalarVector3d &p) {
+            return dr::squared_norm(dr::cross(p - p0, d)); });
+        anchors[2] = i2;
+
+        return dist2 > dr::square(1e-3 * g.radius);
+    }
+
+    /**
+     * \brief Check whether \c g is equal to the representative of a cluster
+     * up to a rigid transformation, and if so, store this transformation
+     */
+    bool match(const Cluster &cluster, Geometry &g) const {
+        const Geometry &r = *cluster.members[0];
+        size_t n = r.mesh->vertex_count(), m = r.mesh->face_count();
+
+        // Cheap tests first, the buffers are only compared afterwards
+        if (g.mesh->bsdf() != r.mesh->bsdf() || g.flags != r.flags ||
+            g.mesh->vertex_count() != n || g.mesh->face_count() != m)
+            return false;
+
+        // Rigid transformations preserve the size of the mesh
+        double tol = 1e-5 * (r.radius + dr::max(dr::abs(r.centroid)) +
+                             dr::max(dr::abs(g.centroid)));
+        if (dr::abs(r.radius - g.radius) > tol)
+            return false;
+
+        // The hashed buffers must match exactly
+        if (std::memcmp(g.faces, r.faces, m * 3 * sizeof(uint32_t)) != 0 ||
+            (r.texcoords && std::memcmp(g.texcoords, r.texcoords,
+                                        n * 2 * sizeof(InputFloat)) != 0))
+            return false;
+
+        ScalarMatrix3d rot = anchor_frame(g, cluster.anchors) *
+                             dr::transpose(anchor_frame(r, cluster.anchors));
+        ScalarVector3d trans = g.centroid - mul(rot, r.centroid);
+
+        for (uint32_t i = 0; i < n; ++i) {
+            ScalarVector3d p = mul(rot, position(r, i)) + trans;
+            if (dr::squared_norm(p - position(g, i)) > dr::square(tol))
+                return false;
+        }
+
+        if (r.normals) {
+            for (uint32_t i = 0; i < n; ++i) {
+                ScalarVector3d nr(dr::load<dr::Array<InputFloat, 3>>(r.normals + 3 * i)),
+                               ng(dr::load<dr::Array<InputFloat, 3>>(g.normals + 3 * i));
+                if (dr::squared_norm(mul(rot, nr) - ng) > 1e-6)
+                    return false;
+            }
+        }
+
+        g.to_world = dr::identity<ScalarMatrix4d>();
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 3; ++j)
+                g.to_world.entry(i, j) = rot.entry(i, j);
+            g.to_world.entry(i, 3) = trans.entry(i);
+        }
+        return true;
+    }
+
+    /**
+     * \brief Replace meshes that are identical up to a rigid transformation
+     * by instances of a shape group containing a single copy of the geometry
+     *
+     * Meshes are first bucketed by a hash of their topology, texture
+     * coordinates and material, combined with their (logarithmically binned)
+     * radius. Candidates are searched in the bucket of a mesh and in the
+     * neighboring radius bin, and compared vertex by vertex after aligning a
+     * reference frame spanned by three vertices. The affected entries of
+     * \c shapes are replaced by the new shape groups and instances.
+     */
+    void instance_duplicates(std::vector<ref<Object>> &shapes) {
+        Timer timer;
+        std::vector<std::unique_ptr<Geometry>> geometry(shapes.size());
+
+        auto process = [&](size_t i) {
+            Mesh *mesh = dynamic_cast<Mesh *>(shapes[i].get());
+
+            // Instances can't carry emitters, sensors, media or attributes
+            if (!mesh || mesh->is_emitter() || mesh->is_sensor() ||
+                mesh->interior_medium() || mesh->exterior_medium() ||
+                mesh->has_mesh_attributes() || mesh->compact() ||
+                mesh->vertex_count() < 3 || mesh->face_count() == 0)
+                return;
+
+            geometry[i] = std::make_unique<Geometry>();
+            describe(mesh, *geometry[i]);
+        };
+
+        // JIT variants first copy the buffers to the host
+        if constexpr (dr::is_jit_v<Float>) {
+            for (size_t i = 0; i < shapes.size(); ++i)
+                process(i);
+        } else {
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, shapes.size(), 1),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i)
+                        process(i);
+                }
+            );
+        }
+
+        /* Meshes of the same topology but different sizes (e.g. one sphere
+           tessellation at many scales) land in different buckets. Unless a
+           mesh lies very far from the origin compared to its size, the bins
+           are much wider than the tolerance of match(), hence checking the
+           closer neighboring bin suffices. */
+        auto bucket_key = [](const Geometry &g, int64_t bin) {
+            size_t seed = g.hash;
+            hash_combine(seed, bin);
+            return seed;
+        };
+
+        std::unordered_map<size_t, std::vector<Cluster>> buckets;
+        for (auto &g : geometry) {
+            // Degenerate meshes can't be matched (see choose_anchors())
+            if (!g || !(g->radius > 0.0))
+                continue;
+
+            double x = std::log(g->radius) / RadiusBinWidth;
+            int64_t bin = (int64_t) std::floor(x),
+                    neighbor = x - (double) bin < .5 ? bin - 1 : bin + 1;
+
+            auto add_to_cluster = [&](std::vector<Cluster> &clusters) {
+                for (Cluster &cluster : clusters) {
+                    if (match(cluster, *g)) {
+                        cluster.members.push_back(g.get());
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            std::vector<Cluster> &candidates = buckets[bucket_key(*g, bin)];
+            bool found = add_to_cluster(candidates);
+            if (!found) {
+                auto it = buckets.find(bucket_key(*g, neighbor));
+                found = it != buckets.end() && add_to_cluster(it->second);
+            }
+
+            if (!found) {
+                Cluster cluster;
+                if (!choose_anchors(*g, cluster.anchors))
+                    continue;
+                g->to_world = dr::identity<ScalarMatrix4d>();
+                cluster.members.push_back(g.get());
+                candidates.push_back(std::move(cluster));
+            }
+        }
+
+        // Replace the duplicates by instances
+        std::unordered_map<const Object *, std::vector<ref<Object>>> replacement;
+        size_t group_count = 0, instance_count = 0;
+        PluginManager *pmgr = PluginManager::instance();
+        for (auto &[hash, candidates] : buckets) {
+            for (Cluster &cluster : candidates) {
+                if (cluster.members.size() < 2)
+                    continue;
+
+                Mesh *representative = cluster.members[0]->mesh.get();
+                Properties props_group("shapegroup");
+                props_group.set("shape", (Object *) representative);
+                ref<Base> group = pmgr->create_object<Base>(props_group);
+
+                std::vector<ref<Object>> &objects = replacement[representative];
+                objects.push_back((ref<Object>) group);
+
+                for (Geometry *g : cluster.members) {
+                    Properties props_instance("instance");
+                    props_instance.set("shapegroup", (Object *) group.get());
+                    props_instance.set("to_world", ScalarAffineTransform4d(g->to_world));
+                    ref<Base> instance = pmgr->create_object<Base>(props_instance);
+                    if (!g->mesh->id().empty())
+                        instance->set_id(g->mesh->id());
+
+                    if (g == cluster.members[0])
+                        objects.push_back((ref<Object>) instance);
+                    else
+                        replacement[g->mesh.get()].push_back((ref<Object>) instance);
+                }
+
+                group_count++;
+                instance_count += cluster.members.size();
+            }
+        }
+
+        if (replacement.empty())
+            return;
+
+        std::vector<ref<Object>> result;
+        for (auto &shape : shapes) {
+            auto it = replacement.find(shape.get());
+            if (it == replacement.end())
+                result.push_back(shape);
+            else
+                result.insert(result.end(), it->second.begin(), it->second.end());
+        }
+        shapes = std::move(result);
+
+        Log(Info, "Replaced %zu duplicate meshes by instances of %zu shape "
+                  "groups. (took %s)", instance_count, group_count,
+            util::time_string((float) timer.value()));
+    }
+
+    /// Fetch the geometry of a mesh and compute its rigid-invariant hash
+    void describe(Mesh *mesh, Geometry &g) const {
+        g.mesh = mesh;
+
+        const FloatStorage &positions = mesh->vertex_positions_buffer();
+        const FloatStorage &normals = mesh->vertex_normals_buffer();
+        const FloatStorage &texcoords = mesh->vertex_texcoords_buffer();
+        const DynamicBuffer<UInt32> &faces = mesh->faces_buffer();
+
+        if constexpr (dr::is_jit_v<Float>) {
+            g.positions_host = dr::migrate(positions, AllocType::Host);
+            g.normals_host = dr::migrate(normals, AllocType::Host);
+            g.texcoords_host = dr::migrate(texcoords, AllocType::Host);
+            g.faces_host = dr::migrate(faces, AllocType::Host);
+            dr::sync_thread();
+            g.positions = g.positions_host.data();
+            g.normals = mesh->has_vertex_normals() ? g.normals_host.data() : nullptr;
+            g.texcoords = mesh->has_vertex_texcoords() ? g.texcoords_host.data() : nullptr;
+            g.faces = g.faces_host.data();
+        } else {
+            g.positions = positions.data();
+            g.normals = mesh->has_vertex_normals() ? normals.data() : nullptr;
+            g.texcoords = mesh->has_vertex_texcoords() ? texcoords.data() : nullptr;
+            g.faces = faces.data();
+        }
+
+        uint32_t n = mesh->vertex_count();
+        ScalarVector3d centroid(0.0);
+        for (uint32_t i = 0; i < n; ++i)
+            centroid += position(g, i);
+        g.centroid = centroid / (double) n;
+
+        for (uint32_t i = 0; i < n; ++i)
+            g.radius = dr::maximum(g.radius, dr::norm(position(g, i) - g.centroid));
+
+        auto hash_bytes = [](const void *ptr, size_t size) {
+            return std::hash<std::string_view>()(
+                std::string_view((const char *) ptr, size));
+        };
+
+        g.flags = (g.normals ? 1 : 0) + (g.texcoords ? 2 : 0) +
+                  (mesh->has_face_normals() ? 4 : 0) +
+                  (mesh->has_flipped_normals() ? 8 : 0);
+        size_t seed = 0;
+        hash_combine(seed, (const BSDF *) mesh->bsdf(), n, mesh->face_count(),
+                     g.flags, hash_bytes(g.faces, mesh->face_count() * 3 * sizeof(uint32_t)));
+        if (g.texcoords)
+            hash_combine(seed, hash_bytes(g.texcoords, n * 2 * sizeof(InputFloat)));
+        g.hash = seed;
+    }
+
     struct Key {
         const BSDF *bsdf;
         const Medium *interior_medium;
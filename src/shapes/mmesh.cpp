@@ -0,0 +1,549 @@
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/render/mmesh.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/mstream.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/trace.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/zstream.h>
+#include <nanothread/nanothread.h>
+#include <cstring>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-mmesh:
+
+Memory-mapped mesh loader (:monosp:`mmesh`)
+-------------------------------------------
+
+.. pluginparameters::
+ :extra-rows: 5
+
+ * - filename
+   - |string|
+   - Filename of the :monosp:`.mmesh` file that should be loaded
+
+ * - face_normals
+   - |bool|
+   - When set to |true|, any existing or computed vertex normals are
+     discarded and \emph{face normals} will instead be used during rendering.
+     This gives the rendered object a faceted appearance. (Default: |false|)
+
+ * - flip_normals
+   - |bool|
+   - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
+     the normals point outside)
+
+ * - alias_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample its triangles in constant time
+     using an alias table instead of a binary search over their areas. This
+     does not preserve the stratification of the input samples. (Default: |false|)
+
+ * - solid_angle_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample directions uniformly within the
+     spherical triangle of faces that subtend a solid angle larger than
+     :monosp:`solid_angle_threshold`, instead of sampling positions by area.
+     This reduces variance for large emitters close to the shading point.
+     (Default: |false|)
+
+ * - solid_angle_threshold
+   - |float|
+   - Solid angle (in steradians) above which spherical triangle sampling is
+     used. (Default: 0.001)
+
+ * - compact
+   - |bool|
+   - Store the mesh in compact form to reduce its memory footprint (scalar
+     variants only, see :ref:`compact mesh storage <mesh-compact>`).
+     (Default: |false|)
+
+ * - compact_position_bits
+   - |int|
+   - Number of bits per component of the quantized vertex positions of a
+     compact mesh. Must be 16 or 21. (Default: 21)
+
+ * - to_world
+   - |transform|
+   - Specifies an optional linear object-to-world transformation.
+     (Default: none, i.e. object space = world space)
+
+ * - vertex_count
+   - |int|
+   - Total number of vertices
+   - |exposed|
+
+ * - face_count
+   - |int|
+   - Total number of faces
+   - |exposed|
+
+ * - faces
+   - :paramtype:`uint32[]`
+   - Face indices buffer (flatten)
+   - |exposed|
+
+ * - vertex_positions
+   - :paramtype:`float[]`
+   - Vertex positions buffer (flatten) pre-multiplied by the object-to-world transformation.
+   - |exposed|, |differentiable|, |discontinuous|
+
+ * - vertex_normals
+   - :paramtype:`float[]`
+   - Vertex normals buffer (flatten)  pre-multiplied by the object-to-world transformation.
+   - |exposed|, |differentiable|, |discontinuous|
+
+ * - vertex_texcoords
+   - :paramtype:`float[]`
+   - Vertex texcoords buffer (flatten)
+   - |exposed|, |differentiable|
+
+ * - (Mesh attribute)
+   - :paramtype:`float[]`
+   - Mesh attribute buffer (flatten)
+   - |exposed|, |differentiable|
+
+This plugin loads meshes stored in Mitsuba's native binary mesh container,
+which is written by the ``Mesh.write_mmesh()`` function. The file is mapped
+into memory instead of being read: its buffers are aligned and stored in the
+same layout as Mitsuba's internal mesh representation, hence uncompressed
+buffers are used in place without any parsing or copying. Pages are only read
+from disk once they are accessed, and are shared between all processes that
+load the same file. Large scenes therefore start considerably faster than with
+the :ref:`ply <shape-ply>` or :ref:`serialized <shape-serialized>` plugins.
+
+The file additionally stores the bounding box of the mesh and the surface area
+of each face, which are used to skip the corresponding precomputation when
+the mesh is loaded without a :monosp:`to_world` transformation.
+
+Buffers are copied in the following cases:
+
+- on CUDA variants, where they must be uploaded to the GPU,
+- when the mesh has a :monosp:`to_world` transformation (positions and normals),
+- when the buffers were compressed by ``Mesh.write_mmesh(..., compress=True)``.
+  Compressed buffers consist of independently compressed zlib chunks, which are
+  decompressed in parallel.
+
+Mapped buffers are read-only and remain tied to the shape: they can be
+replaced through :py:func:`mitsuba.traverse`, but must not be modified in
+place. The file must not be modified while it is in use.
+
+Format description
+******************
+
+All fields are stored in little endian byte order. The file starts with a
+header of 128 bytes:
+
+.. figtable::
+    :label: table-mmesh-header
+
+    .. list-table::
+        :widths: 20 80
+        :header-rows: 1
+
+        * - Type
+          - Content
+        * - :monosp:`char[8]`
+          - File format identifier: :code:`MI_MESH\0`
+        * - :monosp:`uint32`
+          - File version identifier. Currently set to :code:`1`
+        * - :monosp:`uint32`
+          - An 32-bit integer whose bits can be used to specify the following flags:
+
+            - :code:`0x0001`: The mesh data includes per-vertex normals
+            - :code:`0x0002`: The mesh data includes texture coordinates
+            - :code:`0x0004`: The mesh used face normals when it was written
+            - :code:`0x0008`: Color attributes store spectral upsampling model
+              coefficients instead of RGB values
+        * - :monosp:`uint64`
+          - Number of vertices in the mesh
+        * - :monosp:`uint64`
+          - Number of triangles in the mesh
+        * - :monosp:`float32[6]`
+          - Bounding box of the mesh (minimum and maximum corner)
+        * - :monosp:`uint32`
+          - Number of sections (buffers) stored in the file
+        * - :monosp:`uint32`
+          - Reserved
+        * - :monosp:`char[64]`
+          - A null-terminated string (utf-8), which denotes the name of the shape.
+
+The header is followed by a table with one entry of 96 bytes per section:
+
+.. figtable::
+    :label: table-mmesh-section
+
+    .. list-table::
+        :widths: 20 80
+        :header-rows: 1
+
+        * - Type
+          - Content
+        * - :monosp:`char[48]`
+          - Null-terminated name of the buffer, e.g. :monosp:`vertex_positions`
+            or :monosp:`vertex_color` for a mesh attribute
+        * - :monosp:`uint32`
+          - Type of the buffer: vertex positions (0), normals (1), texture
+            coordinates (2), faces (3), face areas (4), vertex attribute (5)
+            or face attribute (6)
+        * - :monosp:`uint32`
+          - Number of values per vertex or face
+        * - :monosp:`uint32`
+          - Compression: none (0) or chunked zlib streams (1)
+        * - :monosp:`uint32`
+          - Uncompressed size of a chunk (compressed sections only)
+        * - :monosp:`uint64`
+          - Offset of the section from the start of the file, which is a
+            multiple of 64 bytes
+        * - :monosp:`uint64`
+          - Number of bytes occupied by the section
+        * - :monosp:`uint64`
+          - Number of bytes of the uncompressed buffer
+        * - :monosp:`uint64`
+          - Reserved
+
+Vertex data and face areas are stored as :monosp:`float32` values, and face
+indices as :monosp:`uint32` values. A compressed section starts with
+:math:`n+1` :monosp:`uint64` offsets (relative to the start of the section)
+that delimit its :math:`n` chunks.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: mmesh
+
+        <shape type="mmesh">
+            <string name="filename" value="shape.mmesh"/>
+            <bsdf type='diffuse'/>
+        </shape>
+
+    .. code-tab:: python
+
+        'type': 'mmesh',
+        'filename': 'shape.mmesh',
+        'material': {
+            'type': 'diffuse',
+        }
+ */
+
+template <typename Float, typename Spectrum>
+class MemoryMappedMesh final : public Mesh<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Mesh, m_name, m_bbox, m_to_world, m_vertex_count,
+                   m_face_count, m_vertex_positions, m_vertex_normals,
+                   m_vertex_texcoords, m_faces, m_face_normals,
+                   m_mesh_attributes, m_area_pmf, m_alias_sampling, m_emitter,
+                   m_sensor, add_attribute, recompute_vertex_normals,
+                   initialize)
+    MI_IMPORT_TYPES()
+
+    using typename Base::ScalarSize;
+    using typename Base::ScalarIndex;
+    using typename Base::InputFloat;
+    using typename Base::InputPoint3f;
+    using typename Base::InputNormal3f;
+    using typename Base::FloatStorage;
+    using typename Base::MeshAttributeType;
+
+    MemoryMappedMesh(const Properties &props) : Base(props) {
+        auto fs = file_resolver();
+        fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
+        m_name = file_path.filename().string();
+
+        Log(Debug, "Loading mesh from \"%s\" ..", m_name);
+        if (!fs::exists(file_path))
+            fail("file not found");
+        if (Struct::host_byte_order() == Struct::ByteOrder::BigEndian)
+            fail("big endian platforms are not supported");
+
+        ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        ScopedTraceEvent trace_event("File I/O", "Load geometry", file_path);
+        Timer timer;
+
+        m_mmap = new MemoryMappedFile(file_path);
+        const uint8_t *data = (const uint8_t *) m_mmap->data();
+        size_t file_size = m_mmap->size();
+
+        MeshFileHeader header;
+        if (file_size < sizeof(MeshFileHeader))
+            fail("file is truncated");
+        memcpy(&header, data, sizeof(MeshFileHeader));
+
+        if (memcmp(header.magic, MeshFileMagic, sizeof(MeshFileMagic)) != 0)
+            fail("encountered an invalid file format");
+        if (header.version != MeshFileVersion)
+            fail(tfm::format("encountered an incompatible file version (%u)",
+                             header.version));
+        if (header.vertex_count > 0xFFFFFFFFull || header.face_count > 0xFFFFFFFFull)
+            fail("the mesh has too many vertices or faces");
+        if (sizeof(MeshFileHeader) + header.section_count * sizeof(MeshFileSection) > file_size)
+            fail("file is truncated");
+
+        m_vertex_count = (ScalarSize) header.vertex_count;
+        m_face_count   = (ScalarSize) header.face_count;
+
+        const MeshFileSection *sections =
+            (const MeshFileSection *) (data + sizeof(MeshFileHeader));
+        const MeshFileSection *positions = nullptr, *normals = nullptr,
+                              *texcoords = nullptr, *faces = nullptr,
+                              *areas = nullptr;
+        std::vector<const MeshFileSection *> attributes;
+
+        for (uint32_t i = 0; i < header.section_count; ++i) {
+            const MeshFileSection &section = sections[i];
+            if (section.offset % MeshFileAlignment != 0 ||
+                section.offset + section.stored_size > file_size)
+                fail(tfm::format("section %u is out of bounds", i));
+
+            switch (section.type) {
+                case MeshFileSectionType::VertexPositions: positions = &section; break;
+                case MeshFileSectionType::VertexNormals:   normals = &section; break;
+                case MeshFileSectionType::VertexTexcoords: texcoords = &section; break;
+                case MeshFileSectionType::Faces:           faces = &section; break;
+                case MeshFileSectionType::FaceAreas:       areas = &section; break;
+                case MeshFileSectionType::VertexAttribute:
+                case MeshFileSectionType::FaceAttribute:
+                    attributes.push_back(&section);
+                    break;
+                default:
+                    Log(Warn, "\"%s\": skipping section of unknown type %u",
+                        m_name, (uint32_t) section.type);
+            }
+        }
+
+        if (!positions || !faces)
+            fail("vertex positions or faces are missing");
+
+        bool identity = dr::all_nested(m_to_world.scalar().matrix ==
+                                       ScalarTransform4f().matrix);
+        size_t mapped_bytes = 0, copied_bytes = 0;
+
+        /* Uncompressed sections are used in place, unless they must be
+           uploaded to the GPU or were modified while loading */
+        auto in_place = [&](const MeshFileSection &section, const void *ptr) {
+            bool result = !dr::is_cuda_v<Float> && ptr == data + section.offset;
+            (result ? mapped_bytes : copied_bytes) += section.size;
+            return result;
+        };
+
+        std::unique_ptr<uint8_t[]> temp;
+
+        // Vertex positions
+        {
+            const InputFloat *ptr = (const InputFloat *) decode(
+                *positions, m_vertex_count * 3 * sizeof(InputFloat), temp);
+
+            if (identity) {
+                m_bbox = ScalarBoundingBox3f(
+                    ScalarPoint3f(header.bbox_min[0], header.bbox_min[1], header.bbox_min[2]),
+                    ScalarPoint3f(header.bbox_max[0], header.bbox_max[1], header.bbox_max[2]));
+                m_vertex_positions = to_storage<FloatStorage>(
+                    ptr, m_vertex_count * 3, in_place(*positions, ptr));
+            } else {
+                std::unique_ptr<InputFloat[]> transformed(new InputFloat[m_vertex_count * 3]);
+                for (ScalarSize i = 0; i < m_vertex_count; ++i) {
+                    InputPoint3f p = m_to_world.scalar() * dr::load<InputPoint3f>(ptr + 3 * i);
+                    dr::store(transformed.get() + 3 * i, p);
+                    m_bbox.expand(p);
+                }
+                m_vertex_positions = to_storage<FloatStorage>(
+                    transformed.get(), m_vertex_count * 3,
+                    in_place(*positions, transformed.get()));
+            }
+        }
+
+        // Vertex normals
+        if (normals && !m_face_normals) {
+            const InputFloat *ptr = (const InputFloat *) decode(
+                *normals, m_vertex_count * 3 * sizeof(InputFloat), temp);
+
+            if (identity) {
+                m_vertex_normals = to_storage<FloatStorage>(
+                    ptr, m_vertex_count * 3, in_place(*normals, ptr));
+            } else {
+                std::unique_ptr<InputFloat[]> transformed(new InputFloat[m_vertex_count * 3]);
+                for (ScalarSize i = 0; i < m_vertex_count; ++i) {
+                    InputNormal3f n = dr::load<InputNormal3f>(ptr + 3 * i);
+                    dr::store(transformed.get() + 3 * i,
+                              dr::normalize(m_to_world.scalar() * n));
+                }
+                m_vertex_normals = to_storage<FloatStorage>(
+                    transformed.get(), m_vertex_count * 3,
+                    in_place(*normals, transformed.get()));
+            }
+        }
+
+        // Texture coordinates
+        if (texcoords) {
+            const void *ptr = decode(*texcoords, m_vertex_count * 2 * sizeof(InputFloat), temp);
+            m_vertex_texcoords = to_storage<FloatStorage>(
+                ptr, m_vertex_count * 2, in_place(*texcoords, ptr));
+        }
+
+        // Faces
+        {
+            const void *ptr = decode(*faces, m_face_count * 3 * sizeof(ScalarIndex), temp);
+            m_faces = to_storage<DynamicBuffer<UInt32>>(
+                ptr, m_face_count * 3, in_place(*faces, ptr));
+        }
+
+        // Mesh attributes
+        bool spectral_colors = has_flag(header.flags, MeshFileFlags::SpectralColors);
+        for (const MeshFileSection *section : attributes) {
+            std::string name(section->name,
+                             strnlen(section->name, sizeof(section->name)));
+            bool is_vertex_attr =
+                section->type == MeshFileSectionType::VertexAttribute;
+            size_t count = section->components *
+                           (size_t) (is_vertex_attr ? m_vertex_count : m_face_count);
+
+            const InputFloat *ptr = (const InputFloat *) decode(
+                *section, count * sizeof(InputFloat), temp);
+
+            bool is_color = section->components == 3 &&
+                            name.find("color") != std::string::npos;
+            if (is_color && spectral_colors != is_spectral_v<Spectrum>) {
+                if (spectral_colors)
+                    fail(tfm::format("attribute \"%s\" stores spectral "
+                                     "coefficients and can only be loaded "
+                                     "in spectral variants", name));
+
+                // Convert RGB colors to spectral model coefficients
+                add_attribute(name, section->components,
+                              std::vector<InputFloat>(ptr, ptr + count));
+                copied_bytes += section->size;
+                continue;
+            }
+
+            if (m_mesh_attributes.find(name) != m_mesh_attributes.end())
+                fail(tfm::format("attribute \"%s\" is stored twice", name));
+
+            m_mesh_attributes.insert(
+                { name,
+                  { section->components,
+                    is_vertex_attr ? MeshAttributeType::Vertex
+                                   : MeshAttributeType::Face,
+                    to_storage<FloatStorage>(ptr, count,
+                                             in_place(*section, ptr)) } });
+        }
+
+        /* Reuse the precomputed face areas to build the sampling table. They
+           are only valid when the mesh isn't transformed. */
+        if ((m_emitter || m_sensor) && identity && areas && m_face_count > 0) {
+            const InputFloat *ptr = (const InputFloat *) decode(
+                *areas, m_face_count * sizeof(InputFloat), temp);
+
+            if constexpr (std::is_same_v<ScalarFloat, InputFloat>) {
+                m_area_pmf = DiscreteDistribution<Float>(ptr, m_face_count);
+            } else {
+                std::vector<ScalarFloat> values(ptr, ptr + m_face_count);
+                m_area_pmf = DiscreteDistribution<Float>(values.data(), m_face_count);
+            }
+
+            if (m_alias_sampling)
+                m_area_pmf.set_alias_sampling(true);
+        }
+
+        Log(Debug, "\"%s\": read %i faces, %i vertices (%s mapped, %s copied, took %s)",
+            m_name, m_face_count, m_vertex_count,
+            util::mem_string(mapped_bytes), util::mem_string(copied_bytes),
+            util::time_string((float) timer.value()));
+
+        if (!m_face_normals && !normals) {
+            Timer timer2;
+            m_vertex_normals = dr::zeros<FloatStorage>(m_vertex_count * 3);
+            recompute_vertex_normals();
+            Log(Debug, "\"%s\": computed vertex normals (took %s)", m_name,
+                util::time_string((float) timer2.value()));
+        }
+
+        initialize();
+    }
+
+    MI_DECLARE_CLASS(MemoryMappedMesh)
+
+private:
+    [[noreturn]] void fail(const std::string &descr) const {
+        Throw("Error while loading mesh file \"%s\": %s!", m_name, descr);
+    }
+
+    /**
+     * \brief Return a pointer to the uncompressed contents of a section
+     *
+     * Uncompressed sections are returned in place. Compressed sections are
+     * decompressed chunk by chunk in parallel into \c temp.
+     */
+    const void *decode(const MeshFileSection &section, size_t size,
+                       std::unique_ptr<uint8_t[]> &temp) {
+        const uint8_t *ptr = (const uint8_t *) m_mmap->data() + section.offset;
+
+        if (section.size != size)
+            fail(tfm::format("section \"%s\" has an unexpected size "
+                             "(%zu bytes, expected %zu)",
+                             std::string(section.name,
+                                         strnlen(section.name, sizeof(section.name))),
+                             (size_t) section.size, size));
+
+        if (section.compression == MeshFileCompression::None) {
+            if (section.stored_size < size)
+                fail("file is truncated");
+            return ptr;
+        } else if (section.compression != MeshFileCompression::Deflate) {
+            fail(tfm::format("unsupported compression method %u",
+                             (uint32_t) section.compression));
+        }
+
+        if (section.chunk_size == 0)
+            fail("invalid chunk size");
+
+        size_t chunk_count = (size + section.chunk_size - 1) / section.chunk_size;
+        const uint64_t *offsets = (const uint64_t *) ptr;
+        if ((chunk_count + 1) * sizeof(uint64_t) > section.stored_size ||
+            offsets[chunk_count] > section.stored_size)
+            fail("file is truncated");
+
+        temp.reset(new uint8_t[size]);
+        uint8_t *target = temp.get();
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, chunk_count, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    if (offsets[i] > offsets[i + 1])
+                        fail("encountered an invalid chunk table");
+
+                    size_t start = i * (size_t) section.chunk_size;
+                    ref<MemoryStream> ms = new MemoryStream(
+                        (void *) (ptr + offsets[i]), offsets[i + 1] - offsets[i]);
+                    ref<ZStream> zs = new ZStream(ms);
+                    zs->read(target + start,
+                             std::min((size_t) section.chunk_size, size - start));
+                }
+            }
+        );
+
+        return target;
+    }
+
+    /// Wrap \c count values into a buffer, without copying them if \c in_place is set
+    template <typename Storage>
+    Storage to_storage(const void *ptr, size_t count, bool in_place) {
+        if constexpr (!dr::is_cuda_v<Float>) {
+            if (in_place)
+                return dr::map<Storage>((void *) ptr, count, false);
+        }
+        return dr::load<Storage>(ptr, count);
+    }
+
+private:
+    /// Memory mapping referenced by the buffers of this mesh
+    ref<MemoryMappedFile> m_mmap;
+};
+
+MI_EXPORT_PLUGIN(MemoryMappedMesh)
+NAMESPACE_END(mitsuba)
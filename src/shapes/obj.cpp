@@ -3,8 +3,11 @@
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/mmap.h>
+#include <mitsuba/core/mstream.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/core/profiler.h>
 
 #include <array>
@@ -41,6 +44,36 @@ Wavefront OBJ mesh loader (:monosp:`obj`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - alias_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample its triangles in constant time
+     using an alias table instead of a binary search over their areas. This
+     does not preserve the stratification of the input samples. (Default: |false|)
+
+ * - solid_angle_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample directions uniformly within the
+     spherical triangle of faces that subtend a solid angle larger than
+     :monosp:`solid_angle_threshold`, instead of sampling positions by area.
+     This reduces variance for large emitters close to the shading point.
+     (Default: |false|)
+
+ * - solid_angle_threshold
+   - |float|
+   - Solid angle (in steradians) above which spherical triangle sampling is
+     used. (Default: 0.001)
+
+ * - compact
+   - |bool|
+   - Store the mesh in compact form to reduce its memory footprint (scalar
+     variants only, see :ref:`compact mesh storage <mesh-compact>`).
+     (Default: |false|)
+
+ * - compact_position_bits
+   - |int|
+   - Number of bits per component of the quantized vertex positions of a
+     compact mesh. Must be 16 or 21. (Default: 21)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -165,6 +198,7 @@ public:
             fail("file not found");
 
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        ScopedTraceEvent trace_event("File I/O", "Load geometry", file_path);
 
         using ScalarIndex3 = std::array<ScalarIndex, 3>;
 
@@ -181,19 +215,34 @@ public:
         std::vector<ScalarIndex3> triangles;
         std::vector<VertexBinding> vertex_map;
 
- #if !defined(_WIN32)
-        ref<MemoryMappedFile> mmap = new MemoryMappedFile(file_path);
-        size_t file_size           = mmap->size();
-        const char *ptr            = (const char *) mmap->data();
+        // Use the file contents if the scene loader already read them
+        ref<MemoryStream> prefetched = FilePrefetcher::fetch(file_path);
+        size_t file_size;
+        const char *ptr;
+#if !defined(_WIN32)
+        ref<MemoryMappedFile> mmap;
 #else
-        // Memory-mapped IO performs surprisingly poorly on Windows
-        ref<FileStream> fs = new FileStream(file_path);
-        size_t file_size = fs->size();
-        std::unique_ptr<char[]> tmp(new char[file_size]);
-        fs->read(tmp.get(), file_size);
-        const char *ptr = tmp.get();
+        std::unique_ptr<char[]> tmp;
 #endif
 
+        if (prefetched) {
+            file_size = prefetched->size();
+            ptr       = (const char *) prefetched->raw_buffer();
+        } else {
+#if !defined(_WIN32)
+            mmap      = new MemoryMappedFile(file_path);
+            file_size = mmap->size();
+            ptr       = (const char *) mmap->data();
+#else
+            // Memory-mapped IO performs surprisingly poorly on Windows
+            ref<FileStream> fs = new FileStream(file_path);
+            file_size = fs->size();
+            tmp.reset(new char[file_size]);
+            fs->read(tmp.get(), file_size);
+            ptr = tmp.get();
+#endif
+        }
+
         size_t vertex_guess = file_size / 100;
         const char *eof     = ptr + file_size;
         char buf[1025];
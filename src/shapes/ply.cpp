@@ -1,10 +1,12 @@
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/mstream.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/core/profiler.h>
 #include <drjit-core/half.h>
 #include <unordered_map>
@@ -44,6 +46,36 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - alias_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample its triangles in constant time
+     using an alias table instead of a binary search over their areas. This
+     does not preserve the stratification of the input samples. (Default: |false|)
+
+ * - solid_angle_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample directions uniformly within the
+     spherical triangle of faces that subtend a solid angle larger than
+     :monosp:`solid_angle_threshold`, instead of sampling positions by area.
+     This reduces variance for large emitters close to the shading point.
+     (Default: |false|)
+
+ * - solid_angle_threshold
+   - |float|
+   - Solid angle (in steradians) above which spherical triangle sampling is
+     used. (Default: 0.001)
+
+ * - compact
+   - |bool|
+   - Store the mesh in compact form to reduce its memory footprint (scalar
+     variants only, see :ref:`compact mesh storage <mesh-compact>`).
+     (Default: |false|)
+
+ * - compact_position_bits
+   - |int|
+   - Number of bits per component of the quantized vertex positions of a
+     compact mesh. Must be 16 or 21. (Default: 21)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -126,6 +158,58 @@ multidimensional attribute named ``{vertex|face}_color``.
 
     Values stored in a RBG color attribute will automatically be converted into spectral model
     coefficients when using a spectral variant of the renderer.
+
+.. _mesh-compact:
+
+**Compact storage**: the :monosp:`compact` parameter, which is supported by
+all mesh plugins, trades precision for memory in scalar variants. Vertex
+normals are then stored using an octahedral mapping with 2 x 16 bits (angular
+error below 0.01 degrees) and texture coordinates in half precision (a
+resolution of 1/2048 in the range [0.5, 1)). When the scene is intersected
+using the built-in kd-tree (i.e. Mitsuba was compiled without Embree), vertex
+positions are furthermore quantized relative to the bounding box of the mesh,
+with a maximum error of 2\ :sup:`-22` (21 bits) or 2\ :sup:`-17` (16 bits) times
+its extent along each axis, and meshes with less than 65536 vertices use
+16-bit indices. The memory used by the buffers of a mesh with vertex normals
+and texture coordinates is as follows:
+
+.. list-table::
+   :header-rows: 1
+
+   * - Storage
+     - Bytes per vertex
+     - Bytes per face
+   * - Default
+     - 32
+     - 12
+   * - Compact, Embree
+     - 20
+     - 12
+   * - Compact, kd-tree, 21 bits
+     - 16
+     - 12 (6 with < 65536 vertices)
+   * - Compact, kd-tree, 16 bits
+     - 14
+     - 12 (6 with < 65536 vertices)
+
+Since a closed triangle mesh has about twice as many faces as vertices, this
+reduces its size by about 21% with Embree, 29-32% with the kd-tree, and
+50-54% when 16-bit indices are used as well. In exchange, every access to the
+mesh data needs a few additional integer and floating point operations to
+decode it, which mostly affects the cost of ray intersections with the
+kd-tree. Compact meshes can't be modified through :monosp:`traverse()`, and
+the accessors of the single precision buffers (e.g.
+:monosp:`vertex_positions_buffer()`) return empty buffers for compact data.
+They are also never merged with other meshes when the scene is loaded, since
+that would quantize their positions relative to a larger bounding box.
+
+The table lists the size of the mesh buffers. The memory that is actually
+used by each mesh is part of the memory report that the :monosp:`mitsuba`
+executable logs once the scene is loaded (see :monosp:`mi.MemoryUsage.report()`). The cost of ray
+intersections depends on the scene and the CPU, and is best measured on the
+target machine: :monosp:`mitsuba-bench -f scene/ray_intersect` (built with
+:monosp:`-DMI_ENABLE_BENCHMARKS=ON`) intersects random rays with a sphere of
+262144 triangles that is stored with and without compact storage.
  */
 
 template <typename Float, typename Spectrum>
@@ -168,8 +252,9 @@ public:
         if (!fs::exists(file_path))
             fail("file not found");
 
-        ref<Stream> stream = new FileStream(file_path);
+        ref<Stream> stream = FilePrefetcher::open(file_path);
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        ScopedTraceEvent trace_event("File I/O", "Load geometry", file_path);
         Timer timer;
 
         PLYHeader header;
@@ -181,7 +266,13 @@ public:
                         "\"%s\": performance warning -- this file uses the ASCII PLY format, which "
                         "is slow to parse. Consider converting it to the binary PLY format.",
                         m_name);
-                stream = parse_ascii((FileStream *) stream.get(), header.elements, m_name);
+                // The ASCII parser operates on the underlying std::fstream
+                ref<FileStream> fstream = dynamic_cast<FileStream *>(stream.get());
+                if (!fstream) {
+                    fstream = new FileStream(file_path);
+                    fstream->seek(stream->tell());
+                }
+                stream = parse_ascii(fstream, header.elements, m_name);
             }
         } catch (const std::exception &e) {
             fail(e.what());
@@ -1,9 +1,11 @@
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/core/zstream.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/timer.h>
+#include <mitsuba/core/trace.h>
 #include <mitsuba/core/profiler.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -38,6 +40,36 @@ Serialized mesh loader (:monosp:`serialized`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - alias_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample its triangles in constant time
+     using an alias table instead of a binary search over their areas. This
+     does not preserve the stratification of the input samples. (Default: |false|)
+
+ * - solid_angle_sampling
+   - |bool|
+   - When the mesh is an area emitter, sample directions uniformly within the
+     spherical triangle of faces that subtend a solid angle larger than
+     :monosp:`solid_angle_threshold`, instead of sampling positions by area.
+     This reduces variance for large emitters close to the shading point.
+     (Default: |false|)
+
+ * - solid_angle_threshold
+   - |float|
+   - Solid angle (in steradians) above which spherical triangle sampling is
+     used. (Default: 0.001)
+
+ * - compact
+   - |bool|
+   - Store the mesh in compact form to reduce its memory footprint (scalar
+     variants only, see :ref:`compact mesh storage <mesh-compact>`).
+     (Default: |false|)
+
+ * - compact_position_bits
+   - |int|
+   - Number of bits per component of the quantized vertex positions of a
+     compact mesh. Must be 16 or 21. (Default: 21)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -254,8 +286,9 @@ public:
 
         m_name = tfm::format("%s@%i", file_path.filename(), shape_index);
 
-        ref<Stream> stream = new FileStream(file_path);
+        ref<Stream> stream = FilePrefetcher::open(file_path);
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        ScopedTraceEvent trace_event("File I/O", "Load geometry", file_path);
         Timer timer;
         stream->set_byte_order(Stream::ELittleEndian);
 
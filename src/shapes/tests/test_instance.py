@@ -216,3 +216,43 @@ def test03_ray_intersect_instance(variants_all_rgb, width):
         assert 'instance=0x0' in str(pi)
     else:
         assert ('instance=[' + '0x0, ' * (width - 1) + '0x0]') in str(pi)
+
+
+def test04_instance_update_to_world(variant_scalar_rgb):
+    """Check that the cached world-to-object transform and bounding box
+    follow updates of the instance's ``to_world`` parameter"""
+
+    from mitsuba import ScalarTransform4f as T
+
+    scene = mi.load_dict({
+        'type' : 'scene',
+        'group_0' : {
+            'type' : 'shapegroup',
+            'sphere_0' : { 'type' : 'sphere', 'center' : [-2, 0, 0] },
+            'sphere_1' : { 'type' : 'sphere', 'center' : [ 2, 0, 0] }
+        },
+        'instance' : {
+            'type' : 'instance',
+            "group" : {
+                "type" : "ref",
+                "id" : "group_0"
+            }
+        }
+    })
+
+    ray = mi.Ray3f(o=[2, 0, -8], d=[0, 0, 1], time=0.0, wavelengths=[])
+    assert scene.ray_test(ray)
+    assert dr.allclose(scene.ray_intersect(ray).t, 7)
+
+    params = mi.traverse(scene)
+    params['instance.to_world'] = T().translate([0, 3, 0])
+    params.update()
+
+    assert not scene.ray_test(ray)
+    ray.o += [0, 3, 0]
+    assert scene.ray_test(ray)
+    assert dr.allclose(scene.ray_intersect(ray).t, 7)
+
+    bbox = scene.bbox()
+    assert dr.allclose(bbox.min, [-3, 2, -1])
+    assert dr.allclose(bbox.max, [3, 4, 1])
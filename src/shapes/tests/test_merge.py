@@ -103,3 +103,20 @@ def test02_two_shapes(variants_all_rgb):
     })
     assert len(m.shapes()) == 2
     assert set([m.shapes()[0].id(), m.shapes()[1].id()]) == {"parent", "child2"}
+
+
+@fresolver_append_path
+def test03_compact_meshes(variant_scalar_rgb):
+    # Compact meshes are quantized w.r.t. their own bounding box --> don't merge
+    m = mi.load_dict({
+        "type": "scene",
+        "bsdf1": { "type": "diffuse" },
+        "parent": {
+            "type": "merge",
+            "child1": example_mesh(bsdf={ "type": "ref", "id": "bsdf1" }, compact=True),
+            "child2": example_mesh(bsdf={ "type": "ref", "id": "bsdf1" }, compact=True),
+            "child3": example_mesh(bsdf={ "type": "ref", "id": "bsdf1" }),
+        }
+    })
+    assert len(m.shapes()) == 3
+    assert sum(1 for s in m.shapes() if s.compact()) == 2
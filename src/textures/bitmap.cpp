@@ -1,6 +1,9 @@
+#include <mitsuba/core/asset.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/prefetch.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/distr_2d.h>
@@ -111,6 +114,12 @@ These conversions can alternatively be disabled with the :paramtype:`raw` flag,
 e.g. when textured data is already in linear space or does not represent colors
 at all.
 
+The converted data is shared between all bitmap textures that load the same
+file with identical :paramtype:`raw` and :paramtype:`format` settings (see
+:monosp:`AssetRegistry`). In JIT variants, such textures then reference a
+single copy of the data, which is duplicated on demand if one of them is
+modified (e.g., during an optimization).
+
 .. tabs::
     .. code-tab:: xml
         :name: bitmap-texture
@@ -137,6 +146,24 @@ class BitmapTexture final : public Texture<Float, Spectrum> {
 public:
     MI_IMPORT_TYPES(Texture)
 
+    using TensorXh = dr::replace_scalar_t<TensorXf, dr::half>;
+
+    enum class Format {
+        Auto,
+        Variant,
+        Float16
+    };
+
+    /// Converted contents of an image file (see \ref AssetRegistry)
+    struct Asset {
+        /// Stored data, depending on \c half
+        TensorXf tensor;
+        TensorXh tensor_half;
+        bool half = false;
+        /// Accounts for the data once, however many textures share it
+        MemoryTracker memory { MemoryCategory::Textures };
+    };
+
     /* Recap of numerical precision of lookup operations
      *
      * backend | variant | format   | accel  | behavior
@@ -237,8 +264,33 @@ public:
                 FileResolver* fs = file_resolver();
                 fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
                 m_name = file_path.filename().string();
-                Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
-                m_bitmap = new Bitmap(file_path);
+
+                // Textures loading the same file with the same settings share their data
+                std::string key = tfm::format("bitmap:%s:%s:raw=%i:format=%i",
+                                              Texture::Variant, AssetRegistry::file_key(file_path),
+                                              (int) m_raw, (int) m_format);
+                m_asset = AssetRegistry::get<Asset>(key, [&]() {
+                    Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
+                    m_bitmap = FilePrefetcher::load_bitmap(file_path);
+
+                    auto asset = std::make_shared<Asset>();
+                    size_t size;
+                    if (resolve_format() == Format::Float16) {
+                        asset->tensor_half = convert_bitmap<dr::replace_scalar_t<Float, dr::half>>();
+                        asset->half = true;
+                        size = asset->tensor_half.array().size() * sizeof(dr::half);
+                    } else {
+                        asset->tensor = convert_bitmap<Float>();
+                        size = asset->tensor.array().size() * sizeof(ScalarFloat);
+                    }
+                    m_bitmap = nullptr;
+
+                    // Only JIT variants share the storage (see BitmapTextureImpl)
+                    if constexpr (dr::is_jit_v<Float>)
+                        asset->memory.set(size, m_name);
+
+                    return std::make_pair(asset, size);
+                });
             } else if (props.has_property("data")) {
                 m_tensor = std::move(const_cast<TensorXf&>(props.get_any<TensorXf>("data")));
                 if (m_tensor.ndim() != 3)
@@ -261,26 +313,26 @@ public:
 
 protected:
     Object* expand_1() const {
-        if (m_bitmap) {
-            Format format = m_format;
-            // Format auto means we store texture as FP16 when possible.
-            // Skip this conversion for spectral variants as we want to perform
-            // spectral upsampling in the variant's native FP representation
-            if constexpr (!is_spectral_v<Spectrum>) {
-                size_t bytes_p_ch = m_bitmap->bytes_per_pixel()
-                    / m_bitmap->channel_count();
-                if (m_format == Format::Auto && bytes_p_ch <= 2)
-                    format = Format::Float16;
-            }
+        Properties props;
+        if (m_asset) {
+            if (m_asset->half)
+                return new BitmapTextureImpl<Float, Spectrum, dr::replace_scalar_t<Float, dr::half>>(
+                    props, m_name, m_transform, m_filter_mode, m_wrap_mode,
+                    m_raw, m_accel, TensorXh(m_asset->tensor_half), m_asset);
+            else
+                return new BitmapTextureImpl<Float, Spectrum, Float>(
+                    props, m_name, m_transform, m_filter_mode, m_wrap_mode,
+                    m_raw, m_accel, TensorXf(m_asset->tensor), m_asset);
+        }
 
-            if (format == Format::Float16)
+        if (m_bitmap) {
+            if (resolve_format() == Format::Float16)
                 return expand_bitmap<dr::replace_scalar_t<Float, dr::half>>();
             else
                 return expand_bitmap<Float>();
         }
 
         // Otherwise, initializing using tensor
-        Properties props;
         return new BitmapTextureImpl<Float, Spectrum, Float>(
             props,
             m_name,
@@ -292,7 +344,36 @@ protected:
             std::move(m_tensor));
     }
 
+    /// Storage format of \c m_bitmap after resolving \c Format::Auto
+    Format resolve_format() const {
+        // Format auto means we store texture as FP16 when possible.
+        // Skip this conversion for spectral variants as we want to perform
+        // spectral upsampling in the variant's native FP representation
+        if constexpr (!is_spectral_v<Spectrum>) {
+            size_t bytes_p_ch = m_bitmap->bytes_per_pixel()
+                / m_bitmap->channel_count();
+            if (m_format == Format::Auto && bytes_p_ch <= 2)
+                return Format::Float16;
+        }
+        return m_format;
+    }
+
     template <typename StoredType> Object* expand_bitmap() const {
+        Properties props;
+        return new BitmapTextureImpl<Float, Spectrum, StoredType>(
+            props,
+            m_name,
+            m_transform,
+            m_filter_mode,
+            m_wrap_mode,
+            m_raw,
+            m_accel,
+            convert_bitmap<StoredType>());
+    }
+
+    /// Convert \c m_bitmap into a tensor in the given storage format
+    template <typename StoredType>
+    dr::replace_scalar_t<TensorXf, dr::scalar_t<StoredType>> convert_bitmap() const {
         using StoredScalar           = dr::scalar_t<StoredType>;
         using StoredTensorXf         = dr::replace_scalar_t<TensorXf, StoredScalar>;
 
@@ -344,18 +425,7 @@ protected:
         size_t channels = m_bitmap->channel_count();
         ScalarVector2i res = ScalarVector2i(m_bitmap->size());
         size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), channels };
-        StoredTensorXf tensor = StoredTensorXf(m_bitmap->data(), 3, shape);
-
-        Properties props;
-        return new BitmapTextureImpl<Float, Spectrum, StoredType>(
-            props,
-            m_name,
-            m_transform,
-            m_filter_mode,
-            m_wrap_mode,
-            m_raw,
-            m_accel,
-            std::move(tensor));
+        return StoredTensorXf(m_bitmap->data(), 3, shape);
     }
 
 private:
@@ -374,11 +444,7 @@ private:
         }
     }
 
-    enum class Format {
-        Auto,
-        Variant,
-        Float16
-    } m_format;
+    Format m_format;
 
     bool m_accel;
     bool m_raw;
@@ -388,6 +454,7 @@ private:
     dr::WrapMode m_wrap_mode;
     mutable ref<Bitmap> m_bitmap;
     TensorXf m_tensor;
+    std::shared_ptr<const Asset> m_asset;
 
     MI_TRAVERSE_CB(Texture, m_bitmap, m_tensor)
 };
@@ -410,13 +477,21 @@ public:
                       dr::WrapMode wrap_mode,
                       bool raw,
                       bool accel,
-                      Tensor&& tensor) :
+                      Tensor&& tensor,
+                      std::shared_ptr<const void> asset = nullptr) :
         Texture(props),
         m_name(name),
         m_transform(transform),
         m_accel(accel),
         m_raw(raw) {
 
+        /* Keep shared data alive (and thereby available to other textures)
+           when the texture references it instead of storing a private copy */
+        if constexpr (dr::is_jit_v<Float>) {
+            if (!(dr::is_cuda_v<Float> && accel))
+                m_asset = std::move(asset);
+        }
+
         /* Compute mean without migrating texture data
            i.e. Avoid call to m_texture.tensor() that triggers migration.
            For CUDA-variants, ideally want to solely keep data as CUDA texture
@@ -425,6 +500,7 @@ public:
 
         m_texture = StoredTexture2f(std::forward<Tensor>(tensor), accel, accel,
                                     filter_mode, wrap_mode);
+        update_memory_usage();
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -445,8 +521,11 @@ public:
                       " it must be at least 2x2 pixels in size!",
                       to_string());
 
+            // The data may have been replaced, stop attributing it to the asset
+            m_asset.reset();
             m_texture.update_inplace();
             rebuild_internals(m_texture.tensor(), true, m_distr2d != nullptr);
+            update_memory_usage();
         }
     }
 
@@ -728,6 +807,16 @@ public:
     MI_DECLARE_CLASS(BitmapTextureImpl)
 
 protected:
+    /**
+     * Report the size of the texture data (computed from the shape to avoid
+     * migrating it). Shared data is accounted for by the asset instead.
+     */
+    void update_memory_usage() {
+        const size_t *shape = m_texture.shape();
+        m_memory.set(m_asset ? 0 : shape[0] * shape[1] * shape[2] * sizeof(StoredScalar),
+                     m_name);
+    }
+
     /**
      * \brief Evaluates the texture at the given surface interaction using
      * spectral upsampling
@@ -932,6 +1021,11 @@ protected:
     mutable std::mutex m_mutex;
     std::unique_ptr<DiscreteDistribution2D<Float>> m_distr2d;
 
+    /// Data shared with other textures (see \ref AssetRegistry)
+    std::shared_ptr<const void> m_asset;
+
+    MemoryTracker m_memory { MemoryCategory::Textures };
+
     MI_TRAVERSE_CB(Texture, m_mean, m_texture, m_distr2d)
 };
 
@@ -1,3 +1,5 @@
+import os
+
 import pytest
 import drjit as dr
 import mitsuba as mi
@@ -279,3 +281,68 @@ def test08_to_uv(variant_scalar_rgb):
 
     params = mi.traverse(bitmap)
     assert params["to_uv"] == transform
+
+
+@fresolver_append_path
+def test09_shared_data(variants_vec_backends_once_rgb):
+    # Textures loading the same file with the same settings share their data
+    def load(**kwargs):
+        return mi.load_dict({
+            "type" : "bitmap",
+            "filename" : "resources/data/common/textures/carrot.png",
+            "accel" : False,
+            **kwargs
+        })
+
+    bitmap_1 = load()
+    hits = mi.AssetRegistry.hit_count()
+    saved = mi.AssetRegistry.deduplicated_bytes()
+
+    bitmap_2 = load(filter_type="nearest")
+    assert mi.AssetRegistry.hit_count() == hits + 1
+    assert mi.AssetRegistry.deduplicated_bytes() > saved
+
+    # Different conversion settings produce separate data
+    bitmap_3 = load(raw=True)
+    assert mi.AssetRegistry.hit_count() == hits + 1
+
+    params_1, params_2 = mi.traverse(bitmap_1), mi.traverse(bitmap_2)
+    assert dr.all(params_1["data"] == params_2["data"], axis=None)
+
+    # Modifying one texture leaves the others untouched
+    data = mi.TensorXf(params_1["data"])
+    params_1["data"] = params_1["data"] * 0.5
+    params_1.update()
+    assert dr.all(mi.traverse(bitmap_2)["data"] == data, axis=None)
+
+    # Disabled registry: every texture loads its own copy
+    mi.AssetRegistry.set_enabled(False)
+    try:
+        load()
+        assert mi.AssetRegistry.hit_count() == hits + 1
+    finally:
+        mi.AssetRegistry.set_enabled(True)
+
+
+def test10_shared_data_file_changed(variants_vec_backends_once_rgb, tmp_path):
+    # Overwriting a file must not hand out the data of its previous version
+    filename = str(tmp_path / 'texture.exr')
+
+    def load(value, mtime):
+        mi.Bitmap(dr.full(mi.TensorXf, value, shape=[4, 4, 3])).write(filename)
+        # Don't depend on the timestamp resolution of the file system
+        os.utime(filename, (mtime, mtime))
+        return mi.load_dict({
+            "type" : "bitmap",
+            "filename" : filename,
+            "raw" : True,
+            "accel" : False
+        })
+
+    bitmap_1 = load(1.0, 1000000000)
+    key = mi.AssetRegistry.file_key(filename)
+    bitmap_2 = load(2.0, 1000000001)
+    assert mi.AssetRegistry.file_key(filename) != key
+
+    assert dr.all(mi.traverse(bitmap_1)["data"] == 1.0, axis=None)
+    assert dr.all(mi.traverse(bitmap_2)["data"] == 2.0, axis=None)
@@ -1,4 +1,6 @@
+#include <mitsuba/core/asset.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/memory.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
@@ -161,6 +163,18 @@ public:
     MI_IMPORT_BASE(Volume, update_bbox, m_to_local, m_bbox, m_channel_count)
     MI_IMPORT_TYPES(VolumeGrid)
 
+    /// Converted contents of a volume grid (see \ref AssetRegistry)
+    struct Asset {
+        TensorXf data;
+        ScalarFloat max = 0.f;
+        std::vector<ScalarFloat> max_per_channel;
+        /// Number of channels (or zero when spectral upsampling was applied)
+        uint32_t channel_count = 0;
+        ScalarAffineTransform4f bbox_transform;
+        /// Accounts for the data once, however many volumes share it
+        MemoryTracker memory { MemoryCategory::Volumes };
+    };
+
     GridVolume(const Properties &props) : Base(props) {
         std::string_view filter_type_str = props.get<std::string_view>("filter_type", "trilinear");
         dr::FilterMode filter_mode;
@@ -189,121 +203,95 @@ public:
         m_accel = props.get<bool>("accel", true);
 
         // Load volume data
-        ref<VolumeGrid> volume_grid = nullptr;
-        TensorXf* tensor = nullptr;
-        {
-            ScalarVector3u res;
-            ScalarUInt32 channel_count = 0;
-
-            if (props.has_property("grid")) {
-                // Creates a Bitmap texture directly from an existing Bitmap object
-                if (props.has_property("filename"))
-                    Throw("Cannot specify both \"grid\" and \"filename\".");
-                Log(Debug, "Loading volume grid from memory...");
-                // Note: ref-counted, so we don't have to worry about lifetime
-                ref<Object> other = props.get<ref<Object>>("grid");
-                volume_grid = dynamic_cast<VolumeGrid *>(other.get());
-                if (!volume_grid)
-                    Throw("Property \"grid\" must be a VolumeGrid instance.");
-                res = volume_grid->size();
-                channel_count = (uint32_t) volume_grid->channel_count();
-            } else if(props.has_property("data")) {
-                tensor = const_cast<TensorXf*>(&props.get_any<TensorXf>("data"));
-                if (tensor->ndim() != 3 && tensor->ndim() != 4)
-                    Throw("Tensor->has %ul dimensions. Expected 3 or 4", tensor->ndim());
-                res = { (uint32_t) tensor->shape(2), (uint32_t) tensor->shape(1), (uint32_t) tensor->shape(0) };
-                channel_count = tensor->ndim() == 4 ? (uint32_t) tensor->shape(3) : 1;
-
-                if (channel_count != 1 && channel_count != 3 && channel_count != 6)
-                    Throw("Tensor shape at index 3 is %lu invalid. Only volumes with 1, 3 or 6 "
-                          "channels are supported!", to_string(), channel_count);
-            } else {
-                FileResolver *fs = file_resolver();
-                fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
-                if (!fs::exists(file_path))
-                    Log(Error, "\"%s\": file does not exist!", file_path);
-                volume_grid = new VolumeGrid(file_path);
-                res = volume_grid->size();
-                channel_count = (uint32_t) volume_grid->channel_count();
-            }
+        std::shared_ptr<const Asset> asset;
+        if (props.has_property("grid")) {
+            // Creates a Bitmap texture directly from an existing Bitmap object
+            if (props.has_property("filename"))
+                Throw("Cannot specify both \"grid\" and \"filename\".");
+            Log(Debug, "Loading volume grid from memory...");
+            // Note: ref-counted, so we don't have to worry about lifetime
+            ref<Object> other = props.get<ref<Object>>("grid");
+            VolumeGrid *volume_grid = dynamic_cast<VolumeGrid *>(other.get());
+            if (!volume_grid)
+                Throw("Property \"grid\" must be a VolumeGrid instance.");
+            asset = convert(volume_grid);
+        } else if (props.has_property("data")) {
+            TensorXf *tensor = const_cast<TensorXf*>(&props.get_any<TensorXf>("data"));
+            if (tensor->ndim() != 3 && tensor->ndim() != 4)
+                Throw("Tensor->has %ul dimensions. Expected 3 or 4", tensor->ndim());
+            ScalarVector3u res = { (uint32_t) tensor->shape(2), (uint32_t) tensor->shape(1), (uint32_t) tensor->shape(0) };
+            ScalarUInt32 channel_count = tensor->ndim() == 4 ? (uint32_t) tensor->shape(3) : 1;
+
+            if (channel_count != 1 && channel_count != 3 && channel_count != 6)
+                Throw("Tensor shape at index 3 is %lu invalid. Only volumes with 1, 3 or 6 "
+                      "channels are supported!", to_string(), channel_count);
+
+            if (is_spectral_v<Spectrum> && channel_count == 3 && !m_raw)
+                Throw("Spectral conversion of tensor input is not supported "
+                      "and requires a volume grid");
+
+            if (props.get<bool>("use_grid_bbox", false))
+                Throw("use_grid_bbox is unsupported with tensor input and requires a volume grid");
 
-            ScalarUInt32 size = dr::prod(res);
-
-            // Apply spectral conversion if necessary
-            if (is_spectral_v<Spectrum> && channel_count == 3 &&
-                !m_raw) {
-                if (tensor)
-                    Throw("Spectral conversion of tensor input is not supported "
-                          "and requires a volume grid");
-
-                ScalarFloat *ptr = volume_grid->data();
-
-                auto scaled_data =
-                    std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * 4]);
-                ScalarFloat *scaled_data_ptr = scaled_data.get();
-                ScalarFloat max = 0.0;
-                for (ScalarUInt32 i = 0; i < size; ++i) {
-                    ScalarColor3f rgb = dr::load<ScalarColor3f>(ptr);
-                    // TODO: Make this scaling optional if the RGB values are
-                    // between 0 and 1
-                    ScalarFloat scale = dr::max(rgb) * 2.f;
-                    ScalarColor3f rgb_norm =
-                        rgb / dr::maximum((ScalarFloat) 1e-8, scale);
-                    ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
-                    max = dr::maximum(max, scale);
-                    dr::store(scaled_data_ptr,
-                              dr::concat(coeff, dr::Array<ScalarFloat, 1>(scale)));
-                    ptr += 3;
-                    scaled_data_ptr += 4;
-                }
-                m_max = (float) max;
-
-                size_t shape[4] = {
-                    (size_t) res.z(),
-                    (size_t) res.y(),
-                    (size_t) res.x(),
-                    4
-                };
-                m_texture = Texture3f(TensorXf(scaled_data.get(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
-            } else if (volume_grid) {
-                size_t shape[4] = {
-                    (size_t) res.z(),
-                    (size_t) res.y(),
-                    (size_t) res.x(),
-                    channel_count
-                };
-                m_texture = Texture3f(TensorXf(volume_grid->data(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
-                m_max = volume_grid->max();
-                m_max_per_channel.resize(volume_grid->channel_count());
-                volume_grid->max_per_channel(m_max_per_channel.data());
-                m_channel_count = channel_count;
-            } else if (tensor) {
-                size_t shape[4] = {
-                    (size_t) res.z(),
-                    (size_t) res.y(),
-                    (size_t) res.x(),
-                    channel_count
-                };
-                m_texture = Texture3f(TensorXf(tensor->array(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
-                m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
-                m_channel_count = channel_count;
-            }
+            size_t shape[4] = {
+                (size_t) res.z(),
+                (size_t) res.y(),
+                (size_t) res.x(),
+                channel_count
+            };
+            m_texture = Texture3f(TensorXf(tensor->array(), 4, shape),
+                                  m_accel, m_accel, filter_mode, wrap_mode);
+            m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+            m_channel_count = channel_count;
+        } else {
+            FileResolver *fs = file_resolver();
+            fs::path file_path = fs->resolve(props.get<std::string_view>("filename"));
+            if (!fs::exists(file_path))
+                Log(Error, "\"%s\": file does not exist!", file_path);
+
+            // Volumes loading the same file with the same settings share their data
+            std::string key = tfm::format("gridvolume:%s:%s:raw=%i", Base::Variant,
+                                          AssetRegistry::file_key(file_path), (int) m_raw);
+            asset = AssetRegistry::get<Asset>(key, [&]() {
+                ref<VolumeGrid> volume_grid = new VolumeGrid(file_path);
+                std::shared_ptr<Asset> result = convert(volume_grid.get());
+                size_t size = result->data.array().size() * sizeof(ScalarFloat);
+                // Only JIT variants share the storage (see below)
+                if constexpr (dr::is_jit_v<Float>)
+                    result->memory.set(size, file_path.filename().string());
+                return std::make_pair(result, size);
+            });
         }
 
-        if (props.get<bool>("use_grid_bbox", false)) {
-            if (tensor)
-                Throw("use_grid_bbox is unsupported with tensor input and requires a volume grid");
-            m_to_local = volume_grid->bbox_transform() * m_to_local;
-            update_bbox();
+        if (asset) {
+            // In JIT variants, this shares the underlying storage with the asset
+            m_texture = Texture3f(asset->data, m_accel, m_accel, filter_mode, wrap_mode);
+            m_max = asset->max;
+            m_max_per_channel = asset->max_per_channel;
+            if (asset->channel_count)
+                m_channel_count = asset->channel_count;
+
+            if (props.get<bool>("use_grid_bbox", false)) {
+                m_to_local = asset->bbox_transform * m_to_local;
+                update_bbox();
+            }
+
+            /* Keep the shared data alive (and thereby available to other
+               volumes) when the texture references it instead of storing a
+               private copy */
+            if constexpr (dr::is_jit_v<Float>) {
+                if (!(dr::is_cuda_v<Float> && m_accel))
+                    m_asset = asset;
+            }
         }
 
         if (props.has_property("max_value")) {
             m_fixed_max = true;
             m_max = props.get<ScalarFloat>("max_value");
         }
+
+        // Shared data is accounted for by the asset
+        m_memory.set(m_asset ? 0 : data_bytes(), std::string(props.id()));
     }
 
     void traverse(TraversalCallback *cb) override {
@@ -319,7 +307,10 @@ public:
                       "to have %d channels, only volumes with 1, 3 or 6 "
                       "channels are supported!", to_string(), channels);
 
+            // The data may have been replaced, stop attributing it to the asset
+            m_asset.reset();
             m_texture.update_inplace();
+            m_memory.set(data_bytes());
 
             if (!m_fixed_max)
                 m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
@@ -454,6 +445,12 @@ public:
     MI_DECLARE_CLASS(GridVolume)
 
 protected:
+    /// Size of the grid data (computed from the shape to avoid migrating it)
+    size_t data_bytes() const {
+        const size_t *shape = m_texture.shape();
+        return shape[0] * shape[1] * shape[2] * shape[3] * sizeof(ScalarFloat);
+    }
+
     /**
      * \brief Returns the number of channels in the grid
      *
@@ -618,6 +615,66 @@ protected:
             m_texture.template eval_nonaccel<Float>(p, out, active);
     }
 
+protected:
+    /**
+     * \brief Convert a volume grid into the stored representation, applying
+     * spectral upsampling if necessary
+     */
+    std::shared_ptr<Asset> convert(const VolumeGrid *volume_grid) const {
+        auto asset = std::make_shared<Asset>();
+        ScalarVector3u res = volume_grid->size();
+        ScalarUInt32 channel_count = (uint32_t) volume_grid->channel_count();
+        ScalarUInt32 size = dr::prod(res);
+        asset->bbox_transform = volume_grid->bbox_transform();
+
+        // Apply spectral conversion if necessary
+        if (is_spectral_v<Spectrum> && channel_count == 3 && !m_raw) {
+            const ScalarFloat *ptr = volume_grid->data();
+
+            auto scaled_data =
+                std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * 4]);
+            ScalarFloat *scaled_data_ptr = scaled_data.get();
+            ScalarFloat max = 0.0;
+            for (ScalarUInt32 i = 0; i < size; ++i) {
+                ScalarColor3f rgb = dr::load<ScalarColor3f>(ptr);
+                // TODO: Make this scaling optional if the RGB values are
+                // between 0 and 1
+                ScalarFloat scale = dr::max(rgb) * 2.f;
+                ScalarColor3f rgb_norm =
+                    rgb / dr::maximum((ScalarFloat) 1e-8, scale);
+                ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
+                max = dr::maximum(max, scale);
+                dr::store(scaled_data_ptr,
+                          dr::concat(coeff, dr::Array<ScalarFloat, 1>(scale)));
+                ptr += 3;
+                scaled_data_ptr += 4;
+            }
+            asset->max = (float) max;
+
+            size_t shape[4] = {
+                (size_t) res.z(),
+                (size_t) res.y(),
+                (size_t) res.x(),
+                4
+            };
+            asset->data = TensorXf(scaled_data.get(), 4, shape);
+        } else {
+            size_t shape[4] = {
+                (size_t) res.z(),
+                (size_t) res.y(),
+                (size_t) res.x(),
+                channel_count
+            };
+            asset->data = TensorXf(volume_grid->data(), 4, shape);
+            asset->max = volume_grid->max();
+            asset->max_per_channel.resize(volume_grid->channel_count());
+            volume_grid->max_per_channel(asset->max_per_channel.data());
+            asset->channel_count = channel_count;
+        }
+
+        return asset;
+    }
+
 protected:
     Texture3f m_texture;
     bool m_accel;
@@ -625,6 +682,9 @@ protected:
     bool m_fixed_max = false;
     ScalarFloat m_max;
     std::vector<ScalarFloat> m_max_per_channel;
+    /// Data shared with other volumes (see \ref AssetRegistry)
+    std::shared_ptr<const Asset> m_asset;
+    MemoryTracker m_memory { MemoryCategory::Volumes };
 
     MI_TRAVERSE_CB(Base, m_texture)
 };